@@ -0,0 +1,111 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+//
+// *********     Adaptive Timeout Benchmark      *********
+//
+//
+// Reads the present position of 8 Dynamixels one by one on PortHandlerSim ("sim:" port),
+// where one of them does not respond, with the fixed packet timeout and with the adaptive timeout
+// (PortHandler::setAdaptiveTimeout()). It reports the bus time per control cycle on the virtual clock
+// and the response time statistics learned for each ID.
+//
+// usage: adaptive_timeout [cycles] [dead ID] [port latency in usec] [return delay in usec]
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "dynamixel_sdk.h"                                  // Uses Dynamixel SDK library
+#include "port_handler_sim.h"
+
+#define NUM_DEVICES                     8
+#define BAUDRATE                        1000000
+#define ADDR_PRO_PRESENT_POSITION       611
+
+static void run(const char *name, bool adaptive, int cycles, int dead_id, int latency_us, int return_delay)
+{
+  dynamixel::PortHandlerSim *port          = new dynamixel::PortHandlerSim("sim:0");
+  dynamixel::PacketHandler  *packetHandler = dynamixel::PacketHandler::getPacketHandler(2.0);
+
+  for (int id = 3; id <= NUM_DEVICES; id++)
+    port->getBus()->addDevice(2.0, id);
+  port->getBus()->removeDevice(2.0, dead_id);
+  port->getBus()->setReturnDelayTime(return_delay);
+  port->setLatency((int64_t)latency_us * 1000);
+  port->openPort();
+  port->setBaudRate(BAUDRATE);
+  port->setAdaptiveTimeout(adaptive);
+
+  int       failures  = 0;
+  long long start     = port->getCurrentTimeNs();
+  for (int i = 0; i < cycles; i++)
+  {
+    for (int id = 1; id <= NUM_DEVICES; id++)
+    {
+      uint8_t  dxl_error = 0;
+      uint32_t position;
+      if (packetHandler->read4ByteTxRx(port, id, ADDR_PRO_PRESENT_POSITION, &position, &dxl_error) != COMM_SUCCESS)
+        failures++;
+    }
+  }
+  long long bus = port->getCurrentTimeNs() - start;
+
+  printf("%-9s  bus %8.1f us/cycle   failures %d\n", name, bus / 1000.0 / cycles, failures);
+  printf("  ID    count  timeouts  outliers  fallbacks    mean us     dev us     p99 us     max us  timeout us\n");
+  for (int id = 1; id <= NUM_DEVICES + 1; id++)
+  {
+    const dynamixel::ResponseStats *stats = port->getResponseStats((id <= NUM_DEVICES) ? id : BROADCAST_ID);
+    char                            id_name[8] = "all";
+    if (id <= NUM_DEVICES)
+      snprintf(id_name, sizeof(id_name), "%d", id);
+    printf("  %3s  %6u  %8u  %8u  %9u  %9.1f  %9.1f  %9.1f  %9.1f  %10.1f\n",
+           id_name, stats->count, stats->timeouts, stats->outliers, stats->fallbacks, stats->mean_ns / 1000.0,
+           stats->deviation_ns / 1000.0, stats->p99_ns / 1000.0, stats->max_ns / 1000.0, stats->timeout_ns / 1000.0);
+  }
+
+  port->closePort();
+  delete port;
+}
+
+int main(int argc, char *argv[])
+{
+  int cycles        = (argc > 1) ? atoi(argv[1]) : 1000;
+  int dead_id       = (argc > 2) ? atoi(argv[2]) : 5;
+  int latency_us    = (argc > 3) ? atoi(argv[3]) : 1000;
+  int return_delay  = (argc > 4) ? atoi(argv[4]) : 250;
+
+  printf("%d cycles of %d reads / dead ID %d / port latency %d us / return delay %d us\n",
+         cycles, NUM_DEVICES, dead_id, latency_us, return_delay);
+
+  run("fixed", false, cycles, dead_id, latency_us, return_delay);
+  run("adaptive", true, cycles, dead_id, latency_us, return_delay);
+  return 0;
+}
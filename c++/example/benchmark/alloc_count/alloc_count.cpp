@@ -0,0 +1,246 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+//
+// *********     Alloc Count Benchmark      *********
+//
+//
+// Counts the heap allocations (malloc/calloc/realloc, and new through them) made by the thread
+// running the transactions in steady state, on EmulatedBusPty with 4 MX-28 (Protocol 1.0) and 4 XM430-W350 (Protocol 2.0).
+// The emulator runs on its own thread, and its allocations are not counted.
+// It exits with 1 when a transaction allocates, so it can be used as a check of the hot paths.
+//
+// usage: alloc_count [transactions] [protocol version (0: both)]
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "dynamixel_sdk.h"                                  // Uses Dynamixel SDK library
+#include "emulated_bus.h"
+#include "emulated_bus_pty.h"
+
+#define NUM_DEVICES                     4
+#define BAUDRATE                        1000000
+#define ADDR_MX_GOAL_POSITION           30
+#define ADDR_MX_PRESENT_POSITION        36
+#define ADDR_XM_GOAL_POSITION           116
+#define ADDR_XM_PRESENT_POSITION        132
+#define XM430_W350_MODEL_NUMBER         1020
+
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+
+static __thread bool  counting          = false;
+static __thread long  allocation_count  = 0;
+
+// the allocations of the library and of libstdc++ come here, as the executable is searched first
+extern "C" void *malloc(size_t size)
+{
+  if (counting)
+    allocation_count++;
+  return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size)
+{
+  if (counting)
+    allocation_count++;
+  return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size)
+{
+  if (counting)
+    allocation_count++;
+  return __libc_realloc(ptr, size);
+}
+
+struct Context
+{
+  dynamixel::PortHandler    *port;
+  dynamixel::PacketHandler  *packetHandler;
+  dynamixel::GroupSyncWrite *groupSyncWrite;
+  dynamixel::GroupBulkRead  *groupBulkRead;
+  uint16_t                   goal_address;
+  uint16_t                   present_address;
+  int                        count;
+};
+
+static bool ping(Context *c)
+{
+  uint8_t dxl_error = 0;
+  return c->packetHandler->ping(c->port, (uint8_t)(c->count % NUM_DEVICES + 1), &dxl_error) == COMM_SUCCESS;
+}
+
+static bool read2ByteTxRx(Context *c)
+{
+  uint16_t position = 0;
+  uint8_t  dxl_error = 0;
+  return c->packetHandler->read2ByteTxRx(c->port, (uint8_t)(c->count % NUM_DEVICES + 1), c->present_address, &position, &dxl_error) == COMM_SUCCESS;
+}
+
+static bool readTxThenRx(Context *c)
+{
+  uint8_t  id = (uint8_t)(c->count % NUM_DEVICES + 1);
+  uint8_t  data[2];
+  uint8_t  dxl_error = 0;
+  if (c->packetHandler->readTx(c->port, id, c->present_address, 2) != COMM_SUCCESS)
+    return false;
+  return c->packetHandler->readRx(c->port, id, 2, data, &dxl_error) == COMM_SUCCESS;
+}
+
+static bool write2ByteTxRx(Context *c)
+{
+  uint8_t dxl_error = 0;
+  return c->packetHandler->write2ByteTxRx(c->port, (uint8_t)(c->count % NUM_DEVICES + 1), c->goal_address, (uint16_t)(c->count % 1024), &dxl_error) == COMM_SUCCESS;
+}
+
+static bool write2ByteTxOnly(Context *c)
+{
+  return c->packetHandler->write2ByteTxOnly(c->port, (uint8_t)(c->count % NUM_DEVICES + 1), c->goal_address, (uint16_t)(c->count % 1024)) == COMM_SUCCESS;
+}
+
+static bool regWriteAction(Context *c)
+{
+  uint8_t data[2] = { DXL_LOBYTE(c->count % 1024), DXL_HIBYTE(c->count % 1024) };
+  uint8_t dxl_error = 0;
+  if (c->packetHandler->regWriteTxRx(c->port, (uint8_t)(c->count % NUM_DEVICES + 1), c->goal_address, 2, data, &dxl_error) != COMM_SUCCESS)
+    return false;
+  return c->packetHandler->action(c->port, BROADCAST_ID) == COMM_SUCCESS;
+}
+
+static bool syncWrite(Context *c)
+{
+  for (int id = 1; id <= NUM_DEVICES; id++)
+  {
+    uint8_t data[2] = { DXL_LOBYTE((c->count + id) % 1024), DXL_HIBYTE((c->count + id) % 1024) };
+    c->groupSyncWrite->changeParam((uint8_t)id, data);
+  }
+  return c->groupSyncWrite->txPacket() == COMM_SUCCESS;
+}
+
+static bool bulkRead(Context *c)
+{
+  if (c->groupBulkRead->txRxPacket() != COMM_SUCCESS)
+    return false;
+  return c->groupBulkRead->getData(1, c->present_address, 2) < 4096;
+}
+
+static bool run(const char *name, bool (*transaction)(Context *), Context *c, int transactions)
+{
+  int failures = 0;
+
+  // the first transactions may make the parameters of the group classes
+  for (c->count = 0; c->count < 10; c->count++)
+    transaction(c);
+
+  allocation_count = 0;
+  counting = true;
+  for (c->count = 0; c->count < transactions; c->count++)
+  {
+    if (transaction(c) == false)
+      failures++;
+  }
+  counting = false;
+
+  printf("%-22s allocations %6ld (%.3f /txn)   failures %d\n", name, allocation_count, (double)allocation_count / transactions, failures);
+  return allocation_count == 0;
+}
+
+static bool runProtocol(float protocol_version, int transactions)
+{
+  dynamixel::EmulatedBus bus(BAUDRATE);
+  for (int id = 1; id <= NUM_DEVICES; id++)
+    bus.addDevice(protocol_version, id, (protocol_version == 1.0) ? 0 : XM430_W350_MODEL_NUMBER);
+  bus.setReturnDelayTime(0);
+
+  dynamixel::EmulatedBusPty pty(&bus);
+  if (!pty.start())
+    return false;
+
+  Context c;
+  c.port            = dynamixel::PortHandler::getPortHandler(pty.getPortName());
+  c.packetHandler   = dynamixel::PacketHandler::getPacketHandler(protocol_version);
+  c.goal_address    = (protocol_version == 1.0) ? ADDR_MX_GOAL_POSITION : ADDR_XM_GOAL_POSITION;
+  c.present_address = (protocol_version == 1.0) ? ADDR_MX_PRESENT_POSITION : ADDR_XM_PRESENT_POSITION;
+  if (!c.port->openPort() || !c.port->setBaudRate(BAUDRATE))
+  {
+    printf("Failed to open %s\n", pty.getPortName());
+    delete c.port;
+    pty.stop();
+    return false;
+  }
+
+  bool result = true;
+  {
+    dynamixel::GroupSyncWrite groupSyncWrite(c.port, c.packetHandler, c.goal_address, 2);
+    dynamixel::GroupBulkRead  groupBulkRead(c.port, c.packetHandler);
+    for (int id = 1; id <= NUM_DEVICES; id++)
+    {
+      uint8_t data[2] = { 0, 0 };
+      groupSyncWrite.addParam((uint8_t)id, data);
+      groupBulkRead.addParam((uint8_t)id, c.present_address, 2);
+    }
+    c.groupSyncWrite = &groupSyncWrite;
+    c.groupBulkRead  = &groupBulkRead;
+
+    printf("Protocol %.1f on %s / %d transactions each\n", protocol_version, pty.getPortName(), transactions);
+    result &= run("ping", ping, &c, transactions);
+    result &= run("read2ByteTxRx", read2ByteTxRx, &c, transactions);
+    result &= run("readTx + readRx", readTxThenRx, &c, transactions);
+    result &= run("write2ByteTxRx", write2ByteTxRx, &c, transactions);
+    result &= run("write2ByteTxOnly", write2ByteTxOnly, &c, transactions);
+    result &= run("regWriteTxRx + action", regWriteAction, &c, transactions);
+    result &= run("GroupSyncWrite", syncWrite, &c, transactions);
+    result &= run("GroupBulkRead", bulkRead, &c, transactions);
+  }
+
+  c.port->closePort();
+  delete c.port;
+  pty.stop();
+  return result;
+}
+
+int main(int argc, char *argv[])
+{
+  int   transactions     = (argc > 1) ? atoi(argv[1]) : 500;
+  float protocol_version = (argc > 2) ? (float)atof(argv[2]) : 0;
+
+  bool result = true;
+  if (protocol_version == 0 || protocol_version == 1.0)
+    result &= runProtocol(1.0, transactions);
+  if (protocol_version == 0 || protocol_version == 2.0)
+    result &= runProtocol(2.0, transactions);
+
+  printf("%s\n", result ? "no allocation in steady state" : "ALLOCATIONS FOUND");
+  return result ? 0 : 1;
+}
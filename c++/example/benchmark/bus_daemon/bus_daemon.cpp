@@ -0,0 +1,225 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+//
+// *********     Bus Daemon Benchmark      *********
+//
+//
+// Shares one emulated bus (EmulatedBusPty with 8 Dynamixels) among processes by BusDaemon.
+// A 500 Hz control loop (sync read of 8 IDs through PortHandlerClient, priority 10) runs alone,
+// then with monitor processes reading single registers as fast as they can through "unix:<socket>",
+// at priority 0 and at the same priority as the control loop.
+// It reports the cycle time of the control loop, and the transactions of the monitors.
+//
+// usage: bus_daemon [cycles] [monitors]
+//
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/wait.h>
+#include <algorithm>
+#include <vector>
+
+#include "dynamixel_sdk.h"                                  // Uses Dynamixel SDK library
+#include "bus_daemon.h"
+#include "emulated_bus.h"
+#include "emulated_bus_pty.h"
+#include "port_handler_client.h"
+
+#define NUM_DEVICES                     8
+#define BAUDRATE                        1000000
+#define PERIOD_US                       2000
+#define CONTROL_PRIORITY                10
+#define ADDR_PRO_PRESENT_POSITION       611
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void onSignal(int)
+{
+  stop_requested = 1;
+}
+
+static long long nowNs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// process owning the bus
+static int serve(const char *socket_path)
+{
+  sigset_t sigset;
+  sigemptyset(&sigset);
+  sigaddset(&sigset, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &sigset, NULL);
+
+  dynamixel::EmulatedBus bus(BAUDRATE);
+  for (int id = 1; id <= NUM_DEVICES; id++)
+    bus.addDevice(2.0, id);
+  bus.setReturnDelayTime(0);
+
+  dynamixel::EmulatedBusPty pty(&bus);
+  if (!pty.start())
+    return 1;
+
+  dynamixel::PortHandlerLinux port(pty.getPortName());
+  dynamixel::BusDaemon        daemon(&port);
+  if (!port.openPort() || !port.setBaudRate(BAUDRATE) || !daemon.start(socket_path))
+    return 1;
+
+  int sig;
+  sigwait(&sigset, &sig);
+  daemon.stop();
+  printf("  daemon: %u transactions served\n", daemon.getTransactionCount());
+  return 0;
+}
+
+// process reading the registers of every ID one by one, as a monitor or a logger
+static int monitor(const char *socket_path, int index, int priority)
+{
+  signal(SIGTERM, onSignal);
+
+  char port_name[128];
+  snprintf(port_name, sizeof(port_name), "unix:%s", socket_path);
+
+  dynamixel::PortHandler   *port          = dynamixel::PortHandler::getPortHandler(port_name);
+  dynamixel::PacketHandler *packetHandler = dynamixel::PacketHandler::getPacketHandler(2.0);
+  if (!port->openPort() || !port->setBaudRate(BAUDRATE))
+    return 1;
+  ((dynamixel::PortHandlerClient *)port)->setPriority(priority);
+
+  long      count     = 0;
+  long      failures  = 0;
+  uint32_t  position  = 0;
+  uint8_t   dxl_error = 0;
+  while (!stop_requested)
+  {
+    uint8_t id = (uint8_t)(count % NUM_DEVICES + 1);
+    if (packetHandler->read4ByteTxRx(port, id, ADDR_PRO_PRESENT_POSITION, &position, &dxl_error) != COMM_SUCCESS)
+      failures++;
+    count++;
+  }
+  printf("  monitor %d: %ld transactions   failures %ld\n", index, count, failures);
+  delete port;
+  return 0;
+}
+
+static void run(const char *name, const char *socket_path, int cycles, int monitors, int monitor_priority)
+{
+  std::vector<pid_t>      children;
+  std::vector<long long>  cycle;
+  int                     failures = 0;
+
+  printf("%s\n", name);
+  fflush(stdout);
+  for (int i = 0; i < monitors; i++)
+  {
+    pid_t pid = fork();
+    if (pid == 0)
+      exit(monitor(socket_path, i + 1, monitor_priority));
+    children.push_back(pid);
+  }
+
+  char port_name[128];
+  snprintf(port_name, sizeof(port_name), "unix:%s", socket_path);
+  dynamixel::PortHandlerClient  port(port_name);
+  dynamixel::PacketHandler     *packetHandler = dynamixel::PacketHandler::getPacketHandler(2.0);
+  if (!port.openPort() || !port.setBaudRate(BAUDRATE))
+  {
+    printf("Failed to open %s\n", port_name);
+    return;
+  }
+  port.setPriority(CONTROL_PRIORITY);
+
+  dynamixel::GroupSyncRead groupSyncRead(&port, packetHandler, ADDR_PRO_PRESENT_POSITION, 4);
+  for (int id = 1; id <= NUM_DEVICES; id++)
+    groupSyncRead.addParam(id);
+
+  long long next = nowNs();
+  for (int i = 0; i < cycles; i++)
+  {
+    next += PERIOD_US * 1000LL;
+    struct timespec ts = { (time_t)(next / 1000000000LL), (long)(next % 1000000000LL) };
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+
+    long long start = nowNs();
+    if (groupSyncRead.txRxPacket() != COMM_SUCCESS)
+      failures++;
+    cycle.push_back(nowNs() - start);
+
+    // a cycle overrun is not caught up
+    if (nowNs() > next + PERIOD_US * 1000LL)
+      next = nowNs();
+  }
+  port.closePort();
+
+  for (size_t i = 0; i < children.size(); i++)
+  {
+    kill(children[i], SIGTERM);
+    waitpid(children[i], NULL, 0);
+  }
+
+  std::sort(cycle.begin(), cycle.end());
+  size_t n = cycle.size();
+  printf("  control: cycle p50 %8.1f us   p99 %8.1f us   max %8.1f us   failures %d\n\n",
+         cycle[n / 2] / 1000.0, cycle[(n * 99) / 100] / 1000.0, cycle[n - 1] / 1000.0, failures);
+  fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+  int  cycles   = (argc > 1) ? atoi(argv[1]) : 1000;
+  int  monitors = (argc > 2) ? atoi(argv[2]) : 3;
+  char socket_path[64];
+
+  snprintf(socket_path, sizeof(socket_path), "/tmp/dxl_bus_daemon_%d.sock", (int)getpid());
+  printf("%s / %d cycles of %d us (sync read x%d) / %d monitors\n\n", socket_path, cycles, PERIOD_US, NUM_DEVICES, monitors);
+  fflush(stdout);
+
+  pid_t server = fork();
+  if (server == 0)
+    exit(serve(socket_path));
+
+  // the socket is created by the daemon
+  for (int i = 0; i < 200 && access(socket_path, F_OK) != 0; i++)
+    usleep(10000);
+
+  run("control loop alone", socket_path, cycles, 0, 0);
+  run("with monitors of priority 0", socket_path, cycles, monitors, 0);
+  run("with monitors of the same priority", socket_path, cycles, monitors, CONTROL_PRIORITY);
+
+  kill(server, SIGTERM);
+  waitpid(server, NULL, 0);
+  return 0;
+}
@@ -0,0 +1,177 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+//
+// *********     Bus Executor Benchmark      *********
+//
+//
+// Runs a control cycle (sync write + sync read of 8 Dynamixels) on several buses, each emulated on a pseudo-terminal
+// (EmulatedBusPty) and opened by PortHandlerLinux. The cycle is run on the buses one after the other from the control thread,
+// then on all buses at once by BusExecutor. It reports the cycle time, which should become the time of one bus.
+//
+// usage: bus_executor [cycles] [buses]
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <algorithm>
+#include <vector>
+
+#include "dynamixel_sdk.h"                                  // Uses Dynamixel SDK library
+#include "bus_executor.h"
+#include "emulated_bus.h"
+#include "emulated_bus_pty.h"
+
+#define MAX_BUSES                       8
+#define NUM_DEVICES                     8
+#define BAUDRATE                        1000000
+#define ADDR_PRO_GOAL_POSITION          596
+#define ADDR_PRO_PRESENT_POSITION       611
+
+static long long nowNs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void report(const char *name, std::vector<long long> &cycle, int failures)
+{
+  std::sort(cycle.begin(), cycle.end());
+  size_t n = cycle.size();
+  long long sum = 0;
+  for (size_t i = 0; i < n; i++)
+    sum += cycle[i];
+  printf("%-10s  cycle mean %8.1f us   p50 %8.1f us   p99 %8.1f us   failures %d\n",
+         name, sum / 1000.0 / n, cycle[n / 2] / 1000.0, cycle[(n * 99) / 100] / 1000.0, failures);
+}
+
+int main(int argc, char *argv[])
+{
+  int cycles      = (argc > 1) ? atoi(argv[1]) : 1000;
+  int num_buses   = (argc > 2) ? atoi(argv[2]) : 2;
+  if (num_buses < 1 || num_buses > MAX_BUSES)
+    num_buses = 2;
+
+  dynamixel::PacketHandler   *packetHandler = dynamixel::PacketHandler::getPacketHandler(2.0);
+  dynamixel::EmulatedBus     *bus[MAX_BUSES];
+  dynamixel::EmulatedBusPty  *pty[MAX_BUSES];
+  dynamixel::PortHandler     *port[MAX_BUSES];
+  dynamixel::GroupSyncWrite  *groupSyncWrite[MAX_BUSES];
+  dynamixel::GroupSyncRead   *groupSyncRead[MAX_BUSES];
+
+  for (int b = 0; b < num_buses; b++)
+  {
+    bus[b] = new dynamixel::EmulatedBus(BAUDRATE);
+    for (int id = 1; id <= NUM_DEVICES; id++)
+      bus[b]->addDevice(2.0, id);
+    bus[b]->setReturnDelayTime(0);
+
+    pty[b] = new dynamixel::EmulatedBusPty(bus[b]);
+    if (!pty[b]->start())
+      return 1;
+
+    port[b] = dynamixel::PortHandler::getPortHandler(pty[b]->getPortName());
+    if (!port[b]->openPort() || !port[b]->setBaudRate(BAUDRATE))
+    {
+      printf("Failed to open %s\n", pty[b]->getPortName());
+      return 1;
+    }
+
+    uint8_t goal[4] = { 0x00, 0x08, 0x00, 0x00 };
+    groupSyncWrite[b] = new dynamixel::GroupSyncWrite(port[b], packetHandler, ADDR_PRO_GOAL_POSITION, 4);
+    groupSyncRead[b]  = new dynamixel::GroupSyncRead(port[b], packetHandler, ADDR_PRO_PRESENT_POSITION, 4);
+    for (int id = 1; id <= NUM_DEVICES; id++)
+    {
+      groupSyncWrite[b]->addParam(id, goal);
+      groupSyncRead[b]->addParam(id);
+    }
+  }
+
+  printf("%d cycles (sync write + sync read x%d) on %d buses\n", cycles, NUM_DEVICES, num_buses);
+
+  // one bus after the other
+  std::vector<long long> cycle;
+  int                    failures = 0;
+  for (int i = 0; i < cycles; i++)
+  {
+    long long start = nowNs();
+    for (int b = 0; b < num_buses; b++)
+    {
+      if (groupSyncWrite[b]->txPacket() != COMM_SUCCESS)
+        failures++;
+      if (groupSyncRead[b]->txRxPacket() != COMM_SUCCESS)
+        failures++;
+    }
+    cycle.push_back(nowNs() - start);
+  }
+  report("sequential", cycle, failures);
+
+  // all buses at once
+  dynamixel::BusExecutor *executor = new dynamixel::BusExecutor();
+  for (int b = 0; b < num_buses; b++)
+    executor->addPort(port[b]);
+
+  cycle.clear();
+  failures = 0;
+  for (int i = 0; i < cycles; i++)
+  {
+    long long start = nowNs();
+    for (int b = 0; b < num_buses; b++)
+    {
+      executor->submitTx(b, groupSyncWrite[b]);
+      executor->submitTxRx(b, groupSyncRead[b]);
+    }
+    for (int b = 0; b < num_buses; b++)
+    {
+      dynamixel::BusCompletion completion;
+      while (executor->waitCompletion(b, &completion))
+      {
+        if (completion.result != COMM_SUCCESS)
+          failures++;
+      }
+    }
+    cycle.push_back(nowNs() - start);
+  }
+  report("executor", cycle, failures);
+
+  delete executor;
+  for (int b = 0; b < num_buses; b++)
+  {
+    delete groupSyncRead[b];
+    delete groupSyncWrite[b];
+    port[b]->closePort();
+    delete port[b];
+    delete pty[b];
+    delete bus[b];
+  }
+  return 0;
+}
@@ -0,0 +1,191 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+//
+// *********     Bus Lock Benchmark      *********
+//
+//
+// Shares one bus (EmulatedBusPty, 8 Dynamixels) between a control thread and a telemetry thread without a mutex of the
+// application. The control thread runs a cycle (sync write + sync read in one BusTransaction) every period, while the
+// telemetry thread reads each Dynamixel (read4ByteTxRx) as fast as it can. The run is made with the control thread at
+// the same priority as the telemetry thread, then at a higher priority.
+// It reports the time the control thread waits for the bus, the cycle time, and the failures (COMM_PORT_BUSY, timeouts).
+//
+// usage: bus_lock [cycles] [period in usec]
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <algorithm>
+#include <vector>
+
+#include "dynamixel_sdk.h"                                  // Uses Dynamixel SDK library
+#include "emulated_bus.h"
+#include "emulated_bus_pty.h"
+
+#define NUM_DEVICES                     8
+#define BAUDRATE                        1000000
+#define ADDR_PRO_GOAL_POSITION          596
+#define ADDR_PRO_PRESENT_POSITION       611
+#define ADDR_PRO_PRESENT_TEMPERATURE    625
+
+struct Telemetry
+{
+  dynamixel::PortHandler   *port;
+  volatile bool             stop;
+  int                       reads;
+  int                       failures;
+};
+
+static long long nowNs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void sleepUntil(long long time_ns)
+{
+  struct timespec ts = { (time_t)(time_ns / 1000000000LL), (long)(time_ns % 1000000000LL) };
+  clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+}
+
+static void *readTelemetry(void *arg)
+{
+  Telemetry                *telemetry     = (Telemetry *)arg;
+  dynamixel::PacketHandler *packetHandler = dynamixel::PacketHandler::getPacketHandler(2.0);
+  uint8_t                   dxl_error     = 0;
+  uint32_t                  temperature   = 0;
+
+  for (int i = 0; telemetry->stop == false; i++)
+  {
+    int id = (i % NUM_DEVICES) + 1;
+    if (packetHandler->read4ByteTxRx(telemetry->port, id, ADDR_PRO_PRESENT_TEMPERATURE, &temperature, &dxl_error) != COMM_SUCCESS)
+      telemetry->failures++;
+    telemetry->reads++;
+  }
+  return NULL;
+}
+
+static void report(const char *name, std::vector<long long> &samples)
+{
+  std::sort(samples.begin(), samples.end());
+  size_t n = samples.size();
+  printf("  %-12s p50 %8.1f us   p99 %8.1f us   max %8.1f us\n",
+         name, samples[n / 2] / 1000.0, samples[(n * 99) / 100] / 1000.0, samples[n - 1] / 1000.0);
+}
+
+static void run(dynamixel::PortHandler *port, dynamixel::GroupSyncWrite *groupSyncWrite, dynamixel::GroupSyncRead *groupSyncRead,
+                int priority, int cycles, int period_us)
+{
+  Telemetry telemetry;
+  telemetry.port     = port;
+  telemetry.stop     = false;
+  telemetry.reads    = 0;
+  telemetry.failures = 0;
+
+  pthread_t telemetry_thread;
+  pthread_create(&telemetry_thread, NULL, readTelemetry, &telemetry);
+
+  std::vector<long long> wait, cycle;
+  int                    failures = 0;
+  long long              next     = nowNs();
+  for (int i = 0; i < cycles; i++)
+  {
+    next += period_us * 1000LL;
+    sleepUntil(next);
+
+    long long start = nowNs();
+    dynamixel::BusTransaction transaction(port, -1.0, priority);
+    long long acquired = nowNs();
+    if (groupSyncWrite->txPacket() != COMM_SUCCESS)
+      failures++;
+    if (groupSyncRead->txRxPacket() != COMM_SUCCESS)
+      failures++;
+    transaction.release();
+
+    wait.push_back(acquired - start);
+    cycle.push_back(nowNs() - start);
+  }
+
+  telemetry.stop = true;
+  pthread_join(telemetry_thread, NULL);
+
+  printf("control priority %d : %d cycles   failures %d   telemetry reads %d   failures %d\n",
+         priority, cycles, failures, telemetry.reads, telemetry.failures);
+  report("bus wait", wait);
+  report("cycle", cycle);
+}
+
+int main(int argc, char *argv[])
+{
+  int cycles    = (argc > 1) ? atoi(argv[1]) : 1000;
+  int period_us = (argc > 2) ? atoi(argv[2]) : 4000;
+
+  dynamixel::EmulatedBus bus(BAUDRATE);
+  for (int id = 1; id <= NUM_DEVICES; id++)
+    bus.addDevice(2.0, id);
+  bus.setReturnDelayTime(0);
+
+  dynamixel::EmulatedBusPty pty(&bus);
+  if (!pty.start())
+    return 1;
+
+  dynamixel::PortHandler   *port          = dynamixel::PortHandler::getPortHandler(pty.getPortName());
+  dynamixel::PacketHandler *packetHandler = dynamixel::PacketHandler::getPacketHandler(2.0);
+  if (!port->openPort() || !port->setBaudRate(BAUDRATE))
+  {
+    printf("Failed to open %s\n", pty.getPortName());
+    return 1;
+  }
+
+  // the threads wait for the bus in turn, instead of getting COMM_PORT_BUSY at once
+  port->setBusTimeout(-1.0);
+
+  uint8_t goal[4] = { 0x00, 0x08, 0x00, 0x00 };
+  dynamixel::GroupSyncWrite groupSyncWrite(port, packetHandler, ADDR_PRO_GOAL_POSITION, 4);
+  dynamixel::GroupSyncRead  groupSyncRead(port, packetHandler, ADDR_PRO_PRESENT_POSITION, 4);
+  for (int id = 1; id <= NUM_DEVICES; id++)
+  {
+    groupSyncWrite.addParam(id, goal);
+    groupSyncRead.addParam(id);
+  }
+
+  printf("%d cycles every %d us (sync write + sync read x%d) with a telemetry thread on %s\n",
+         cycles, period_us, NUM_DEVICES, pty.getPortName());
+  run(port, &groupSyncWrite, &groupSyncRead, 0, cycles, period_us);
+  run(port, &groupSyncWrite, &groupSyncRead, 1, cycles, period_us);
+
+  port->closePort();
+  delete port;
+  return 0;
+}
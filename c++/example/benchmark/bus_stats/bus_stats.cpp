@@ -0,0 +1,198 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+//
+// *********     Bus Stats Benchmark      *********
+//
+//
+// Runs a control loop (sync write + sync read of 8 Dynamixels + read of an ID not connected)
+// against PortHandlerSim with the bus statistics disabled and enabled,
+// while another thread takes a snapshot of the statistics every msec by PortHandler::getBusStats().
+// It reports the cost of the statistics per cycle, and prints the last snapshot.
+//
+// usage: bus_stats [cycles]
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "dynamixel_sdk.h"                                  // Uses Dynamixel SDK library
+#include "port_handler_sim.h"
+
+#define NUM_DEVICES                     8
+#define MISSING_ID                      20
+#define BAUDRATE                        1000000
+#define ADDR_PRO_GOAL_POSITION          596
+#define ADDR_PRO_PRESENT_POSITION       611
+
+struct Scraper
+{
+  dynamixel::PortHandler *port;
+  volatile bool           stop;
+  long                    snapshots;
+  dynamixel::BusStats     stats;
+};
+
+static long long nowNs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void *scrape(void *arg)
+{
+  Scraper *scraper = (Scraper *)arg;
+  while (!scraper->stop)
+  {
+    if (scraper->port->getBusStats(&scraper->stats))
+      scraper->snapshots++;
+    usleep(1000);
+  }
+  return NULL;
+}
+
+// upper bound of the bucket where the ratio of the samples is reached
+static double percentile(const dynamixel::LatencyHistogram *histogram, double ratio)
+{
+  uint32_t target = (uint32_t)(histogram->count * ratio);
+  uint32_t sum    = 0;
+  for (int b = 0; b < dynamixel::LatencyHistogram::BUCKET_COUNT_; b++)
+  {
+    sum += histogram->buckets[b];
+    if (sum > target)
+      return (double)(2 << b);
+  }
+  return (double)(2 << (dynamixel::LatencyHistogram::BUCKET_COUNT_ - 1));
+}
+
+static void printHistogram(const char *name, const dynamixel::LatencyHistogram *histogram)
+{
+  if (histogram->count == 0)
+    return;
+  printf("  %-14s count %8u   mean %8.1f us   p50 < %6.0f us   p99 < %6.0f us\n", name, histogram->count,
+         histogram->sum_ns / 1000.0 / histogram->count, percentile(histogram, 0.50), percentile(histogram, 0.99));
+}
+
+static long long runCycles(dynamixel::PortHandler *port, int cycles)
+{
+  dynamixel::PacketHandler *packetHandler = dynamixel::PacketHandler::getPacketHandler(2.0);
+  dynamixel::GroupSyncWrite sync_write(port, packetHandler, ADDR_PRO_GOAL_POSITION, 4);
+  dynamixel::GroupSyncRead  sync_read(port, packetHandler, ADDR_PRO_PRESENT_POSITION, 4);
+  uint8_t                   goal[4] = { 0x00, 0x10, 0x00, 0x00 };
+  uint8_t                   dxl_error = 0;
+  uint32_t                  position = 0;
+
+  for (int id = 1; id <= NUM_DEVICES; id++)
+  {
+    sync_write.addParam((uint8_t)id, goal);
+    sync_read.addParam((uint8_t)id);
+  }
+
+  long long start = nowNs();
+  for (int i = 0; i < cycles; i++)
+  {
+    sync_write.txPacket();
+    sync_read.txRxPacket();
+    packetHandler->read4ByteTxRx(port, MISSING_ID, ADDR_PRO_PRESENT_POSITION, &position, &dxl_error);
+  }
+  return nowNs() - start;
+}
+
+int main(int argc, char *argv[])
+{
+  int cycles = (argc > 1) ? atoi(argv[1]) : 100000;
+
+  dynamixel::PortHandlerSim *port = (dynamixel::PortHandlerSim *)dynamixel::PortHandler::getPortHandler("sim:0");
+  for (int id = 3; id <= NUM_DEVICES; id++)
+    port->getBus()->addDevice(2.0, (uint8_t)id);
+  port->getBus()->setReturnDelayTime(0);
+
+  if (!port->openPort() || !port->setBaudRate(BAUDRATE))
+  {
+    printf("Failed to open the port!\n");
+    return 1;
+  }
+
+  printf("%d cycles (sync write x%d + sync read x%d + read of ID %d not connected)\n", cycles, NUM_DEVICES, NUM_DEVICES, MISSING_ID);
+
+  long long disabled = runCycles(port, cycles);
+
+  Scraper scraper;
+  scraper.port      = port;
+  scraper.stop      = false;
+  scraper.snapshots = 0;
+
+  port->setBusStats(true);
+  pthread_t scraper_thread;
+  pthread_create(&scraper_thread, NULL, scrape, &scraper);
+
+  long long enabled = runCycles(port, cycles);
+
+  scraper.stop = true;
+  pthread_join(scraper_thread, NULL);
+
+  printf("disabled    host %7.3f us/cycle\n", disabled / 1000.0 / cycles);
+  printf("enabled     host %7.3f us/cycle   overhead %6.3f us/cycle   snapshots %ld\n",
+         enabled / 1000.0 / cycles, (enabled - disabled) / 1000.0 / cycles, scraper.snapshots);
+
+  dynamixel::BusStats *stats = &scraper.stats;
+  port->getBusStats(stats);
+  printf("tx %u packets %llu bytes / rx %u packets %llu bytes / syscalls %u\n",
+         stats->tx_packets, (unsigned long long)stats->tx_bytes, stats->rx_packets, (unsigned long long)stats->rx_bytes, stats->syscalls);
+  printf("rx timeouts %u / rx corrupts %u / checksum errors %u / resyncs %u (%u bytes)\n",
+         stats->rx_timeouts, stats->rx_corrupts, stats->checksum_errors, stats->resyncs, stats->resync_bytes);
+
+  printf("latency by instruction\n");
+  for (int i = 0; i < dynamixel::BusStats::INSTRUCTION_COUNT_; i++)
+  {
+    char name[16];
+    snprintf(name, sizeof(name), "0x%02X", stats->instructions[i]);
+    printHistogram(name, &stats->instruction_latency[i]);
+  }
+  printf("latency by ID\n");
+  for (int id = 0; id < dynamixel::BusStats::ID_COUNT_; id++)
+  {
+    char name[16];
+    snprintf(name, sizeof(name), "[ID:%03d]", id);
+    printHistogram(name, &stats->id_latency[id]);
+  }
+
+  port->clearBusStats();
+  port->getBusStats(stats);
+  printf("after clearBusStats: tx %u packets / rx %u packets\n", stats->tx_packets, stats->rx_packets);
+
+  port->closePort();
+  delete port;
+  return 0;
+}
@@ -0,0 +1,181 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+//
+// *********     CRC-16 Benchmark      *********
+//
+//
+// Measures the throughput of the CRC-16 kernels of Protocol 2.0 (Crc16) for the lengths of packets,
+// against the previous calculation which built its table on the stack on every call (kept in this file).
+// Before that, every kernel is cross-validated against a bitwise calculation:
+// the check value of "123456789", every length up to 1100 bytes at every alignment of 16 bytes,
+// random initial CRC, and data split into random pieces.
+// It exits with 1 when a kernel gives a different CRC.
+//
+// usage: crc16 [megabytes per measurement]
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "crc16.h"
+
+#define BUFFER_LEN                      (8*1024)
+
+typedef uint16_t (*Kernel)(uint16_t crc, const uint8_t *data, int length);
+
+// the definition of the CRC, one bit at a time
+static uint16_t bitwiseCRC(uint16_t crc, const uint8_t *data, int length)
+{
+  for (int i = 0; i < length; i++)
+  {
+    crc ^= (uint16_t)data[i] << 8;
+    for (int b = 0; b < 8; b++)
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x8005) : (uint16_t)(crc << 1);
+  }
+  return crc;
+}
+
+static uint16_t previous_table[256];
+
+// the previous Protocol2PacketHandler::updateCRC(), which copied its table to the stack on every call
+static uint16_t previousCRC(uint16_t crc, const uint8_t *data, int length)
+{
+  uint16_t table[256];
+  memcpy(table, previous_table, sizeof(table));
+  __asm__ __volatile__("" : : "r"(table) : "memory");
+
+  for (int i = 0; i < length; i++)
+    crc = (uint16_t)(crc << 8) ^ table[((crc >> 8) ^ data[i]) & 0xFF];
+  return crc;
+}
+
+static long long nowNs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static bool validate(const char *name, Kernel kernel, const uint8_t *data)
+{
+  int failures = 0;
+
+  if (kernel(0, (const uint8_t *)"123456789", 9) != 0xFEE8)
+    failures++;
+
+  for (int length = 0; length <= 1100; length++)
+  {
+    for (int offset = 0; offset < 16; offset++)
+    {
+      uint16_t init = (uint16_t)(length * 40503 + offset);
+      if (kernel(init, data + offset, length) != bitwiseCRC(init, data + offset, length))
+        failures++;
+    }
+  }
+
+  // a packet written from several buffers
+  for (int i = 0; i < 10000; i++)
+  {
+    int      length   = rand() % 4096;
+    uint16_t expected = bitwiseCRC(0, data, length);
+    uint16_t crc      = 0;
+    for (int done = 0; done < length; )
+    {
+      int piece = rand() % (length - done + 1);
+      crc   = kernel(crc, data + done, piece);
+      done += piece;
+    }
+    if (crc != expected)
+      failures++;
+  }
+
+  printf("%-10s %s (%d failures)\n", name, failures == 0 ? "valid" : "INVALID", failures);
+  return failures == 0;
+}
+
+static void measure(const char *name, Kernel kernel, const uint8_t *data, const int *lengths, int count, long long bytes)
+{
+  printf("%-10s", name);
+  for (int i = 0; i < count; i++)
+  {
+    int       iterations = (int)(bytes / lengths[i]) + 1;
+    uint16_t  crc        = 0;
+    long long start      = nowNs();
+    for (int n = 0; n < iterations; n++)
+      crc = kernel(crc, data, lengths[i]);
+    long long elapsed    = nowNs() - start;
+    __asm__ __volatile__("" : : "r"(crc));
+    printf(" %8.0f", (double)lengths[i] * iterations / elapsed * 1000.0);   // MB/s
+  }
+  printf("\n");
+}
+
+int main(int argc, char *argv[])
+{
+  long long bytes = (long long)((argc > 1) ? atof(argv[1]) : 32.0) * 1000000LL;
+
+  for (int n = 0; n < 256; n++)
+  {
+    uint8_t byte = (uint8_t)n;
+    previous_table[n] = bitwiseCRC(0, &byte, 1);
+  }
+
+  static uint8_t data[BUFFER_LEN];
+  for (int i = 0; i < BUFFER_LEN; i++)
+    data[i] = (uint8_t)rand();
+
+  printf("CPU carry-less multiplication : %s / Crc16::update() kernel : %d\n",
+         dynamixel::Crc16::isClmulSupported() ? "yes" : "no", dynamixel::Crc16::getKernel());
+
+  bool result = true;
+  result &= validate("table", dynamixel::Crc16::updateTable, data);
+  result &= validate("slicing8", dynamixel::Crc16::updateSlicing8, data);
+  result &= validate("clmul", dynamixel::Crc16::updateClmul, data);
+  result &= validate("update", dynamixel::Crc16::update, data);
+
+  static const int lengths[] = { 10, 14, 32, 64, 128, 256, 1024, 4096 };
+  int count = sizeof(lengths) / sizeof(lengths[0]);
+
+  printf("\nMB/s by data length\n%-10s", "bytes");
+  for (int i = 0; i < count; i++)
+    printf(" %8d", lengths[i]);
+  printf("\n");
+  measure("previous", previousCRC, data, lengths, count, bytes);
+  measure("table", dynamixel::Crc16::updateTable, data, lengths, count, bytes);
+  measure("slicing8", dynamixel::Crc16::updateSlicing8, data, lengths, count, bytes);
+  measure("clmul", dynamixel::Crc16::updateClmul, data, lengths, count, bytes);
+  measure("update", dynamixel::Crc16::update, data, lengths, count, bytes);
+
+  printf("%s\n", result ? "all kernels match" : "MISMATCH FOUND");
+  return result ? 0 : 1;
+}
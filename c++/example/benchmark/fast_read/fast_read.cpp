@@ -0,0 +1,234 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+//
+// *********     Fast Read Benchmark      *********
+//
+//
+// Compares GroupSyncRead and GroupBulkRead of N Dynamixels emulated on a pseudo-terminal
+// with and without the fast mode (Fast Sync Read / Fast Bulk Read), and checks that both read the same data,
+// including data which holds FF FF FD. Then a Dynamixel without the fast instructions is added to the list,
+// and the group is checked to fall back to Sync Read / Bulk Read.
+//
+// usage: fast_read [transactions] [devices] [return delay in usec]
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "dynamixel_sdk.h"                                  // Uses Dynamixel SDK library
+#include "emulated_bus.h"
+#include "emulated_bus_pty.h"
+
+#define BAUDRATE                        1000000
+#define MAX_DEVICES                     32
+
+// XM430-W350
+#define ADDR_PRO_PRESENT_CURRENT        126
+#define ADDR_PRO_PRESENT_POSITION       132
+
+static long long nowNs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Sync Read of the present position, or Bulk Read of the present position and current in turn
+struct Group
+{
+  dynamixel::GroupSyncRead *sync_read;
+  dynamixel::GroupBulkRead *bulk_read;
+
+  void    setFastMode(bool enable)  { if (sync_read) sync_read->setFastMode(enable); else bulk_read->setFastMode(enable); }
+  bool    isFastMode()              { return sync_read ? sync_read->isFastMode() : bulk_read->isFastMode(); }
+  int     txRxPacket()              { return sync_read ? sync_read->txRxPacket() : bulk_read->txRxPacket(); }
+  uint32_t getData(uint8_t id)
+  {
+    if (sync_read)
+      return sync_read->getData(id, ADDR_PRO_PRESENT_POSITION, 4);
+    if (id % 2 == 1)
+      return bulk_read->getData(id, ADDR_PRO_PRESENT_POSITION, 4);
+    return bulk_read->getData(id, ADDR_PRO_PRESENT_CURRENT, 2);
+  }
+};
+
+static void addParam(Group *group, uint8_t id)
+{
+  if (group->sync_read)
+    group->sync_read->addParam(id);
+  else if (id % 2 == 1)
+    group->bulk_read->addParam(id, ADDR_PRO_PRESENT_POSITION, 4);
+  else
+    group->bulk_read->addParam(id, ADDR_PRO_PRESENT_CURRENT, 2);
+}
+
+// runs the group in one mode, and keeps the data read
+static long long run(Group *group, bool fast, int transactions, int devices, uint32_t *data, int *failures)
+{
+  group->setFastMode(fast);
+  *failures = 0;
+
+  long long start = nowNs();
+  for (int i = 0; i < transactions; i++)
+  {
+    if (group->txRxPacket() != COMM_SUCCESS)
+      (*failures)++;
+  }
+  long long elapsed = nowNs() - start;
+
+  for (int d = 0; d < devices; d++)
+    data[d] = group->getData((uint8_t)(d + 1));
+  return elapsed;
+}
+
+static bool compare(const char *name, Group *group, int transactions, int devices)
+{
+  uint32_t  data[2][MAX_DEVICES + 1];
+  int       failures[2];
+  bool      ok = true;
+
+  long long elapsed_normal  = run(group, false, transactions, devices, data[0], &failures[0]);
+  long long elapsed_fast    = run(group, true, transactions, devices, data[1], &failures[1]);
+
+  printf("%-10s x%-3d normal %8.1f us/txn   fast %8.1f us/txn   speedup %5.2f   failures %d / %d\n",
+         name, devices, elapsed_normal / 1000.0 / transactions, elapsed_fast / 1000.0 / transactions,
+         (double)elapsed_normal / elapsed_fast, failures[0], failures[1]);
+
+  if (group->isFastMode() == false)
+  {
+    printf("  fast mode fell back\n");
+    ok = false;
+  }
+  for (int d = 0; d < devices; d++)
+  {
+    if (data[0][d] != data[1][d])
+    {
+      printf("  ID %d: data mismatch (normal 0x%08X / fast 0x%08X)\n", d + 1, data[0][d], data[1][d]);
+      ok = false;
+    }
+  }
+  return ok && failures[0] == 0 && failures[1] == 0;
+}
+
+// a Dynamixel without the fast instructions in the list makes the group fall back
+static bool checkFallback(const char *name, Group *group, int devices)
+{
+  uint32_t data[2][MAX_DEVICES + 1];
+  int      failures[2];
+
+  run(group, false, 1, devices, data[0], &failures[0]);
+  run(group, true, 1, devices, data[1], &failures[1]);
+  bool fell_back = (group->isFastMode() == false);
+
+  // the next transaction uses Sync Read / Bulk Read without trying the fast instruction
+  int  result    = group->txRxPacket();
+
+  bool ok = (failures[0] == 0 && failures[1] == 0 && fell_back && result == COMM_SUCCESS &&
+             memcmp(data[0], data[1], devices * sizeof(uint32_t)) == 0);
+  printf("%-10s fallback with a Dynamixel without the fast instruction: %s\n", name, ok ? "ok" : "FAILED");
+  return ok;
+}
+
+int main(int argc, char *argv[])
+{
+  int transactions    = (argc > 1) ? atoi(argv[1]) : 1000;
+  int devices         = (argc > 2) ? atoi(argv[2]) : 8;
+  int return_delay_us = (argc > 3) ? atoi(argv[3]) : 0;
+
+  if (devices < 1 || devices > MAX_DEVICES)
+  {
+    printf("devices: 1 ... %d\n", MAX_DEVICES);
+    return 1;
+  }
+
+  // XM430-W350 answer the fast instructions, and H54-200-S500-R (the last ID) does not
+  dynamixel::EmulatedBus bus(BAUDRATE);
+  for (int id = 1; id <= devices; id++)
+  {
+    bus.addDevice(2.0, (uint8_t)id, 1020);
+    uint8_t *table = bus.getControlTable(2.0, (uint8_t)id);
+    table[ADDR_PRO_PRESENT_POSITION + 0] = (uint8_t)id;
+    table[ADDR_PRO_PRESENT_POSITION + 1] = 0x08;
+    table[ADDR_PRO_PRESENT_CURRENT + 0]  = (uint8_t)(0x40 + id);
+    table[ADDR_PRO_PRESENT_CURRENT + 1]  = 0x00;
+  }
+  bus.addDevice(2.0, (uint8_t)(devices + 1), 54024);
+  bus.setReturnDelayTime(return_delay_us);
+
+  // FF FF FD in the data, which is stuffed only in the status packet of each Dynamixel
+  uint8_t *table = bus.getControlTable(2.0, 1);
+  table[ADDR_PRO_PRESENT_POSITION + 0] = 0xFF;
+  table[ADDR_PRO_PRESENT_POSITION + 1] = 0xFF;
+  table[ADDR_PRO_PRESENT_POSITION + 2] = 0xFD;
+  table[ADDR_PRO_PRESENT_POSITION + 3] = 0x00;
+
+  dynamixel::EmulatedBusPty pty(&bus);
+  if (pty.start() == false)
+  {
+    printf("Failed to start the emulated bus!\n");
+    return 1;
+  }
+  printf("Pseudo-terminal : %s / %d transactions / %d devices / return delay %d us\n",
+         pty.getPortName(), transactions, devices, return_delay_us);
+
+  dynamixel::PortHandler   *port           = dynamixel::PortHandler::getPortHandler(pty.getPortName());
+  dynamixel::PacketHandler *packet_handler = dynamixel::PacketHandler::getPacketHandler(2.0);
+  if (!port->openPort() || !port->setBaudRate(BAUDRATE))
+  {
+    printf("Failed to open %s\n", pty.getPortName());
+    return 1;
+  }
+
+  bool ok = true;
+  for (int g = 0; g < 2; g++)
+  {
+    dynamixel::GroupSyncRead sync_read(port, packet_handler, ADDR_PRO_PRESENT_POSITION, 4);
+    dynamixel::GroupBulkRead bulk_read(port, packet_handler);
+    Group       group = { (g == 0) ? &sync_read : 0, (g == 1) ? &bulk_read : 0 };
+    const char *name  = (g == 0) ? "sync read" : "bulk read";
+
+    for (int id = 1; id <= devices; id++)
+      addParam(&group, (uint8_t)id);
+    ok = compare(name, &group, transactions, devices) && ok;
+
+    addParam(&group, (uint8_t)(devices + 1));
+    ok = checkFallback(name, &group, devices + 1) && ok;
+  }
+
+  port->closePort();
+  delete port;
+  pty.stop();
+
+  printf("%s\n", ok ? "OK" : "FAILED");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,368 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+//
+// *********     Pipeline Benchmark      *********
+//
+//
+// Runs the control loop of N Dynamixels emulated on a pseudo-terminal (three reads and one write per Dynamixel),
+// first as sequential TxRx calls, then as one batch of PacketHandler::txRxPackets(),
+// and compares the time per cycle. The data read both ways and the goal position written are checked,
+// as is a batch with a request to a missing ID in the middle, and one whose status packet never comes
+// while status packets answering no request keep arriving.
+//
+// usage: pipeline [cycles] [devices] [return delay in usec]
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+#include "dynamixel_sdk.h"                                  // Uses Dynamixel SDK library
+#include "emulated_bus.h"
+#include "emulated_bus_pty.h"
+#include "crc16.h"
+
+#define BAUDRATE                        1000000
+#define MAX_DEVICES                     32
+#define MISSING_ID                      200
+#define STRAY_ID                        50
+#define STRAY_MSEC                      1000                // the stray status packets stop after this
+
+// XM430-W350
+#define ADDR_PRO_GOAL_POSITION          116
+#define ADDR_PRO_PRESENT_CURRENT        126
+#define ADDR_PRO_PRESENT_VELOCITY       128
+#define ADDR_PRO_PRESENT_POSITION       132
+
+// MX-28
+#define ADDR_MX_GOAL_POSITION           30
+#define ADDR_MX_PRESENT_POSITION        36
+#define ADDR_MX_PRESENT_SPEED           38
+#define ADDR_MX_PRESENT_LOAD            40
+
+struct Cycle
+{
+  float    protocol_version;
+  uint16_t addr_read[3];
+  uint16_t len_read[3];
+  uint16_t addr_goal;
+  uint16_t len_goal;
+};
+
+static const Cycle CYCLES[2] =
+{
+  { 1.0, { ADDR_MX_PRESENT_POSITION, ADDR_MX_PRESENT_SPEED, ADDR_MX_PRESENT_LOAD }, { 2, 2, 2 }, ADDR_MX_GOAL_POSITION, 2 },
+  { 2.0, { ADDR_PRO_PRESENT_CURRENT, ADDR_PRO_PRESENT_VELOCITY, ADDR_PRO_PRESENT_POSITION }, { 2, 4, 4 }, ADDR_PRO_GOAL_POSITION, 4 },
+};
+
+static long long nowNs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// the port returns status packets of a ping to STRAY_ID, which answer no request, for STRAY_MSEC
+class StrayPort : public dynamixel::PortHandler
+{
+ public:
+  uint8_t   packet[14];
+  int       packet_length;
+  int       index;
+  long long end_ns;
+
+  StrayPort(float protocol_version) : index(0), end_ns(nowNs() + STRAY_MSEC * 1000000LL)
+  {
+    if (protocol_version == 1.0)
+    {
+      uint8_t status[6] = { 0xFF, 0xFF, STRAY_ID, 0x02, 0x00, 0x00 };
+      status[5]     = (uint8_t)~(status[2] + status[3] + status[4]);
+      packet_length = 6;
+      memcpy(packet, status, packet_length);
+    }
+    else
+    {
+      uint8_t status[14] = { 0xFF, 0xFF, 0xFD, 0x00, STRAY_ID, 0x07, 0x00, 0x55, 0x00, 0x06, 0x04, 0x26, 0x00, 0x00 };
+      uint16_t crc  = dynamixel::Crc16::update(0, status, 12);
+      status[12]    = DXL_LOBYTE(crc);
+      status[13]    = DXL_HIBYTE(crc);
+      packet_length = 14;
+      memcpy(packet, status, packet_length);
+    }
+  }
+
+  bool    openPort() { return true; }
+  void    closePort() { }
+  void    clearPort() { }
+  void    setPortName(const char *) { }
+  char   *getPortName() { return (char *)"stray"; }
+  bool    setBaudRate(const int) { return true; }
+  int     getBaudRate() { return BAUDRATE; }
+  int     getBytesAvailable() { return (nowNs() < end_ns) ? packet_length : 0; }
+
+  int readPort(uint8_t *data, int length)
+  {
+    if (nowNs() >= end_ns)
+      return 0;
+    for (int i = 0; i < length; i++)
+    {
+      data[i] = packet[index];
+      index   = (index + 1) % packet_length;
+    }
+    return length;
+  }
+
+  int     writePort(uint8_t *, int length) { return length; }
+  int64_t getCurrentTimeNs() { return nowNs(); }
+  void    setPacketTimeout(uint16_t) { PortHandler::setPacketTimeout(5.0); }
+};
+
+static uint32_t getValue(const uint8_t *data, int length)
+{
+  uint32_t value = 0;
+  for (int i = length - 1; i >= 0; i--)
+    value = (value << 8) | data[i];
+  return value;
+}
+
+static void setValue(uint8_t *data, int length, uint32_t value)
+{
+  for (int i = 0; i < length; i++)
+    data[i] = (uint8_t)(value >> (8 * i));
+}
+
+// one cycle of sequential TxRx calls, which reads to data[device][read]
+static int runSequential(dynamixel::PortHandler *port, dynamixel::PacketHandler *packet_handler, const Cycle *cycle,
+                         int devices, uint8_t data[][3][4], uint8_t goal[][4])
+{
+  int failures = 0;
+  for (int d = 0; d < devices; d++)
+  {
+    uint8_t id = (uint8_t)(d + 1);
+    for (int r = 0; r < 3; r++)
+    {
+      if (packet_handler->readTxRx(port, id, cycle->addr_read[r], cycle->len_read[r], data[d][r]) != COMM_SUCCESS)
+        failures++;
+    }
+    if (packet_handler->writeTxRx(port, id, cycle->addr_goal, cycle->len_goal, goal[d]) != COMM_SUCCESS)
+      failures++;
+  }
+  return failures;
+}
+
+// the same cycle as one batch of requests
+static int runPipelined(dynamixel::PortHandler *port, dynamixel::PacketHandler *packet_handler, const Cycle *cycle,
+                        int devices, uint8_t data[][3][4], uint8_t goal[][4])
+{
+  dynamixel::PacketRequest requests[MAX_DEVICES * 4];
+  int                      count = 0;
+
+  memset(requests, 0, sizeof(requests));
+  for (int d = 0; d < devices; d++)
+  {
+    for (int r = 0; r < 4; r++, count++)
+    {
+      requests[count].id            = (uint8_t)(d + 1);
+      requests[count].instruction   = (r < 3) ? INST_READ : INST_WRITE;
+      requests[count].address       = (r < 3) ? cycle->addr_read[r] : cycle->addr_goal;
+      requests[count].length        = (r < 3) ? cycle->len_read[r] : cycle->len_goal;
+      requests[count].data          = (r < 3) ? data[d][r] : goal[d];
+    }
+  }
+
+  packet_handler->txRxPackets(port, requests, count);
+
+  int failures = 0;
+  for (int i = 0; i < count; i++)
+  {
+    if (requests[i].result != COMM_SUCCESS)
+      failures++;
+  }
+  return failures;
+}
+
+// a request to a missing ID gets no status packet, and the requests around it are not affected
+static bool checkMissingId(dynamixel::PortHandler *port, dynamixel::PacketHandler *packet_handler, const Cycle *cycle)
+{
+  dynamixel::PacketRequest requests[3];
+  uint8_t                  data[3][4];
+  uint8_t                  ids[3] = { 1, MISSING_ID, 2 };
+
+  memset(requests, 0, sizeof(requests));
+  for (int i = 0; i < 3; i++)
+  {
+    requests[i].id            = ids[i];
+    requests[i].instruction   = INST_READ;
+    requests[i].address       = cycle->addr_read[0];
+    requests[i].length        = cycle->len_read[0];
+    requests[i].data          = data[i];
+  }
+
+  int result = packet_handler->txRxPackets(port, requests, 3);
+  return result == COMM_RX_TIMEOUT && requests[0].result == COMM_SUCCESS &&
+         requests[1].result == COMM_RX_TIMEOUT && requests[2].result == COMM_SUCCESS;
+}
+
+// a request whose status packet never comes times out although status packets answering no request keep arriving
+static bool checkStrayStatus(const Cycle *cycle)
+{
+  StrayPort                 port(cycle->protocol_version);
+  dynamixel::PacketHandler *packet_handler = dynamixel::PacketHandler::getPacketHandler(cycle->protocol_version);
+  dynamixel::PacketRequest  request;
+  uint8_t                   data[4];
+
+  memset(&request, 0, sizeof(request));
+  request.id            = 1;
+  request.instruction   = INST_READ;
+  request.address       = cycle->addr_read[0];
+  request.length        = cycle->len_read[0];
+  request.data          = data;
+  request.timeout_msec  = 5.0;
+
+  long long start  = nowNs();
+  int       result = packet_handler->txRxPackets(&port, &request, 1);
+  long long msec   = (nowNs() - start) / 1000000;
+  return result == COMM_RX_TIMEOUT && msec < STRAY_MSEC / 2;
+}
+
+static bool run(dynamixel::EmulatedBus *bus, const char *port_name, const Cycle *cycle, int cycles, int devices)
+{
+  dynamixel::PortHandler   *port           = dynamixel::PortHandler::getPortHandler(port_name);
+  dynamixel::PacketHandler *packet_handler = dynamixel::PacketHandler::getPacketHandler(cycle->protocol_version);
+  uint8_t                   data_sequential[MAX_DEVICES][3][4];
+  uint8_t                   data_pipelined[MAX_DEVICES][3][4];
+  uint8_t                   goal[MAX_DEVICES][4];
+  bool                      ok = true;
+
+  if (!port->openPort() || !port->setBaudRate(BAUDRATE))
+  {
+    printf("Failed to open %s\n", port_name);
+    delete port;
+    return false;
+  }
+
+  memset(data_sequential, 0, sizeof(data_sequential));
+  memset(data_pipelined, 0xAA, sizeof(data_pipelined));
+  for (int d = 0; d < devices; d++)
+    setValue(goal[d], cycle->len_goal, 1000 + d);
+
+  int       failures_sequential = 0;
+  long long start               = nowNs();
+  for (int i = 0; i < cycles; i++)
+    failures_sequential += runSequential(port, packet_handler, cycle, devices, data_sequential, goal);
+  long long elapsed_sequential  = nowNs() - start;
+
+  int       failures_pipelined  = 0;
+  start                         = nowNs();
+  for (int i = 0; i < cycles; i++)
+    failures_pipelined += runPipelined(port, packet_handler, cycle, devices, data_pipelined, goal);
+  long long elapsed_pipelined   = nowNs() - start;
+
+  printf("P%.0f x%-3d sequential %8.1f us/cycle   pipelined %8.1f us/cycle   speedup %5.2f   failures %d / %d\n",
+         cycle->protocol_version, devices,
+         elapsed_sequential / 1000.0 / cycles, elapsed_pipelined / 1000.0 / cycles,
+         (double)elapsed_sequential / elapsed_pipelined, failures_sequential, failures_pipelined);
+
+  // the present values do not change, so both ways read the same data
+  for (int d = 0; d < devices; d++)
+  {
+    for (int r = 0; r < 3; r++)
+    {
+      if (memcmp(data_sequential[d][r], data_pipelined[d][r], cycle->len_read[r]) != 0)
+      {
+        printf("  ID %d: read %d mismatch (sequential %u / pipelined %u)\n", d + 1, r,
+               getValue(data_sequential[d][r], cycle->len_read[r]), getValue(data_pipelined[d][r], cycle->len_read[r]));
+        ok = false;
+      }
+    }
+    uint8_t *table = bus->getControlTable(cycle->protocol_version, (uint8_t)(d + 1));
+    if (table == 0 || memcmp(&table[cycle->addr_goal], goal[d], cycle->len_goal) != 0)
+    {
+      printf("  ID %d: goal position not written\n", d + 1);
+      ok = false;
+    }
+  }
+
+  if (checkMissingId(port, packet_handler, cycle) == false)
+  {
+    printf("  request to a missing ID: unexpected results\n");
+    ok = false;
+  }
+  if (checkStrayStatus(cycle) == false)
+  {
+    printf("  request among stray status packets: no timeout\n");
+    ok = false;
+  }
+
+  port->closePort();
+  delete port;
+  return ok;
+}
+
+int main(int argc, char *argv[])
+{
+  int cycles          = (argc > 1) ? atoi(argv[1]) : 500;
+  int devices         = (argc > 2) ? atoi(argv[2]) : 4;
+  int return_delay_us = (argc > 3) ? atoi(argv[3]) : 0;
+
+  if (devices < 1 || devices > MAX_DEVICES)
+  {
+    printf("devices: 1 ... %d\n", MAX_DEVICES);
+    return 1;
+  }
+
+  dynamixel::EmulatedBus bus(BAUDRATE);
+  for (int id = 1; id <= devices; id++)
+  {
+    bus.addDevice(1.0, (uint8_t)id, 29);      // MX-28
+    bus.addDevice(2.0, (uint8_t)id, 1020);    // XM430-W350
+  }
+  bus.setReturnDelayTime(return_delay_us);
+
+  dynamixel::EmulatedBusPty pty(&bus);
+  if (pty.start() == false)
+  {
+    printf("Failed to start the emulated bus!\n");
+    return 1;
+  }
+  printf("Pseudo-terminal : %s / %d cycles / %d devices / return delay %d us\n",
+         pty.getPortName(), cycles, devices, return_delay_us);
+
+  bool ok = true;
+  for (int c = 0; c < 2; c++)
+    ok = run(&bus, pty.getPortName(), &CYCLES[c], cycles, devices) && ok;
+
+  pty.stop();
+  printf("%s\n", ok ? "OK" : "FAILED");
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,193 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+//
+// *********     Reconnect Benchmark      *********
+//
+//
+// Runs a 500 Hz control loop (sync read of 4 Dynamixels) on EmulatedBusPty behind a symbolic link,
+// which stands for the device node of a USB serial converter.
+// The converter is "unplugged" by closing the pseudo-terminal and removing the link,
+// and "plugged in" again after a while by a new pseudo-terminal behind the same link.
+// The state callback of PortHandlerLinux holds the loop while the device is lost.
+// It reports the time to find the loss, the time to reconnect after the device is back and the cycles failed.
+//
+// usage: reconnect [unplugs] [unplugged time in msec]
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <time.h>
+
+#include "dynamixel_sdk.h"                                  // Uses Dynamixel SDK library
+#include "emulated_bus.h"
+#include "emulated_bus_pty.h"
+#include "port_handler_linux.h"
+
+#define NUM_DEVICES                     4
+#define BAUDRATE                        1000000
+#define PERIOD_US                       2000
+#define ADDR_PRO_PRESENT_POSITION       611
+
+struct LoopState
+{
+  bool      hold;               // the joints are held at the last position while the device is lost
+  long long disconnected_ns;
+  long long connected_ns;
+};
+
+static long long nowNs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void onPortState(dynamixel::PortHandlerLinux *port, int state, void *arg)
+{
+  LoopState *loop = (LoopState *)arg;
+
+  if (state == dynamixel::PortHandlerLinux::PORT_DISCONNECTED_)
+  {
+    loop->hold            = true;
+    loop->disconnected_ns = nowNs();
+  }
+  else if (state == dynamixel::PortHandlerLinux::PORT_CONNECTED_)
+  {
+    loop->hold          = false;
+    loop->connected_ns  = nowNs();
+  }
+}
+
+static bool plugIn(dynamixel::EmulatedBusPty *pty, const char *link_name)
+{
+  if (!pty->start())
+    return false;
+  unlink(link_name);
+  return (symlink(pty->getPortName(), link_name) == 0);
+}
+
+int main(int argc, char *argv[])
+{
+  int unplugs         = (argc > 1) ? atoi(argv[1]) : 5;
+  int unplugged_msec  = (argc > 2) ? atoi(argv[2]) : 200;
+  int cycles_per_run  = 250;
+  char link_name[64];
+
+  dynamixel::EmulatedBus bus(BAUDRATE);
+  for (int id = 1; id <= NUM_DEVICES; id++)
+    bus.addDevice(2.0, id);
+  bus.setReturnDelayTime(0);
+
+  snprintf(link_name, sizeof(link_name), "/tmp/ttyDXL_reconnect_%d", (int)getpid());
+  dynamixel::EmulatedBusPty pty(&bus);
+  if (!plugIn(&pty, link_name))
+  {
+    printf("Failed to create %s\n", link_name);
+    return 1;
+  }
+
+  LoopState loop = { false, 0, 0 };
+  dynamixel::PortHandlerLinux port(link_name);
+  dynamixel::PacketHandler   *packetHandler = dynamixel::PacketHandler::getPacketHandler(2.0);
+  port.setPortStateCallback(onPortState, &loop);
+  if (!port.openPort() || !port.setBaudRate(BAUDRATE))
+  {
+    printf("Failed to open %s\n", link_name);
+    return 1;
+  }
+
+  dynamixel::GroupSyncRead groupSyncRead(&port, packetHandler, ADDR_PRO_PRESENT_POSITION, 4);
+  for (int id = 1; id <= NUM_DEVICES; id++)
+    groupSyncRead.addParam(id);
+
+  printf("%s / %d unplugs of %d msec / %d us cycle (sync read x%d) / reconnect interval %d msec\n\n",
+         link_name, unplugs, unplugged_msec, PERIOD_US, NUM_DEVICES, dynamixel::PortHandlerLinux::DEFAULT_RECONNECT_INTERVAL_);
+
+  long long next = nowNs();
+  for (int u = 0; u < unplugs; u++)
+  {
+    int       failures  = 0;
+    int       held      = 0;
+    long long unplug_ns = 0;
+    long long plug_ns   = 0;
+
+    loop.disconnected_ns  = 0;
+    loop.connected_ns     = 0;
+
+    for (int i = 0; i < cycles_per_run * 2; i++)
+    {
+      next += PERIOD_US * 1000LL;
+      struct timespec ts = { (time_t)(next / 1000000000LL), (long)(next % 1000000000LL) };
+      clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+
+      if (i == cycles_per_run / 2)
+      {
+        pty.stop();
+        unlink(link_name);
+        unplug_ns = nowNs();
+      }
+      if (unplug_ns != 0 && plug_ns == 0 && nowNs() - unplug_ns >= unplugged_msec * 1000000LL)
+      {
+        if (!plugIn(&pty, link_name))
+        {
+          printf("Failed to create %s\n", link_name);
+          return 1;
+        }
+        plug_ns = nowNs();
+      }
+
+      if (loop.hold)
+        held++;
+      if (groupSyncRead.txRxPacket() != COMM_SUCCESS)
+        failures++;
+
+      // a cycle overrun is not caught up
+      if (nowNs() > next + PERIOD_US * 1000LL)
+        next = nowNs();
+    }
+
+    if (loop.disconnected_ns == 0 || loop.connected_ns == 0)
+    {
+      printf("unplug %d: the port was not reconnected (state %d)\n", u + 1, port.getPortState());
+      continue;
+    }
+    printf("unplug %d: loss found in %6.2f ms   reconnected %6.2f ms after plugged in   "
+           "recovery %7.2f ms   cycles failed %3d / held %3d\n",
+           u + 1, (loop.disconnected_ns - unplug_ns) / 1000000.0, (loop.connected_ns - plug_ns) / 1000000.0,
+           port.getRecoveryTime(), failures, held);
+  }
+
+  port.closePort();
+  pty.stop();
+  unlink(link_name);
+  return 0;
+}
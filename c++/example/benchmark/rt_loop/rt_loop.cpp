@@ -0,0 +1,182 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+//
+// *********     RT Loop Benchmark      *********
+//
+//
+// Runs a 500 Hz control loop (sync read of 8 Dynamixels on EmulatedBusPty) as a normal thread,
+// then with the real-time settings of RtSupport (SCHED_FIFO, CPU pinning, mlockall, stack prefault),
+// and the same settings applied to the I/O thread of BusExecutor.
+// It reports the results of the settings, the wake-up jitter of the loop, the cycle time and the page faults.
+// SCHED_FIFO and mlockall need root, or CAP_SYS_NICE and CAP_IPC_LOCK.
+//
+// usage: rt_loop [cycles] [SCHED_FIFO priority]
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <sys/resource.h>
+#include <algorithm>
+#include <vector>
+
+#include "dynamixel_sdk.h"                                  // Uses Dynamixel SDK library
+#include "bus_executor.h"
+#include "emulated_bus.h"
+#include "emulated_bus_pty.h"
+#include "rt_support.h"
+
+#define NUM_DEVICES                     8
+#define BAUDRATE                        1000000
+#define PERIOD_US                       2000
+#define ADDR_PRO_PRESENT_POSITION       611
+
+static long long nowNs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static long minorFaults()
+{
+  struct rusage ru;
+  getrusage(RUSAGE_THREAD, &ru);
+  return ru.ru_minflt;
+}
+
+static void report(const char *name, std::vector<long long> &samples)
+{
+  std::sort(samples.begin(), samples.end());
+  size_t n = samples.size();
+  printf("  %-14s p50 %8.1f us   p99 %8.1f us   max %8.1f us\n",
+         name, samples[n / 2] / 1000.0, samples[(n * 99) / 100] / 1000.0, samples[n - 1] / 1000.0);
+}
+
+static void run(const char *name, dynamixel::GroupSyncRead *groupSyncRead, dynamixel::BusExecutor *executor, int cycles)
+{
+  std::vector<long long> jitter, cycle;
+  int                    failures = 0;
+  long                   faults   = minorFaults();
+  long long              next     = nowNs();
+
+  for (int i = 0; i < cycles; i++)
+  {
+    next += PERIOD_US * 1000LL;
+    struct timespec ts = { (time_t)(next / 1000000000LL), (long)(next % 1000000000LL) };
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+
+    long long start = nowNs();
+    int       result;
+    if (executor == NULL)
+    {
+      result = groupSyncRead->txRxPacket();
+    }
+    else
+    {
+      dynamixel::BusCompletion completion;
+      executor->submitTxRx(0, groupSyncRead);
+      executor->waitCompletion(0, &completion);
+      result = completion.result;
+    }
+    if (result != COMM_SUCCESS)
+      failures++;
+
+    jitter.push_back(start - next);
+    cycle.push_back(nowNs() - start);
+
+    // a cycle overrun is not caught up
+    if (nowNs() > next + PERIOD_US * 1000LL)
+      next = nowNs();
+  }
+
+  printf("%s: %d cycles   failures %d   page faults of the loop %ld\n", name, cycles, failures, minorFaults() - faults);
+  report("wake-up jitter", jitter);
+  report("cycle", cycle);
+}
+
+int main(int argc, char *argv[])
+{
+  int cycles   = (argc > 1) ? atoi(argv[1]) : 2000;
+  int priority = (argc > 2) ? atoi(argv[2]) : 80;
+
+  dynamixel::EmulatedBus bus(BAUDRATE);
+  for (int id = 1; id <= NUM_DEVICES; id++)
+    bus.addDevice(2.0, id);
+  bus.setReturnDelayTime(0);
+
+  dynamixel::EmulatedBusPty pty(&bus);
+  if (!pty.start())
+    return 1;
+
+  dynamixel::PortHandler   *port          = dynamixel::PortHandler::getPortHandler(pty.getPortName());
+  dynamixel::PacketHandler *packetHandler = dynamixel::PacketHandler::getPacketHandler(2.0);
+  if (!port->openPort() || !port->setBaudRate(BAUDRATE))
+  {
+    printf("Failed to open %s\n", pty.getPortName());
+    return 1;
+  }
+
+  dynamixel::GroupSyncRead groupSyncRead(port, packetHandler, ADDR_PRO_PRESENT_POSITION, 4);
+  for (int id = 1; id <= NUM_DEVICES; id++)
+    groupSyncRead.addParam(id);
+
+  std::vector<int> isolated;
+  printf("%d cycles of %d us (sync read x%d)   isolated CPUs %d\n\n",
+         cycles, PERIOD_US, NUM_DEVICES, dynamixel::RtSupport::getIsolatedCpus(isolated));
+
+  run("normal thread", &groupSyncRead, NULL, cycles);
+
+  dynamixel::RtConfig config;
+  dynamixel::RtStatus status;
+  config.priority       = priority;
+  config.cpu            = isolated.empty() ? 0 : dynamixel::RtConfig::CPU_ISOLATED_;
+  config.lock_memory    = true;
+  config.stack_prefault = 256 * 1024;
+
+  printf("\n");
+  dynamixel::RtSupport::apply(config, &status);
+  dynamixel::RtSupport::printStatus("control loop", status);
+  run("real-time thread", &groupSyncRead, NULL, cycles);
+
+  // the I/O thread waits for the status packets at a higher priority than the loop
+  config.priority = (priority < 99) ? priority + 1 : priority;
+  dynamixel::BusExecutor *executor = new dynamixel::BusExecutor();
+  printf("\n");
+  executor->addPort(port, &config, &status);
+  dynamixel::RtSupport::printStatus("I/O thread", status);
+  run("real-time I/O thread", &groupSyncRead, executor, cycles);
+  delete executor;
+
+  port->closePort();
+  delete port;
+  return 0;
+}
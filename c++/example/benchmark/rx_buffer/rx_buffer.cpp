@@ -0,0 +1,196 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+//
+// *********     Rx Buffer Benchmark      *********
+//
+//
+// Runs Protocol 2.0 sync read and Protocol 1.0 bulk read of 8 Dynamixels emulated on a pseudo-terminal,
+// and counts the read() syscalls made by PortHandlerLinux against the calls of PortHandlerLinux::readPort().
+// Before the receive ring buffer, every readPort() call was one read() syscall.
+// Each read() takes all the bytes the port has, but the emulated Dynamixels answer one after another,
+// so a read() rarely gets more than one status packet: about 24 readPort() calls are served by about 15 read() calls
+// per transaction, about 7 of which find nothing yet (counted as empty) and are followed by a wait.
+// The port is not read while the instruction packet is being transmitted, which saves one empty read() per transaction.
+//
+// usage: rx_buffer [transactions]
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+
+#include "dynamixel_sdk.h"                                  // Uses Dynamixel SDK library
+#include "port_handler_linux.h"
+#include "emulated_bus.h"
+#include "emulated_bus_pty.h"
+
+#define NUM_DEVICES                     8
+#define BAUDRATE                        1000000
+#define ADDR_PRO_PRESENT_POSITION       611
+#define ADDR_MX_PRESENT_POSITION        36
+
+static pthread_t  main_thread;
+static long       read_syscalls = 0;
+static long       empty_reads   = 0;
+
+// read() and readv() of the library are counted here, only for the thread of the benchmark
+extern "C" ssize_t read(int fd, void *buf, size_t count)
+{
+  long result = syscall(SYS_read, fd, buf, count);
+  if (pthread_equal(pthread_self(), main_thread))
+  {
+    read_syscalls++;
+    if (result <= 0)
+      empty_reads++;
+  }
+  return result;
+}
+
+extern "C" ssize_t readv(int fd, const struct iovec *iov, int iovcnt)
+{
+  long result = syscall(SYS_readv, fd, iov, iovcnt);
+  if (pthread_equal(pthread_self(), main_thread))
+  {
+    read_syscalls++;
+    if (result <= 0)
+      empty_reads++;
+  }
+  return result;
+}
+
+class CountingPortHandler : public dynamixel::PortHandlerLinux
+{
+ public:
+  long read_port_calls;
+
+  CountingPortHandler(const char *port_name) : PortHandlerLinux(port_name), read_port_calls(0) { }
+  int readPort(uint8_t *packet, int length)
+  {
+    read_port_calls++;
+    return PortHandlerLinux::readPort(packet, length);
+  }
+};
+
+static long long nowNs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void report(const char *name, CountingPortHandler *port, long syscalls, long empty, long long elapsed, int transactions, int failures)
+{
+  printf("%-16s readPort %6.1f /txn   read() %6.1f /txn (empty %5.1f)   wall %7.1f us/txn   failures %d\n",
+         name, (double)port->read_port_calls / transactions, (double)syscalls / transactions,
+         (double)empty / transactions, elapsed / 1000.0 / transactions, failures);
+}
+
+int main(int argc, char *argv[])
+{
+  int transactions = (argc > 1) ? atoi(argv[1]) : 1000;
+
+  main_thread = pthread_self();
+
+  dynamixel::EmulatedBus bus(BAUDRATE);
+  for (int id = 1; id <= NUM_DEVICES; id++)
+  {
+    bus.addDevice(1.0, (uint8_t)id);
+    bus.addDevice(2.0, (uint8_t)id);
+  }
+  bus.setReturnDelayTime(0);
+
+  dynamixel::EmulatedBusPty pty(&bus);
+  if (pty.start() == false)
+  {
+    printf("Failed to start the emulated bus!\n");
+    return 1;
+  }
+  printf("Pseudo-terminal : %s / %d transactions / %d devices\n", pty.getPortName(), transactions, NUM_DEVICES);
+
+  // Protocol 2.0 sync read
+  {
+    CountingPortHandler port(pty.getPortName());
+    dynamixel::GroupSyncRead sync_read(&port, dynamixel::PacketHandler::getPacketHandler(2.0), ADDR_PRO_PRESENT_POSITION, 4);
+    for (int id = 1; id <= NUM_DEVICES; id++)
+      sync_read.addParam((uint8_t)id);
+
+    if (!port.openPort() || !port.setBaudRate(BAUDRATE))
+    {
+      printf("Failed to open %s\n", pty.getPortName());
+      return 1;
+    }
+
+    int       failures  = 0;
+    long      syscalls  = read_syscalls;
+    long      empty     = empty_reads;
+    long long start     = nowNs();
+    for (int i = 0; i < transactions; i++)
+    {
+      if (sync_read.txRxPacket() != COMM_SUCCESS)
+        failures++;
+    }
+    report("P2 sync read x8", &port, read_syscalls - syscalls, empty_reads - empty, nowNs() - start, transactions, failures);
+    port.closePort();
+  }
+
+  // Protocol 1.0 bulk read
+  {
+    CountingPortHandler port(pty.getPortName());
+    dynamixel::GroupBulkRead bulk_read(&port, dynamixel::PacketHandler::getPacketHandler(1.0));
+    for (int id = 1; id <= NUM_DEVICES; id++)
+      bulk_read.addParam((uint8_t)id, ADDR_MX_PRESENT_POSITION, 2);
+
+    if (!port.openPort() || !port.setBaudRate(BAUDRATE))
+    {
+      printf("Failed to open %s\n", pty.getPortName());
+      return 1;
+    }
+
+    int       failures  = 0;
+    long      syscalls  = read_syscalls;
+    long      empty     = empty_reads;
+    long long start     = nowNs();
+    for (int i = 0; i < transactions; i++)
+    {
+      if (bulk_read.txRxPacket() != COMM_SUCCESS)
+        failures++;
+    }
+    report("P1 bulk read x8", &port, read_syscalls - syscalls, empty_reads - empty, nowNs() - start, transactions, failures);
+    port.closePort();
+  }
+
+  pty.stop();
+  return 0;
+}
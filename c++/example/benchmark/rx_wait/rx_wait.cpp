@@ -0,0 +1,216 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+//
+// *********     Rx Wait Benchmark      *********
+//
+//
+// Compares the receiving loop sleeping in PortHandler::waitForBytes() with the
+// previous busy-spinning loop, using a Protocol 1.0 ping responder on a pseudo-terminal.
+// It reports CPU time per transaction and the wake-up latency
+// (time from the status packet being written to the ping call returning).
+//
+// usage: rx_wait [transactions] [response delay in usec]
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <time.h>
+#include <sys/resource.h>
+#include <algorithm>
+#include <vector>
+
+#include "dynamixel_sdk.h"                                  // Uses Dynamixel SDK library
+#include "port_handler_linux.h"
+
+#define DXL_ID                          1
+#define BAUDRATE                        1000000
+
+// Receiving loop of the previous SDK: readPort() is polled until the packet timeout
+class SpinningPortHandler : public dynamixel::PortHandlerLinux
+{
+ public:
+  SpinningPortHandler(const char *port_name) : PortHandlerLinux(port_name) { }
+  bool waitForBytes() { return true; }
+};
+
+struct Responder
+{
+  int           master_fd;
+  int           delay_us;
+  volatile bool stop;
+  volatile long long last_write_ns;
+};
+
+static long long nowNs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static long long threadCpuNs()
+{
+  struct rusage ru;
+  getrusage(RUSAGE_THREAD, &ru);
+  return ((long long)ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000000LL
+         + ((long long)ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) * 1000LL;
+}
+
+// Answers every Protocol 1.0 ping (FF FF ID 02 01 CHKSUM) after delay_us
+static void *respond(void *arg)
+{
+  Responder *r = (Responder *)arg;
+  uint8_t    buf[64];
+  int        len = 0;
+
+  while (!r->stop)
+  {
+    int n = read(r->master_fd, &buf[len], sizeof(buf) - len);
+    if (n <= 0)
+    {
+      usleep(100);
+      continue;
+    }
+    len += n;
+
+    while (len >= 6)
+    {
+      if (buf[0] != 0xFF || buf[1] != 0xFF)
+      {
+        memmove(buf, buf + 1, --len);
+        continue;
+      }
+
+      uint8_t id = buf[2];
+      memmove(buf, buf + 6, len - 6);
+      len -= 6;
+
+      if (r->delay_us > 0)
+      {
+        struct timespec ts = { r->delay_us / 1000000, (r->delay_us % 1000000) * 1000L };
+        nanosleep(&ts, NULL);
+      }
+
+      uint8_t status[6] = { 0xFF, 0xFF, id, 2, 0, 0 };
+      status[5] = ~(uint8_t)(id + 2);
+      r->last_write_ns = nowNs();
+      if (write(r->master_fd, status, sizeof(status)) != sizeof(status))
+        fprintf(stderr, "[Responder] write failed\n");
+    }
+  }
+  return NULL;
+}
+
+static void run(const char *name, dynamixel::PortHandler *port, Responder *responder, int transactions)
+{
+  dynamixel::PacketHandler *packetHandler = dynamixel::PacketHandler::getPacketHandler(1.0);
+  std::vector<long long>    latency;
+  int                       failures = 0;
+  uint8_t                   dxl_error = 0;
+
+  if (!port->openPort() || !port->setBaudRate(BAUDRATE))
+  {
+    printf("Failed to open %s\n", port->getPortName());
+    return;
+  }
+
+  // warm up
+  for (int i = 0; i < 10; i++)
+    packetHandler->ping(port, DXL_ID, &dxl_error);
+
+  long long cpu_start  = threadCpuNs();
+  long long wall_start = nowNs();
+  for (int i = 0; i < transactions; i++)
+  {
+    int dxl_comm_result = packetHandler->ping(port, DXL_ID, &dxl_error);
+    long long returned  = nowNs();
+    if (dxl_comm_result != COMM_SUCCESS)
+    {
+      failures++;
+      continue;
+    }
+    latency.push_back(returned - responder->last_write_ns);
+  }
+  long long cpu  = threadCpuNs() - cpu_start;
+  long long wall = nowNs() - wall_start;
+
+  port->closePort();
+
+  std::sort(latency.begin(), latency.end());
+  size_t n = latency.size();
+  printf("%-10s  cpu/txn %8.1f us   wall/txn %8.1f us   cpu load %5.1f %%   failures %d\n",
+         name, cpu / 1000.0 / transactions, wall / 1000.0 / transactions, 100.0 * cpu / wall, failures);
+  if (n > 0)
+  {
+    printf("%-10s  wake-up latency  p50 %7.1f us   p99 %7.1f us   max %7.1f us\n",
+           "", latency[n / 2] / 1000.0, latency[(n * 99) / 100] / 1000.0, latency[n - 1] / 1000.0);
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  int transactions = (argc > 1) ? atoi(argv[1]) : 2000;
+  int delay_us     = (argc > 2) ? atoi(argv[2]) : 500;
+
+  Responder responder;
+  responder.master_fd     = posix_openpt(O_RDWR | O_NOCTTY);
+  responder.delay_us      = delay_us;
+  responder.stop          = false;
+  responder.last_write_ns = 0;
+
+  if (responder.master_fd < 0 || grantpt(responder.master_fd) != 0 || unlockpt(responder.master_fd) != 0)
+  {
+    printf("Failed to open a pseudo-terminal!\n");
+    return 1;
+  }
+
+  const char *slave_name = ptsname(responder.master_fd);
+  printf("Pseudo-terminal : %s / %d transactions / response delay %d us\n", slave_name, transactions, delay_us);
+
+  pthread_t responder_thread;
+  pthread_create(&responder_thread, NULL, respond, &responder);
+
+  SpinningPortHandler        spin_port(slave_name);
+  dynamixel::PortHandlerLinux wait_port(slave_name);
+
+  run("spin", &spin_port, &responder, transactions);
+  run("wait", &wait_port, &responder, transactions);
+
+  responder.stop = true;
+  pthread_join(responder_thread, NULL);
+  close(responder.master_fd);
+
+  return 0;
+}
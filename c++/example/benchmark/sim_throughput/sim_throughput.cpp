@@ -0,0 +1,187 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+//
+// *********     Sim Throughput Benchmark      *********
+//
+//
+// Runs the packet handlers and the Group* classes against PortHandlerSim ("sim:" port),
+// which answers from emulated control tables on a virtual clock.
+// It reports the host time per transaction (cost of the SDK and the emulation, no syscall)
+// and the bus time per transaction on the virtual clock (baudrate and return delay model).
+//
+// usage: sim_throughput [transactions] [baudrate] [return delay in usec]
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "dynamixel_sdk.h"                                  // Uses Dynamixel SDK library
+#include "port_handler_sim.h"
+
+#define NUM_DEVICES                     8
+#define ADDR_PRO_GOAL_POSITION          596
+#define ADDR_PRO_PRESENT_POSITION       611
+#define ADDR_MX_PRESENT_POSITION        36
+
+static long long nowNs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+class Benchmark
+{
+ public:
+  const char  *name;
+  Benchmark(const char *n) : name(n) { }
+  virtual ~Benchmark() { }
+  virtual int run() = 0;
+};
+
+class Ping1 : public Benchmark
+{
+  dynamixel::PortHandler *port_; dynamixel::PacketHandler *ph_;
+ public:
+  Ping1(dynamixel::PortHandler *port) : Benchmark("P1 ping"), port_(port), ph_(dynamixel::PacketHandler::getPacketHandler(1.0)) { }
+  int run() { uint8_t error; return ph_->ping(port_, 1, &error); }
+};
+
+class Read2 : public Benchmark
+{
+  dynamixel::PortHandler *port_; dynamixel::PacketHandler *ph_;
+ public:
+  Read2(dynamixel::PortHandler *port) : Benchmark("P2 read 4 bytes"), port_(port), ph_(dynamixel::PacketHandler::getPacketHandler(2.0)) { }
+  int run() { uint8_t error; uint32_t data; return ph_->read4ByteTxRx(port_, 1, ADDR_PRO_PRESENT_POSITION, &data, &error); }
+};
+
+class SyncWrite2 : public Benchmark
+{
+  dynamixel::GroupSyncWrite sw_;
+ public:
+  SyncWrite2(dynamixel::PortHandler *port)
+    : Benchmark("P2 sync write x8"), sw_(port, dynamixel::PacketHandler::getPacketHandler(2.0), ADDR_PRO_GOAL_POSITION, 4)
+  {
+    uint8_t data[4] = { 0x00, 0x10, 0x00, 0x00 };
+    for (int id = 1; id <= NUM_DEVICES; id++)
+      sw_.addParam(id, data);
+  }
+  int run() { return sw_.txPacket(); }
+};
+
+class SyncRead2 : public Benchmark
+{
+  dynamixel::GroupSyncRead sr_;
+ public:
+  SyncRead2(dynamixel::PortHandler *port)
+    : Benchmark("P2 sync read x8"), sr_(port, dynamixel::PacketHandler::getPacketHandler(2.0), ADDR_PRO_PRESENT_POSITION, 4)
+  {
+    for (int id = 1; id <= NUM_DEVICES; id++)
+      sr_.addParam(id);
+  }
+  int run() { return sr_.txRxPacket(); }
+};
+
+class BulkRead2 : public Benchmark
+{
+  dynamixel::GroupBulkRead br_;
+ public:
+  BulkRead2(dynamixel::PortHandler *port)
+    : Benchmark("P2 bulk read x8"), br_(port, dynamixel::PacketHandler::getPacketHandler(2.0))
+  {
+    for (int id = 1; id <= NUM_DEVICES; id++)
+      br_.addParam(id, ADDR_PRO_PRESENT_POSITION, 4);
+  }
+  int run() { return br_.txRxPacket(); }
+};
+
+class BulkRead1 : public Benchmark
+{
+  dynamixel::GroupBulkRead br_;
+ public:
+  BulkRead1(dynamixel::PortHandler *port)
+    : Benchmark("P1 bulk read x8"), br_(port, dynamixel::PacketHandler::getPacketHandler(1.0))
+  {
+    for (int id = 1; id <= NUM_DEVICES; id++)
+      br_.addParam(id, ADDR_MX_PRESENT_POSITION, 2);
+  }
+  int run() { return br_.txRxPacket(); }
+};
+
+int main(int argc, char *argv[])
+{
+  int transactions  = (argc > 1) ? atoi(argv[1]) : 200000;
+  int baudrate      = (argc > 2) ? atoi(argv[2]) : 1000000;
+  int return_delay  = (argc > 3) ? atoi(argv[3]) : 0;
+
+  dynamixel::PortHandlerSim *port = (dynamixel::PortHandlerSim *)dynamixel::PortHandler::getPortHandler("sim:0");
+  for (int id = 3; id <= NUM_DEVICES; id++)
+  {
+    port->getBus()->addDevice(1.0, id);
+    port->getBus()->addDevice(2.0, id);
+  }
+  port->getBus()->setReturnDelayTime(return_delay);
+
+  if (!port->openPort() || !port->setBaudRate(baudrate))
+  {
+    printf("Failed to open the port!\n");
+    return 1;
+  }
+
+  printf("%d transactions / baudrate %d / return delay %d us\n", transactions, baudrate, return_delay);
+
+  Benchmark *benchmarks[] = { new Ping1(port), new Read2(port), new SyncWrite2(port),
+                              new SyncRead2(port), new BulkRead2(port), new BulkRead1(port) };
+
+  for (size_t b = 0; b < sizeof(benchmarks) / sizeof(benchmarks[0]); b++)
+  {
+    int       failures    = 0;
+    long long bus_start   = port->getCurrentTimeNs();
+    long long host_start  = nowNs();
+    for (int i = 0; i < transactions; i++)
+    {
+      if (benchmarks[b]->run() != COMM_SUCCESS)
+        failures++;
+    }
+    long long host  = nowNs() - host_start;
+    long long bus   = port->getCurrentTimeNs() - bus_start;
+
+    printf("%-18s  host %7.3f us/txn (%9.0f txn/s)   bus %8.1f us/txn   failures %d\n",
+           benchmarks[b]->name, host / 1000.0 / transactions, transactions * 1e9 / host,
+           bus / 1000.0 / transactions, failures);
+    delete benchmarks[b];
+  }
+
+  port->closePort();
+  delete port;
+  return 0;
+}
@@ -0,0 +1,619 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+//
+// *********     Status Packet Parser Benchmark      *********
+//
+//
+// Checks StatusPacketParser with streams of Protocol 1.0 and 2.0 status packets
+// (byte stuffing, wrong checksum or CRC, noise and false headers between them) fed in chunks of random length,
+// so a chunk often has several packets or a part of one, as the status packets of Sync Read and Bulk Read.
+// Every packet has to be found in order, with the data as it was before the byte stuffing.
+// A write has to get its status packet after a long stale one left on the bus by setTxFlush(false).
+// It then compares the receiving loops of the previous SDK, which moved the bytes left forward
+// to find the next header, with the parser: rxPacket() after noise with false headers,
+// and the status packets of a broadcast ping received at once.
+// It exits with 1 when a check fails.
+//
+// usage: status_parser [iterations]
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+
+#include "dynamixel_sdk.h"                                  // Uses Dynamixel SDK library
+#include "status_packet_parser.h"
+#include "crc16.h"
+
+#define BUFFER_LEN                      (64*1024)
+#define RXPACKET_MAX_LEN                (4*1024)
+#define STATUS_LENGTH                   14                  // status packet of ping
+
+// the port returns the bytes given to it
+class MemoryPort : public dynamixel::PortHandler
+{
+ public:
+  uint8_t rx[BUFFER_LEN];
+  int     rx_length;
+  int     rx_index;
+
+  MemoryPort() : rx_length(0), rx_index(0) { }
+
+  bool    openPort() { return true; }
+  void    closePort() { }
+  void    clearPort() { }
+  void    setPortName(const char *) { }
+  char   *getPortName() { return (char *)"memory"; }
+  bool    setBaudRate(const int) { return true; }
+  int     getBaudRate() { return 1000000; }
+  int     getBytesAvailable() { return rx_length - rx_index; }
+
+  int readPort(uint8_t *packet, int length)
+  {
+    int n = (length < rx_length - rx_index) ? length : rx_length - rx_index;
+    memcpy(packet, &rx[rx_index], n);
+    rx_index += n;
+    return n;
+  }
+
+  int writePort(uint8_t *, int length) { return length; }
+
+  int64_t getCurrentTimeNs()
+  {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+  }
+
+  void    setPacketTimeout(uint16_t) { }
+
+  // the bytes given have all arrived
+  bool    isPacketTimeout() { return rx_index == rx_length; }
+
+  void    setBytes(const uint8_t *data, int length)
+  {
+    memcpy(rx, data, length);
+    rx_length = length;
+    rx_index  = 0;
+  }
+};
+
+struct Packet
+{
+  std::vector<uint8_t> unstuffed;   // as rxPacket() returns it
+  std::vector<uint8_t> wire;        // as it is sent
+  int                  result;
+};
+
+static unsigned int seed = 1;
+static int random(int n)
+{
+  seed = seed * 1103515245 + 12345;
+  return (int)((seed >> 16) % n);
+}
+
+static long long nowNs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// status packet of Protocol 2.0 with data of length bytes, FF FF FD put in the data sometimes when stuffing
+static Packet makePacket2(uint8_t id, int length, bool corrupt, bool stuffing = true)
+{
+  Packet p;
+  uint8_t header[9] = { 0xFF, 0xFF, 0xFD, 0x00, id, DXL_LOBYTE(length + 4), DXL_HIBYTE(length + 4), 0x55, (uint8_t)random(0x80) };
+  p.unstuffed.assign(header, header + 9);
+  for (int i = 0; i < length; i++)
+    p.unstuffed.push_back((uint8_t)random(stuffing ? 256 : 0xFF));
+  for (int i = 9; stuffing && i + 3 <= (int)p.unstuffed.size() && random(4) == 0; i += 1 + random(8))
+  {
+    p.unstuffed[i] = 0xFF;
+    p.unstuffed[i+1] = 0xFF;
+    p.unstuffed[i+2] = 0xFD;
+  }
+
+  // FF FF FD -> FF FF FD FD after the header
+  p.wire.assign(p.unstuffed.begin(), p.unstuffed.begin() + 7);
+  for (size_t i = 7; i < p.unstuffed.size(); i++)
+  {
+    p.wire.push_back(p.unstuffed[i]);
+    if (p.unstuffed[i] == 0xFD && p.unstuffed[i-1] == 0xFF && p.unstuffed[i-2] == 0xFF)
+      p.wire.push_back(0xFD);
+  }
+  int wire_length = (int)p.wire.size() + 2 - 7;
+  p.wire[5] = DXL_LOBYTE(wire_length);
+  p.wire[6] = DXL_HIBYTE(wire_length);
+
+  uint16_t crc = dynamixel::Crc16::update(0, &p.wire[0], (int)p.wire.size());
+  if (corrupt)
+    crc ^= 0x0100;
+  p.wire.push_back(DXL_LOBYTE(crc));
+  p.wire.push_back(DXL_HIBYTE(crc));
+
+  p.unstuffed.push_back(DXL_LOBYTE(crc));
+  p.unstuffed.push_back(DXL_HIBYTE(crc));
+  p.result = corrupt ? COMM_RX_CORRUPT : COMM_SUCCESS;
+
+  // a packet which fails CRC is taken as it was received
+  if (corrupt)
+    p.unstuffed = p.wire;
+  return p;
+}
+
+static Packet makePacket1(uint8_t id, int length, bool corrupt)
+{
+  Packet p;
+  uint8_t header[5] = { 0xFF, 0xFF, id, (uint8_t)(length + 2), (uint8_t)random(0x64) };
+  p.wire.assign(header, header + 5);
+  for (int i = 0; i < length; i++)
+    p.wire.push_back((uint8_t)random(256));
+
+  uint8_t checksum = 0;
+  for (size_t i = 2; i < p.wire.size(); i++)
+    checksum += p.wire[i];
+  checksum = ~checksum;
+  if (corrupt)
+    checksum ^= 0x01;
+  p.wire.push_back(checksum);
+
+  p.unstuffed = p.wire;
+  p.result    = corrupt ? COMM_RX_CORRUPT : COMM_SUCCESS;
+  return p;
+}
+
+// bytes between the packets: no 0xFF but in a header which is found wrong
+static void addNoise(std::vector<uint8_t> &stream, int protocol)
+{
+  static const uint8_t false_headers2[][5] = {
+    { 0xFF, 0, 0, 0, 0 }, { 0xFF, 0xFF, 0, 0, 0 }, { 0xFF, 0xFF, 0xFD, 0x01, 0 }, { 0xFF, 0xFF, 0xFD, 0x00, 0xFD }
+  };
+  static const int false_lengths2[] = { 1, 2, 4, 5 };
+  static const uint8_t false_headers1[][3] = { { 0xFF, 0, 0 }, { 0xFF, 0xFF, 0xFE } };
+  static const int false_lengths1[] = { 1, 3 };
+
+  int n = random(4) == 0 ? 0 : random(24);
+  for (int i = 0; i < n; i++)
+  {
+    if (random(6) == 0)
+    {
+      int k = (protocol == 2) ? random(4) : random(2);
+      const uint8_t *bytes = (protocol == 2) ? false_headers2[k] : false_headers1[k];
+      int length = (protocol == 2) ? false_lengths2[k] : false_lengths1[k];
+      stream.insert(stream.end(), bytes, bytes + length);
+      stream.push_back(0x00);   // so the next bytes do not complete the header
+    }
+    else
+    {
+      stream.push_back((uint8_t)random(0xFF));
+    }
+  }
+}
+
+static bool checkStream(int protocol, int packets)
+{
+  std::vector<Packet>  expected;
+  std::vector<uint8_t> stream;
+
+  for (int i = 0; i < packets; i++)
+  {
+    addNoise(stream, protocol);
+    int length   = (random(8) == 0) ? random(protocol == 2 ? 1024 : 240) : random(16);
+    bool corrupt = random(10) == 0;
+    expected.push_back(protocol == 2 ? makePacket2((uint8_t)random(0xFD), length, corrupt)
+                                     : makePacket1((uint8_t)random(0xFE), length, corrupt));
+    stream.insert(stream.end(), expected.back().wire.begin(), expected.back().wire.end());
+  }
+
+  dynamixel::StatusPacketParser parser(protocol == 2 ? 8192 : 512);
+  parser.begin(protocol == 2 ? 2.0 : 1.0);
+
+  static uint8_t packet[BUFFER_LEN];
+  size_t fed = 0, found = 0;
+  bool   ok  = true;
+  while (ok && found < expected.size())
+  {
+    if (fed < stream.size())
+    {
+      int chunk = 1 + random(random(4) == 0 ? 2048 : 32);
+      if (chunk > (int)(stream.size() - fed))
+        chunk = (int)(stream.size() - fed);
+      fed += parser.feed(&stream[fed], chunk);
+    }
+    else if (parser.getFrameCount() == 0)
+    {
+      printf("Protocol %d.0: %d of %d packets found\n", protocol, (int)found, (int)expected.size());
+      return false;
+    }
+
+    // take some of the packets found, so several are kept sometimes
+    while (parser.getFrameCount() > 0 && (random(2) == 0 || fed == stream.size() || parser.getWritableLength() == 0))
+    {
+      int length = 0;
+      int result = parser.popFrame(packet, BUFFER_LEN, &length);
+      const Packet &p = expected[found++];
+      if (result != p.result || length != (int)p.unstuffed.size() || memcmp(packet, &p.unstuffed[0], length) != 0)
+      {
+        printf("Protocol %d.0: packet %d is different (result %d, length %d / %d)\n",
+               protocol, (int)found - 1, result, length, (int)p.unstuffed.size());
+        ok = false;
+        break;
+      }
+    }
+  }
+  return ok;
+}
+
+/////////////// the previous implementation ///////////////
+
+static void legacyRemoveStuffing(uint8_t *packet)
+{
+  int     packet_length_in = DXL_MAKEWORD(packet[5], packet[6]);
+  int     end              = 7 + packet_length_in - 2;  // except CRC
+  int     index            = 7;
+  uint8_t prev[2]          = { packet[5], packet[6] };
+
+  // the bytes are compared as received, as the bytes before index are overwritten
+  for (int i = 7; i < end; i++)
+  {
+    uint8_t data = packet[i];
+    packet[index++] = data;
+    if (data == 0xFD && prev[1] == 0xFF && prev[0] == 0xFF && i + 1 < end && packet[i+1] == 0xFD)
+      i++;  // FF FF FD FD
+    prev[0] = prev[1];
+    prev[1] = data;
+  }
+  if (index == end)
+    return;
+
+  packet[index++] = packet[end];
+  packet[index++] = packet[end+1];
+
+  int packet_length_out = index - 7;
+  packet[5] = DXL_LOBYTE(packet_length_out);
+  packet[6] = DXL_HIBYTE(packet_length_out);
+}
+
+static int legacyRxPacket(dynamixel::PortHandler *port, uint8_t *rxpacket)
+{
+  int     result         = COMM_TX_FAIL;
+
+  uint16_t rx_length     = 0;
+  uint16_t wait_length   = 11; // minimum length (HEADER0 HEADER1 HEADER2 RESERVED ID LENGTH_L LENGTH_H INST ERROR CRC16_L CRC16_H)
+
+  while(true)
+  {
+    int read_length = port->readPort(&rxpacket[rx_length], wait_length - rx_length);
+    port->addBusRx(read_length);
+    rx_length += read_length;
+    if (rx_length >= wait_length)
+    {
+      uint16_t idx = 0;
+
+      // find packet header
+      for (idx = 0; idx < (rx_length - 3); idx++)
+      {
+        if ((rxpacket[idx] == 0xFF) && (rxpacket[idx+1] == 0xFF) && (rxpacket[idx+2] == 0xFD) && (rxpacket[idx+3] != 0xFD))
+          break;
+      }
+
+      if (idx == 0)   // found at the beginning of the packet
+      {
+        if (rxpacket[3] != 0x00 ||
+           rxpacket[4] > 0xFC ||
+           DXL_MAKEWORD(rxpacket[5], rxpacket[6]) > RXPACKET_MAX_LEN ||
+           rxpacket[7] != 0x55)
+        {
+          // remove the first byte in the packet
+          for (uint16_t s = 0; s < rx_length - 1; s++)
+            rxpacket[s] = rxpacket[1 + s];
+          //memcpy(&rxpacket[0], &rxpacket[idx], rx_length - idx);
+          rx_length -= 1;
+          port->addBusResync(1);
+          continue;
+        }
+
+        // re-calculate the exact length of the rx packet
+        if (wait_length != DXL_MAKEWORD(rxpacket[5], rxpacket[6]) + 7)
+        {
+          wait_length = DXL_MAKEWORD(rxpacket[5], rxpacket[6]) + 7;
+          continue;
+        }
+
+        if (rx_length < wait_length)
+        {
+          // check timeout
+          if (port->isPacketTimeout() == true)
+          {
+            if (rx_length == 0)
+            {
+              result = COMM_RX_TIMEOUT;
+            }
+            else
+            {
+              result = COMM_RX_CORRUPT;
+            }
+            break;
+          }
+          else
+          {
+            // sleep until the rest of the packet arrives
+            port->waitForBytes();
+            continue;
+          }
+        }
+
+        // verify CRC16
+        uint16_t crc = DXL_MAKEWORD(rxpacket[wait_length-2], rxpacket[wait_length-1]);
+        if (dynamixel::Crc16::update(0, rxpacket, wait_length - 2) == crc)
+        {
+          result = COMM_SUCCESS;
+        }
+        else
+        {
+          result = COMM_RX_CORRUPT;
+          port->addBusChecksumError();
+        }
+        break;
+      }
+      else
+      {
+        // remove unnecessary packets
+        for (uint16_t s = 0; s < rx_length - idx; s++)
+          rxpacket[s] = rxpacket[idx + s];
+        //memcpy(&rxpacket[0], &rxpacket[idx], rx_length - idx);
+        rx_length -= idx;
+        port->addBusResync(idx);
+      }
+    }
+    else
+    {
+      // check timeout
+      if (port->isPacketTimeout() == true)
+      {
+        if (rx_length == 0)
+        {
+          result = COMM_RX_TIMEOUT;
+        }
+        else
+        {
+          result = COMM_RX_CORRUPT;
+        }
+        break;
+      }
+
+      // sleep until the rest of the packet arrives
+      port->waitForBytes();
+    }
+  }
+  port->endTransaction();
+  port->addBusStatus(rxpacket[4], result);
+
+  if (result == COMM_SUCCESS)
+    legacyRemoveStuffing(rxpacket);
+
+  return result;
+}
+
+// the status packets of a broadcast ping were all read, and then taken from the front of the buffer
+static int legacyPingDecode(uint8_t *rxpacket, uint16_t rx_length, std::vector<uint8_t> &id_list)
+{
+  int result = COMM_TX_FAIL;
+  id_list.clear();
+
+  while(1)
+  {
+    if (rx_length < STATUS_LENGTH)
+      return COMM_RX_CORRUPT;
+
+    uint16_t idx = 0;
+    for (idx = 0; idx < (rx_length - 2); idx++)
+    {
+      if (rxpacket[idx] == 0xFF && rxpacket[idx+1] == 0xFF && rxpacket[idx+2] == 0xFD)
+        break;
+    }
+
+    if (idx == 0)
+    {
+      uint16_t crc = DXL_MAKEWORD(rxpacket[STATUS_LENGTH-2], rxpacket[STATUS_LENGTH-1]);
+      if (dynamixel::Crc16::update(0, rxpacket, STATUS_LENGTH - 2) == crc)
+      {
+        result = COMM_SUCCESS;
+        id_list.push_back(rxpacket[4]);
+        for (uint16_t s = 0; s < rx_length - STATUS_LENGTH; s++)
+          rxpacket[s] = rxpacket[STATUS_LENGTH + s];
+        rx_length -= STATUS_LENGTH;
+        if (rx_length == 0)
+          return result;
+      }
+      else
+      {
+        result = COMM_RX_CORRUPT;
+        for (uint16_t s = 0; s < rx_length - 3; s++)
+          rxpacket[s] = rxpacket[3 + s];
+        rx_length -= 3;
+      }
+    }
+    else
+    {
+      for (uint16_t s = 0; s < rx_length - idx; s++)
+        rxpacket[s] = rxpacket[idx + s];
+      rx_length -= idx;
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////
+
+// rxPacket() with the bytes of noise before the status packet
+static bool benchmarkRxPacket(const char *name, const uint8_t *noise, int noise_length, int repeat, int iterations)
+{
+  dynamixel::PacketHandler *packetHandler = dynamixel::PacketHandler::getPacketHandler(2.0);
+  MemoryPort port;
+  std::vector<uint8_t> stream;
+  static uint8_t rxpacket[BUFFER_LEN];
+
+  for (int i = 0; i < repeat; i++)
+    stream.insert(stream.end(), noise, noise + noise_length);
+  Packet p = makePacket2(1, 4, false, false);
+  stream.insert(stream.end(), p.wire.begin(), p.wire.end());
+
+  bool ok = true;
+  port.setBytes(&stream[0], (int)stream.size());
+  if (legacyRxPacket(&port, rxpacket) != COMM_SUCCESS || memcmp(rxpacket, &p.unstuffed[0], p.unstuffed.size()) != 0)
+    ok = false;
+  port.setBytes(&stream[0], (int)stream.size());
+  if (packetHandler->rxPacket(&port, rxpacket) != COMM_SUCCESS || memcmp(rxpacket, &p.unstuffed[0], p.unstuffed.size()) != 0)
+    ok = false;
+
+  long long start = nowNs();
+  for (int i = 0; i < iterations; i++)
+  {
+    port.setBytes(&stream[0], (int)stream.size());
+    legacyRxPacket(&port, rxpacket);
+  }
+  double legacy = (double)(nowNs() - start) / iterations;
+
+  start = nowNs();
+  for (int i = 0; i < iterations; i++)
+  {
+    port.setBytes(&stream[0], (int)stream.size());
+    packetHandler->rxPacket(&port, rxpacket);
+  }
+  double parsed = (double)(nowNs() - start) / iterations;
+
+  printf("rxPacket() %-32s %5d B | %10.1f %10.1f ns %s\n",
+         name, noise_length * repeat, legacy, parsed, ok ? "" : "MISMATCH");
+  return ok;
+}
+
+// the status packets of a broadcast ping from every ID
+static bool benchmarkPing(int iterations)
+{
+  std::vector<uint8_t> stream;
+  for (int id = 0; id < MAX_ID; id++)
+  {
+    Packet p = makePacket2((uint8_t)id, 3, false, false);
+    stream.insert(stream.end(), p.wire.begin(), p.wire.end());
+  }
+
+  static uint8_t rxpacket[BUFFER_LEN];
+  std::vector<uint8_t> legacy_ids, ids;
+  dynamixel::StatusPacketParser parser;
+  bool ok = true;
+
+  long long start = nowNs();
+  for (int i = 0; i < iterations; i++)
+  {
+    memcpy(rxpacket, &stream[0], stream.size());
+    legacyPingDecode(rxpacket, (uint16_t)stream.size(), legacy_ids);
+  }
+  double legacy = (double)(nowNs() - start) / iterations;
+
+  start = nowNs();
+  for (int i = 0; i < iterations; i++)
+  {
+    ids.clear();
+    parser.begin(2.0);
+    for (size_t fed = 0; fed < stream.size(); )
+    {
+      fed += parser.feed(&stream[fed], (int)(stream.size() - fed));
+      while (parser.getFrameCount() > 0)
+        if (parser.popFrame(rxpacket, BUFFER_LEN) == COMM_SUCCESS)
+          ids.push_back(rxpacket[4]);
+    }
+  }
+  double parsed = (double)(nowNs() - start) / iterations;
+
+  if (ids.size() != MAX_ID || ids != legacy_ids)
+    ok = false;
+  printf("broadcast ping, %-36d | %10.1f %10.1f ns %s\n",
+         MAX_ID, legacy, parsed, ok ? "" : "MISMATCH");
+  return ok;
+}
+
+// a long status packet left on the bus when the port is not cleared before a write (PortHandler::setTxFlush(false))
+// is read before the status packet of the write, which has to be found without overflowing any buffer
+static bool checkStalePacket(int protocol)
+{
+  MemoryPort port;
+  dynamixel::PacketHandler *packetHandler = dynamixel::PacketHandler::getPacketHandler((float)protocol);
+  Packet stale  = (protocol == 2) ? makePacket2(1, 200, false, false) : makePacket1(1, 240, false);
+  Packet status = (protocol == 2) ? makePacket2(1, 0, false) : makePacket1(1, 0, false);
+
+  std::vector<uint8_t> stream(stale.wire);
+  stream.insert(stream.end(), status.wire.begin(), status.wire.end());
+  port.setTxFlush(false);
+  port.setBytes(&stream[0], (int)stream.size());
+
+  uint8_t error  = 0xFF;
+  int     result = packetHandler->write1ByteTxRx(&port, 1, 64, 1, &error);
+  uint8_t status_error = status.wire[(protocol == 2) ? 8 : 4];
+  bool    ok     = (result == COMM_SUCCESS && error == status_error && port.rx_index == port.rx_length);
+
+  printf("Protocol %d.0: write after a stale status packet of %d B %s\n",
+         protocol, (int)stale.wire.size(), ok ? "OK" : "FAILED");
+  return ok;
+}
+
+int main(int argc, char *argv[])
+{
+  int iterations = (argc > 1) ? atoi(argv[1]) : 2000;
+  bool result = true;
+
+  for (int i = 0; i < 20; i++)
+  {
+    result &= checkStream(1, 500);
+    result &= checkStream(2, 500);
+  }
+  printf("streams of status packets %s\n", result ? "match" : "MISMATCH FOUND");
+
+  result &= checkStalePacket(1);
+  result &= checkStalePacket(2);
+
+  // the echo of a read instruction packet, random bytes without 0xFF, and headers with a wrong ID
+  static const uint8_t echo[]         = { 0xFF, 0xFF, 0xFD, 0x00, 0x01, 0x07, 0x00, 0x02, 0x84, 0x00, 0x04, 0x00, 0x1D, 0x15 };
+  static const uint8_t random_bytes[] = { 0x12, 0x9A, 0x00, 0xFD, 0x3C, 0xE1, 0x55, 0x07 };
+  static const uint8_t false_header[] = { 0xFF, 0xFF, 0xFD, 0x00, 0xFD, 0x10 };
+
+  printf("%-51s | %10s %10s\n", "ns per call", "previous", "parser");
+  result &= benchmarkRxPacket("status packet only", echo, 0, 0, iterations);
+  result &= benchmarkRxPacket("after the instruction echo", echo, sizeof(echo), 1, iterations);
+  result &= benchmarkRxPacket("after random bytes", random_bytes, sizeof(random_bytes), 128, iterations);
+  result &= benchmarkRxPacket("after false headers", false_header, sizeof(false_header), 170, iterations);
+  result &= benchmarkPing(iterations);
+
+  printf("%s\n", result ? "all packets match" : "MISMATCH FOUND");
+  return result ? 0 : 1;
+}
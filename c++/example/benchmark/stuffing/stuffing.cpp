@@ -0,0 +1,379 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+//
+// *********     Byte Stuffing Benchmark      *********
+//
+//
+// Compares the Protocol 2.0 transmit path with byte stuffing against the previous one
+// (zero-filled 4 KB temporary, two copies, CRC table built on the stack on every call),
+// which is kept in this file. The packets are written to a port in memory, so only the packet handling is timed.
+// It also checks that every packet is written with the same bytes as before,
+// and that the stuffed status packets are read back with the data as it was.
+// It exits with 1 when a check fails.
+//
+// usage: stuffing [iterations]
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "dynamixel_sdk.h"                                  // Uses Dynamixel SDK library
+
+#define DXL_ID                          1
+#define ADDR_DATA                       0x0200
+#define TXPACKET_MAX_LEN                (4*1024)
+#define RXPACKET_MAX_LEN                (4*1024)
+#define BUFFER_LEN                      (8*1024)
+
+// the port keeps the last packet written, and returns the status packet given to it
+class MemoryPort : public dynamixel::PortHandler
+{
+ public:
+  uint8_t tx[BUFFER_LEN];
+  int     tx_length;
+  uint8_t rx[BUFFER_LEN];
+  int     rx_length;
+  int     rx_index;
+
+  MemoryPort() : tx_length(0), rx_length(0), rx_index(0) { }
+
+  bool    openPort() { return true; }
+  void    closePort() { }
+  void    clearPort() { tx_length = 0; }
+  void    setPortName(const char *) { }
+  char   *getPortName() { return (char *)"memory"; }
+  bool    setBaudRate(const int) { return true; }
+  int     getBaudRate() { return 1000000; }
+  int     getBytesAvailable() { return rx_length - rx_index; }
+
+  int readPort(uint8_t *packet, int length)
+  {
+    int n = (length < rx_length - rx_index) ? length : rx_length - rx_index;
+    memcpy(packet, &rx[rx_index], n);
+    rx_index += n;
+    return n;
+  }
+
+  int writePort(uint8_t *packet, int length)
+  {
+    memcpy(&tx[tx_length], packet, length);
+    tx_length += length;
+    return length;
+  }
+
+  int64_t getCurrentTimeNs()
+  {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+  }
+
+  void    setPacketTimeout(uint16_t) { PortHandler::setPacketTimeout(1000.0); }
+
+  void    setStatus(const uint8_t *packet, int length)
+  {
+    memcpy(rx, packet, length);
+    rx_length = length;
+    rx_index  = 0;
+  }
+};
+
+/////////////// the previous implementation ///////////////
+
+static unsigned short legacyUpdateCRC(uint16_t crc_accum, uint8_t *data_blk_ptr, uint16_t data_blk_size)
+{
+  uint16_t i;
+  uint16_t crc_table[256];  // initialized on every call, as the table of the previous implementation
+  for (int n = 0; n < 256; n++)
+  {
+    uint16_t c = (uint16_t)(n << 8);
+    for (int b = 0; b < 8; b++)
+      c = (c & 0x8000) ? (uint16_t)((c << 1) ^ 0x8005) : (uint16_t)(c << 1);
+    crc_table[n] = c;
+  }
+  __asm__ __volatile__("" : : "r"(crc_table) : "memory");
+
+  for (uint16_t j = 0; j < data_blk_size; j++)
+  {
+    i = ((uint16_t)(crc_accum >> 8) ^ *data_blk_ptr++) & 0xFF;
+    crc_accum = (crc_accum << 8) ^ crc_table[i];
+  }
+  return crc_accum;
+}
+
+// realloc() of the previous implementation is left out, as it frees the buffer of the caller
+static void legacyAddStuffing(uint8_t *packet)
+{
+  int i = 0, index = 0;
+  int packet_length_in = DXL_MAKEWORD(packet[5], packet[6]);
+  int packet_length_out = packet_length_in;
+  uint8_t temp[TXPACKET_MAX_LEN] = {0};
+
+  for (uint8_t s = 0; s <= 6; s++)
+    temp[s] = packet[s];
+  index = 7;
+  for (i = 0; i < packet_length_in - 2; i++)
+  {
+    temp[index++] = packet[i+7];
+    if (packet[i+7] == 0xFD && packet[i+7-1] == 0xFF && packet[i+7-2] == 0xFF)
+    {
+      temp[index++] = 0xFD;
+      packet_length_out++;
+    }
+  }
+  temp[index++] = packet[7+packet_length_in-2];
+  temp[index++] = packet[7+packet_length_in-1];
+
+  for (int s = 0; s < index; s++)
+    packet[s] = temp[s];
+  packet[5] = DXL_LOBYTE(packet_length_out);
+  packet[6] = DXL_HIBYTE(packet_length_out);
+}
+
+static int legacyTxPacket(dynamixel::PortHandler *port, uint8_t *txpacket)
+{
+  legacyAddStuffing(txpacket);
+
+  uint16_t total_packet_length = DXL_MAKEWORD(txpacket[5], txpacket[6]) + 7;
+  if (total_packet_length > TXPACKET_MAX_LEN)
+    return COMM_TX_ERROR;
+
+  txpacket[0] = 0xFF;
+  txpacket[1] = 0xFF;
+  txpacket[2] = 0xFD;
+  txpacket[3] = 0x00;
+
+  uint16_t crc = legacyUpdateCRC(0, txpacket, total_packet_length - 2);
+  txpacket[total_packet_length - 2] = DXL_LOBYTE(crc);
+  txpacket[total_packet_length - 1] = DXL_HIBYTE(crc);
+
+  port->clearPort();
+  if (port->writePort(txpacket, total_packet_length) != total_packet_length)
+    return COMM_TX_FAIL;
+  return COMM_SUCCESS;
+}
+
+// the previous readRx() took the status packet in a buffer from malloc()
+static int legacyReadRx(dynamixel::PacketHandler *packetHandler, dynamixel::PortHandler *port, uint16_t length, uint8_t *data)
+{
+  uint8_t *rxpacket = (uint8_t *)malloc(RXPACKET_MAX_LEN);
+  int      result   = packetHandler->rxPacket(port, rxpacket);
+  if (result == COMM_SUCCESS)
+    memcpy(data, &rxpacket[9], length);
+  free(rxpacket);
+  return result;
+}
+
+///////////////////////////////////////////////////////////
+
+struct Case
+{
+  const char *name;
+  int         length;
+  int         stuffing_interval;    // FF FF FD every this number of bytes (0: none)
+};
+
+static long long nowNs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void makeData(uint8_t *data, const Case &c)
+{
+  for (int i = 0; i < c.length; i++)
+    data[i] = (uint8_t)(i * 7 + 1);
+  for (int i = 0; c.stuffing_interval > 0 && i + 3 <= c.length; i += c.stuffing_interval)
+  {
+    data[i]   = 0xFF;
+    data[i+1] = 0xFF;
+    data[i+2] = 0xFD;
+  }
+}
+
+// instruction packet of INST_WRITE to ADDR_DATA, before stuffing
+static int makeWritePacket(uint8_t *packet, const uint8_t *data, int length)
+{
+  packet[4] = DXL_ID;
+  packet[5] = DXL_LOBYTE(length + 5);
+  packet[6] = DXL_HIBYTE(length + 5);
+  packet[7] = INST_WRITE;
+  packet[8] = DXL_LOBYTE(ADDR_DATA);
+  packet[9] = DXL_HIBYTE(ADDR_DATA);
+  memcpy(&packet[10], data, length);
+  return length + 12;
+}
+
+// status packet with the data, stuffed as a Dynamixel sends it
+static int makeStatusPacket(uint8_t *packet, const uint8_t *data, int length)
+{
+  memset(packet, 0, BUFFER_LEN);
+  packet[0] = 0xFF;
+  packet[1] = 0xFF;
+  packet[2] = 0xFD;
+  packet[3] = 0x00;
+  packet[4] = DXL_ID;
+  packet[5] = DXL_LOBYTE(length + 4);
+  packet[6] = DXL_HIBYTE(length + 4);
+  packet[7] = 0x55;
+  packet[8] = 0;
+  memcpy(&packet[9], data, length);
+  legacyAddStuffing(packet);
+
+  int total = DXL_MAKEWORD(packet[5], packet[6]) + 7;
+  uint16_t crc = legacyUpdateCRC(0, packet, total - 2);
+  packet[total - 2] = DXL_LOBYTE(crc);
+  packet[total - 1] = DXL_HIBYTE(crc);
+  return total;
+}
+
+static bool run(const Case &c, int iterations)
+{
+  dynamixel::PacketHandler *packetHandler = dynamixel::PacketHandler::getPacketHandler(2.0);
+  MemoryPort port;
+  uint8_t    data[BUFFER_LEN];
+  uint8_t    source[BUFFER_LEN];
+  uint8_t    packet[BUFFER_LEN];
+  uint8_t    expected[BUFFER_LEN];
+  uint8_t    status[BUFFER_LEN];
+  uint8_t    read_data[BUFFER_LEN];
+  bool       ok = true;
+
+  makeData(data, c);
+  int source_length   = makeWritePacket(source, data, c.length);
+  int status_length   = makeStatusPacket(status, data, c.length);
+
+  // the bytes written by the previous implementation
+  memcpy(packet, source, source_length);
+  legacyTxPacket(&port, packet);
+  int expected_length = port.tx_length;
+  memcpy(expected, port.tx, expected_length);
+
+  // the same bytes are written by txPacket() and writeTxOnly()
+  memcpy(packet, source, source_length);
+  if (packetHandler->txPacket(&port, packet) != COMM_SUCCESS ||
+      port.tx_length != expected_length || memcmp(port.tx, expected, expected_length) != 0)
+  {
+    printf("%-16s txPacket() wrote different bytes\n", c.name);
+    ok = false;
+  }
+  port.endTransaction();    // ended by rxPacket() after the status packet otherwise
+  if (packetHandler->writeTxOnly(&port, DXL_ID, ADDR_DATA, (uint16_t)c.length, data) != COMM_SUCCESS ||
+      port.tx_length != expected_length || memcmp(port.tx, expected, expected_length) != 0)
+  {
+    printf("%-16s writeTxOnly() wrote different bytes\n", c.name);
+    ok = false;
+  }
+
+  // the stuffed status packet is read back with the data
+  uint8_t dxl_error = 0;
+  port.setStatus(status, status_length);
+  memset(read_data, 0, sizeof(read_data));
+  if (packetHandler->readRx(&port, DXL_ID, (uint16_t)c.length, read_data, &dxl_error) != COMM_SUCCESS ||
+      memcmp(read_data, data, c.length) != 0)
+  {
+    printf("%-16s readRx() read different data\n", c.name);
+    ok = false;
+  }
+
+  long long start = nowNs();
+  for (int i = 0; i < iterations; i++)
+  {
+    memcpy(packet, source, source_length);
+    legacyTxPacket(&port, packet);
+  }
+  double legacy_tx = (double)(nowNs() - start) / iterations;
+
+  start = nowNs();
+  for (int i = 0; i < iterations; i++)
+  {
+    memcpy(packet, source, source_length);
+    packetHandler->txPacket(&port, packet);
+    port.endTransaction();
+  }
+  double tx = (double)(nowNs() - start) / iterations;
+
+  start = nowNs();
+  for (int i = 0; i < iterations; i++)
+    packetHandler->writeTxOnly(&port, DXL_ID, ADDR_DATA, (uint16_t)c.length, data);
+  double write_tx = (double)(nowNs() - start) / iterations;
+
+  start = nowNs();
+  for (int i = 0; i < iterations; i++)
+  {
+    port.setStatus(status, status_length);
+    legacyReadRx(packetHandler, &port, (uint16_t)c.length, read_data);
+  }
+  double legacy_rx = (double)(nowNs() - start) / iterations;
+
+  start = nowNs();
+  for (int i = 0; i < iterations; i++)
+  {
+    port.setStatus(status, status_length);
+    packetHandler->readRx(&port, DXL_ID, (uint16_t)c.length, read_data, &dxl_error);
+  }
+  double rx = (double)(nowNs() - start) / iterations;
+
+  printf("%-16s %5d %5d | %9.1f %9.1f %9.1f | %9.1f %9.1f\n",
+         c.name, c.length, expected_length - source_length,
+         legacy_tx, tx, write_tx, legacy_rx, rx);
+  return ok;
+}
+
+int main(int argc, char *argv[])
+{
+  int iterations = (argc > 1) ? atoi(argv[1]) : 20000;
+
+  static const Case cases[] = {
+    { "4 B",             4,    0  },
+    { "4 B stuffed",     4,    4  },
+    { "64 B",            64,   0  },
+    { "64 B stuffed",    64,   16 },
+    { "512 B",           512,  0  },
+    { "512 B stuffed",   512,  16 },
+    { "2048 B",          2048, 0  },
+    { "2048 B stuffed",  2048, 3  },
+  };
+
+  printf("ns per packet / %d iterations\n", iterations);
+  printf("%-16s %5s %5s | %9s %9s %9s | %9s %9s\n",
+         "data", "bytes", "stuff", "old tx", "txPacket", "writeTx", "old rx", "readRx");
+
+  bool result = true;
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    result &= run(cases[i], iterations);
+
+  printf("%s\n", result ? "all packets match" : "MISMATCH FOUND");
+  return result ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+//
+// *********     Trace Replay Benchmark      *********
+//
+//
+// Records a control loop (sync write + sync read of 8 Dynamixels) run against PortHandlerSim
+// through PortHandlerRecorder, then runs the same loop against PortHandlerReplay ("replay:" port).
+// It reports the cost of recording per transaction, the size of the trace,
+// and how fast the trace is replayed compared with the recorded bus time.
+//
+// usage: trace_replay [transactions] [trace path] [replay speed (0: as fast as possible)]
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+
+#include "dynamixel_sdk.h"                                  // Uses Dynamixel SDK library
+#include "port_handler_sim.h"
+#include "port_handler_recorder.h"
+#include "port_handler_replay.h"
+
+#define NUM_DEVICES                     8
+#define BAUDRATE                        1000000
+#define ADDR_PRO_GOAL_POSITION          596
+#define ADDR_PRO_PRESENT_POSITION       611
+
+static long long nowNs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Runs the control loop and returns the number of failed transactions
+static int run(dynamixel::PortHandler *port, int transactions)
+{
+  dynamixel::PacketHandler  *packetHandler = dynamixel::PacketHandler::getPacketHandler(2.0);
+  dynamixel::GroupSyncWrite  groupSyncWrite(port, packetHandler, ADDR_PRO_GOAL_POSITION, 4);
+  dynamixel::GroupSyncRead   groupSyncRead(port, packetHandler, ADDR_PRO_PRESENT_POSITION, 4);
+  int                        failures = 0;
+
+  for (int id = 1; id <= NUM_DEVICES; id++)
+    groupSyncRead.addParam(id);
+
+  for (int i = 0; i < transactions; i++)
+  {
+    uint8_t goal[4] = { (uint8_t)i, (uint8_t)(i >> 8), 0, 0 };
+    groupSyncWrite.clearParam();
+    for (int id = 1; id <= NUM_DEVICES; id++)
+      groupSyncWrite.addParam(id, goal);
+
+    if (groupSyncWrite.txPacket() != COMM_SUCCESS)
+      failures++;
+    if (groupSyncRead.txRxPacket() != COMM_SUCCESS)
+      failures++;
+  }
+  return failures;
+}
+
+static dynamixel::PortHandlerSim *openSim()
+{
+  dynamixel::PortHandlerSim *port = new dynamixel::PortHandlerSim("sim:0");
+  for (int id = 3; id <= NUM_DEVICES; id++)
+    port->getBus()->addDevice(2.0, id);
+  port->getBus()->setReturnDelayTime(0);
+  port->openPort();
+  port->setBaudRate(BAUDRATE);
+  return port;
+}
+
+int main(int argc, char *argv[])
+{
+  int         transactions  = (argc > 1) ? atoi(argv[1]) : 100000;
+  const char *trace_path    = (argc > 2) ? argv[2] : "/tmp/trace_replay.dxltrace";
+  double      speed         = (argc > 3) ? atof(argv[3]) : 0.0;
+  char        replay_name[256];
+
+  printf("%d transactions (sync write + sync read x%d) / trace %s\n", transactions, NUM_DEVICES, trace_path);
+
+  // plain sim
+  dynamixel::PortHandlerSim *sim = openSim();
+  long long host_start  = nowNs();
+  int       failures    = run(sim, transactions);
+  long long plain       = nowNs() - host_start;
+  delete sim;
+  printf("%-10s  host %7.3f us/txn   failures %d\n", "sim", plain / 1000.0 / transactions, failures);
+
+  // sim recorded
+  sim = openSim();
+  dynamixel::PortHandlerRecorder *recorder = new dynamixel::PortHandlerRecorder(sim, trace_path);
+  if (!recorder->isRecording())
+    return 1;
+  long long bus_start   = sim->getCurrentTimeNs();
+  host_start            = nowNs();
+  failures              = run(recorder, transactions);
+  long long recorded    = nowNs() - host_start;
+  long long bus         = sim->getCurrentTimeNs() - bus_start;
+  recorder->closeTrace();
+  delete recorder;
+  delete sim;
+
+  struct stat st;
+  stat(trace_path, &st);
+  printf("%-10s  host %7.3f us/txn   overhead %6.3f us/txn   trace %.1f MB (%.0f bytes/txn)   failures %d\n",
+         "record", recorded / 1000.0 / transactions, (recorded - plain) / 1000.0 / transactions,
+         st.st_size / 1048576.0, (double)st.st_size / transactions, failures);
+
+  // replay
+  snprintf(replay_name, sizeof(replay_name), "replay:%s", trace_path);
+  dynamixel::PortHandlerReplay *replay = (dynamixel::PortHandlerReplay *)dynamixel::PortHandler::getPortHandler(replay_name);
+  if (!replay->openPort())
+    return 1;
+  replay->setSpeed(speed);
+  host_start            = nowNs();
+  failures              = run(replay, transactions);
+  long long replayed    = nowNs() - host_start;
+
+  printf("%-10s  host %7.3f us/txn   recorded bus %.3f s in %.3f s (x%.1f)   writes %u   mismatches %u   end %s   failures %d\n",
+         "replay", replayed / 1000.0 / transactions, bus / 1e9, replayed / 1e9, (double)bus / replayed,
+         replay->getWriteCount(), replay->getMismatchCount(), replay->isEnd() ? "yes" : "no", failures);
+
+  replay->closePort();
+  delete replay;
+  return 0;
+}
@@ -0,0 +1,316 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+//
+// *********     Uring Scaling Benchmark      *********
+//
+//
+// Runs a control cycle (sync write + sync read of 4 Dynamixels) on a growing number of buses, each emulated on a
+// pseudo-terminal (EmulatedBusPty) served by a child process, so only the CPU time of the controller is measured.
+// The cycle is run
+//   classic  : from the control thread by read()/write(), writing to every bus before receiving from them
+//   executor : by BusExecutor, one thread per bus
+//   uring    : from the control thread by SerialUring, the writes of every bus submitted together
+// It reports the cycle time and the CPU time of the controller per cycle.
+//
+// usage: uring_scaling [cycles] [max buses]
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+
+#include "dynamixel_sdk.h"                                  // Uses Dynamixel SDK library
+#include "bus_executor.h"
+#include "emulated_bus.h"
+#include "emulated_bus_pty.h"
+#include "port_handler_linux.h"
+#include "serial_uring.h"
+
+#define MAX_BUSES                       32
+#define NUM_DEVICES                     4
+#define BAUDRATE                        1000000
+#define ADDR_PRO_GOAL_POSITION          596
+#define ADDR_PRO_PRESENT_POSITION       611
+#define PORT_NAME_LENGTH                100
+
+static long long nowNs()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (long long)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// CPU time of every thread of the controller
+static long long processCpuNs()
+{
+  struct rusage ru;
+  getrusage(RUSAGE_SELF, &ru);
+  return ((long long)ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000000LL
+         + ((long long)ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) * 1000LL;
+}
+
+// Child process: serves the buses until the pipe from the parent is closed
+static void serveBuses(int num_buses, int name_fd, int stop_fd)
+{
+  dynamixel::EmulatedBus    *bus[MAX_BUSES];
+  dynamixel::EmulatedBusPty *pty[MAX_BUSES];
+
+  for (int b = 0; b < num_buses; b++)
+  {
+    char name[PORT_NAME_LENGTH];
+    memset(name, 0, sizeof(name));
+
+    bus[b] = new dynamixel::EmulatedBus(BAUDRATE);
+    for (int id = 1; id <= NUM_DEVICES; id++)
+      bus[b]->addDevice(2.0, id);
+    bus[b]->setReturnDelayTime(0);
+
+    pty[b] = new dynamixel::EmulatedBusPty(bus[b]);
+    if (pty[b]->start())
+      strncpy(name, pty[b]->getPortName(), sizeof(name) - 1);
+    if (write(name_fd, name, sizeof(name)) != (ssize_t)sizeof(name))
+      break;
+  }
+  close(name_fd);
+
+  char c;
+  while (read(stop_fd, &c, 1) > 0)
+    ;
+
+  for (int b = 0; b < num_buses; b++)
+  {
+    delete pty[b];
+    delete bus[b];
+  }
+}
+
+struct Buses
+{
+  int                                 count;
+  dynamixel::PortHandlerLinux        *port[MAX_BUSES];
+  dynamixel::GroupSyncWrite          *groupSyncWrite[MAX_BUSES];
+  dynamixel::GroupSyncRead           *groupSyncRead[MAX_BUSES];
+};
+
+static void report(const char *name, int num_buses, int cycles, long long wall, long long cpu, int failures)
+{
+  printf("%3d buses  %-9s  cycle %8.1f us   cpu/cycle %8.1f us   cpu/bus %7.1f us   failures %d\n",
+         num_buses, name, wall / 1000.0 / cycles, cpu / 1000.0 / cycles, cpu / 1000.0 / cycles / num_buses, failures);
+}
+
+static void runClassic(Buses *buses, int cycles)
+{
+  int       failures  = 0;
+  long long cpu_start = processCpuNs();
+  long long start     = nowNs();
+  for (int i = 0; i < cycles; i++)
+  {
+    for (int b = 0; b < buses->count; b++)
+    {
+      if (buses->groupSyncWrite[b]->txPacket() != COMM_SUCCESS)
+        failures++;
+      if (buses->groupSyncRead[b]->txPacket() != COMM_SUCCESS)
+        failures++;
+    }
+    for (int b = 0; b < buses->count; b++)
+    {
+      if (buses->groupSyncRead[b]->rxPacket() != COMM_SUCCESS)
+        failures++;
+    }
+  }
+  report("classic", buses->count, cycles, nowNs() - start, processCpuNs() - cpu_start, failures);
+}
+
+static void runExecutor(Buses *buses, int cycles)
+{
+  dynamixel::BusExecutor *executor = new dynamixel::BusExecutor();
+  for (int b = 0; b < buses->count; b++)
+    executor->addPort(buses->port[b]);
+
+  int       failures  = 0;
+  long long cpu_start = processCpuNs();
+  long long start     = nowNs();
+  for (int i = 0; i < cycles; i++)
+  {
+    for (int b = 0; b < buses->count; b++)
+    {
+      executor->submitTx(b, buses->groupSyncWrite[b]);
+      executor->submitTxRx(b, buses->groupSyncRead[b]);
+    }
+    for (int b = 0; b < buses->count; b++)
+    {
+      dynamixel::BusCompletion completion;
+      while (executor->waitCompletion(b, &completion))
+      {
+        if (completion.result != COMM_SUCCESS)
+          failures++;
+      }
+    }
+  }
+  report("executor", buses->count, cycles, nowNs() - start, processCpuNs() - cpu_start, failures);
+
+  delete executor;
+}
+
+static void runUring(Buses *buses, int cycles)
+{
+  dynamixel::SerialUring *uring = new dynamixel::SerialUring();
+  for (int b = 0; b < buses->count; b++)
+  {
+    if (!buses->port[b]->setUring(uring))
+    {
+      printf("%3d buses  %-9s  io_uring is not available\n", buses->count, "uring");
+      delete uring;
+      return;
+    }
+  }
+
+  int       failures  = 0;
+  long long cpu_start = processCpuNs();
+  long long start     = nowNs();
+  for (int i = 0; i < cycles; i++)
+  {
+    uring->beginBatch();
+    for (int b = 0; b < buses->count; b++)
+    {
+      if (buses->groupSyncWrite[b]->txPacket() != COMM_SUCCESS)
+        failures++;
+      if (buses->groupSyncRead[b]->txPacket() != COMM_SUCCESS)
+        failures++;
+    }
+    uring->endBatch();
+    for (int b = 0; b < buses->count; b++)
+    {
+      if (buses->groupSyncRead[b]->rxPacket() != COMM_SUCCESS)
+        failures++;
+    }
+  }
+  report("uring", buses->count, cycles, nowNs() - start, processCpuNs() - cpu_start, failures);
+
+  for (int b = 0; b < buses->count; b++)
+    buses->port[b]->setUring(NULL);
+  delete uring;
+}
+
+static bool runBuses(int num_buses, int cycles)
+{
+  int name_pipe[2], stop_pipe[2];
+  if (pipe(name_pipe) != 0 || pipe(stop_pipe) != 0)
+    return false;
+
+  pid_t child = fork();
+  if (child == 0)
+  {
+    close(name_pipe[0]);
+    close(stop_pipe[1]);
+    serveBuses(num_buses, name_pipe[1], stop_pipe[0]);
+    _exit(0);
+  }
+  close(name_pipe[1]);
+  close(stop_pipe[0]);
+
+  dynamixel::PacketHandler *packetHandler = dynamixel::PacketHandler::getPacketHandler(2.0);
+  Buses buses;
+  bool  opened = true;
+  buses.count = 0;
+  for (int b = 0; b < num_buses; b++)
+  {
+    char name[PORT_NAME_LENGTH];
+    if (read(name_pipe[0], name, sizeof(name)) != (ssize_t)sizeof(name) || name[0] == 0)
+    {
+      printf("Failed to start the emulated bus %d\n", b);
+      opened = false;
+      break;
+    }
+
+    buses.port[b] = new dynamixel::PortHandlerLinux(name);
+    buses.count++;
+    if (!buses.port[b]->openPort() || !buses.port[b]->setBaudRate(BAUDRATE))
+    {
+      printf("Failed to open %s\n", name);
+      opened = false;
+      break;
+    }
+
+    uint8_t goal[4] = { 0x00, 0x08, 0x00, 0x00 };
+    buses.groupSyncWrite[b] = new dynamixel::GroupSyncWrite(buses.port[b], packetHandler, ADDR_PRO_GOAL_POSITION, 4);
+    buses.groupSyncRead[b]  = new dynamixel::GroupSyncRead(buses.port[b], packetHandler, ADDR_PRO_PRESENT_POSITION, 4);
+    for (int id = 1; id <= NUM_DEVICES; id++)
+    {
+      buses.groupSyncWrite[b]->addParam(id, goal);
+      buses.groupSyncRead[b]->addParam(id);
+    }
+  }
+  close(name_pipe[0]);
+
+  if (opened)
+  {
+    runClassic(&buses, cycles);
+    runExecutor(&buses, cycles);
+    runUring(&buses, cycles);
+    printf("\n");
+  }
+
+  for (int b = 0; b < buses.count; b++)
+  {
+    if (opened || b < buses.count - 1)
+    {
+      delete buses.groupSyncRead[b];
+      delete buses.groupSyncWrite[b];
+    }
+    buses.port[b]->closePort();
+    delete buses.port[b];
+  }
+
+  close(stop_pipe[1]);
+  waitpid(child, NULL, 0);
+  return opened;
+}
+
+int main(int argc, char *argv[])
+{
+  int cycles    = (argc > 1) ? atoi(argv[1]) : 500;
+  int max_buses = (argc > 2) ? atoi(argv[2]) : 16;
+  if (max_buses < 1 || max_buses > MAX_BUSES)
+    max_buses = 16;
+
+  printf("%d cycles (sync write + sync read x%d) per run\n\n", cycles, NUM_DEVICES);
+  for (int num_buses = 1; num_buses <= max_buses; num_buses *= 2)
+  {
+    if (!runBuses(num_buses, cycles))
+      return 1;
+  }
+  return 0;
+}
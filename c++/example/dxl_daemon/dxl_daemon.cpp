@@ -0,0 +1,185 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+//
+// *********     DXL Daemon Example      *********
+//
+//
+// Owns a serial port and serves it to other processes over a Unix-domain socket (BusDaemon),
+// so a control loop, a monitor and a logger can use the same Dynamixel bus at the same time.
+// The other processes open the port name "unix:<socket path>" (ex. "unix:/tmp/dxl.sock") as DEVICENAME,
+// and PortHandlerClient::setPriority() puts the transactions of the control loop first.
+// Stop it with Ctrl+C.
+//
+
+#include <getopt.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "dynamixel_sdk.h"                                  // Uses Dynamixel SDK library
+#include "bus_daemon.h"
+#include "port_handler_linux.h"
+
+// Default setting
+#define BAUDRATE                        1000000
+#define DEVICENAME                      "/dev/ttyUSB0"      // Check which port is being used on your controller
+#define SOCKET_PATH                     "/tmp/dxl.sock"
+
+void usage(char *progname)
+{
+  printf("-----------------------------------------------------------------------\n");
+  printf("Usage: %s\n", progname);
+  printf(" [-h | --help]........: display this help\n");
+  printf(" [-d | --device]......: port name of the bus (default: %s)\n", DEVICENAME);
+  printf(" [-b | --baudrate]....: baudrate of the bus (default: %d)\n", BAUDRATE);
+  printf(" [-s | --socket]......: path of the socket served (default: %s)\n", SOCKET_PATH);
+  printf(" [-l | --limit].......: time a client can hold the bus in msec (default: %d)\n",
+         dynamixel::BusDaemon::DEFAULT_HOLD_LIMIT_);
+  printf("-----------------------------------------------------------------------\n");
+}
+
+int main(int argc, char *argv[])
+{
+  const char *device_name = DEVICENAME;
+  const char *socket_path = SOCKET_PATH;
+  int         baudrate    = BAUDRATE;
+  int         hold_limit  = dynamixel::BusDaemon::DEFAULT_HOLD_LIMIT_;
+
+  // parameter parsing
+  while(1)
+  {
+    int option_index = 0, c = 0;
+    static struct option long_options[] = {
+        {"h", no_argument, 0, 0},
+        {"help", no_argument, 0, 0},
+        {"d", required_argument, 0, 0},
+        {"device", required_argument, 0, 0},
+        {"b", required_argument, 0, 0},
+        {"baudrate", required_argument, 0, 0},
+        {"s", required_argument, 0, 0},
+        {"socket", required_argument, 0, 0},
+        {"l", required_argument, 0, 0},
+        {"limit", required_argument, 0, 0},
+        {0, 0, 0, 0}
+    };
+
+    // parsing all parameters according to the list above is sufficent
+    c = getopt_long_only(argc, argv, "", long_options, &option_index);
+
+    // no more options to parse
+    if (c == -1) break;
+
+    // unrecognized option
+    if (c == '?') {
+      usage(argv[0]);
+      return 0;
+    }
+
+    // dispatch the given options
+    switch(option_index) {
+    // h, help
+    case 0:
+    case 1:
+      usage(argv[0]);
+      return 0;
+
+    // d, device
+    case 2:
+    case 3:
+      device_name = optarg;
+      break;
+
+    // b, baudrate
+    case 4:
+    case 5:
+      baudrate = atoi(optarg);
+      break;
+
+    // s, socket
+    case 6:
+    case 7:
+      socket_path = optarg;
+      break;
+
+    // l, limit
+    case 8:
+    case 9:
+      hold_limit = atoi(optarg);
+      break;
+
+    default:
+      usage(argv[0]);
+      return 0;
+    }
+  }
+
+  if (baudrate <= 0 || hold_limit <= 0)
+  {
+    usage(argv[0]);
+    return 0;
+  }
+
+  // the signals are taken by sigwait() below, not by the thread of the daemon
+  sigset_t sigset;
+  sigemptyset(&sigset);
+  sigaddset(&sigset, SIGINT);
+  sigaddset(&sigset, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &sigset, NULL);
+
+  dynamixel::PortHandlerLinux port(device_name);
+  if (!port.openPort() || !port.setBaudRate(baudrate))
+  {
+    printf("Failed to open %s!\n", device_name);
+    return 0;
+  }
+
+  dynamixel::BusDaemon daemon(&port);
+  daemon.setHoldLimit(hold_limit);
+  if (!daemon.start(socket_path))
+  {
+    printf("Failed to start the daemon!\n");
+    return 0;
+  }
+
+  printf("%s is served on unix:%s\n", device_name, socket_path);
+  printf(" - Baudrate          : %d\n", baudrate);
+  printf(" - Hold limit        : %d msec\n", hold_limit);
+  printf("Press Ctrl+C to quit!\n");
+
+  int sig;
+  sigwait(&sigset, &sig);
+
+  daemon.stop();
+  port.closePort();
+  printf("\n%u transactions served (%u ended by the hold limit)\n", daemon.getTransactionCount(), daemon.getExpiredCount());
+
+  return 0;
+}
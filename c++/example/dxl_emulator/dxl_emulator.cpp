@@ -0,0 +1,225 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+//
+// *********     DXL Emulator Example      *********
+//
+//
+// Emulates Dynamixels of Protocol 1.0 (MX-28) and Protocol 2.0 (H54-200-S500-R or XM430-W350)
+// on a pseudo-terminal, so the other examples can run without any hardware.
+// Run this example, and use the device path printed (ex. "/dev/pts/3") as DEVICENAME of the other examples.
+// Stop it with Ctrl+C.
+//
+
+#include <getopt.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "dynamixel_sdk.h"                                  // Uses Dynamixel SDK library
+#include "emulated_bus.h"
+#include "emulated_bus_pty.h"
+
+// Default setting
+#define BAUDRATE                        1000000
+#define RETURN_DELAY_TIME               0                   // usec
+#define DXL1_IDS                        "1,2"               // IDs of the Protocol 1.0 devices
+#define DXL2_IDS                        "1,2"               // IDs of the Protocol 2.0 devices
+
+void usage(char *progname)
+{
+  printf("-----------------------------------------------------------------------\n");
+  printf("Usage: %s\n", progname);
+  printf(" [-h | --help]........: display this help\n");
+  printf(" [-b | --baudrate]....: baudrate of the bus (default: %d)\n", BAUDRATE);
+  printf(" [-r | --delay].......: return delay time in usec (default: %d)\n", RETURN_DELAY_TIME);
+  printf(" [-p1 | --protocol1]..: IDs of Protocol 1.0 devices (ex. 1,2,5-8 / default: %s)\n", DXL1_IDS);
+  printf(" [-p2 | --protocol2]..: IDs of Protocol 2.0 devices (ex. 1,2,5-8 / default: %s)\n", DXL2_IDS);
+  printf(" [-m | --model].......: model number of Protocol 2.0 devices (54024 or 1020 / default: 54024)\n");
+  printf("-----------------------------------------------------------------------\n");
+}
+
+// Adds the devices of the ID list (ex. "1,2,5-8")
+bool addDevices(dynamixel::EmulatedBus *bus, float protocol_version, const char *ids, uint16_t model_number)
+{
+  char *list = strdup(ids);
+  bool result = true;
+
+  for (char *tok = strtok(list, ","); tok != NULL; tok = strtok(NULL, ","))
+  {
+    int first = 0, last = 0;
+    int n = sscanf(tok, "%d-%d", &first, &last);
+    if (n < 1)
+    {
+      result = false;
+      break;
+    }
+    if (n == 1)
+      last = first;
+
+    for (int id = first; id <= last; id++)
+    {
+      if (bus->addDevice(protocol_version, (uint8_t)id, model_number) == false)
+      {
+        printf("Failed to add [ID:%03d] of Protocol %.1f\n", id, protocol_version);
+        result = false;
+      }
+    }
+  }
+
+  free(list);
+  return result;
+}
+
+int main(int argc, char *argv[])
+{
+  int         baudrate      = BAUDRATE;
+  int         return_delay  = RETURN_DELAY_TIME;
+  const char *dxl1_ids      = DXL1_IDS;
+  const char *dxl2_ids      = DXL2_IDS;
+  int         model_number  = 0;
+
+  // parameter parsing
+  while(1)
+  {
+    int option_index = 0, c = 0;
+    static struct option long_options[] = {
+        {"h", no_argument, 0, 0},
+        {"help", no_argument, 0, 0},
+        {"b", required_argument, 0, 0},
+        {"baudrate", required_argument, 0, 0},
+        {"r", required_argument, 0, 0},
+        {"delay", required_argument, 0, 0},
+        {"p1", required_argument, 0, 0},
+        {"protocol1", required_argument, 0, 0},
+        {"p2", required_argument, 0, 0},
+        {"protocol2", required_argument, 0, 0},
+        {"m", required_argument, 0, 0},
+        {"model", required_argument, 0, 0},
+        {0, 0, 0, 0}
+    };
+
+    // parsing all parameters according to the list above is sufficent
+    c = getopt_long_only(argc, argv, "", long_options, &option_index);
+
+    // no more options to parse
+    if (c == -1) break;
+
+    // unrecognized option
+    if (c == '?') {
+      usage(argv[0]);
+      return 0;
+    }
+
+    // dispatch the given options
+    switch(option_index) {
+    // h, help
+    case 0:
+    case 1:
+      usage(argv[0]);
+      return 0;
+
+    // b, baudrate
+    case 2:
+    case 3:
+      baudrate = atoi(optarg);
+      break;
+
+    // r, delay
+    case 4:
+    case 5:
+      return_delay = atoi(optarg);
+      break;
+
+    // p1, protocol1
+    case 6:
+    case 7:
+      dxl1_ids = optarg;
+      break;
+
+    // p2, protocol2
+    case 8:
+    case 9:
+      dxl2_ids = optarg;
+      break;
+
+    // m, model
+    case 10:
+    case 11:
+      model_number = atoi(optarg);
+      break;
+
+    default:
+      usage(argv[0]);
+      return 0;
+    }
+  }
+
+  if (baudrate <= 0)
+  {
+    usage(argv[0]);
+    return 0;
+  }
+
+  dynamixel::EmulatedBus bus(baudrate);
+  if (!addDevices(&bus, 1.0, dxl1_ids, 0) || !addDevices(&bus, 2.0, dxl2_ids, (uint16_t)model_number))
+    return 0;
+  bus.setReturnDelayTime(return_delay);
+
+  // the signals are taken by sigwait() below, not by the thread of the bus
+  sigset_t sigset;
+  sigemptyset(&sigset);
+  sigaddset(&sigset, SIGINT);
+  sigaddset(&sigset, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &sigset, NULL);
+
+  dynamixel::EmulatedBusPty pty(&bus);
+  if (!pty.start())
+  {
+    printf("Failed to start the emulator!\n");
+    return 0;
+  }
+
+  printf("Dynamixel bus is emulated on %s\n", pty.getPortName());
+  printf(" - Baudrate          : %d\n", baudrate);
+  printf(" - Return delay time : %d usec\n", return_delay);
+  printf(" - Protocol 1.0 IDs  : %s\n", dxl1_ids);
+  printf(" - Protocol 2.0 IDs  : %s\n", dxl2_ids);
+  printf("Press Ctrl+C to quit!\n");
+
+  int sig;
+  sigwait(&sigset, &sig);
+
+  pty.stop();
+  printf("\n%u instruction packets processed\n", bus.getInstructionCount());
+
+  return 0;
+}
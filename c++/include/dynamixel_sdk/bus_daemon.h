@@ -0,0 +1,171 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file The file for sharing a serial bus among processes in Linux
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_LINUX_BUSDAEMON_H_
+#define DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_LINUX_BUSDAEMON_H_
+
+
+#include <pthread.h>
+#include "port_handler_linux.h"
+
+// messages between BusDaemon and PortHandlerClient (one message per send() of SOCK_SEQPACKET)
+#define BUS_MESSAGE_INFO        1   // daemon -> client on connection (value: baudrate, data: int32_t latency timer)
+#define BUS_MESSAGE_TX          2   // client -> daemon (value: priority, data: bytes written)
+#define BUS_MESSAGE_TX_DONE     3   // daemon -> client (value: result of writePort())
+#define BUS_MESSAGE_RX          4   // daemon -> client (data: bytes read)
+#define BUS_MESSAGE_END         5   // client -> daemon: the bus is released
+
+#define BUS_MESSAGE_CLEAR       0x01  // flag of BUS_MESSAGE_TX: the port is cleared before the write
+#define BUS_MESSAGE_AUTO_END    0x02  // flag of BUS_MESSAGE_TX: the bus is released after the write
+
+#define BUS_MESSAGE_DATA_MAX    (8*1024)
+
+namespace dynamixel
+{
+
+struct BusMessageHeader
+{
+  uint8_t   type;
+  uint8_t   flags;
+  uint16_t  length;     // bytes of the data following the header
+  int32_t   value;
+};
+
+struct BusDaemonClient;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief The class that serves one serial port to PortHandlerClient of other processes over a Unix-domain socket
+/// @description A thread owns the port and grants it to one client at a time.
+/// @description A client holds the bus from its first write until the end of its transaction (BusTransaction,
+/// @description or the packet transaction of PacketHandler), and the bytes read meanwhile are sent to the client only.
+/// @description The clients waiting are granted in order of priority, first come first served within a priority.
+/// @description A transaction is not preempted, so a client of high priority waits at most for one transaction
+/// @description of another client, which is ended by the daemon when it holds the bus longer than the hold limit.
+////////////////////////////////////////////////////////////////////////////////
+class BusDaemon
+{
+ private:
+  PortHandlerLinux *port_;
+  int               listen_fd_;
+  int               wakeup_fd_[2];
+  char              socket_path_[108];
+  int               hold_limit_;        // msec
+
+  BusDaemonClient  *clients_;
+  BusDaemonClient  *owner_;
+  int64_t           owner_deadline_ns_;
+  uint32_t          sequence_;          // order of the requests
+
+  uint32_t          transaction_count_;
+  uint32_t          expired_count_;
+
+  pthread_t         thread_;
+  bool              is_running_;
+
+  static void  *run(void *arg);
+  void          loop();
+  void          acceptClient();
+  bool          receiveMessage(BusDaemonClient *client);
+  void          removeClient(BusDaemonClient *client);
+  void          grantBus();
+  void          transmit(BusDaemonClient *client);
+  void          releaseBus();
+  void          forwardRx();
+
+ public:
+  static const int DEFAULT_HOLD_LIMIT_ = 1000;  ///< Default time a client can hold the bus (msec)
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that initializes instance of BusDaemon
+  /// @param port Port served. It should be open, and should not be accessed by other threads while the thread is running.
+  ////////////////////////////////////////////////////////////////////////////////
+  BusDaemon(PortHandlerLinux *port);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that stops the thread and closes the socket
+  ////////////////////////////////////////////////////////////////////////////////
+  virtual ~BusDaemon() { stop(); }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that listens on a Unix-domain socket and starts the thread serving the port
+  /// @description A socket file left at the path is removed.
+  /// @param socket_path Path of the socket, which is given to PortHandlerClient as "unix:<socket_path>"
+  /// @return false
+  /// @return   when the socket or the thread could not be created
+  /// @return or true
+  ////////////////////////////////////////////////////////////////////////////////
+  bool      start(const char *socket_path);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that stops the thread, and closes the socket and the connections of the clients
+  ////////////////////////////////////////////////////////////////////////////////
+  void      stop();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that sets the time a client can hold the bus
+  /// @description The bus is taken from the client when it is held longer, as from a client stopped in a transaction.
+  /// @param msec Hold limit
+  ////////////////////////////////////////////////////////////////////////////////
+  void      setHoldLimit(int msec);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that sends a message on a socket of SOCK_SEQPACKET without blocking
+  /// @description The function is used by PortHandlerClient as well.
+  /// @param fd Socket
+  /// @param type Type of the message (BUS_MESSAGE_*)
+  /// @param flags Flags of the message
+  /// @param value Value of the message
+  /// @param data Data following the header
+  /// @param length Length of the data
+  /// @return false
+  /// @return   when the message is not sent
+  /// @return or true
+  ////////////////////////////////////////////////////////////////////////////////
+  static bool sendMessage(int fd, uint8_t type, uint8_t flags, int32_t value, const uint8_t *data, int length);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns the number of the transactions served
+  ////////////////////////////////////////////////////////////////////////////////
+  uint32_t  getTransactionCount();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns the number of the transactions ended by the hold limit
+  ////////////////////////////////////////////////////////////////////////////////
+  uint32_t  getExpiredCount();
+};
+
+}
+
+
+#endif /* DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_LINUX_BUSDAEMON_H_ */
@@ -0,0 +1,206 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file The file for running transactions on multiple ports in parallel in Linux
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_LINUX_BUSEXECUTOR_H_
+#define DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_LINUX_BUSEXECUTOR_H_
+
+
+#include <pthread.h>
+#include <vector>
+#include "port_handler.h"
+#include "group_bulk_read.h"
+#include "group_bulk_write.h"
+#include "group_sync_read.h"
+#include "group_sync_write.h"
+#include "rt_support.h"
+
+namespace dynamixel
+{
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief The type of function run by BusExecutor on the thread of a port
+/// @param port Port of the bus
+/// @param arg Argument given to BusExecutor::submit()
+/// @return Communication result
+////////////////////////////////////////////////////////////////////////////////
+typedef int (*BusFunction)(PortHandler *port, void *arg);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief The struct of a command completed by BusExecutor
+////////////////////////////////////////////////////////////////////////////////
+struct BusCompletion
+{
+  uint32_t  tag;                        ///< tag given to BusExecutor::submit()
+  int       result;                     ///< communication result returned by the command
+  int64_t   start_ns;                   ///< time when the command started on the monotonic clock
+  int64_t   end_ns;                     ///< time when the command ended on the monotonic clock
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief The class that runs transactions on multiple ports in parallel in Linux
+/// @description Each port added gets an I/O thread. Commands are passed to the thread and completions are returned
+/// @description through single-producer single-consumer rings without lock, and a thread waiting on an empty ring sleeps in futex.
+/// @description The commands of one control cycle can be submitted to every bus at once, so the cycle takes
+/// @description the time of the slowest bus instead of the sum of all buses.
+/// @description The functions except BusExecutor::addPort() should be called by one thread (the control loop).
+/// @description A port, and the Group* instances on it, should not be accessed by the control loop while its commands are running.
+////////////////////////////////////////////////////////////////////////////////
+class BusExecutor
+{
+ public:
+  static const uint32_t QUEUE_SIZE_ = 64;   ///< Maximum number of commands submitted and not waited for on a bus
+
+ private:
+  struct Command
+  {
+    BusFunction function;
+    void       *arg;
+    uint32_t    tag;
+  };
+
+  struct Bus
+  {
+    PortHandler    *port;
+    pthread_t       thread;
+
+    // written by the control loop
+    uint32_t        command_write;
+    uint32_t        completion_read;
+    uint32_t        host_waiting;
+    char            pad0[64];
+
+    // written by the I/O thread
+    uint32_t        command_read;
+    uint32_t        completion_write;
+    uint32_t        io_waiting;
+    char            pad1[64];
+
+    Command         commands[QUEUE_SIZE_];
+    BusCompletion   completions[QUEUE_SIZE_];
+  };
+
+  std::vector<Bus *> buses_;
+
+  static void  *run(void *arg);
+  static int    applyRtConfig(PortHandler *port, void *arg);
+  static int    syncReadTxRx(PortHandler *port, void *group);
+  static int    bulkReadTxRx(PortHandler *port, void *group);
+  static int    syncWriteTx(PortHandler *port, void *group);
+  static int    bulkWriteTx(PortHandler *port, void *group);
+
+ public:
+  BusExecutor() { }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that stops every I/O thread
+  /// @description The commands submitted are run before the threads stop. The ports are not closed.
+  ////////////////////////////////////////////////////////////////////////////////
+  virtual ~BusExecutor();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that adds a port and starts its I/O thread
+  /// @description The real-time settings are applied by the I/O thread before the function returns.
+  /// @description The port is added even when a setting did not take effect, which is reported in status.
+  /// @param port Port opened. It is not deleted by BusExecutor.
+  /// @param rt_config Real-time settings of the I/O thread (NULL: none, see RtSupport::apply())
+  /// @param rt_status Results of the settings (can be NULL)
+  /// @return Index of the bus
+  /// @return or -1 when the thread could not be created
+  ////////////////////////////////////////////////////////////////////////////////
+  int     addPort(PortHandler *port, const RtConfig *rt_config = 0, RtStatus *rt_status = 0);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns number of buses
+  ////////////////////////////////////////////////////////////////////////////////
+  int     getBusCount();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that submits a command to the I/O thread of a bus
+  /// @param bus Index of the bus returned by BusExecutor::addPort()
+  /// @param function Function called on the I/O thread
+  /// @param arg Argument of the function
+  /// @param tag Value returned in BusCompletion
+  /// @return false
+  /// @return   when the bus index is wrong, or BusExecutor::QUEUE_SIZE_ commands are not waited for
+  /// @return or true
+  ////////////////////////////////////////////////////////////////////////////////
+  bool    submit(int bus, BusFunction function, void *arg, uint32_t tag = 0);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The functions that submit GroupSyncRead::txRxPacket(), GroupBulkRead::txRxPacket(),
+  /// @brief GroupSyncWrite::txPacket() or GroupBulkWrite::txPacket() to the I/O thread of a bus
+  /// @param bus Index of the bus of the port given to the group
+  /// @param group Group instance
+  /// @param tag Value returned in BusCompletion
+  /// @return result of BusExecutor::submit()
+  ////////////////////////////////////////////////////////////////////////////////
+  bool    submitTxRx(int bus, GroupSyncRead *group, uint32_t tag = 0);
+  bool    submitTxRx(int bus, GroupBulkRead *group, uint32_t tag = 0);
+  bool    submitTx(int bus, GroupSyncWrite *group, uint32_t tag = 0);
+  bool    submitTx(int bus, GroupBulkWrite *group, uint32_t tag = 0);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that gets the next completion of a bus without waiting
+  /// @param bus Index of the bus
+  /// @param completion Completion returned
+  /// @return false
+  /// @return   when no command is completed
+  /// @return or true
+  ////////////////////////////////////////////////////////////////////////////////
+  bool    pollCompletion(int bus, BusCompletion *completion);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that waits for the next completion of a bus
+  /// @param bus Index of the bus
+  /// @param completion Completion returned
+  /// @return false
+  /// @return   when no command is submitted
+  /// @return or true
+  ////////////////////////////////////////////////////////////////////////////////
+  bool    waitCompletion(int bus, BusCompletion *completion);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that waits until every command submitted to every bus is completed
+  /// @description The completions are consumed.
+  /// @return COMM_SUCCESS
+  /// @return   when every command returned COMM_SUCCESS
+  /// @return or the first other result
+  ////////////////////////////////////////////////////////////////////////////////
+  int     waitAll();
+};
+
+}
+
+
+#endif /* DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_LINUX_BUSEXECUTOR_H_ */
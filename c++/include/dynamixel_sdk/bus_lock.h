@@ -0,0 +1,124 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file The file for the lock which gives a port to one thread at a time
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_BUSLOCK_H_
+#define DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_BUSLOCK_H_
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <pthread.h>
+#elif defined(_WIN32) || defined(_WIN64)
+#include <windows.h>
+#endif
+
+#include "port_handler.h"
+
+namespace dynamixel
+{
+
+struct BusLockWaiter;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief The class of a recursive lock which hands the bus over to the waiting threads in order of priority
+/// @description The thread owning the lock can acquire it again, and the lock is free when every acquisition is released.
+/// @description A thread which finds the lock owned waits in a queue, ordered by priority and first come first served
+/// @description within a priority. On the last release, the lock is handed over to the head of the queue,
+/// @description so a thread acquiring again right after its release cannot overtake the threads waiting.
+/// @description The owner acquires again, releases other than the last acquisition and checks its ownership without the mutex,
+/// @description so nested acquisitions within a transaction cost no system call.
+/// @description On Arduino, which has no threads, the lock only counts the acquisitions.
+////////////////////////////////////////////////////////////////////////////////
+class WINDECLSPEC BusLock
+{
+ private:
+#if defined(__linux__) || defined(__APPLE__)
+  pthread_mutex_t     mutex_;
+  pthread_cond_t      cond_;
+  pthread_t           owner_;
+#elif defined(_WIN32) || defined(_WIN64)
+  SRWLOCK             mutex_;
+  CONDITION_VARIABLE  cond_;
+  DWORD               owner_;
+#endif
+  int                 depth_;       // acquisitions by the owner (0: free), set after owner_
+  BusLockWaiter      *waiters_;     // queue of the threads waiting, ordered by priority
+
+  void    lock();
+  void    unlock();
+  void    setOwner();
+  bool    checkOwner();
+  bool    wait(BusLockWaiter *waiter, double timeout_msec);
+
+ public:
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that initializes instance of BusLock
+  ////////////////////////////////////////////////////////////////////////////////
+  BusLock();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that releases the resources of the lock, which should not be owned
+  ////////////////////////////////////////////////////////////////////////////////
+  virtual ~BusLock();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that acquires the lock
+  /// @param timeout_msec Time to wait for the lock (negative: no limit, 0: no wait)
+  /// @param priority Priority of the thread in the queue (higher first)
+  /// @return false
+  /// @return   when the lock is not acquired within the time
+  /// @return or true
+  ////////////////////////////////////////////////////////////////////////////////
+  bool    acquire(double timeout_msec = -1.0, int priority = 0);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that releases an acquisition of the thread
+  /// @description The function does nothing when the thread does not own the lock.
+  ////////////////////////////////////////////////////////////////////////////////
+  void    release();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that checks whether the calling thread owns the lock
+  ////////////////////////////////////////////////////////////////////////////////
+  bool    isOwner();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns the number of acquisitions by the calling thread
+  /// @return 0 when the thread does not own the lock
+  ////////////////////////////////////////////////////////////////////////////////
+  int     getDepth();
+};
+
+}
+
+
+#endif /* DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_BUSLOCK_H_ */
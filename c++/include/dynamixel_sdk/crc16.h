@@ -0,0 +1,127 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file The file for the CRC-16 of Protocol 2.0 packets
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_CRC16_H_
+#define DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_CRC16_H_
+
+
+#include "port_handler.h"
+
+namespace dynamixel
+{
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief The class that calculates CRC-16 of Protocol 2.0 (polynomial 0x8005, not reflected, initial value 0)
+/// @description The tables are constant data, so nothing is built at run time.
+/// @description Crc16::update() uses the fastest kernel of the CPU, which is selected when the library is loaded:
+/// @description carry-less multiplication (PCLMULQDQ) on x86 and x64 CPUs which have it, or slicing-by-8 otherwise.
+/// @description Every kernel gives the same CRC, and can be called directly to compare them.
+////////////////////////////////////////////////////////////////////////////////
+class WINDECLSPEC Crc16
+{
+ public:
+  static const int KERNEL_TABLE_    = 0;  ///< One table lookup per byte
+  static const int KERNEL_SLICING8_ = 1;  ///< Eight table lookups per 8 bytes
+  static const int KERNEL_CLMUL_    = 2;  ///< Folding of 16 bytes by carry-less multiplication
+
+  static const int CLMUL_MIN_LENGTH_ = 64;  ///< Length of data from which carry-less multiplication is used
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that updates CRC by data with the kernel selected
+  /// @param crc CRC of the data before (0 for the first data of a packet)
+  /// @param data Data
+  /// @param length Length of the data
+  /// @return CRC
+  ////////////////////////////////////////////////////////////////////////////////
+  static uint16_t update(uint16_t crc, const uint8_t *data, int length);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that updates CRC by data with the kernel of one table lookup per byte
+  /// @param crc CRC of the data before
+  /// @param data Data
+  /// @param length Length of the data
+  /// @return CRC
+  ////////////////////////////////////////////////////////////////////////////////
+  static uint16_t updateTable(uint16_t crc, const uint8_t *data, int length);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that updates CRC by data with the slicing-by-8 kernel
+  /// @param crc CRC of the data before
+  /// @param data Data
+  /// @param length Length of the data
+  /// @return CRC
+  ////////////////////////////////////////////////////////////////////////////////
+  static uint16_t updateSlicing8(uint16_t crc, const uint8_t *data, int length);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that updates CRC by data with the carry-less multiplication kernel
+  /// @description The data shorter than Crc16::CLMUL_MIN_LENGTH_ is passed to the slicing-by-8 kernel,
+  /// @description as the setup of the folding takes longer than the table lookups.
+  /// @description The function uses the slicing-by-8 kernel when the CPU doesn't have PCLMULQDQ.
+  /// @param crc CRC of the data before
+  /// @param data Data
+  /// @param length Length of the data
+  /// @return CRC
+  ////////////////////////////////////////////////////////////////////////////////
+  static uint16_t updateClmul(uint16_t crc, const uint8_t *data, int length);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that checks whether the CPU has carry-less multiplication
+  /// @return true
+  /// @return   when the CPU is x86 or x64 with PCLMULQDQ and SSSE3, and the library is built with the kernel
+  /// @return or false
+  ////////////////////////////////////////////////////////////////////////////////
+  static bool     isClmulSupported();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns the kernel used by Crc16::update()
+  /// @return Crc16::KERNEL_TABLE_, Crc16::KERNEL_SLICING8_ or Crc16::KERNEL_CLMUL_
+  ////////////////////////////////////////////////////////////////////////////////
+  static int      getKernel();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that changes the kernel used by Crc16::update()
+  /// @description The function is for comparison of the kernels, and is not to be called while packets are handled.
+  /// @param kernel Crc16::KERNEL_TABLE_, Crc16::KERNEL_SLICING8_ or Crc16::KERNEL_CLMUL_
+  /// @return false
+  /// @return   when the kernel is unknown or not supported by the CPU
+  /// @return or true
+  ////////////////////////////////////////////////////////////////////////////////
+  static bool     setKernel(int kernel);
+};
+
+}
+
+
+#endif /* DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_CRC16_H_ */
@@ -0,0 +1,230 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file The file for emulating Dynamixels on a bus
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_EMULATEDBUS_H_
+#define DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_EMULATEDBUS_H_
+
+
+#include <deque>
+#include <vector>
+#include "port_handler.h"
+
+namespace dynamixel
+{
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief The class that emulates Dynamixels of Protocol 1.0 and 2.0 connected to one bus
+/// @description The bus parses instruction packets written by the host and queues status packets
+/// @description with the time when each byte reaches the host, modeling the return delay time of each device
+/// @description and the time which every byte takes on the wire at the baudrate.
+/// @description All times are in nsec on a clock given by the caller, so the bus can be driven by real time
+/// @description (EmulatedBusPty) or by a virtual clock.
+////////////////////////////////////////////////////////////////////////////////
+class WINDECLSPEC EmulatedBus
+{
+ private:
+  struct Device
+  {
+    uint8_t               id;
+    int                   model;            // index of the control table layout
+    std::vector<uint8_t>  table;
+    std::vector<uint8_t>  reg_write_data;
+    uint16_t              reg_write_address;
+    bool                  reg_write_pending;
+  };
+
+  struct Response
+  {
+    std::vector<uint8_t>  packet;
+    int64_t               start_ns;         // time when the first bit of the packet is sent
+    size_t                sent;             // number of bytes already taken by the host
+  };
+
+  std::vector<Device>     devices_;
+  std::vector<uint8_t>    rx_buffer_;
+  std::deque<Response>    tx_queue_;
+
+  int       baudrate_;
+  int64_t   byte_time_ns_;
+  int64_t   rx_end_ns_;                     // time when the last byte written by the host is received
+  int64_t   tx_end_ns_;                     // time when the last status packet queued is sent
+
+  uint32_t  instruction_count_;
+
+  Device   *findDevice(float protocol_version, uint8_t id);
+  void      resetControlTable(Device *device);
+  int       getReturnDelayNs(Device *device);
+  int       getStatusReturnLevel(Device *device);
+  bool      writeControlTable(Device *device, uint16_t address, const uint8_t *data, uint16_t length);
+
+  int       parsePacket(int64_t *end_ns);
+  void      processPacket1(uint8_t *packet, int64_t end_ns);
+  void      processPacket2(uint8_t *packet, int64_t end_ns);
+  void      queueStatus1(Device *device, uint8_t error, const uint8_t *data, uint16_t length, int64_t *time_ns);
+  void      queueStatus2(Device *device, uint8_t error, const uint8_t *data, uint16_t length, int64_t *time_ns);
+  void      queueFastStatus2(uint8_t instruction, const uint8_t *param, uint16_t param_length, int64_t *time_ns);
+
+ public:
+  static const int DEFAULT_RETURN_DELAY_US_ = 500;    ///< Default return delay time (same as the factory setting)
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that initializes instance of EmulatedBus
+  /// @param baudrate Baudrate used for the time of every byte on the wire
+  ////////////////////////////////////////////////////////////////////////////////
+  EmulatedBus(int baudrate = PortHandler::DEFAULT_BAUDRATE_);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that adds an emulated Dynamixel on the bus
+  /// @description The function adds a device with the factory control table of model_number.
+  /// @description Supported models are MX-28 (29) for Protocol 1.0, and XM430-W350 (1020) and H54-200-S500-R (54024) for Protocol 2.0.
+  /// @description XM430-W350 answers Fast Sync Read and Fast Bulk Read, which H54-200-S500-R does not know.
+  /// @param protocol_version Protocol version which the device answers
+  /// @param id Dynamixel ID
+  /// @param model_number Model number (0: MX-28 for Protocol 1.0 / H54-200-S500-R for Protocol 2.0)
+  /// @return false
+  /// @return   when the model is not supported or the ID is already used in the protocol
+  /// @return or true
+  ////////////////////////////////////////////////////////////////////////////////
+  bool      addDevice(float protocol_version, uint8_t id, uint16_t model_number = 0);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that removes an emulated Dynamixel from the bus
+  /// @param protocol_version Protocol version of the device
+  /// @param id Dynamixel ID
+  ////////////////////////////////////////////////////////////////////////////////
+  void      removeDevice(float protocol_version, uint8_t id);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns the control table of an emulated Dynamixel
+  /// @param protocol_version Protocol version of the device
+  /// @param id Dynamixel ID
+  /// @param length Length of the control table returned
+  /// @return NULL
+  /// @return   when the device is not on the bus
+  /// @return or Control table
+  ////////////////////////////////////////////////////////////////////////////////
+  uint8_t  *getControlTable(float protocol_version, uint8_t id, uint16_t *length = 0);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that sets return delay time of every device on the bus
+  /// @description The function writes the Return Delay Time of the control tables (2 usec resolution).
+  /// @param usec Return delay time in usec (0 ~ 508)
+  ////////////////////////////////////////////////////////////////////////////////
+  void      setReturnDelayTime(int usec);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that sets baudrate of the bus
+  /// @param baudrate Baudrate
+  ////////////////////////////////////////////////////////////////////////////////
+  void      setBaudRate(int baudrate);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns baudrate of the bus
+  /// @return Baudrate
+  ////////////////////////////////////////////////////////////////////////////////
+  int       getBaudRate();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns the time which one byte takes on the wire
+  /// @return Time of 10 bits (start, 8 data and stop bit) in nsec
+  ////////////////////////////////////////////////////////////////////////////////
+  int64_t   getByteTimeNs();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns the number of instruction packets processed
+  /// @return Number of instruction packets
+  ////////////////////////////////////////////////////////////////////////////////
+  uint32_t  getInstructionCount();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that passes bytes written by the host to the bus
+  /// @description The function starts sending the bytes at now_ns (or after the bytes written before),
+  /// @description processes every instruction packet completed and queues status packets of the devices addressed.
+  /// @param now_ns Time when the bytes are written
+  /// @param data Bytes written
+  /// @param length Length of the bytes
+  ////////////////////////////////////////////////////////////////////////////////
+  void      receive(int64_t now_ns, const uint8_t *data, int length);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns when the last byte written by the host is received by the devices
+  /// @return Time of the last byte written
+  ////////////////////////////////////////////////////////////////////////////////
+  int64_t   getReceiveEndTime();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns how many bytes have reached the host
+  /// @param now_ns Current time
+  /// @return Length of the bytes which can be read
+  ////////////////////////////////////////////////////////////////////////////////
+  int       getBytesAvailable(int64_t now_ns);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that takes bytes which have reached the host
+  /// @param now_ns Current time
+  /// @param packet Buffer for the bytes
+  /// @param length Length of the buffer
+  /// @return Length of bytes read
+  ////////////////////////////////////////////////////////////////////////////////
+  int       read(int64_t now_ns, uint8_t *packet, int length);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that discards bytes which have reached the host
+  /// @description The function discards bytes like the receive buffer of the port being flushed.
+  /// @description Bytes still on the wire arrive later.
+  /// @param now_ns Current time
+  ////////////////////////////////////////////////////////////////////////////////
+  void      discard(int64_t now_ns);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns when the next byte reaches the host
+  /// @return -1
+  /// @return   when no status packet is queued
+  /// @return or Time of the next byte
+  ////////////////////////////////////////////////////////////////////////////////
+  int64_t   getNextByteTime();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns when the last byte of the status packet being sent reaches the host
+  /// @return -1
+  /// @return   when no status packet is queued
+  /// @return or Time of the last byte of the status packet
+  ////////////////////////////////////////////////////////////////////////////////
+  int64_t   getPacketEndTime();
+};
+
+}
+
+
+#endif /* DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_EMULATEDBUS_H_ */
@@ -0,0 +1,101 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file The file for serving an emulated Dynamixel bus on a pseudo-terminal in Linux
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_LINUX_EMULATEDBUSPTY_H_
+#define DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_LINUX_EMULATEDBUSPTY_H_
+
+
+#include <pthread.h>
+#include "emulated_bus.h"
+
+namespace dynamixel
+{
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief The class that serves EmulatedBus on a pseudo-terminal in Linux
+/// @description A thread answers the instruction packets written on the slave side of a pseudo-terminal,
+/// @description so PortHandlerLinux opens the device path of getPortName() like a USB serial adapter.
+/// @description Each status packet is written when its last byte would have been received at the baudrate of the bus.
+////////////////////////////////////////////////////////////////////////////////
+class EmulatedBusPty
+{
+ private:
+  EmulatedBus  *bus_;
+  int           master_fd_;
+  int           slave_fd_;
+  int           wakeup_fd_[2];
+  char          port_name_[100];
+
+  pthread_t     thread_;
+  bool          is_running_;
+
+  static void  *run(void *arg);
+  void          loop();
+
+ public:
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that initializes instance of EmulatedBusPty
+  /// @param bus Emulated bus served. It should not be accessed by other threads while the thread is running.
+  ////////////////////////////////////////////////////////////////////////////////
+  EmulatedBusPty(EmulatedBus *bus);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that stops the thread and closes the pseudo-terminal
+  ////////////////////////////////////////////////////////////////////////////////
+  virtual ~EmulatedBusPty() { stop(); }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that opens a pseudo-terminal and starts the thread serving the bus
+  /// @return false
+  /// @return   when the pseudo-terminal or the thread could not be created
+  /// @return or true
+  ////////////////////////////////////////////////////////////////////////////////
+  bool    start();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that stops the thread and closes the pseudo-terminal
+  ////////////////////////////////////////////////////////////////////////////////
+  void    stop();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns device path of the pseudo-terminal
+  /// @return Device path which can be opened by PortHandler (ex. "/dev/pts/3")
+  ////////////////////////////////////////////////////////////////////////////////
+  char   *getPortName();
+};
+
+}
+
+
+#endif /* DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_LINUX_EMULATEDBUSPTY_H_ */
@@ -62,6 +62,13 @@ class WINDECLSPEC GroupBulkRead
   bool            last_result_;
   bool            is_param_changed_;
 
+  std::vector<PacketRequest>      requests_;  // <id, length, data> for PacketHandler::fastReadRx()
+
+  bool            is_fast_mode_;          // Fast Bulk Read is used instead of Bulk Read (see GroupBulkRead::setFastMode())
+  bool            is_fast_sent_;          // the last instruction packet is Fast Bulk Read
+  bool            is_fast_failed_;        // the last Fast Bulk Read failed, so Bulk Read is tried next
+  bool            is_fast_unsupported_;   // Bulk Read succeeded after Fast Bulk Read failed
+
   uint8_t        *param_;
 
   void    makeParam();
@@ -113,6 +120,24 @@ class WINDECLSPEC GroupBulkRead
   ////////////////////////////////////////////////////////////////////////////////
   void    clearParam  ();
 
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that makes the group read with Fast Bulk Read instead of Bulk Read (Protocol 2.0)
+  /// @description In Fast Bulk Read, the Dynamixels answer one status packet together, instead of one status packet each.
+  /// @description When Fast Bulk Read fails and Bulk Read of the same list succeeds, a Dynamixel is taken as without Fast Bulk Read,
+  /// @description and Bulk Read is used until the list changes. GroupBulkRead::txRxPacket() tries Bulk Read at once.
+  /// @param enable Whether Fast Bulk Read is used
+  ////////////////////////////////////////////////////////////////////////////////
+  void    setFastMode (bool enable);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that checks whether the group reads with Fast Bulk Read
+  /// @return false
+  /// @return   when the fast mode is disabled
+  /// @return   when a Dynamixel of the list is taken as without Fast Bulk Read
+  /// @return or true
+  ////////////////////////////////////////////////////////////////////////////////
+  bool    isFastMode  ();
+
   ////////////////////////////////////////////////////////////////////////////////
   /// @brief The function that transmits the Bulk Read instruction packet which might be constructed by GroupBulkRead::addParam function
   /// @return COMM_NOT_AVAILABLE
@@ -60,6 +60,13 @@ class WINDECLSPEC GroupSyncRead
   bool            last_result_;
   bool            is_param_changed_;
 
+  std::vector<PacketRequest>      requests_;  // <id, length, data> for PacketHandler::fastReadRx()
+
+  bool            is_fast_mode_;          // Fast Sync Read is used instead of Sync Read (see GroupSyncRead::setFastMode())
+  bool            is_fast_sent_;          // the last instruction packet is Fast Sync Read
+  bool            is_fast_failed_;        // the last Fast Sync Read failed, so Sync Read is tried next
+  bool            is_fast_unsupported_;   // Sync Read succeeded after Fast Sync Read failed
+
   uint8_t        *param_;
   uint16_t        start_address_;
   uint16_t        data_length_;
@@ -114,6 +121,25 @@ class WINDECLSPEC GroupSyncRead
   ////////////////////////////////////////////////////////////////////////////////
   void    clearParam  ();
 
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that makes the group read with Fast Sync Read instead of Sync Read (Protocol 2.0)
+  /// @description In Fast Sync Read, the Dynamixels answer one status packet together, instead of one status packet each.
+  /// @description When Fast Sync Read fails and Sync Read of the same list succeeds, a Dynamixel is taken as without Fast Sync Read,
+  /// @description and Sync Read is used until the list changes. GroupSyncRead::txRxPacket() tries Sync Read at once.
+  /// @param enable Whether Fast Sync Read is used
+  ////////////////////////////////////////////////////////////////////////////////
+  void    setFastMode (bool enable);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that checks whether the group reads with Fast Sync Read
+  /// @return false
+  /// @return   when the fast mode is disabled
+  /// @return   when a Dynamixel of the list is taken as without Fast Sync Read
+  /// @return   when the protocol1.0 has been used
+  /// @return or true
+  ////////////////////////////////////////////////////////////////////////////////
+  bool    isFastMode  ();
+
   ////////////////////////////////////////////////////////////////////////////////
   /// @brief The function that transmits the Sync Read instruction packet which might be constructed by GroupSyncRead::addParam function
   /// @return COMM_NOT_AVAILABLE
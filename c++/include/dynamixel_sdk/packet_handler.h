@@ -69,6 +69,8 @@
 #define INST_STATUS             85      // 0x55
 #define INST_SYNC_READ          130     // 0x82
 #define INST_BULK_WRITE         147     // 0x93
+#define INST_FAST_SYNC_READ     138     // 0x8A
+#define INST_FAST_BULK_READ     154     // 0x9A
 
 // Communication Result
 #define COMM_SUCCESS        0       // tx or rx packet communication success
@@ -84,6 +86,23 @@
 namespace dynamixel
 {
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief The struct for a request of PacketHandler::txRxPackets()
+/// @description The caller fills id, instruction, address, length and data (and timeout_msec),
+/// @description and the function returns result and error of the request in it.
+////////////////////////////////////////////////////////////////////////////////
+struct PacketRequest
+{
+  uint8_t   id;                 ///< Dynamixel ID
+  uint8_t   instruction;        ///< INST_PING, INST_READ, INST_WRITE or INST_REG_WRITE
+  uint16_t  address;            ///< Address of the data (INST_READ, INST_WRITE, INST_REG_WRITE)
+  uint16_t  length;             ///< Length of the data (INST_READ, INST_WRITE, INST_REG_WRITE)
+  uint8_t  *data;               ///< Data written, or the buffer for the data read (INST_PING of Protocol 2.0: model number and firmware version)
+  double    timeout_msec;       ///< Time waited for the status packet in msec (0: PortHandler::setResponseTimeout())
+  int       result;             ///< Communication result of the request
+  uint8_t   error;              ///< Dynamixel hardware error of the request
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief The class that inherits Protocol1PacketHandler class or Protocol2PacketHandler class
 ////////////////////////////////////////////////////////////////////////////////
@@ -137,7 +156,7 @@ class WINDECLSPEC PacketHandler
 
   ////////////////////////////////////////////////////////////////////////////////
   /// @brief The function that transmits the instruction packet txpacket via PortHandler port.
-  /// @description The function clears the port buffer by PortHandler::clearPort() function,
+  /// @description The function clears the port buffer by PortHandler::clearPort() function (unless disabled by PortHandler::setTxFlush()),
   /// @description   then transmits txpacket by PortHandler::writePort() function.
   /// @description The function activates only when the port is not busy and when the packet is already written on the port buffer
   /// @param port PortHandler instance
@@ -596,6 +615,60 @@ class WINDECLSPEC PacketHandler
   /// @return communication results which come from PacketHandler::txRxPacket()
   ////////////////////////////////////////////////////////////////////////////////
   virtual int bulkWriteTxOnly (PortHandler *port, uint8_t *param, uint16_t param_length) = 0;
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that transmits INST_FAST_SYNC_READ instruction packet
+  /// @description The function makes an instruction packet with INST_FAST_SYNC_READ,
+  /// @description transmits the packet with PacketHandler::txPacket().
+  /// @description The Dynamixels answer one status packet together, which is received by PacketHandler::fastReadRx().
+  /// @param port PortHandler instance
+  /// @param start_address Address of the data for Fast Sync Read
+  /// @param data_length Length of the data for Fast Sync Read
+  /// @param param Parameter for Fast Sync Read
+  /// @param param_length Length of the data for Fast Sync Read
+  /// @return communication results which come from PacketHandler::txPacket()
+  ////////////////////////////////////////////////////////////////////////////////
+  virtual int fastSyncReadTx  (PortHandler *port, uint16_t start_address, uint16_t data_length, uint8_t *param, uint16_t param_length) = 0;
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that transmits INST_FAST_BULK_READ instruction packet
+  /// @description The function makes an instruction packet with INST_FAST_BULK_READ,
+  /// @description transmits the packet with PacketHandler::txPacket().
+  /// @description The Dynamixels answer one status packet together, which is received by PacketHandler::fastReadRx().
+  /// @param port PortHandler instance
+  /// @param param Parameter for Fast Bulk Read
+  /// @param param_length Length of the data for Fast Bulk Read
+  /// @return communication results which come from PacketHandler::txPacket()
+  ////////////////////////////////////////////////////////////////////////////////
+  virtual int fastBulkReadTx  (PortHandler *port, uint8_t *param, uint16_t param_length) = 0;
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that receives the status packet of Fast Sync Read or Fast Bulk Read
+  /// @description The function receives the status packet which the Dynamixels answer together,
+  /// @description and splits it into the data of each Dynamixel.
+  /// @param port PortHandler instance
+  /// @param requests Dynamixels in the order of the instruction packet (id, length and data), which get their result and error
+  /// @param count Number of the requests
+  /// @return communication results of the status packet
+  ////////////////////////////////////////////////////////////////////////////////
+  virtual int fastReadRx      (PortHandler *port, PacketRequest *requests, int count) = 0;
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that transmits the instruction packets of several requests back to back and receives their status packets
+  /// @description The function makes an instruction packet for each of requests,
+  /// @description transmits them in one packet transaction without waiting for the status packets in between,
+  /// @description then matches the status packets to the requests by ID and order.
+  /// @description The latency of the port is paid once for the requests, instead of once for each request.
+  /// @description The devices answer one after another, so the return delay time of each device should cover
+  /// @description the instruction packets still being transmitted on a half-duplex bus.
+  /// @param port PortHandler instance
+  /// @param requests Requests, which get their result, error and data read
+  /// @param count Number of the requests
+  /// @return COMM_SUCCESS
+  /// @return   when every request succeeds
+  /// @return or the result of the first request failed
+  ////////////////////////////////////////////////////////////////////////////////
+  virtual int txRxPackets     (PortHandler *port, PacketRequest *requests, int count) = 0;
 };
 
 }
@@ -55,23 +55,143 @@
 namespace dynamixel
 {
 
+class BusLock;
+class StatusPacketParser;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief The struct of a buffer written by PortHandler::writePortv()
+////////////////////////////////////////////////////////////////////////////////
+struct PortBuffer
+{
+  uint8_t  *data;
+  int       length;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief The struct of response time statistics of a Dynamixel kept by PortHandler::updateResponseTime()
+/// @description Response latency is the time from the instruction packet written to the status packet received,
+/// @description less the time for the status packet to be transferred.
+////////////////////////////////////////////////////////////////////////////////
+struct ResponseStats
+{
+  uint32_t  count;                      ///< number of responses received
+  uint32_t  timeouts;                   ///< number of responses not received (timeout or corrupt)
+  uint32_t  consecutive_timeouts;       ///< number of responses not received since the last one received
+  uint32_t  outliers;                   ///< number of responses later than mean + 4 * deviation
+  uint32_t  fallbacks;                  ///< number of timeouts set by the fixed formula while the adaptive timeout is used (not enough samples, or probing after timeout)
+  int64_t   mean_ns;                    ///< exponentially weighted moving average of the latency (gain 1/8)
+  int64_t   deviation_ns;               ///< exponentially weighted moving average of the absolute deviation (gain 1/4)
+  int64_t   p99_ns;                     ///< running estimate of the 99th percentile of the latency
+  int64_t   max_ns;                     ///< maximum latency
+  int64_t   timeout_ns;                 ///< latency allowed by the last adaptive timeout
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief The struct of a latency histogram with buckets on a log2 scale
+////////////////////////////////////////////////////////////////////////////////
+struct LatencyHistogram
+{
+  static const int BUCKET_COUNT_ = 20;  ///< Number of buckets
+
+  uint32_t  count;                      ///< number of samples
+  uint32_t  buckets[BUCKET_COUNT_];     ///< buckets[0]: < 2 usec, buckets[i]: 2^i ~ 2^(i+1) usec, buckets[19]: >= 2^19 usec
+  int64_t   sum_ns;                     ///< sum of the latency (sum_ns / count: mean latency)
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief The struct of bus statistics kept by PortHandler when PortHandler::setBusStats() is enabled
+/// @description Latency is the time from the instruction packet written to a status packet received,
+/// @description so the status packets of Sync Read and Bulk Read include the time of the status packets before.
+////////////////////////////////////////////////////////////////////////////////
+struct BusStats
+{
+  static const int INSTRUCTION_COUNT_ = 16;   ///< Number of instructions which have a histogram
+  static const int ID_COUNT_          = 253;  ///< Number of IDs which have a histogram (0 ~ 252)
+
+  uint32_t  sequence;                   ///< odd while the statistics are being updated (used by PortHandler::getBusStats())
+  uint64_t  tx_bytes;                   ///< bytes of the instruction packets written
+  uint64_t  rx_bytes;                   ///< bytes read from the port
+  uint32_t  tx_packets;                 ///< instruction packets written
+  uint32_t  rx_packets;                 ///< status packets received
+  uint32_t  syscalls;                   ///< system calls made by the port (0: not counted by the port)
+  uint32_t  rx_timeouts;                ///< status packets not received (COMM_RX_TIMEOUT)
+  uint32_t  rx_corrupts;                ///< status packets received in part or broken (COMM_RX_CORRUPT)
+  uint32_t  checksum_errors;            ///< status packets with a wrong checksum or CRC
+  uint32_t  resyncs;                    ///< times the parser skipped bytes to find the next packet header
+  uint32_t  resync_bytes;               ///< bytes skipped to find the next packet header
+
+  uint8_t           instructions[INSTRUCTION_COUNT_];         ///< instruction of each histogram below (0: not used yet)
+  LatencyHistogram  instruction_latency[INSTRUCTION_COUNT_];  ///< latency of the status packets by the instruction answered
+  LatencyHistogram  id_latency[ID_COUNT_];                    ///< latency of the status packets by ID
+};
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief The class for port control that inherits PortHandlerLinux, PortHandlerWindows, PortHandlerMac, or PortHandlerArduino
 ////////////////////////////////////////////////////////////////////////////////
 class WINDECLSPEC PortHandler
 {
+ protected:
+  int64_t packet_deadline_ns_;  ///< Time of packet timeout on the monotonic clock (nsec)
+  int64_t cycle_deadline_ns_;   ///< Time which limits every packet timeout on the monotonic clock (nsec, 0: not set)
+
+  ResponseStats *response_stats_;     ///< Response time statistics of each ID (allocated by PortHandler::setAdaptiveTimeout())
+  bool    response_adaptive_;         ///< Whether the adaptive timeout is used
+  double  response_factor_;           ///< Safety factor of the adaptive timeout
+  int64_t response_min_ns_;           ///< Minimum latency allowed by the adaptive timeout
+  int64_t response_start_ns_;         ///< Time when PortHandler::setResponseTimeout() was called
+  int64_t response_transfer_ns_;      ///< Time for the expected status packet to be transferred
+  int     response_id_;               ///< ID waited by PortHandler::setResponseTimeout() (-1: none)
+  bool    tx_flush_;                  ///< Whether the port is cleared before every instruction packet
+
+  void    addResponseSample(ResponseStats *stats, int64_t latency);
+
+  BusStats *bus_stats_;               ///< Bus statistics updated by the thread using the port (allocated by PortHandler::setBusStats())
+  BusStats *bus_stats_base_;          ///< Bus statistics at PortHandler::clearBusStats(), subtracted by PortHandler::getBusStats()
+  bool    bus_stats_enabled_;         ///< Whether the bus statistics are updated
+  uint8_t bus_instruction_;           ///< Instruction of the last instruction packet written
+  int64_t bus_tx_ns_;                 ///< Time when the last instruction packet was written
+
+  bool    beginBusStats();
+  void    endBusStats();
+  void    addBusLatency(LatencyHistogram *histogram, int64_t latency);
+  void    copyBusStats(BusStats *stats);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that counts a system call made by the port
+  ////////////////////////////////////////////////////////////////////////////////
+  void    addBusSyscall();
+
+  BusLock  *bus_lock_;                ///< Lock which gives the port to one thread at a time
+  double    bus_timeout_msec_;        ///< Time the packet handlers wait for the port (negative: no limit, 0: no wait)
+
+  StatusPacketParser *status_parser_; ///< Parser of the status packets received (allocated by PortHandler::getStatusParser())
+  uint8_t  *packet_buffer_;           ///< Buffer for the packets of the packet handlers (allocated by PortHandler::getPacketBuffer())
+  int       packet_buffer_length_;    ///< Length of packet_buffer_
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function called before the calling thread gives the port up
+  /// @description The function is called by PortHandler::releaseBus() and PortHandler::endTransaction()
+  /// @description before the last acquisition of the calling thread is released, so the thread still owns the port.
+  ////////////////////////////////////////////////////////////////////////////////
+  virtual void  onBusRelease() { }
+
+  PortHandler();
+
  public:
   static const int DEFAULT_BAUDRATE_ = 57600; ///< Default Baudrate
 
   ////////////////////////////////////////////////////////////////////////////////
   /// @brief The function that gets PortHandler class inheritance
   /// @description The function gets class inheritance (PortHandlerLinux / PortHandlerWindows / PortHandlerMac / PortHandlerArduino.
+  /// @description The port name starting with "sim:" (ex. "sim:0") gets PortHandlerSim which emulates Dynamixels in memory.
+  /// @description In Linux, the port name "replay:<trace path>" gets PortHandlerReplay which replays a trace recorded by PortHandlerRecorder.
+  /// @description In Linux, the port name "unix:<socket path>" gets PortHandlerClient which uses the port served by BusDaemon.
   ////////////////////////////////////////////////////////////////////////////////
   static PortHandler *getPortHandler(const char *port_name);
 
-  bool   is_using_; ///< shows whether the port is in use
+  bool   is_using_; ///< shows whether a packet transaction is open (see PortHandler::beginTransaction())
 
-  virtual ~PortHandler() { }
+  virtual ~PortHandler();
 
   ////////////////////////////////////////////////////////////////////////////////
   /// @brief The function that opens the port
@@ -156,24 +276,344 @@ class WINDECLSPEC PortHandler
   virtual int     writePort(uint8_t *packet, int length) = 0;
 
   ////////////////////////////////////////////////////////////////////////////////
-  /// @brief The function that sets and starts stopwatch for watching packet timeout
-  /// @description The function sets the stopwatch by getting current time and the time of packet timeout with packet_length.
+  /// @brief The function that writes several buffers on the port buffer as one packet
+  /// @description The function writes the buffers in order without copying them into one buffer,
+  /// @description and returns a number of bytes which are successfully written.
+  /// @description The default implementation calls PortHandler::writePort() for each buffer.
+  /// @param buffers Buffers which would be written on the port buffer
+  /// @param count Number of the buffers
+  /// @return -1
+  /// @return   when error was occurred
+  /// @return or Length of bytes written
+  ////////////////////////////////////////////////////////////////////////////////
+  virtual int     writePortv(PortBuffer *buffers, int count);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that waits until bytes are able to be read from the port buffer
+  /// @description The function sleeps until at least one byte is able to be read from the port buffer
+  /// @description or the time of packet timeout set by PortHandler::setPacketDeadline() is passed.
+  /// @description The default implementation returns immediately, so the caller keeps polling PortHandler::readPort().
+  /// @return false
+  /// @return   when the packet timeout is passed without any byte received
+  /// @return or true
+  ////////////////////////////////////////////////////////////////////////////////
+  virtual bool    waitForBytes() { return true; }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns current time of the monotonic clock
+  /// @description The function returns time which never goes backwards, so it is not affected by the system clock adjustment.
+  /// @return Current time in nsec
+  ////////////////////////////////////////////////////////////////////////////////
+  virtual int64_t getCurrentTimeNs() = 0;
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that sets packet timeout for the packet expected to be received
+  /// @description The function sets the time of packet timeout by PortHandler::setPacketDeadline()
+  /// @description with the time expected for packet_length bytes to be transferred.
   /// @param packet_length Length of the packet expected to be received
   ////////////////////////////////////////////////////////////////////////////////
   virtual void    setPacketTimeout(uint16_t packet_length) = 0;
 
   ////////////////////////////////////////////////////////////////////////////////
-  /// @brief The function that sets and starts stopwatch for watching packet timeout
-  /// @description The function sets the stopwatch by getting current time and the time of packet timeout with msec.
-  /// @param packet_length Length of the packet expected to be received
+  /// @brief The function that sets packet timeout in msec from now
+  /// @description The function sets the time of packet timeout by PortHandler::setPacketDeadline().
+  /// @param msec Time left until packet timeout
   ////////////////////////////////////////////////////////////////////////////////
-  virtual void    setPacketTimeout(double msec) = 0;
+  virtual void    setPacketTimeout(double msec);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that sets the time of packet timeout
+  /// @description The function sets the absolute time of packet timeout on the clock of PortHandler::getCurrentTimeNs().
+  /// @description The time is limited by the deadline set by PortHandler::setCycleDeadline().
+  /// @param deadline_ns Time of packet timeout in nsec
+  ////////////////////////////////////////////////////////////////////////////////
+  virtual void    setPacketDeadline(int64_t deadline_ns);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns the time of packet timeout
+  /// @return Time of packet timeout in nsec
+  ////////////////////////////////////////////////////////////////////////////////
+  virtual int64_t getPacketDeadline();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that sets the deadline of the whole control cycle
+  /// @description The function sets the absolute time on the clock of PortHandler::getCurrentTimeNs()
+  /// @description which every packet timeout set afterwards cannot exceed,
+  /// @description so a budget of the control cycle is kept even when several devices do not respond.
+  /// @param deadline_ns Deadline of the cycle in nsec (0: no deadline)
+  ////////////////////////////////////////////////////////////////////////////////
+  virtual void    setCycleDeadline(int64_t deadline_ns);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns the deadline of the whole control cycle
+  /// @return Deadline of the cycle in nsec (0: no deadline)
+  ////////////////////////////////////////////////////////////////////////////////
+  virtual int64_t getCycleDeadline();
 
   ////////////////////////////////////////////////////////////////////////////////
   /// @brief The function that checks whether packet timeout is occurred
-  /// @description The function checks whether current time is passed by the time of packet timeout from the time set by PortHandlerLinux::setPacketTimeout().
+  /// @description The function checks whether current time is passed by the time of packet timeout set by PortHandler::setPacketDeadline().
+  ////////////////////////////////////////////////////////////////////////////////
+  virtual bool    isPacketTimeout();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that sets whether the port is cleared before every instruction packet
+  /// @description When enabled (default), the packet handlers call PortHandler::clearPort() before writing an instruction packet,
+  /// @description which discards the bytes left on the port (ex. a status packet arrived after its timeout).
+  /// @description When disabled, the bytes are kept and the packet handlers discard a stale status packet
+  /// @description whose ID, instruction or length does not answer the instruction packet waited for.
+  /// @description This saves a system call per packet and lets instruction packets be written back to back,
+  /// @description while a late status packet of the same ID and length is taken as the answer.
+  /// @param enable Whether the port is cleared
+  ////////////////////////////////////////////////////////////////////////////////
+  void    setTxFlush(bool enable);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that checks whether the port is cleared before every instruction packet
+  ////////////////////////////////////////////////////////////////////////////////
+  bool    isTxFlush();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that enables the packet timeout learned for each ID
+  /// @description The function makes PortHandler::setResponseTimeout() derive the timeout
+  /// @description from the response latency of the ID measured by PortHandler::updateResponseTime().
+  /// @description The allowed latency is max(p99, mean + 4 * deviation) * safety_factor, at least min_msec,
+  /// @description and never more than the fixed formula of PortHandler::setPacketTimeout(uint16_t packet_length).
+  /// @description An ID with less than 8 responses measured (ex. not connected) gets the estimate of every ID together.
+  /// @description The fixed formula is used until 8 responses are measured, and once in 16 timeouts in a row
+  /// @description so a Dynamixel which has become slower is measured again.
+  /// @param enable Whether the adaptive timeout is used (the statistics are kept while it is allocated)
+  /// @param safety_factor Ratio of the allowed latency to the latency estimated
+  /// @param min_msec Minimum latency allowed
+  ////////////////////////////////////////////////////////////////////////////////
+  void    setAdaptiveTimeout(bool enable, double safety_factor = 2.0, double min_msec = 0.2);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that checks whether the adaptive timeout is used
+  ////////////////////////////////////////////////////////////////////////////////
+  bool    isAdaptiveTimeout();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that sets packet timeout for the status packet of a Dynamixel
+  /// @description The function sets the adaptive timeout of the ID when it is enabled by PortHandler::setAdaptiveTimeout(),
+  /// @description or calls PortHandler::setPacketTimeout(uint16_t packet_length).
+  /// @description It is called right after the instruction packet is written.
+  /// @param id Dynamixel ID expected to respond
+  /// @param packet_length Length of the status packet expected to be received
+  ////////////////////////////////////////////////////////////////////////////////
+  void    setResponseTimeout(uint8_t id, uint16_t packet_length);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that updates the response time statistics of a Dynamixel
+  /// @description The function measures the time from PortHandler::setResponseTimeout() of the same ID.
+  /// @description It does nothing when the packet timeout was set otherwise afterwards (ex. for Sync Read).
+  /// @param id Dynamixel ID which responded
+  /// @param received Whether the status packet was received
+  ////////////////////////////////////////////////////////////////////////////////
+  void    updateResponseTime(uint8_t id, bool received);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns the response time statistics of a Dynamixel
+  /// @param id Dynamixel ID (0xFE: every ID together)
+  /// @return Statistics of the ID
+  /// @return or NULL when the adaptive timeout has never been enabled
+  ////////////////////////////////////////////////////////////////////////////////
+  const ResponseStats *getResponseStats(uint8_t id);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that clears the response time statistics of every ID
+  ////////////////////////////////////////////////////////////////////////////////
+  void    clearResponseStats();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that enables the bus statistics
+  /// @description The statistics are updated by the thread using the port without any lock,
+  /// @description and PortHandler::getBusStats() takes a consistent snapshot of them from another thread.
+  /// @param enable Whether the statistics are updated (they are kept while disabled)
+  ////////////////////////////////////////////////////////////////////////////////
+  void    setBusStats(bool enable);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that checks whether the bus statistics are enabled
+  ////////////////////////////////////////////////////////////////////////////////
+  bool    isBusStats();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that takes a snapshot of the bus statistics since PortHandler::clearBusStats()
+  /// @description The function can be called by another thread (ex. monitoring) while the port is in use.
+  /// @description It retries while the statistics are being updated, and never blocks the thread using the port.
+  /// @param stats Snapshot of the statistics
+  /// @return false
+  /// @return   when the statistics have never been enabled
+  /// @return or true
+  ////////////////////////////////////////////////////////////////////////////////
+  bool    getBusStats(BusStats *stats);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that clears the bus statistics
+  /// @description The function can be called by the same thread as PortHandler::getBusStats().
+  /// @description The counters are not written, but the current values are subtracted from the later snapshots.
+  ////////////////////////////////////////////////////////////////////////////////
+  void    clearBusStats();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that counts an instruction packet written
+  /// @description The function is called by the packet handler.
+  /// @param instruction Instruction of the packet
+  /// @param length Length of the packet
+  ////////////////////////////////////////////////////////////////////////////////
+  void    addBusTx(uint8_t instruction, int length);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that counts bytes read from the port
+  /// @description The function is called by the packet handler.
+  /// @param length Length of the bytes read
+  ////////////////////////////////////////////////////////////////////////////////
+  void    addBusRx(int length);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that counts bytes skipped to find the next packet header
+  /// @description The function is called by the packet handler.
+  /// @param length Length of the bytes skipped
+  ////////////////////////////////////////////////////////////////////////////////
+  void    addBusResync(int length);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that counts a status packet with a wrong checksum or CRC
+  /// @description The function is called by the packet handler.
+  ////////////////////////////////////////////////////////////////////////////////
+  void    addBusChecksumError();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that counts the result of receiving a status packet
+  /// @description The function is called by the packet handler.
+  /// @description The latency of a status packet received is added to the histograms of the ID and the last instruction.
+  /// @param id ID of the status packet received
+  /// @param result Communication result (COMM_SUCCESS, COMM_RX_TIMEOUT, COMM_RX_CORRUPT...)
+  ////////////////////////////////////////////////////////////////////////////////
+  void    addBusStatus(uint8_t id, int result);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that acquires the port for the calling thread
+  /// @description The acquisitions are counted, and the port is given to another thread when every acquisition is released.
+  /// @description The threads waiting get the port in order of priority, and first come first served within a priority.
+  /// @description The packet handlers acquire the port from an instruction packet to its status packet,
+  /// @description so several packets can be made one transaction by acquiring the port around them (see BusTransaction).
+  /// @param timeout_msec Time to wait for the port (negative: no limit, 0: no wait)
+  /// @param priority Priority of the thread among the threads waiting (higher first)
+  /// @return false
+  /// @return   when the port is not acquired within the time
+  /// @return or true
+  ////////////////////////////////////////////////////////////////////////////////
+  bool    acquireBus(double timeout_msec, int priority = 0);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that acquires the port for the calling thread within the time set by PortHandler::setBusTimeout()
+  ////////////////////////////////////////////////////////////////////////////////
+  bool    acquireBus();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that releases an acquisition of the port by the calling thread
+  /// @description When only the packet transaction is left after the release (ex. readTx() without readRx()),
+  /// @description the transaction is ended as well, so the port is not kept by a transaction abandoned.
+  ////////////////////////////////////////////////////////////////////////////////
+  void    releaseBus();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that checks whether the calling thread has acquired the port
+  ////////////////////////////////////////////////////////////////////////////////
+  bool    isBusOwner();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that sets the time the packet handlers wait for the port acquired by another thread
+  /// @description The packet handlers return COMM_PORT_BUSY when the port is not acquired within the time.
+  /// @description By default they do not wait, as before the port could be shared by threads, so the callers polling
+  /// @description and retrying on COMM_PORT_BUSY are not blocked. Waiting in order of priority is chosen by a time other than 0.
+  /// @param msec Time to wait for the port (negative: no limit, 0: no wait (default))
+  ////////////////////////////////////////////////////////////////////////////////
+  void    setBusTimeout(double msec);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that opens a packet transaction
+  /// @description The function is called by the packet handler before an instruction packet is written,
+  /// @description and the transaction is ended by PortHandler::endTransaction() after its status packet.
+  /// @return false
+  /// @return   when the calling thread has a transaction open, or the port is not acquired within PortHandler::setBusTimeout()
+  /// @return or true
+  ////////////////////////////////////////////////////////////////////////////////
+  bool    beginTransaction();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that ends the packet transaction of the calling thread
+  /// @description The function does nothing when the calling thread has no transaction open.
+  ////////////////////////////////////////////////////////////////////////////////
+  void    endTransaction();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns the parser of the status packets received by the port
+  /// @description The parser is made at the first call, and is used by the packet handlers
+  /// @description within a packet transaction, so it is used by one thread at a time.
+  /// @return Parser of the port
+  ////////////////////////////////////////////////////////////////////////////////
+  StatusPacketParser *getStatusParser();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns the buffer of the port for the packets made or received by the packet handlers
+  /// @description The buffer is made at the first call which needs it, and made again when it is shorter than length,
+  /// @description so a packet of several KB is not kept on the stack. It is used by the packet handlers
+  /// @description within a packet transaction, so it is used by one thread at a time.
+  /// @param length Length of the buffer needed
+  /// @return Buffer of the port
+  ////////////////////////////////////////////////////////////////////////////////
+  uint8_t *getPacketBuffer(int length);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief The class that keeps a port acquired by the calling thread within a scope
+/// @description The instruction and status packets in the scope are one transaction on the bus,
+/// @description which the other threads using the port cannot come between. Ex.
+/// @description   BusTransaction transaction(port);
+/// @description   if (transaction.isAcquired()) { groupSyncWrite.txPacket(); groupSyncRead.txRxPacket(); }
+////////////////////////////////////////////////////////////////////////////////
+class WINDECLSPEC BusTransaction
+{
+ private:
+  PortHandler  *port_;
+  bool          acquired_;
+
+ public:
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that acquires the port within the time set by PortHandler::setBusTimeout()
+  ////////////////////////////////////////////////////////////////////////////////
+  BusTransaction(PortHandler *port) : port_(port), acquired_(port->acquireBus()) { }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that acquires the port
+  /// @param timeout_msec Time to wait for the port (negative: no limit, 0: no wait)
+  /// @param priority Priority of the thread among the threads waiting (higher first)
+  ////////////////////////////////////////////////////////////////////////////////
+  BusTransaction(PortHandler *port, double timeout_msec, int priority = 0)
+    : port_(port), acquired_(port->acquireBus(timeout_msec, priority)) { }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that releases the port
+  ////////////////////////////////////////////////////////////////////////////////
+  virtual ~BusTransaction() { release(); }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that checks whether the port has been acquired
+  ////////////////////////////////////////////////////////////////////////////////
+  bool    isAcquired() { return acquired_; }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that releases the port before the end of the scope
   ////////////////////////////////////////////////////////////////////////////////
-  virtual bool    isPacketTimeout() = 0;
+  void    release()
+  {
+    if (acquired_)
+      port_->releaseBus();
+    acquired_ = false;
+  }
 };
 
 }
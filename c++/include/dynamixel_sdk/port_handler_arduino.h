@@ -55,8 +55,6 @@ class PortHandlerArduino : public PortHandler
   int     baudrate_;
   char    port_name_[100];
 
-  double  packet_start_time_;
-  double  packet_timeout_;
   double  tx_time_per_byte;
 
 #if defined(__OPENCM904__)
@@ -65,8 +63,8 @@ class PortHandlerArduino : public PortHandler
 
   bool    setupPort(const int cflag_baud);
 
-  double  getCurrentTime();
-  double  getTimeSinceStart();
+  uint32_t last_micros_;
+  int64_t  elapsed_ns_;
 
   int     checkBaudrateAvailable(int baudrate);
 
@@ -171,24 +169,20 @@ class PortHandlerArduino : public PortHandler
   int     writePort(uint8_t *packet, int length);
 
   ////////////////////////////////////////////////////////////////////////////////
-  /// @brief The function that sets and starts stopwatch for watching packet timeout
-  /// @description The function sets the stopwatch by getting current time and the time of packet timeout with packet_length.
-  /// @param packet_length Length of the packet expected to be received
+  /// @brief The function that returns current time of the monotonic clock
+  /// @return Current time in nsec
   ////////////////////////////////////////////////////////////////////////////////
-  void    setPacketTimeout(uint16_t packet_length);
+  int64_t getCurrentTimeNs();
 
-  ////////////////////////////////////////////////////////////////////////////////
-  /// @brief The function that sets and starts stopwatch for watching packet timeout
-  /// @description The function sets the stopwatch by getting current time and the time of packet timeout with msec.
-  /// @param packet_length Length of the packet expected to be received
-  ////////////////////////////////////////////////////////////////////////////////
-  void    setPacketTimeout(double msec);
+  using PortHandler::setPacketTimeout;
 
   ////////////////////////////////////////////////////////////////////////////////
-  /// @brief The function that checks whether packet timeout is occurred
-  /// @description The function checks whether current time is passed by the time of packet timeout from the time set by PortHandlerArduino::setPacketTimeout().
+  /// @brief The function that sets packet timeout for the packet expected to be received
+  /// @description The function sets the time of packet timeout by PortHandler::setPacketDeadline()
+  /// @description with the time expected for packet_length bytes to be transferred and the USB latency.
+  /// @param packet_length Length of the packet expected to be received
   ////////////////////////////////////////////////////////////////////////////////
-  bool    isPacketTimeout();
+  void    setPacketTimeout(uint16_t packet_length);
 };
 
 }
@@ -0,0 +1,128 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file The file for using a serial bus served by BusDaemon in Linux
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_LINUX_PORTHANDLERCLIENT_H_
+#define DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_LINUX_PORTHANDLERCLIENT_H_
+
+
+#include "port_handler.h"
+#include "bus_daemon.h"
+
+namespace dynamixel
+{
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief The class for a port served by BusDaemon of another process in Linux
+/// @description The port writes and reads through the Unix-domain socket of the daemon, so the packet handlers work unchanged.
+/// @description The bus of the daemon is held from the first write until the calling thread releases the port
+/// @description (the end of the packet transaction, or of BusTransaction around several packets),
+/// @description so the transaction is not mixed with the packets of the other processes.
+/// @description A write outside any transaction releases the bus of the daemon at once.
+/// @description PortHandler::getPortHandler() returns this class for the port name "unix:<socket path>".
+////////////////////////////////////////////////////////////////////////////////
+class PortHandlerClient : public PortHandler
+{
+ private:
+  static const int RX_BUFFER_SIZE_ = 2 * BUS_MESSAGE_DATA_MAX;
+
+  int       socket_fd_;
+  char      port_name_[100];
+  int       baudrate_;
+  int       latency_timer_;
+  double    tx_time_per_byte;
+  int       priority_;
+
+  bool      clear_pending_;         // the port of the daemon is cleared before the next write
+  bool      holding_;               // the bus of the daemon is held by the port
+
+  uint8_t   rx_buffer_[RX_BUFFER_SIZE_];
+  int       rx_head_;
+  int       rx_tail_;
+  uint8_t   message_[sizeof(BusMessageHeader) + BUS_MESSAGE_DATA_MAX];
+
+  int       receiveMessage(bool wait, bool drop_rx, int32_t *value);
+
+ protected:
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that releases the bus of the daemon with the last acquisition of the port
+  ////////////////////////////////////////////////////////////////////////////////
+  void      onBusRelease();
+
+ public:
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that initializes instance of PortHandlerClient and gets port_name
+  /// @param port_name "unix:" followed by path of the socket of BusDaemon
+  ////////////////////////////////////////////////////////////////////////////////
+  PortHandlerClient(const char *port_name);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that closes the connection to the daemon
+  ////////////////////////////////////////////////////////////////////////////////
+  virtual ~PortHandlerClient() { closePort(); }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that sets priority of the transactions of the port among the clients of the daemon
+  /// @param priority Priority (higher first, 0 by default)
+  ////////////////////////////////////////////////////////////////////////////////
+  void      setPriority(int priority);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns priority of the transactions of the port
+  ////////////////////////////////////////////////////////////////////////////////
+  int       getPriority();
+
+  // functions of PortHandler served by the daemon
+  // (the baudrate is set by the daemon, and setBaudRate() fails for any other baudrate)
+  bool      openPort();
+  void      closePort();
+  void      clearPort();
+  void      setPortName(const char *port_name);
+  char     *getPortName();
+  bool      setBaudRate(const int baudrate);
+  int       getBaudRate();
+  int       getBytesAvailable();
+  int       readPort(uint8_t *packet, int length);
+  int       writePort(uint8_t *packet, int length);
+  int       writePortv(PortBuffer *buffers, int count);
+  bool      waitForBytes();
+  int64_t   getCurrentTimeNs();
+
+  using PortHandler::setPacketTimeout;
+  void      setPacketTimeout(uint16_t packet_length);
+};
+
+}
+
+
+#endif /* DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_LINUX_PORTHANDLERCLIENT_H_ */
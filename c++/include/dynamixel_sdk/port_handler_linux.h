@@ -42,6 +42,17 @@
 namespace dynamixel
 {
 
+class SerialUring;
+class PortHandlerLinux;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief The type of the function called when the device of the port is lost or comes back
+/// @param port Port handler
+/// @param state PortHandlerLinux::PORT_DISCONNECTED_ or PortHandlerLinux::PORT_CONNECTED_
+/// @param arg Argument given to PortHandlerLinux::setPortStateCallback()
+////////////////////////////////////////////////////////////////////////////////
+typedef void (*PortStateCallback)(PortHandlerLinux *port, int state, void *arg);
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief The class for control port in Linux
 ////////////////////////////////////////////////////////////////////////////////
@@ -52,18 +63,74 @@ class PortHandlerLinux : public PortHandler
   int     baudrate_;
   char    port_name_[100];
 
-  double  packet_start_time_;
-  double  packet_timeout_;
   double  tx_time_per_byte;
 
+  int     latency_timer_request_;
+  int     latency_timer_;
+  bool    low_latency_;
+
+  bool    rs485_enabled_;
+  bool    rs485_rts_on_send_;
+  int     rs485_delay_before_send_;
+  int     rs485_delay_after_send_;
+  bool    echo_suppression_;
+  int     echo_remaining_;
+
+  static const int RX_BUFFER_SIZE_ = 4096;   // power of 2
+  uint8_t   rx_buffer_[RX_BUFFER_SIZE_];
+  uint32_t  rx_head_;
+  uint32_t  rx_tail_;
+  int64_t   rx_idle_until_ns_;            // time the bytes written are transmitted by, before which nothing is read (0: none)
+
+  SerialUring *uring_;
+  int       uring_pending_;               // requests submitted to uring_ and not completed
+  bool      uring_read_armed_;
+  bool      uring_write_busy_;
+  bool      uring_write_failed_;          // set by the completion of a write which failed, returned by the next write
+  int64_t   uring_write_deadline_ns_;     // time by which the write in flight has completed or timed out
+  uint32_t  uring_write_sequence_;        // sequence number of the last write in SerialUring
+  int       uring_tx_length_;
+  int64_t   uring_write_timeout_[2];      // __kernel_timespec of the timeout linked to the write
+  uint8_t   uring_tx_buffer_[RX_BUFFER_SIZE_];
+
+  int       port_state_;
+  bool      device_lost_;                 // set by the io_uring completions, handled by the next call
+  bool      reconnect_enabled_;
+  int       reconnect_interval_;          // msec
+  int64_t   reconnect_time_ns_;           // time of the next attempt to open the device again
+  int64_t   disconnect_time_ns_;
+  int64_t   recovery_time_ns_;
+  PortStateCallback state_callback_;
+  void     *state_callback_arg_;
+
+  friend class SerialUring;
+
+  bool    openDevice();
+  bool    checkConnection();
+  void    disconnectPort();
+  bool    reconnectPort();
+  void    setPortState(int state);
   bool    setupPort(const int cflag_baud);
+  int     fillRxBuffer();
+  void    holdRxBuffer(int length);
+  void    armUringRead();
+  void    completeUring(int operation, int result);
+  void    stopUring();
+  void    setupLatencyTimer();
+  bool    setupRS485();
   bool    setCustomBaudrate(int speed);
+  bool    setTermios2Baudrate(int speed);
+  int     getAppliedBaudrate();
   int     getCFlagBaud(const int baudrate);
 
-  double  getCurrentTime();
-  double  getTimeSinceStart();
-
  public:
+  static const int DEFAULT_LATENCY_TIMER_ = 1;  ///< Default USB latency timer requested on openPort (msec)
+  static const int DEFAULT_RECONNECT_INTERVAL_ = 10;  ///< Default interval of the attempts to reconnect (msec)
+
+  static const int PORT_CLOSED_       = 0;  ///< The port is not opened, or closed by PortHandlerLinux::closePort()
+  static const int PORT_CONNECTED_    = 1;  ///< The port is open
+  static const int PORT_DISCONNECTED_ = 2;  ///< The device of the port was lost (ex. the USB serial converter was unplugged)
+
   ////////////////////////////////////////////////////////////////////////////////
   /// @brief The function that initializes instance of PortHandler and gets port_name
   /// @description The function initializes instance of PortHandler and gets port_name.
@@ -112,6 +179,9 @@ class PortHandlerLinux : public PortHandler
   ////////////////////////////////////////////////////////////////////////////////
   /// @brief The function that sets baudrate into the port handler
   /// @description The function sets baudrate into the port handler.
+  /// @description A baudrate out of the Bxxx constants (ex. 4500000, 6000000) is set exactly by termios2 (BOTHER),
+  /// @description or by the divisor of the serial driver (ASYNC_SPD_CUST) when the driver does not support termios2.
+  /// @description The packet timeout is calculated from the baudrate applied by the driver.
   /// @param baudrate Baudrate
   /// @return false
   /// @return   when error was occurred during port opening
@@ -129,7 +199,7 @@ class PortHandlerLinux : public PortHandler
   ////////////////////////////////////////////////////////////////////////////////
   /// @brief The function that checks how much bytes are able to be read from the port buffer
   /// @description The function checks how much bytes are able to be read from the port buffer
-  /// @description and returns the number.
+  /// @description and the receive ring buffer, and returns the number.
   /// @return Length of read-able bytes in the port buffer
   ////////////////////////////////////////////////////////////////////////////////
   int     getBytesAvailable();
@@ -138,6 +208,8 @@ class PortHandlerLinux : public PortHandler
   /// @brief The function that reads bytes from the port buffer
   /// @description The function gets bytes from the port buffer,
   /// @description and returns a number of bytes read.
+  /// @description All bytes available are drained into the receive ring buffer by one read(),
+  /// @description and the bytes more than length are kept there for the next call.
   /// @param packet Buffer for the packet received
   /// @param length Length of the buffer for read
   /// @return -1
@@ -159,24 +231,160 @@ class PortHandlerLinux : public PortHandler
   int     writePort(uint8_t *packet, int length);
 
   ////////////////////////////////////////////////////////////////////////////////
-  /// @brief The function that sets and starts stopwatch for watching packet timeout
-  /// @description The function sets the stopwatch by getting current time and the time of packet timeout with packet_length.
-  /// @param packet_length Length of the packet expected to be received
+  /// @brief The function that writes several buffers on the port buffer as one packet
+  /// @description The function writes the buffers by one writev() call.
+  /// @param buffers Buffers which would be written on the port buffer
+  /// @param count Number of the buffers
+  /// @return -1
+  /// @return   when error was occurred
+  /// @return or Length of bytes written
   ////////////////////////////////////////////////////////////////////////////////
-  void    setPacketTimeout(uint16_t packet_length);
+  int     writePortv(PortBuffer *buffers, int count);
 
   ////////////////////////////////////////////////////////////////////////////////
-  /// @brief The function that sets and starts stopwatch for watching packet timeout
-  /// @description The function sets the stopwatch by getting current time and the time of packet timeout with msec.
-  /// @param packet_length Length of the packet expected to be received
+  /// @brief The function that waits until bytes are able to be read from the port buffer
+  /// @description The function sleeps in ppoll() until the port becomes readable
+  /// @description or the time of packet timeout set by PortHandler::setPacketDeadline() is passed,
+  /// @description so the receiving loop does not spin on PortHandlerLinux::readPort().
+  /// @description While the device of the port is lost, the function sleeps until the packet timeout.
+  /// @return false
+  /// @return   when the packet timeout is passed without any byte received
+  /// @return or true
+  ////////////////////////////////////////////////////////////////////////////////
+  bool    waitForBytes();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns current time of the monotonic clock
+  /// @return Current time in nsec
+  ////////////////////////////////////////////////////////////////////////////////
+  int64_t getCurrentTimeNs();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that sets the USB latency timer requested when the port is opened
+  /// @description The function sets the value written to /sys/bus/usb-serial/devices/<tty>/latency_timer
+  /// @description when it is larger, and the ASYNC_LOW_LATENCY flag of the port.
+  /// @description It takes effect on the next PortHandlerLinux::openPort() or PortHandlerLinux::setBaudRate().
+  /// @param msec Latency timer (0: the latency timer and the flag are left as they are)
+  ////////////////////////////////////////////////////////////////////////////////
+  void    setLatencyTimer(int msec);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns the USB latency timer in effect
+  /// @description The function returns the latency timer read from sysfs when the port was opened,
+  /// @description which is used by PortHandlerLinux::setPacketTimeout().
+  /// @return Latency timer in msec
+  /// @return or -1 when the port has no latency timer (not a USB serial converter)
+  ////////////////////////////////////////////////////////////////////////////////
+  int     getLatencyTimer();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that checks whether the port is in low latency mode
+  /// @return true
+  /// @return   when the ASYNC_LOW_LATENCY flag of the port is set
+  /// @return or false
+  ////////////////////////////////////////////////////////////////////////////////
+  bool    isLowLatency();
+
   ////////////////////////////////////////////////////////////////////////////////
-  void    setPacketTimeout(double msec);
+  /// @brief The function that sets RS-485 half-duplex mode of the kernel driver (TIOCSRS485)
+  /// @description The driver switches the transceiver direction with RTS around each transmission,
+  /// @description so a UART with an RS-485 transceiver (ex. on linux_sbc boards) needs no direction-switching hardware.
+  /// @description The mode is applied now when the port is open, and every time the port is opened.
+  /// @param enable Whether the RS-485 mode is enabled
+  /// @param rts_on_send Logical level of RTS while sending (true: high, false: low)
+  /// @param delay_before_send Delay after RTS is set before sending (msec)
+  /// @param delay_after_send Delay after sending before RTS is reset (msec)
+  /// @return false
+  /// @return   when the driver does not support RS-485 mode
+  /// @return or true
+  ////////////////////////////////////////////////////////////////////////////////
+  bool    setRS485(bool enable, bool rts_on_send = true, int delay_before_send = 0, int delay_after_send = 0);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that checks whether RS-485 mode is enabled
+  ////////////////////////////////////////////////////////////////////////////////
+  bool    isRS485();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that sets suppression of the echo of transmitted bytes
+  /// @description The function makes PortHandlerLinux::readPort() and PortHandlerLinux::getBytesAvailable() drop
+  /// @description as many bytes as PortHandlerLinux::writePort() has written, for a transceiver which loops TX back to RX.
+  /// @param enable Whether the echo is suppressed
+  ////////////////////////////////////////////////////////////////////////////////
+  void    setEchoSuppression(bool enable);
 
   ////////////////////////////////////////////////////////////////////////////////
-  /// @brief The function that checks whether packet timeout is occurred
-  /// @description The function checks whether current time is passed by the time of packet timeout from the time set by PortHandlerLinux::setPacketTimeout().
+  /// @brief The function that selects the io_uring backend for the reads and writes of the port
+  /// @description The port writes and receives through the io_uring instance, which can be shared by many ports
+  /// @description so one thread drives them all. See SerialUring for the details.
+  /// @description The requests of the port in flight are cancelled when the port is closed or the backend is changed.
+  /// @param uring io_uring instance (NULL: read()/write() as before)
+  /// @return false
+  /// @return   when io_uring is not available (the port keeps the read()/write() path)
+  /// @return or true
+  ////////////////////////////////////////////////////////////////////////////////
+  bool    setUring(SerialUring *uring);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns the io_uring instance used by the port
+  /// @return io_uring instance
+  /// @return or NULL when the read()/write() path is used
   ////////////////////////////////////////////////////////////////////////////////
-  bool    isPacketTimeout();
+  SerialUring *getUring();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns the file descriptor of the port
+  /// @description The descriptor can be polled with others (ex. by BusDaemon). It changes when the port is reconnected.
+  /// @return File descriptor
+  /// @return or -1 when the port is not open
+  ////////////////////////////////////////////////////////////////////////////////
+  int     getFileDescriptor();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that sets whether the port is opened again after its device is lost
+  /// @description The device is regarded as lost when a read or a write fails by EIO, ENODEV or ENXIO,
+  /// @description or the port is hung up (POLLHUP), as a USB serial converter unplugged.
+  /// @description The port is closed then, and PortHandlerLinux::writePort() and PortHandlerLinux::waitForBytes()
+  /// @description try to open the port name again every interval_msec until the device node comes back,
+  /// @description with the baudrate, the latency timer and the RS-485 mode set before.
+  /// @description The calls fail (COMM_TX_FAIL / COMM_RX_TIMEOUT) while the device is lost. It is enabled by default.
+  /// @param enable Whether the port is opened again
+  /// @param interval_msec Interval of the attempts to open the port
+  ////////////////////////////////////////////////////////////////////////////////
+  void    setAutoReconnect(bool enable, int interval_msec = DEFAULT_RECONNECT_INTERVAL_);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that sets the function called when the device of the port is lost or comes back
+  /// @description The callback is called by the thread using the port, inside the call which found the change,
+  /// @description so it must not use the port. A control loop can hold the position of the joints on PORT_DISCONNECTED_.
+  /// @param callback Function called (NULL: none)
+  /// @param arg Argument given to the callback
+  ////////////////////////////////////////////////////////////////////////////////
+  void    setPortStateCallback(PortStateCallback callback, void *arg = 0);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns the state of the port
+  /// @return PORT_CLOSED_, PORT_CONNECTED_ or PORT_DISCONNECTED_
+  ////////////////////////////////////////////////////////////////////////////////
+  int     getPortState();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns the time taken by the last reconnection
+  /// @return Time from the loss of the device to the port opened again in msec
+  /// @return or 0 when the port has never been reconnected
+  ////////////////////////////////////////////////////////////////////////////////
+  double  getRecoveryTime();
+
+  using PortHandler::setPacketTimeout;
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that sets packet timeout for the packet expected to be received
+  /// @description The function sets the time of packet timeout by PortHandler::setPacketDeadline()
+  /// @description with the time expected for packet_length bytes to be transferred and the USB latency.
+  /// @description The latency timer read on openPort is used, or 8 msec when it is unknown.
+  /// @param packet_length Length of the packet expected to be received
+  ////////////////////////////////////////////////////////////////////////////////
+  void    setPacketTimeout(uint16_t packet_length);
 };
 
 }
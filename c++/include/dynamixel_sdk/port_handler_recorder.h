@@ -0,0 +1,146 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file The file for recording the traffic of a port into a trace file in Linux
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_LINUX_PORTHANDLERRECORDER_H_
+#define DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_LINUX_PORTHANDLERRECORDER_H_
+
+
+#include "port_handler.h"
+
+/* Trace file: TraceHeader followed by records of TraceRecord and its payload, ended by a zero type */
+#define TRACE_MAGIC             "DXLTRACE"
+#define TRACE_VERSION           1
+
+#define TRACE_END               0       // end of the trace
+#define TRACE_WRITE             1       // bytes written by writePort()
+#define TRACE_READ              2       // bytes returned by readPort()
+#define TRACE_CLEAR             3       // clearPort() called
+#define TRACE_BAUDRATE          4       // setBaudRate() called (payload: int32_t baudrate)
+#define TRACE_TIME              5       // time of the next record when the delta does not fit (payload: int64_t nsec)
+
+namespace dynamixel
+{
+
+struct TraceHeader
+{
+  char      magic[8];
+  uint32_t  version;
+  uint32_t  header_size;
+  int64_t   start_ns;                   ///< time of the first record
+  int32_t   baudrate;
+  char      port_name[36];
+};
+
+struct TraceRecord
+{
+  uint8_t   type;
+  uint8_t   reserved;
+  uint16_t  length;                     ///< length of the payload following the record
+  uint32_t  delta_ns;                   ///< time from the previous record
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief The class that records the traffic of a port into a trace file in Linux
+/// @description The class decorates another PortHandler. Every byte run of PortHandler::writePort() and PortHandler::readPort()
+/// @description is appended with the time of the monotonic clock to the trace file mapped in memory,
+/// @description so recording costs a memcpy per call. The trace can be fed back by PortHandlerReplay.
+////////////////////////////////////////////////////////////////////////////////
+class PortHandlerRecorder : public PortHandler
+{
+ private:
+  PortHandler  *port_;
+  int           fd_;
+  uint8_t      *map_;
+  size_t        map_size_;
+  size_t        offset_;
+  int64_t       last_ns_;
+
+  bool    reserve(size_t length);
+  void    append(uint8_t type, const uint8_t *data, uint16_t length);
+  void    append(uint8_t type, PortBuffer *buffers, int count, uint16_t length);
+
+ public:
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that initializes instance of PortHandlerRecorder
+  /// @param port PortHandler instance decorated. It is not deleted by PortHandlerRecorder.
+  /// @param trace_path Path of the trace file, which is overwritten
+  ////////////////////////////////////////////////////////////////////////////////
+  PortHandlerRecorder(PortHandler *port, const char *trace_path);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that closes the trace file
+  ////////////////////////////////////////////////////////////////////////////////
+  virtual ~PortHandlerRecorder() { closeTrace(); }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that checks whether the trace file is opened
+  /// @return false
+  /// @return   when the trace file could not be created
+  /// @return or true
+  ////////////////////////////////////////////////////////////////////////////////
+  bool    isRecording();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that ends the trace and closes the trace file
+  /// @description The function truncates the trace file to the length recorded.
+  ////////////////////////////////////////////////////////////////////////////////
+  void    closeTrace();
+
+  // functions of PortHandler forwarded to the decorated port (readPort, writePort(v), clearPort and setBaudRate are recorded)
+  bool    openPort();
+  void    closePort();
+  void    clearPort();
+  void    setPortName(const char *port_name);
+  char   *getPortName();
+  bool    setBaudRate(const int baudrate);
+  int     getBaudRate();
+  int     getBytesAvailable();
+  int     readPort(uint8_t *packet, int length);
+  int     writePort(uint8_t *packet, int length);
+  int     writePortv(PortBuffer *buffers, int count);
+  bool    waitForBytes();
+  int64_t getCurrentTimeNs();
+  void    setPacketTimeout(uint16_t packet_length);
+  void    setPacketTimeout(double msec);
+  void    setPacketDeadline(int64_t deadline_ns);
+  int64_t getPacketDeadline();
+  void    setCycleDeadline(int64_t deadline_ns);
+  int64_t getCycleDeadline();
+  bool    isPacketTimeout();
+};
+
+}
+
+
+#endif /* DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_LINUX_PORTHANDLERRECORDER_H_ */
@@ -0,0 +1,139 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file The file for replaying a trace file recorded by PortHandlerRecorder in Linux
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_LINUX_PORTHANDLERREPLAY_H_
+#define DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_LINUX_PORTHANDLERREPLAY_H_
+
+
+#include "port_handler.h"
+#include "port_handler_recorder.h"
+
+namespace dynamixel
+{
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief The class for replaying a trace file recorded by PortHandlerRecorder in Linux
+/// @description The port returns the bytes read in the trace at the time they were read, on a clock which
+/// @description jumps to the time of each recorded write when the same write is done again.
+/// @description The clock runs as fast as possible by default, or at the speed set by PortHandlerReplay::setSpeed().
+/// @description PortHandler::getPortHandler() returns this class for the port name "replay:<trace path>".
+////////////////////////////////////////////////////////////////////////////////
+class PortHandlerReplay : public PortHandler
+{
+ private:
+  int       fd_;
+  uint8_t  *map_;
+  size_t    map_size_;
+  char      port_name_[100];
+  int       baudrate_;
+  double    tx_time_per_byte;
+
+  size_t    cursor_;                // offset of the next record
+  int64_t   cursor_ns_;             // time of the record before the cursor
+  size_t    read_offset_;           // bytes of the next record already read
+
+  int64_t   now_ns_;
+  double    speed_;
+  int64_t   anchor_ns_;             // virtual time at anchor_real_ns_
+  int64_t   anchor_real_ns_;
+
+  uint32_t  mismatch_count_;
+  uint32_t  write_count_;
+
+  uint8_t   peekRecord(size_t *cursor, int64_t *base_ns, int64_t *time_ns, TraceRecord *record);
+  void      nextRecord();
+  void      advanceTo(int64_t time_ns);
+
+ public:
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that initializes instance of PortHandlerReplay and gets port_name
+  /// @param port_name "replay:" followed by path of the trace file
+  ////////////////////////////////////////////////////////////////////////////////
+  PortHandlerReplay(const char *port_name);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that closes the trace file
+  ////////////////////////////////////////////////////////////////////////////////
+  virtual ~PortHandlerReplay();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that sets speed of the replay
+  /// @param speed Ratio to the recorded speed (1.0: original speed, 0: as fast as possible)
+  ////////////////////////////////////////////////////////////////////////////////
+  void      setSpeed(double speed);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that checks whether every write in the trace is replayed
+  /// @return true
+  /// @return   when no more write is left in the trace
+  /// @return or false
+  ////////////////////////////////////////////////////////////////////////////////
+  bool      isEnd();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns the number of writes replayed
+  /// @return Number of writes
+  ////////////////////////////////////////////////////////////////////////////////
+  uint32_t  getWriteCount();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns the number of writes different from the trace
+  /// @description A write is counted when its bytes differ from the recorded write, or when the trace has no more write.
+  /// @return Number of writes mismatched
+  ////////////////////////////////////////////////////////////////////////////////
+  uint32_t  getMismatchCount();
+
+  // functions of PortHandler replaying the trace
+  bool      openPort();
+  void      closePort();
+  void      clearPort();
+  void      setPortName(const char *port_name);
+  char     *getPortName();
+  bool      setBaudRate(const int baudrate);
+  int       getBaudRate();
+  int       getBytesAvailable();
+  int       readPort(uint8_t *packet, int length);
+  int       writePort(uint8_t *packet, int length);
+  int       writePortv(PortBuffer *buffers, int count);
+  bool      waitForBytes();
+  int64_t   getCurrentTimeNs();
+
+  using PortHandler::setPacketTimeout;
+  void      setPacketTimeout(uint16_t packet_length);
+};
+
+}
+
+
+#endif /* DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_LINUX_PORTHANDLERREPLAY_H_ */
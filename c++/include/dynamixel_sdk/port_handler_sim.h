@@ -0,0 +1,215 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file The file for port control of an emulated bus in memory
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_PORTHANDLERSIM_H_
+#define DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_PORTHANDLERSIM_H_
+
+
+#include "port_handler.h"
+#include "emulated_bus.h"
+
+namespace dynamixel
+{
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief The class for control port of EmulatedBus in memory
+/// @description The port runs on a virtual clock. Writing an instruction packet advances the clock
+/// @description until the packet is on the wire, and waiting for bytes advances it until the next status packet
+/// @description is received, so the time measured by PortHandlerSim::getCurrentTimeNs() follows the baudrate
+/// @description and the latency model regardless of the speed of the host.
+/// @description PortHandler::getPortHandler() returns this class for the port name starting with "sim:".
+/// @description The bus starts with MX-28 of ID 1 and 2 (Protocol 1.0) and H54-200-S500-R of ID 1 and 2 (Protocol 2.0).
+////////////////////////////////////////////////////////////////////////////////
+class WINDECLSPEC PortHandlerSim : public PortHandler
+{
+ private:
+  EmulatedBus bus_;
+  bool        is_open_;
+  int         baudrate_;
+  char        port_name_[100];
+
+  int64_t     now_ns_;
+  int64_t     latency_ns_;
+  double      tx_time_per_byte;
+
+ public:
+  static const int64_t DEFAULT_LATENCY_NS_ = 0;   ///< Default latency of the adapter
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that initializes instance of PortHandler and gets port_name
+  /// @description The function initializes instance of PortHandler and gets port_name.
+  ////////////////////////////////////////////////////////////////////////////////
+  PortHandlerSim(const char *port_name);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that closes the port
+  /// @description The function calls PortHandlerSim::closePort() to close the port.
+  ////////////////////////////////////////////////////////////////////////////////
+  virtual ~PortHandlerSim() { closePort(); }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns the emulated bus of the port
+  /// @description The devices and the control tables of the bus can be changed through the instance.
+  /// @return EmulatedBus instance
+  ////////////////////////////////////////////////////////////////////////////////
+  EmulatedBus *getBus();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that sets latency of the adapter
+  /// @description The function sets the time from a byte received on the wire to the byte readable by the host,
+  /// @description like the latency timer of a USB serial adapter.
+  /// @param latency_ns Latency in nsec
+  ////////////////////////////////////////////////////////////////////////////////
+  void    setLatency(int64_t latency_ns);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that advances the virtual clock
+  /// @description The function moves the clock forward, for example for the rest of a control cycle.
+  /// @param nsec Time to be advanced in nsec
+  ////////////////////////////////////////////////////////////////////////////////
+  void    advanceTime(int64_t nsec);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that opens the port
+  /// @description The function calls PortHandlerSim::setBaudRate() to open the port.
+  /// @return communication results which come from PortHandlerSim::setBaudRate()
+  ////////////////////////////////////////////////////////////////////////////////
+  bool    openPort();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that closes the port
+  /// @description The function closes the port.
+  ////////////////////////////////////////////////////////////////////////////////
+  void    closePort();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that clears the port
+  /// @description The function discards the bytes which the host has not read yet.
+  ////////////////////////////////////////////////////////////////////////////////
+  void    clearPort();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that sets port name into the port handler
+  /// @description The function sets port name into the port handler.
+  /// @param port_name Port name
+  ////////////////////////////////////////////////////////////////////////////////
+  void    setPortName(const char *port_name);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns port name set into the port handler
+  /// @description The function returns current port name set into the port handler.
+  /// @return Port name
+  ////////////////////////////////////////////////////////////////////////////////
+  char   *getPortName();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that sets baudrate into the port handler
+  /// @description The function sets baudrate of the port and the emulated bus.
+  /// @param baudrate Baudrate
+  /// @return false
+  /// @return   when the baudrate is not positive
+  /// @return or true
+  ////////////////////////////////////////////////////////////////////////////////
+  bool    setBaudRate(const int baudrate);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns current baudrate set into the port handler
+  /// @description The function returns current baudrate set into the port handler.
+  /// @return Baudrate
+  ////////////////////////////////////////////////////////////////////////////////
+  int     getBaudRate();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that checks how much bytes are able to be read from the port buffer
+  /// @description The function checks how much bytes are able to be read from the port buffer
+  /// @description and returns the number.
+  /// @return Length of read-able bytes in the port buffer
+  ////////////////////////////////////////////////////////////////////////////////
+  int     getBytesAvailable();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that reads bytes from the port buffer
+  /// @description The function gets bytes from the port buffer,
+  /// @description and returns a number of bytes read.
+  /// @param packet Buffer for the packet received
+  /// @param length Length of the buffer for read
+  /// @return -1
+  /// @return   when error was occurred
+  /// @return or Length of bytes read
+  ////////////////////////////////////////////////////////////////////////////////
+  int     readPort(uint8_t *packet, int length);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that writes bytes on the port buffer
+  /// @description The function passes bytes to the emulated bus
+  /// @description and advances the virtual clock until the last byte is on the wire.
+  /// @param packet Buffer which would be written on the port buffer
+  /// @param length Length of the buffer for write
+  /// @return -1
+  /// @return   when error was occurred
+  /// @return or Length of bytes written
+  ////////////////////////////////////////////////////////////////////////////////
+  int     writePort(uint8_t *packet, int length);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that waits until bytes are able to be read from the port buffer
+  /// @description The function advances the virtual clock until the status packet being sent is readable,
+  /// @description or until the time of packet timeout when no status packet is coming.
+  /// @return false
+  /// @return   when the packet timeout is passed without any byte received
+  /// @return or true
+  ////////////////////////////////////////////////////////////////////////////////
+  bool    waitForBytes();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns current time of the virtual clock
+  /// @return Current time in nsec
+  ////////////////////////////////////////////////////////////////////////////////
+  int64_t getCurrentTimeNs();
+
+  using PortHandler::setPacketTimeout;
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that sets packet timeout for the packet expected to be received
+  /// @description The function sets the time of packet timeout by PortHandler::setPacketDeadline()
+  /// @description with the time expected for packet_length bytes to be transferred and the latency.
+  /// @param packet_length Length of the packet expected to be received
+  ////////////////////////////////////////////////////////////////////////////////
+  void    setPacketTimeout(uint16_t packet_length);
+};
+
+}
+
+
+#endif /* DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_PORTHANDLERSIM_H_ */
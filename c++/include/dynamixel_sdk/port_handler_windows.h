@@ -55,15 +55,10 @@ class WINDECLSPEC PortHandlerWindows : public PortHandler
   int     baudrate_;
   char    port_name_[100];
 
-  double  packet_start_time_;
-  double  packet_timeout_;
   double  tx_time_per_byte_;
 
   bool    setupPort(const int baudrate);
 
-  double  getCurrentTime();
-  double  getTimeSinceStart();
-
  public:
   ////////////////////////////////////////////////////////////////////////////////
   /// @brief The function that initializes instance of PortHandler and gets port_name
@@ -160,24 +155,20 @@ class WINDECLSPEC PortHandlerWindows : public PortHandler
   int     writePort(uint8_t *packet, int length);
 
   ////////////////////////////////////////////////////////////////////////////////
-  /// @brief The function that sets and starts stopwatch for watching packet timeout
-  /// @description The function sets the stopwatch by getting current time and the time of packet timeout with packet_length.
-  /// @param packet_length Length of the packet expected to be received
+  /// @brief The function that returns current time of the monotonic clock
+  /// @return Current time in nsec
   ////////////////////////////////////////////////////////////////////////////////
-  void    setPacketTimeout(uint16_t packet_length);
+  int64_t getCurrentTimeNs();
 
-  ////////////////////////////////////////////////////////////////////////////////
-  /// @brief The function that sets and starts stopwatch for watching packet timeout
-  /// @description The function sets the stopwatch by getting current time and the time of packet timeout with msec.
-  /// @param packet_length Length of the packet expected to be received
-  ////////////////////////////////////////////////////////////////////////////////
-  void    setPacketTimeout(double msec);
+  using PortHandler::setPacketTimeout;
 
   ////////////////////////////////////////////////////////////////////////////////
-  /// @brief The function that checks whether packet timeout is occurred
-  /// @description The function checks whether current time is passed by the time of packet timeout from the time set by PortHandlerWindows::setPacketTimeout().
+  /// @brief The function that sets packet timeout for the packet expected to be received
+  /// @description The function sets the time of packet timeout by PortHandler::setPacketDeadline()
+  /// @description with the time expected for packet_length bytes to be transferred and the USB latency.
+  /// @param packet_length Length of the packet expected to be received
   ////////////////////////////////////////////////////////////////////////////////
-  bool    isPacketTimeout();
+  void    setPacketTimeout(uint16_t packet_length);
 };
 
 }
@@ -52,6 +52,9 @@ class WINDECLSPEC Protocol1PacketHandler : public PacketHandler
 
   Protocol1PacketHandler();
 
+  int     txPacket(PortHandler *port, uint8_t *txpacket, uint8_t *param, uint16_t param_length);
+  int     txRxPacket(PortHandler *port, uint8_t *txpacket, uint8_t *param, uint16_t param_length, uint8_t *rxpacket, uint8_t *error);
+
  public:
   ////////////////////////////////////////////////////////////////////////////////
   /// @brief The function that returns Protocol1PacketHandler instance
@@ -97,7 +100,7 @@ class WINDECLSPEC Protocol1PacketHandler : public PacketHandler
 
   ////////////////////////////////////////////////////////////////////////////////
   /// @brief The function that transmits the instruction packet txpacket via PortHandler port.
-  /// @description The function clears the port buffer by PortHandler::clearPort() function,
+  /// @description The function clears the port buffer by PortHandler::clearPort() function (unless disabled by PortHandler::setTxFlush()),
   /// @description   then transmits txpacket by PortHandler::writePort() function.
   /// @description The function activates only when the port is not busy and when the packet is already written on the port buffer
   /// @param port PortHandler instance
@@ -115,6 +118,7 @@ class WINDECLSPEC Protocol1PacketHandler : public PacketHandler
   ////////////////////////////////////////////////////////////////////////////////
   /// @brief The function that receives packet (rxpacket) during designated time via PortHandler port
   /// @description The function repeatedly tries to receive rxpacket by PortHandler::readPort() function.
+  /// @description The bytes are read into and parsed by PortHandler::getStatusParser(), no more than the packet being parsed.
   /// @description It breaks out
   /// @description when PortHandler::isPacketTimeout() shows the timeout,
   /// @description when rxpacket seemed as corrupted, or
@@ -548,6 +552,51 @@ class WINDECLSPEC Protocol1PacketHandler : public PacketHandler
   /// @return COMM_NOT_AVAILABLE
   ////////////////////////////////////////////////////////////////////////////////
   int bulkWriteTxOnly (PortHandler *port, uint8_t *param, uint16_t param_length);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief (Available only in Protocol 2.0) The function that transmits Fast Sync Read instruction packet
+  /// @param port PortHandler instance
+  /// @param start_address Address of the data for Fast Sync Read
+  /// @param data_length Length of the data for Fast Sync Read
+  /// @param param Parameter for Fast Sync Read
+  /// @param param_length Length of the data for Fast Sync Read
+  /// @return COMM_NOT_AVAILABLE
+  ////////////////////////////////////////////////////////////////////////////////
+  int fastSyncReadTx  (PortHandler *port, uint16_t start_address, uint16_t data_length, uint8_t *param, uint16_t param_length);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief (Available only in Protocol 2.0) The function that transmits Fast Bulk Read instruction packet
+  /// @param port PortHandler instance
+  /// @param param Parameter for Fast Bulk Read
+  /// @param param_length Length of the data for Fast Bulk Read
+  /// @return COMM_NOT_AVAILABLE
+  ////////////////////////////////////////////////////////////////////////////////
+  int fastBulkReadTx  (PortHandler *port, uint8_t *param, uint16_t param_length);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief (Available only in Protocol 2.0) The function that receives the status packet of Fast Sync Read or Fast Bulk Read
+  /// @param port PortHandler instance
+  /// @param requests Dynamixels in the order of the instruction packet
+  /// @param count Number of the requests
+  /// @return COMM_NOT_AVAILABLE
+  ////////////////////////////////////////////////////////////////////////////////
+  int fastReadRx      (PortHandler *port, PacketRequest *requests, int count);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that transmits the instruction packets of several requests back to back and receives their status packets
+  /// @description The function makes an instruction packet for each of requests (INST_PING, INST_READ, INST_WRITE or INST_REG_WRITE),
+  /// @description transmits them back to back in one packet transaction, without waiting for the status packets in between,
+  /// @description then receives the status packets with Protocol1PacketHandler::rxPacket() and matches them to the requests by ID and order.
+  /// @description A request whose status packet is not found before the status packet of a later request gets COMM_RX_TIMEOUT.
+  /// @description The requests to BROADCAST_ID are transmitted without a status packet, except INST_PING and INST_READ, which are not available.
+  /// @param port PortHandler instance
+  /// @param requests Requests, which get their result, error and data read
+  /// @param count Number of the requests
+  /// @return COMM_SUCCESS
+  /// @return   when every request succeeds
+  /// @return or the result of the first request failed
+  ////////////////////////////////////////////////////////////////////////////////
+  int txRxPackets     (PortHandler *port, PacketRequest *requests, int count);
 };
 
 }
@@ -52,9 +52,10 @@ class WINDECLSPEC Protocol2PacketHandler : public PacketHandler
 
   Protocol2PacketHandler();
 
-  uint16_t    updateCRC(uint16_t crc_accum, uint8_t *data_blk_ptr, uint16_t data_blk_size);
   void        addStuffing(uint8_t *packet);
-  void        removeStuffing(uint8_t *packet);
+
+  int         txPacket(PortHandler *port, uint8_t *txpacket, uint8_t *param, uint16_t param_length);
+  int         txRxPacket(PortHandler *port, uint8_t *txpacket, uint8_t *param, uint16_t param_length, uint8_t *rxpacket, uint8_t *error);
 
  public:
   ////////////////////////////////////////////////////////////////////////////////
@@ -101,9 +102,10 @@ class WINDECLSPEC Protocol2PacketHandler : public PacketHandler
 
   ////////////////////////////////////////////////////////////////////////////////
   /// @brief The function that transmits the instruction packet txpacket via PortHandler port.
-  /// @description The function clears the port buffer by PortHandler::clearPort() function,
+  /// @description The function clears the port buffer by PortHandler::clearPort() function (unless disabled by PortHandler::setTxFlush()),
   /// @description   then transmits txpacket by PortHandler::writePort() function.
   /// @description The function activates only when the port is not busy and when the packet is already written on the port buffer
+  /// @description The byte stuffing is written between the parts of txpacket, so txpacket needs no room for it.
   /// @param port PortHandler instance
   /// @param txpacket packet for transmission
   /// @return COMM_PORT_BUSY
@@ -119,6 +121,7 @@ class WINDECLSPEC Protocol2PacketHandler : public PacketHandler
   ////////////////////////////////////////////////////////////////////////////////
   /// @brief The function that receives packet (rxpacket) during designated time via PortHandler port
   /// @description The function repeatedly tries to receive rxpacket by PortHandler::readPort() function.
+  /// @description The bytes are read into and parsed by PortHandler::getStatusParser(), no more than the packet being parsed.
   /// @description It breaks out
   /// @description when PortHandler::isPacketTimeout() shows the timeout,
   /// @description when rxpacket seemed as corrupted, or
@@ -561,6 +564,66 @@ class WINDECLSPEC Protocol2PacketHandler : public PacketHandler
   /// @return communication results which come from Protocol2PacketHandler::txRxPacket()
   ////////////////////////////////////////////////////////////////////////////////
   int bulkWriteTxOnly (PortHandler *port, uint8_t *param, uint16_t param_length);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that transmits INST_FAST_SYNC_READ instruction packet
+  /// @description The function makes an instruction packet with INST_FAST_SYNC_READ,
+  /// @description transmits the packet with Protocol2PacketHandler::txPacket().
+  /// @description The Dynamixels answer one status packet of BROADCAST_ID together, which is received by Protocol2PacketHandler::fastReadRx().
+  /// @param port PortHandler instance
+  /// @param start_address Address of the data for Fast Sync Read
+  /// @param data_length Length of the data for Fast Sync Read
+  /// @param param Parameter for Fast Sync Read {ID1, ID2, ID3, ...}
+  /// @param param_length Length of the data for Fast Sync Read
+  /// @return communication results which come from Protocol2PacketHandler::txPacket()
+  ////////////////////////////////////////////////////////////////////////////////
+  int fastSyncReadTx  (PortHandler *port, uint16_t start_address, uint16_t data_length, uint8_t *param, uint16_t param_length);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that transmits INST_FAST_BULK_READ instruction packet
+  /// @description The function makes an instruction packet with INST_FAST_BULK_READ,
+  /// @description transmits the packet with Protocol2PacketHandler::txPacket().
+  /// @description The Dynamixels answer one status packet of BROADCAST_ID together, which is received by Protocol2PacketHandler::fastReadRx().
+  /// @param port PortHandler instance
+  /// @param param Parameter for Fast Bulk Read {ID1, ADDR_L1, ADDR_H1, LEN_L1, LEN_H1, ID2, ADDR_L2, ADDR_H2, LEN_L2, LEN_H2, ...}
+  /// @param param_length Length of the data for Fast Bulk Read
+  /// @return communication results which come from Protocol2PacketHandler::txPacket()
+  ////////////////////////////////////////////////////////////////////////////////
+  int fastBulkReadTx  (PortHandler *port, uint8_t *param, uint16_t param_length);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that receives the status packet of Fast Sync Read or Fast Bulk Read
+  /// @description The function receives the status packet of BROADCAST_ID with Protocol2PacketHandler::rxPacket(),
+  /// @description whose parameters are {ERR1, ID1, DATA1..., CRC16_L1, CRC16_H1, ERR2, ID2, DATA2..., CRC16_L2, CRC16_H2, ...}
+  /// @description (the CRC16 of the last Dynamixel is that of the packet), and copies the data of each Dynamixel to the data of its request.
+  /// @description A Dynamixel without Fast Sync Read and Fast Bulk Read answers with an instruction error or does not answer,
+  /// @description and the status packet is cut off at it.
+  /// @param port PortHandler instance
+  /// @param requests Dynamixels in the order of the instruction packet (id, length and data), which get their result and error
+  /// @param count Number of the requests
+  /// @return COMM_NOT_AVAILABLE
+  /// @return   when a Dynamixel answers its own status packet instead (instruction error)
+  /// @return COMM_RX_CORRUPT
+  /// @return   when the status packet does not match the requests
+  /// @return or the other communication results which come from Protocol2PacketHandler::rxPacket()
+  ////////////////////////////////////////////////////////////////////////////////
+  int fastReadRx      (PortHandler *port, PacketRequest *requests, int count);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that transmits the instruction packets of several requests back to back and receives their status packets
+  /// @description The function makes an instruction packet for each of requests (INST_PING, INST_READ, INST_WRITE or INST_REG_WRITE),
+  /// @description transmits them back to back in one packet transaction, without waiting for the status packets in between,
+  /// @description then receives the status packets with Protocol2PacketHandler::rxPacket() and matches them to the requests by ID and order.
+  /// @description A request whose status packet is not found before the status packet of a later request gets COMM_RX_TIMEOUT.
+  /// @description The requests to BROADCAST_ID are transmitted without a status packet, except INST_PING and INST_READ, which are not available.
+  /// @param port PortHandler instance
+  /// @param requests Requests, which get their result, error and data read
+  /// @param count Number of the requests
+  /// @return COMM_SUCCESS
+  /// @return   when every request succeeds
+  /// @return or the result of the first request failed
+  ////////////////////////////////////////////////////////////////////////////////
+  int txRxPackets     (PortHandler *port, PacketRequest *requests, int count);
 };
 
 }
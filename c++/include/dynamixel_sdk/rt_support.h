@@ -0,0 +1,148 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file The file for the real-time settings of the bus and control threads in Linux
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_LINUX_RTSUPPORT_H_
+#define DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_LINUX_RTSUPPORT_H_
+
+
+#include <stdint.h>
+#include <vector>
+
+namespace dynamixel
+{
+
+#define RT_NOT_REQUESTED    -1      // result of a setting not requested in RtConfig
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief The struct of the real-time settings applied to a thread by RtSupport::apply()
+////////////////////////////////////////////////////////////////////////////////
+struct RtConfig
+{
+  static const int CPU_ISOLATED_ = -2;  ///< cpu: the first CPU isolated from the scheduler (isolcpus=)
+
+  int       priority;                   ///< SCHED_FIFO priority (1 ~ 99, 0: the policy is not changed)
+  int       cpu;                        ///< CPU the thread is pinned to (-1: not pinned, CPU_ISOLATED_)
+  bool      lock_memory;                ///< whether the pages of the process are locked by mlockall(MCL_CURRENT | MCL_FUTURE)
+  int       stack_prefault;             ///< bytes of the stack touched in advance so the loop takes no page fault on it (0: none)
+
+  RtConfig() : priority(0), cpu(-1), lock_memory(false), stack_prefault(0) { }
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief The struct of the results of the settings applied by RtSupport::apply()
+/// @description Each result is 0 when the setting took effect, RT_NOT_REQUESTED, or the error number (ex. EPERM).
+////////////////////////////////////////////////////////////////////////////////
+struct RtStatus
+{
+  int       priority;                   ///< result of the SCHED_FIFO priority
+  int       affinity;                   ///< result of the CPU pinning
+  int       memory;                     ///< result of mlockall()
+  int       stack;                      ///< result of the stack prefault
+  int       cpu;                        ///< CPU the thread is pinned to (-1: not pinned)
+};
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief The class of the functions which make a thread run a control loop or the I/O of a bus in real time in Linux
+/// @description The settings are applied to the calling thread (ex. the control loop),
+/// @description or to the I/O threads of BusExecutor by BusExecutor::addPort().
+/// @description SCHED_FIFO and mlockall() need CAP_SYS_NICE and CAP_IPC_LOCK (or RLIMIT_RTPRIO and RLIMIT_MEMLOCK).
+/// @description Each function returns 0 when the setting took effect, or the error number.
+////////////////////////////////////////////////////////////////////////////////
+class RtSupport
+{
+ public:
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that applies the settings to the calling thread
+  /// @param config Settings
+  /// @param status Results of the settings (can be NULL)
+  /// @return false
+  /// @return   when a setting requested did not take effect
+  /// @return or true
+  ////////////////////////////////////////////////////////////////////////////////
+  static bool apply(const RtConfig &config, RtStatus *status);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that sets SCHED_FIFO of the priority to the calling thread
+  /// @param priority Priority (1 ~ 99, 0: SCHED_OTHER)
+  /// @return 0 or error number
+  ////////////////////////////////////////////////////////////////////////////////
+  static int  setPriority(int priority);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that pins the calling thread to a CPU
+  /// @param cpu CPU (-1: every CPU)
+  /// @return 0 or error number
+  ////////////////////////////////////////////////////////////////////////////////
+  static int  setAffinity(int cpu);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that locks the pages of the process, present and future, in memory
+  /// @return 0 or error number
+  ////////////////////////////////////////////////////////////////////////////////
+  static int  lockMemory();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that touches the stack of the calling thread in advance
+  /// @description With the memory locked, the pages touched stay resident.
+  /// @param size Bytes of the stack below the caller
+  /// @return 0 or error number (ENOMEM: larger than the stack limit)
+  ////////////////////////////////////////////////////////////////////////////////
+  static int  prefaultStack(int size);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that gets the CPUs isolated from the scheduler (/sys/devices/system/cpu/isolated)
+  /// @param cpus CPUs returned
+  /// @return Number of CPUs isolated
+  ////////////////////////////////////////////////////////////////////////////////
+  static int  getIsolatedCpus(std::vector<int> &cpus);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns the description of a result
+  /// @param result Result of a setting in RtStatus
+  /// @return "applied", "not requested", or the description of the error number
+  ////////////////////////////////////////////////////////////////////////////////
+  static const char *getResultString(int result);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that prints the results of the settings
+  /// @param name Name of the thread printed
+  /// @param status Results of RtSupport::apply()
+  ////////////////////////////////////////////////////////////////////////////////
+  static void printStatus(const char *name, const RtStatus &status);
+};
+
+}
+
+
+#endif /* DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_LINUX_RTSUPPORT_H_ */
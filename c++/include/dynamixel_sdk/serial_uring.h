@@ -0,0 +1,174 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file The file for the io_uring instance shared by serial ports in Linux
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_LINUX_SERIALURING_H_
+#define DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_LINUX_SERIALURING_H_
+
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace dynamixel
+{
+
+class PortHandlerLinux;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief The class of an io_uring instance which runs the reads and writes of PortHandlerLinux ports
+/// @description A port given to PortHandlerLinux::setUring() writes by IORING_OP_WRITE with a linked timeout,
+/// @description and keeps a read (IORING_OP_POLL_ADD linked to IORING_OP_READ) submitted into its receive ring buffer.
+/// @description The completions of every port are taken whenever one of the ports waits,
+/// @description so one thread can drive many ports with one io_uring_enter() per wait.
+/// @description Between SerialUring::beginBatch() and SerialUring::endBatch(), the writes of every port
+/// @description (ex. GroupSyncRead::txPacket() on each bus) are submitted together.
+/// @description The instance and its ports should be used by one thread.
+/// @description The ports should be closed or detached (PortHandlerLinux::setUring(NULL)) before the instance is deleted.
+////////////////////////////////////////////////////////////////////////////////
+class SerialUring
+{
+ private:
+  int           ring_fd_;
+  uint8_t      *ring_;
+  size_t        ring_size_;
+  io_uring_sqe *sqes_;
+  size_t        sqes_size_;
+  io_uring_cqe *cqes_;
+
+  uint32_t     *sq_head_;
+  uint32_t     *sq_tail_;
+  uint32_t     *sq_array_;
+  uint32_t      sq_mask_;
+  uint32_t      sq_entries_;
+  uint32_t      sq_local_tail_;             // tail of the entries prepared, published by SerialUring::enter()
+
+  uint32_t     *cq_head_;
+  uint32_t     *cq_tail_;
+  uint32_t      cq_mask_;
+
+  int           batch_depth_;
+
+ public:
+  static const int DEFAULT_ENTRIES_ = 256;  ///< Default number of submission queue entries
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that sets up an io_uring instance
+  /// @description SerialUring::isAvailable() returns false when the kernel does not support io_uring
+  /// @description (before 5.11, or disabled by seccomp or sysctl) or the SDK was built without the kernel headers of 5.11,
+  /// @description and the ports keep the read()/write() path.
+  /// @param entries Number of submission queue entries (rounded up to a power of 2 by the kernel)
+  ////////////////////////////////////////////////////////////////////////////////
+  SerialUring(int entries = DEFAULT_ENTRIES_);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that closes the io_uring instance
+  ////////////////////////////////////////////////////////////////////////////////
+  virtual ~SerialUring();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that checks whether the io_uring instance is set up
+  ////////////////////////////////////////////////////////////////////////////////
+  bool    isAvailable();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that holds the submissions until SerialUring::endBatch()
+  /// @description Calls can be nested.
+  ////////////////////////////////////////////////////////////////////////////////
+  void    beginBatch();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that submits the requests held since SerialUring::beginBatch() by one io_uring_enter()
+  ////////////////////////////////////////////////////////////////////////////////
+  void    endBatch();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that makes room for entries to be prepared
+  /// @description The function submits the entries prepared when the queue has not enough room,
+  /// @description so the entries linked by IOSQE_IO_LINK are submitted together.
+  /// @param count Number of entries to be prepared by SerialUring::getEntry()
+  ////////////////////////////////////////////////////////////////////////////////
+  void    reserve(int count);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns a submission queue entry cleared
+  /// @description The room should be made by SerialUring::reserve() in advance.
+  /// @return Entry, which is submitted by the next SerialUring::submit() or SerialUring::enter()
+  ////////////////////////////////////////////////////////////////////////////////
+  io_uring_sqe *getEntry();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns the sequence number of the entry returned by the next SerialUring::getEntry()
+  ////////////////////////////////////////////////////////////////////////////////
+  uint32_t getSequence();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns an entry prepared and not submitted yet, so it can be changed
+  /// @param sequence Sequence number of the entry (SerialUring::getSequence() before SerialUring::getEntry())
+  /// @return NULL
+  /// @return   when the entry has been submitted
+  /// @return or Entry
+  ////////////////////////////////////////////////////////////////////////////////
+  io_uring_sqe *getHeldEntry(uint32_t sequence);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that submits the entries prepared unless a batch is open
+  /// @return -1
+  /// @return   when io_uring_enter() failed
+  /// @return or Number of entries submitted (0: nothing submitted, or held by a batch)
+  ////////////////////////////////////////////////////////////////////////////////
+  int     submit();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that submits the entries prepared and waits for a completion
+  /// @description The completions are passed to their ports.
+  /// @param timeout_ns Time to wait for (0: no wait)
+  /// @return false
+  /// @return   when io_uring_enter() failed
+  /// @return or true
+  ////////////////////////////////////////////////////////////////////////////////
+  bool    enter(int64_t timeout_ns);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that passes the completions posted to their ports without system call
+  /// @return Number of completions
+  ////////////////////////////////////////////////////////////////////////////////
+  int     reap();
+};
+
+}
+
+
+#endif /* DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_LINUX_SERIALURING_H_ */
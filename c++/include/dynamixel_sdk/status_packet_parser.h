@@ -0,0 +1,238 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+////////////////////////////////////////////////////////////////////////////////
+/// @file The file for the incremental parser of status packets
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_STATUSPACKETPARSER_H_
+#define DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_STATUSPACKETPARSER_H_
+
+
+#include "packet_handler.h"
+
+namespace dynamixel
+{
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief The class that finds the status packets of Protocol 1.0 or 2.0 in the bytes received, as they arrive
+/// @description The bytes are kept in a ring buffer and parsed when they are written:
+/// @description the header, ID, length and instruction are checked as they arrive, and the checksum or CRC
+/// @description when the last byte of a packet arrives. A header which turns out to be wrong is searched again
+/// @description from its second byte, which parses again at most the bytes of a header, so nothing is moved in the buffer.
+/// @description Any number of packets may be written at a time (ex. the status packets of Sync Read or Bulk Read),
+/// @description and the packets found are taken in order by StatusPacketParser::popFrame(),
+/// @description which removes the byte stuffing of Protocol 2.0 while copying.
+/// @description PortHandler::getStatusParser() gives the parser of a port, which is used by the packet handlers.
+////////////////////////////////////////////////////////////////////////////////
+class WINDECLSPEC StatusPacketParser
+{
+ public:
+#if defined(ARDUINO) || defined(__OPENCR__) || defined(__OPENCM904__)
+  static const int DEFAULT_CAPACITY_  = 512;  ///< Default size of the ring buffer (the status packets of Protocol 2.0 longer than it are not received)
+#else
+  static const int DEFAULT_CAPACITY_  = 8192; ///< Default size of the ring buffer (the longest status packet of Protocol 2.0 is 4103 bytes)
+#endif
+  static const int FRAME_SLOTS_       = 16;   ///< Number of the packets found which are kept until taken
+
+ private:
+  static const int PROTOCOL1_MIN_LENGTH_  = 6;    // HEADER0 HEADER1 ID LENGTH ERROR CHKSUM
+  static const int PROTOCOL2_MIN_LENGTH_  = 11;   // HEADER0 HEADER1 HEADER2 RESERVED ID LENGTH_L LENGTH_H INST ERROR CRC16_L CRC16_H
+
+  struct Frame
+  {
+    uint32_t  start;        // position of the first byte in the ring buffer
+    int       length;       // length including the byte stuffing
+    int       result;       // COMM_SUCCESS or COMM_RX_CORRUPT (checksum or CRC error)
+  };
+
+  uint8_t  *buffer_;
+  uint32_t  capacity_;
+  uint32_t  mask_;
+  uint32_t  tail_;          // position after the last byte written
+  uint32_t  scan_;          // position of the next byte to be parsed
+  uint32_t  frame_start_;   // position of the first byte of the packet being parsed
+  int       frame_length_;  // length of the packet being parsed (0: not known yet)
+  int       protocol_;      // 1 or 2
+  int       skipped_;       // bytes skipped to find the packets, not taken by takeSkippedLength() yet
+
+  Frame     frames_[FRAME_SLOTS_];
+  int       frame_head_;
+  int       frame_count_;
+
+  void      parse();
+  uint32_t  getHead() { return (frame_count_ > 0) ? frames_[frame_head_].start : frame_start_; }
+
+ public:
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that initializes instance of StatusPacketParser for Protocol 2.0
+  /// @param capacity Size of the ring buffer, rounded up to a power of 2
+  ////////////////////////////////////////////////////////////////////////////////
+  StatusPacketParser(int capacity = DEFAULT_CAPACITY_);
+
+  virtual ~StatusPacketParser();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that discards the bytes and the packets kept, and sets the protocol of the packets
+  /// @param protocol_version Protocol version (1.0 or 2.0)
+  ////////////////////////////////////////////////////////////////////////////////
+  void      begin(float protocol_version) { protocol_ = (protocol_version == 1.0) ? 1 : 2; reset(); }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that discards the bytes and the packets kept
+  ////////////////////////////////////////////////////////////////////////////////
+  void      reset()
+  {
+    tail_         = 0;
+    scan_         = 0;
+    frame_start_  = 0;
+    frame_length_ = 0;
+    skipped_      = 0;
+    frame_head_   = 0;
+    frame_count_  = 0;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that copies bytes received to the parser, and parses them
+  /// @param data Bytes received
+  /// @param length Length of the bytes
+  /// @return Length of the bytes taken, which is shorter than length when the ring buffer is full
+  ////////////////////////////////////////////////////////////////////////////////
+  int       feed(const uint8_t *data, int length);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns where the next bytes received are to be written
+  /// @description PortHandler::readPort() can read into the ring buffer directly,
+  /// @description up to StatusPacketParser::getWritableLength(), and StatusPacketParser::commit() parses the bytes.
+  /// @return Pointer in the ring buffer
+  ////////////////////////////////////////////////////////////////////////////////
+  uint8_t  *getWritePointer() { return &buffer_[tail_ & mask_]; }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns how many bytes can be written from StatusPacketParser::getWritePointer()
+  /// @return Length of the space in a row
+  ////////////////////////////////////////////////////////////////////////////////
+  int       getWritableLength();
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that parses bytes written from StatusPacketParser::getWritePointer()
+  /// @param length Length of the bytes written
+  ////////////////////////////////////////////////////////////////////////////////
+  void      commit(int length) { if (length > 0) { tail_ += length; parse(); } }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns how many bytes are needed for the packet being parsed
+  /// @description Reading no more than this length never takes a byte after the packet.
+  /// @description The length of the shortest status packet is used until the length of the packet arrives.
+  /// @return Length of the bytes needed, no more than StatusPacketParser::getWritableLength()
+  ////////////////////////////////////////////////////////////////////////////////
+  int       getNeededLength()
+  {
+    int expected = frame_length_;
+    if (expected == 0)
+      expected = (protocol_ == 1) ? PROTOCOL1_MIN_LENGTH_ : PROTOCOL2_MIN_LENGTH_;
+
+    int needed = expected - (int)(tail_ - frame_start_);
+    if (needed <= 0)
+      return 0;
+
+    // no more than StatusPacketParser::getWritableLength()
+    int space  = (int)(capacity_ - (tail_ - getHead()));
+    int to_end = (int)(capacity_ - (tail_ & mask_));
+    if (needed > space)
+      needed = space;
+    if (needed > to_end)
+      needed = to_end;
+    return needed;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that checks whether bytes of a packet not completed are kept
+  /// @return true
+  /// @return   when a header has been found and the rest of the packet has not arrived
+  /// @return or false
+  ////////////////////////////////////////////////////////////////////////////////
+  bool      isParsing() { return tail_ != frame_start_; }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns the number of the packets found and not taken
+  /// @return Number of the packets
+  ////////////////////////////////////////////////////////////////////////////////
+  int       getFrameCount() { return frame_count_; }
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that takes the first packet found
+  /// @description The function copies the packet to packet, removing the byte stuffing of a packet of Protocol 2.0
+  /// @description which passes CRC. A packet which fails the checksum or CRC is copied as it was received.
+  /// @description A packet longer than capacity is skipped (counted by StatusPacketParser::takeSkippedLength()),
+  /// @description and the next packet found is taken.
+  /// @param packet Buffer for the packet
+  /// @param capacity Length of packet
+  /// @param length Length of the packet copied (NULL: not returned)
+  /// @return COMM_RX_WAITING
+  /// @return   when no packet has been found
+  /// @return COMM_RX_CORRUPT
+  /// @return   when the packet fails the checksum or CRC
+  /// @return or COMM_SUCCESS
+  ////////////////////////////////////////////////////////////////////////////////
+  int       popFrame(uint8_t *packet, int capacity, int *length = 0);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that checks the header of a status packet read without the parser
+  /// @description The packet handlers read a status packet which has already arrived whole into their buffer directly,
+  /// @description and parse the bytes read only when they are not a status packet.
+  /// @param header Bytes received, as long as the shortest status packet
+  /// @return Length of the packet
+  /// @return or 0 when the bytes do not begin with the header of a status packet
+  ////////////////////////////////////////////////////////////////////////////////
+  int       getPacketLength(const uint8_t *header);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that checks the checksum or CRC of a status packet read without the parser
+  /// @description The function removes the byte stuffing of a packet of Protocol 2.0 which passes CRC, as StatusPacketParser::popFrame() does.
+  /// @param packet Status packet, of the length returned by StatusPacketParser::getPacketLength()
+  /// @param length Length of the packet, which is set to the length after removing the byte stuffing
+  /// @return COMM_RX_CORRUPT
+  /// @return   when the packet fails the checksum or CRC
+  /// @return or COMM_SUCCESS
+  ////////////////////////////////////////////////////////////////////////////////
+  int       checkPacket(uint8_t *packet, int *length);
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief The function that returns the bytes skipped to find the packets since the last call
+  /// @return Length of the bytes skipped
+  ////////////////////////////////////////////////////////////////////////////////
+  int       takeSkippedLength() { int skipped = skipped_; skipped_ = 0; return skipped; }
+};
+
+}
+
+
+#endif /* DYNAMIXEL_SDK_INCLUDE_DYNAMIXEL_SDK_STATUSPACKETPARSER_H_ */
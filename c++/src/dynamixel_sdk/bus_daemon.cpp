@@ -0,0 +1,420 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#if defined(__linux__)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <vector>
+
+#include "bus_daemon.h"
+
+namespace dynamixel
+{
+
+struct BusDaemonClient
+{
+  int               fd;
+  BusDaemonClient  *next;
+
+  bool              waiting;      // a write is waiting for the bus
+  int               priority;
+  uint32_t          sequence;
+  uint8_t           flags;
+  int               length;
+  uint8_t           data[BUS_MESSAGE_DATA_MAX];
+};
+
+}
+
+using namespace dynamixel;
+
+static int64_t getCurrentTimeNs()
+{
+  struct timespec tv;
+  clock_gettime(CLOCK_MONOTONIC, &tv);
+  return (int64_t)tv.tv_sec * 1000000000LL + (int64_t)tv.tv_nsec;
+}
+
+BusDaemon::BusDaemon(PortHandlerLinux *port)
+  : port_(port),
+    listen_fd_(-1),
+    hold_limit_(DEFAULT_HOLD_LIMIT_),
+    clients_(0),
+    owner_(0),
+    owner_deadline_ns_(0),
+    sequence_(0),
+    transaction_count_(0),
+    expired_count_(0),
+    is_running_(false)
+{
+  wakeup_fd_[0] = -1;
+  wakeup_fd_[1] = -1;
+  socket_path_[0] = '\0';
+}
+
+bool BusDaemon::start(const char *socket_path)
+{
+  struct sockaddr_un addr;
+
+  if (is_running_)
+    return true;
+
+  if (strlen(socket_path) >= sizeof(addr.sun_path))
+  {
+    printf("[BusDaemon::start] Socket path is too long!\n");
+    return false;
+  }
+  strcpy(socket_path_, socket_path);
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, socket_path_);
+  unlink(socket_path_);
+
+  listen_fd_ = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+  if (listen_fd_ < 0 || bind(listen_fd_, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(listen_fd_, 16) != 0)
+  {
+    printf("[BusDaemon::start] Error listening on %s!\n", socket_path_);
+    stop();
+    return false;
+  }
+
+  if (pipe(wakeup_fd_) != 0)
+  {
+    printf("[BusDaemon::start] Error creating pipe!\n");
+    stop();
+    return false;
+  }
+
+  is_running_ = true;
+  if (pthread_create(&thread_, NULL, run, this) != 0)
+  {
+    printf("[BusDaemon::start] Error creating thread!\n");
+    is_running_ = false;
+    stop();
+    return false;
+  }
+  return true;
+}
+
+void BusDaemon::stop()
+{
+  if (is_running_)
+  {
+    char c = 0;
+    if (write(wakeup_fd_[1], &c, 1) == 1)
+      pthread_join(thread_, NULL);
+    is_running_ = false;
+  }
+
+  while (clients_ != 0)
+    removeClient(clients_);
+
+  for (int i = 0; i < 2; i++)
+  {
+    if (wakeup_fd_[i] != -1)
+      close(wakeup_fd_[i]);
+    wakeup_fd_[i] = -1;
+  }
+  if (listen_fd_ != -1)
+  {
+    close(listen_fd_);
+    unlink(socket_path_);
+  }
+  listen_fd_ = -1;
+}
+
+void BusDaemon::setHoldLimit(int msec)
+{
+  hold_limit_ = msec;
+}
+
+uint32_t BusDaemon::getTransactionCount()
+{
+  return transaction_count_;
+}
+
+uint32_t BusDaemon::getExpiredCount()
+{
+  return expired_count_;
+}
+
+bool BusDaemon::sendMessage(int fd, uint8_t type, uint8_t flags, int32_t value, const uint8_t *data, int length)
+{
+  BusMessageHeader  header;
+  struct iovec      iov[2];
+  struct msghdr     msg;
+
+  header.type   = type;
+  header.flags  = flags;
+  header.length = (uint16_t)length;
+  header.value  = value;
+  iov[0].iov_base = &header;
+  iov[0].iov_len  = sizeof(header);
+  iov[1].iov_base = (void *)data;
+  iov[1].iov_len  = length;
+
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov     = iov;
+  msg.msg_iovlen  = (length > 0) ? 2 : 1;
+
+  // a client not reading its socket does not stop the daemon
+  return (sendmsg(fd, &msg, MSG_NOSIGNAL | MSG_DONTWAIT) == (ssize_t)(sizeof(header) + length));
+}
+
+void *BusDaemon::run(void *arg)
+{
+  ((BusDaemon *)arg)->loop();
+  return NULL;
+}
+
+void BusDaemon::loop()
+{
+  std::vector<struct pollfd>      pfd;
+  std::vector<BusDaemonClient *>  polled;
+  int                             hangup_fd = -1;   // port hung up, which is not polled until it is reopened
+
+  while (true)
+  {
+    struct pollfd   fd;
+    struct timespec ts;
+    struct timespec *timeout = NULL;
+
+    pfd.clear();
+    polled.clear();
+    fd.events   = POLLIN;
+    fd.revents  = 0;
+    fd.fd       = wakeup_fd_[0];
+    pfd.push_back(fd);
+    fd.fd       = listen_fd_;
+    pfd.push_back(fd);
+    fd.fd       = port_->getFileDescriptor();
+    if (fd.fd == hangup_fd)
+      fd.fd = -1;
+    pfd.push_back(fd);
+    for (BusDaemonClient *client = clients_; client != 0; client = client->next)
+    {
+      fd.fd = client->fd;
+      pfd.push_back(fd);
+      polled.push_back(client);
+    }
+
+    if (owner_ != 0)
+    {
+      int64_t remaining = owner_deadline_ns_ - getCurrentTimeNs();
+      if (remaining < 0)
+        remaining = 0;
+      ts.tv_sec   = (time_t)(remaining / 1000000000LL);
+      ts.tv_nsec  = (long)(remaining % 1000000000LL);
+      timeout     = &ts;
+    }
+
+    if (ppoll(&pfd[0], pfd.size(), timeout, NULL) < 0)
+      continue;
+    if (pfd[0].revents != 0)
+      break;
+
+    // the bytes of the port are forwarded before the messages, which may end the transaction
+    if (pfd[2].revents & (POLLHUP | POLLERR))
+      hangup_fd = pfd[2].fd;
+    if (pfd[2].revents & POLLIN)
+      forwardRx();
+
+    if (pfd[1].revents & POLLIN)
+      acceptClient();
+
+    for (size_t i = 0; i < polled.size(); i++)
+    {
+      if (pfd[i + 3].revents == 0)
+        continue;
+      if (receiveMessage(polled[i]) == false)
+        removeClient(polled[i]);
+    }
+
+    if (owner_ != 0 && getCurrentTimeNs() >= owner_deadline_ns_)
+    {
+      expired_count_++;
+      releaseBus();
+    }
+    if (owner_ == 0)
+      grantBus();
+  }
+}
+
+void BusDaemon::acceptClient()
+{
+  int fd = accept4(listen_fd_, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+  if (fd < 0)
+    return;
+
+  BusDaemonClient *client = new BusDaemonClient;
+  client->fd        = fd;
+  client->waiting   = false;
+  client->priority  = 0;
+  client->sequence  = 0;
+  client->flags     = 0;
+  client->length    = 0;
+  client->next      = clients_;
+  clients_          = client;
+
+  int32_t latency_timer = port_->getLatencyTimer();
+  sendMessage(fd, BUS_MESSAGE_INFO, 0, port_->getBaudRate(), (uint8_t *)&latency_timer, sizeof(latency_timer));
+}
+
+// receives a message of the client, and returns false when the client is gone
+bool BusDaemon::receiveMessage(BusDaemonClient *client)
+{
+  BusMessageHeader  header;
+  struct iovec      iov[2];
+  struct msghdr     msg;
+
+  iov[0].iov_base = &header;
+  iov[0].iov_len  = sizeof(header);
+  iov[1].iov_base = client->data;
+  iov[1].iov_len  = sizeof(client->data);
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov     = iov;
+  msg.msg_iovlen  = 2;
+
+  int length = recvmsg(client->fd, &msg, MSG_DONTWAIT);
+  if (length < 0)
+    return (errno == EAGAIN || errno == EINTR);
+  if (length < (int)sizeof(header) || (msg.msg_flags & MSG_TRUNC) != 0)
+    return false;
+
+  switch (header.type)
+  {
+    case BUS_MESSAGE_TX:
+      client->flags     = header.flags;
+      client->priority  = header.value;
+      client->length    = length - (int)sizeof(header);
+      if (owner_ == client)
+      {
+        transmit(client);
+      }
+      else
+      {
+        client->waiting   = true;
+        client->sequence  = sequence_++;
+      }
+      break;
+
+    case BUS_MESSAGE_END:
+      if (owner_ == client)
+        releaseBus();
+      break;
+
+    default:
+      break;
+  }
+  return true;
+}
+
+void BusDaemon::removeClient(BusDaemonClient *client)
+{
+  if (owner_ == client)
+    releaseBus();
+
+  for (BusDaemonClient **p = &clients_; *p != 0; p = &(*p)->next)
+  {
+    if (*p == client)
+    {
+      *p = client->next;
+      break;
+    }
+  }
+  close(client->fd);
+  delete client;
+}
+
+// grants the bus to the client waiting with the highest priority, the earliest within the priority
+void BusDaemon::grantBus()
+{
+  BusDaemonClient *best = 0;
+
+  for (BusDaemonClient *client = clients_; client != 0; client = client->next)
+  {
+    if (client->waiting == false)
+      continue;
+    if (best == 0 || client->priority > best->priority ||
+        (client->priority == best->priority && (int32_t)(client->sequence - best->sequence) < 0))
+      best = client;
+  }
+  if (best == 0)
+    return;
+
+  best->waiting       = false;
+  owner_              = best;
+  owner_deadline_ns_  = getCurrentTimeNs() + (int64_t)hold_limit_ * 1000000LL;
+  transaction_count_++;
+  transmit(best);
+}
+
+void BusDaemon::transmit(BusDaemonClient *client)
+{
+  if (client->flags & BUS_MESSAGE_CLEAR)
+    port_->clearPort();
+
+  int result = port_->writePort(client->data, client->length);
+  sendMessage(client->fd, BUS_MESSAGE_TX_DONE, 0, result, 0, 0);
+
+  if (client->flags & BUS_MESSAGE_AUTO_END)
+    releaseBus();
+}
+
+void BusDaemon::releaseBus()
+{
+  owner_ = 0;
+}
+
+// sends the bytes read to the client holding the bus, or drops them when no client holds it
+void BusDaemon::forwardRx()
+{
+  uint8_t buffer[BUS_MESSAGE_DATA_MAX];
+  int     length;
+
+  while ((length = port_->readPort(buffer, sizeof(buffer))) > 0)
+  {
+    if (owner_ != 0)
+      sendMessage(owner_->fd, BUS_MESSAGE_RX, 0, 0, buffer, length);
+  }
+}
+
+#endif
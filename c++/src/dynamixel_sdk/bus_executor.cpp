@@ -0,0 +1,270 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#if defined(__linux__)
+
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#include "bus_executor.h"
+
+using namespace dynamixel;
+
+static int64_t getCurrentTimeNs()
+{
+  struct timespec tv;
+  clock_gettime(CLOCK_MONOTONIC, &tv);
+  return (int64_t)tv.tv_sec * 1000000000LL + (int64_t)tv.tv_nsec;
+}
+
+// sleeps while *index is value, unless the other side has published a new value in the meantime
+static void waitIndex(uint32_t *index, uint32_t value, uint32_t *waiting)
+{
+  __atomic_store_n(waiting, 1, __ATOMIC_SEQ_CST);
+  if (__atomic_load_n(index, __ATOMIC_SEQ_CST) == value)
+    syscall(SYS_futex, index, FUTEX_WAIT_PRIVATE, value, NULL, NULL, 0);
+  __atomic_store_n(waiting, 0, __ATOMIC_RELAXED);
+}
+
+// publishes a new value of *index, and wakes the other side only when it sleeps
+static void publishIndex(uint32_t *index, uint32_t value, uint32_t *waiting)
+{
+  __atomic_store_n(index, value, __ATOMIC_SEQ_CST);
+  if (__atomic_load_n(waiting, __ATOMIC_SEQ_CST) != 0)
+    syscall(SYS_futex, index, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+}
+
+BusExecutor::~BusExecutor()
+{
+  waitAll();
+
+  for (size_t i = 0; i < buses_.size(); i++)
+  {
+    // a command without function stops the thread
+    Bus *bus = buses_[i];
+    bus->commands[bus->command_write % QUEUE_SIZE_].function = 0;
+    publishIndex(&bus->command_write, bus->command_write + 1, &bus->io_waiting);
+    pthread_join(bus->thread, NULL);
+    delete bus;
+  }
+  buses_.clear();
+}
+
+// arguments of BusExecutor::applyRtConfig()
+struct RtArgs
+{
+  const RtConfig *config;
+  RtStatus        status;
+};
+
+int BusExecutor::addPort(PortHandler *port, const RtConfig *rt_config, RtStatus *rt_status)
+{
+  Bus *bus = new Bus();
+  bus->port             = port;
+  bus->command_write    = 0;
+  bus->completion_read  = 0;
+  bus->host_waiting     = 0;
+  bus->command_read     = 0;
+  bus->completion_write = 0;
+  bus->io_waiting       = 0;
+
+  if (pthread_create(&bus->thread, NULL, run, bus) != 0)
+  {
+    printf("[BusExecutor::addPort] Error creating thread!\n");
+    delete bus;
+    return -1;
+  }
+
+  buses_.push_back(bus);
+  int index = (int)buses_.size() - 1;
+
+  // the settings are applied on the I/O thread as the first command
+  if (rt_config != 0)
+  {
+    RtArgs        args;
+    BusCompletion completion;
+    args.config = rt_config;
+    submit(index, applyRtConfig, &args);
+    waitCompletion(index, &completion);
+    if (rt_status != 0)
+      *rt_status = args.status;
+  }
+  return index;
+}
+
+int BusExecutor::applyRtConfig(PortHandler *port, void *arg)
+{
+  RtArgs *args = (RtArgs *)arg;
+  RtSupport::apply(*args->config, &args->status);
+  return COMM_SUCCESS;
+}
+
+int BusExecutor::getBusCount()
+{
+  return (int)buses_.size();
+}
+
+void *BusExecutor::run(void *arg)
+{
+  Bus *bus = (Bus *)arg;
+
+  while (true)
+  {
+    uint32_t read   = bus->command_read;
+    uint32_t write  = __atomic_load_n(&bus->command_write, __ATOMIC_ACQUIRE);
+    if (read == write)
+    {
+      waitIndex(&bus->command_write, write, &bus->io_waiting);
+      continue;
+    }
+
+    Command       *command    = &bus->commands[read % QUEUE_SIZE_];
+    if (command->function == 0)
+      break;
+
+    BusCompletion *completion = &bus->completions[bus->completion_write % QUEUE_SIZE_];
+    completion->tag       = command->tag;
+    completion->start_ns  = getCurrentTimeNs();
+    completion->result    = command->function(bus->port, command->arg);
+    completion->end_ns    = getCurrentTimeNs();
+
+    // the slot of the completion is free as the control loop keeps at most QUEUE_SIZE_ commands not waited for
+    __atomic_store_n(&bus->command_read, read + 1, __ATOMIC_RELEASE);
+    publishIndex(&bus->completion_write, bus->completion_write + 1, &bus->host_waiting);
+  }
+  return NULL;
+}
+
+bool BusExecutor::submit(int bus_index, BusFunction function, void *arg, uint32_t tag)
+{
+  if (bus_index < 0 || bus_index >= (int)buses_.size() || function == 0)
+    return false;
+
+  Bus *bus = buses_[bus_index];
+  if (bus->command_write - bus->completion_read >= QUEUE_SIZE_)
+    return false;
+
+  Command *command  = &bus->commands[bus->command_write % QUEUE_SIZE_];
+  command->function = function;
+  command->arg      = arg;
+  command->tag      = tag;
+  publishIndex(&bus->command_write, bus->command_write + 1, &bus->io_waiting);
+  return true;
+}
+
+bool BusExecutor::submitTxRx(int bus, GroupSyncRead *group, uint32_t tag)
+{
+  return submit(bus, syncReadTxRx, group, tag);
+}
+
+bool BusExecutor::submitTxRx(int bus, GroupBulkRead *group, uint32_t tag)
+{
+  return submit(bus, bulkReadTxRx, group, tag);
+}
+
+bool BusExecutor::submitTx(int bus, GroupSyncWrite *group, uint32_t tag)
+{
+  return submit(bus, syncWriteTx, group, tag);
+}
+
+bool BusExecutor::submitTx(int bus, GroupBulkWrite *group, uint32_t tag)
+{
+  return submit(bus, bulkWriteTx, group, tag);
+}
+
+int BusExecutor::syncReadTxRx(PortHandler *port, void *group)
+{
+  return ((GroupSyncRead *)group)->txRxPacket();
+}
+
+int BusExecutor::bulkReadTxRx(PortHandler *port, void *group)
+{
+  return ((GroupBulkRead *)group)->txRxPacket();
+}
+
+int BusExecutor::syncWriteTx(PortHandler *port, void *group)
+{
+  return ((GroupSyncWrite *)group)->txPacket();
+}
+
+int BusExecutor::bulkWriteTx(PortHandler *port, void *group)
+{
+  return ((GroupBulkWrite *)group)->txPacket();
+}
+
+bool BusExecutor::pollCompletion(int bus_index, BusCompletion *completion)
+{
+  if (bus_index < 0 || bus_index >= (int)buses_.size())
+    return false;
+
+  Bus *bus = buses_[bus_index];
+  if (bus->completion_read == __atomic_load_n(&bus->completion_write, __ATOMIC_ACQUIRE))
+    return false;
+
+  *completion = bus->completions[bus->completion_read % QUEUE_SIZE_];
+  bus->completion_read++;
+  return true;
+}
+
+bool BusExecutor::waitCompletion(int bus_index, BusCompletion *completion)
+{
+  if (bus_index < 0 || bus_index >= (int)buses_.size())
+    return false;
+
+  Bus *bus = buses_[bus_index];
+  while (pollCompletion(bus_index, completion) == false)
+  {
+    if (bus->completion_read == bus->command_write)
+      return false;
+    waitIndex(&bus->completion_write, bus->completion_read, &bus->host_waiting);
+  }
+  return true;
+}
+
+int BusExecutor::waitAll()
+{
+  int           result = COMM_SUCCESS;
+  BusCompletion completion;
+
+  for (size_t i = 0; i < buses_.size(); i++)
+  {
+    while (waitCompletion((int)i, &completion))
+    {
+      if (result == COMM_SUCCESS)
+        result = completion.result;
+    }
+  }
+  return result;
+}
+
+#endif
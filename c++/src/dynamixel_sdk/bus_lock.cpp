@@ -0,0 +1,292 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#if defined(__linux__) || defined(__APPLE__)
+#include <time.h>
+#include <sys/time.h>
+#include "bus_lock.h"
+#elif defined(_WIN32) || defined(_WIN64)
+#define WINDLLEXPORT
+#include "bus_lock.h"
+#elif defined(ARDUINO) || defined(__OPENCR__) || defined(__OPENCM904__)
+#include "../../include/dynamixel_sdk/bus_lock.h"
+#endif
+
+// owner_ and depth_ are written with the mutex locked (depth_ also by the owner alone),
+// and read without it: depth_ is read before owner_, which is written before depth_
+#if defined(_MSC_VER)
+#include <intrin.h>
+template <typename T> static inline T loadAcquire(T *p)           { T v = *(volatile T *)p; _ReadWriteBarrier(); return v; }
+template <typename T> static inline void storeRelease(T *p, T v)  { _ReadWriteBarrier(); *(volatile T *)p = v; }
+#else
+template <typename T> static inline T loadAcquire(T *p)           { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+template <typename T> static inline void storeRelease(T *p, T v)  { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+#endif
+
+namespace dynamixel
+{
+
+// a thread waiting for the lock, on its own stack
+struct BusLockWaiter
+{
+  int             priority;
+  bool            granted;      // the lock has been handed over to the thread
+#if defined(__linux__) || defined(__APPLE__)
+  pthread_t       thread;
+#elif defined(_WIN32) || defined(_WIN64)
+  DWORD           thread;
+#endif
+  BusLockWaiter  *next;
+};
+
+}
+
+using namespace dynamixel;
+
+BusLock::BusLock()
+  : depth_(0),
+    waiters_(0)
+{
+#if defined(__linux__)
+  pthread_condattr_t attr;
+  pthread_condattr_init(&attr);
+  pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+  pthread_mutex_init(&mutex_, NULL);
+  pthread_cond_init(&cond_, &attr);
+  pthread_condattr_destroy(&attr);
+#elif defined(__APPLE__)
+  pthread_mutex_init(&mutex_, NULL);
+  pthread_cond_init(&cond_, NULL);
+#elif defined(_WIN32) || defined(_WIN64)
+  InitializeSRWLock(&mutex_);
+  InitializeConditionVariable(&cond_);
+  owner_ = 0;
+#endif
+}
+
+BusLock::~BusLock()
+{
+#if defined(__linux__) || defined(__APPLE__)
+  pthread_cond_destroy(&cond_);
+  pthread_mutex_destroy(&mutex_);
+#endif
+}
+
+void BusLock::lock()
+{
+#if defined(__linux__) || defined(__APPLE__)
+  pthread_mutex_lock(&mutex_);
+#elif defined(_WIN32) || defined(_WIN64)
+  AcquireSRWLockExclusive(&mutex_);
+#endif
+}
+
+void BusLock::unlock()
+{
+#if defined(__linux__) || defined(__APPLE__)
+  pthread_mutex_unlock(&mutex_);
+#elif defined(_WIN32) || defined(_WIN64)
+  ReleaseSRWLockExclusive(&mutex_);
+#endif
+}
+
+void BusLock::setOwner()
+{
+#if defined(__linux__) || defined(__APPLE__)
+  storeRelease(&owner_, pthread_self());
+#elif defined(_WIN32) || defined(_WIN64)
+  storeRelease(&owner_, GetCurrentThreadId());
+#endif
+}
+
+// called with or without the mutex locked: only the calling thread makes itself the owner or not,
+// and owner_ is not changed while depth_ shows it owned by another thread
+bool BusLock::checkOwner()
+{
+  if (loadAcquire(&depth_) == 0)
+    return false;
+#if defined(__linux__) || defined(__APPLE__)
+  return pthread_equal(loadAcquire(&owner_), pthread_self()) != 0;
+#elif defined(_WIN32) || defined(_WIN64)
+  return loadAcquire(&owner_) == GetCurrentThreadId();
+#else
+  return true;
+#endif
+}
+
+// waits until the lock is handed over to the waiter, called with the mutex locked
+bool BusLock::wait(BusLockWaiter *waiter, double timeout_msec)
+{
+#if defined(__linux__) || defined(__APPLE__)
+  struct timespec deadline;
+#if defined(__linux__)
+  clock_gettime(CLOCK_MONOTONIC, &deadline);
+#else
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  deadline.tv_sec  = tv.tv_sec;
+  deadline.tv_nsec = tv.tv_usec * 1000;
+#endif
+  if (timeout_msec > 0)
+  {
+    long long nsec   = deadline.tv_nsec + (long long)(timeout_msec * 1000000.0);
+    deadline.tv_sec += nsec / 1000000000LL;
+    deadline.tv_nsec = nsec % 1000000000LL;
+  }
+
+  while (waiter->granted == false)
+  {
+    if (timeout_msec < 0)
+      pthread_cond_wait(&cond_, &mutex_);
+    else if (pthread_cond_timedwait(&cond_, &mutex_, &deadline) != 0)
+      break;
+  }
+#elif defined(_WIN32) || defined(_WIN64)
+  ULONGLONG deadline = 0;
+  if (timeout_msec >= 0)
+    deadline = GetTickCount64() + (ULONGLONG)timeout_msec;
+  while (waiter->granted == false)
+  {
+    DWORD wait_msec = INFINITE;
+    if (timeout_msec >= 0)
+    {
+      ULONGLONG now = GetTickCount64();
+      if (now >= deadline)
+        break;
+      wait_msec = (DWORD)(deadline - now);
+    }
+    SleepConditionVariableSRW(&cond_, &mutex_, wait_msec, 0);
+  }
+#else
+  (void)timeout_msec;
+#endif
+  return waiter->granted;
+}
+
+bool BusLock::acquire(double timeout_msec, int priority)
+{
+  // the owner acquires again without the mutex
+  if (checkOwner())
+  {
+    storeRelease(&depth_, depth_ + 1);
+    return true;
+  }
+
+  lock();
+  if (depth_ == 0 && waiters_ == 0)
+  {
+    setOwner();
+    storeRelease(&depth_, 1);
+    unlock();
+    return true;
+  }
+  if (timeout_msec == 0)
+  {
+    unlock();
+    return false;
+  }
+
+  // joins the queue behind the threads of the same or higher priority
+  BusLockWaiter waiter;
+  waiter.priority = priority;
+  waiter.granted  = false;
+#if defined(__linux__) || defined(__APPLE__)
+  waiter.thread   = pthread_self();
+#elif defined(_WIN32) || defined(_WIN64)
+  waiter.thread   = GetCurrentThreadId();
+#endif
+  BusLockWaiter **position = &waiters_;
+  while (*position != 0 && (*position)->priority >= priority)
+    position = &(*position)->next;
+  waiter.next = *position;
+  *position   = &waiter;
+
+  if (wait(&waiter, timeout_msec) == false)
+  {
+    // leaves the queue
+    for (position = &waiters_; *position != 0; position = &(*position)->next)
+    {
+      if (*position == &waiter)
+      {
+        *position = waiter.next;
+        break;
+      }
+    }
+    unlock();
+    return false;
+  }
+  unlock();
+  return true;
+}
+
+void BusLock::release()
+{
+  // the owner releases other than the last acquisition without the mutex
+  if (checkOwner() == false)
+    return;
+  if (depth_ > 1)
+  {
+    storeRelease(&depth_, depth_ - 1);
+    return;
+  }
+
+  lock();
+
+  // hands the lock over to the head of the queue, which keeps depth_ 1
+  BusLockWaiter *waiter = waiters_;
+  if (waiter == 0)
+  {
+    storeRelease(&depth_, 0);
+  }
+  else
+  {
+    waiters_        = waiter->next;
+    waiter->granted = true;
+#if defined(__linux__) || defined(__APPLE__) || defined(_WIN32) || defined(_WIN64)
+    storeRelease(&owner_, waiter->thread);
+#endif
+#if defined(__linux__) || defined(__APPLE__)
+    pthread_cond_broadcast(&cond_);
+#elif defined(_WIN32) || defined(_WIN64)
+    WakeAllConditionVariable(&cond_);
+#endif
+  }
+  unlock();
+}
+
+bool BusLock::isOwner()
+{
+  return checkOwner();
+}
+
+int BusLock::getDepth()
+{
+  return checkOwner() ? depth_ : 0;
+}
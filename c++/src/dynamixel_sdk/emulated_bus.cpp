@@ -0,0 +1,908 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include <string.h>
+
+#if defined(__linux__)
+#include "emulated_bus.h"
+#include "packet_handler.h"
+#elif defined(__APPLE__)
+#include "emulated_bus.h"
+#include "packet_handler.h"
+#elif defined(_WIN32) || defined(_WIN64)
+#define WINDLLEXPORT
+#include "emulated_bus.h"
+#include "packet_handler.h"
+#elif defined(ARDUINO) || defined(__OPENCR__) || defined(__OPENCM904__)
+#include "../../include/dynamixel_sdk/emulated_bus.h"
+#include "../../include/dynamixel_sdk/packet_handler.h"
+#endif
+
+#define PACKET_MAX_LEN          (4*1024)
+
+///////////////// for Protocol 1.0 Packet /////////////////
+#define PKT1_ID                 2
+#define PKT1_LENGTH             3
+#define PKT1_INSTRUCTION        4
+#define PKT1_PARAMETER          5
+
+#define ERRBIT1_RANGE           8       // Command(setting value) is out of the range for use.
+#define ERRBIT1_CHECKSUM        16      // Instruction packet checksum is incorrect.
+#define ERRBIT1_INSTRUCTION     64      // Undefined instruction or delivering the action command without the reg_write command.
+
+///////////////// for Protocol 2.0 Packet /////////////////
+#define PKT2_ID                 4
+#define PKT2_LENGTH_L           5
+#define PKT2_LENGTH_H           6
+#define PKT2_INSTRUCTION        7
+
+#define ERRNUM2_INSTRUCTION     2       // Instruction error
+#define ERRNUM2_CRC             3       // CRC check error
+#define ERRNUM2_DATA_LENGTH     5       // Data length error
+#define ERRNUM2_ACCESS          7       // Access error
+
+using namespace dynamixel;
+
+namespace
+{
+
+// Control table items used by the emulation. Every other item is plain memory.
+struct ControlTableLayout
+{
+  uint16_t  model_number;
+  float     protocol_version;
+  uint16_t  size;
+  uint8_t   firmware_version;
+  uint16_t  addr_firmware_version;
+  uint16_t  addr_id;
+  uint16_t  addr_baudrate;
+  uint16_t  addr_return_delay_time;
+  uint16_t  addr_status_return_level;
+  uint16_t  addr_goal_position;
+  uint16_t  addr_present_position;
+  uint8_t   len_position;
+  uint32_t  initial_position;
+  bool      fast_read;                // answers Fast Sync Read and Fast Bulk Read
+};
+
+const ControlTableLayout LAYOUTS[] =
+{
+  // MX-28 (Protocol 1.0)
+  { 29,    1.0, 74,  30, 2, 3, 4, 5, 16,  30,  36,  2, 2048, false },
+  // H54-200-S500-R (Protocol 2.0)
+  { 54024, 2.0, 916, 38, 6, 7, 8, 9, 891, 596, 611, 4, 0,    false },
+  // XM430-W350 (Protocol 2.0)
+  { 1020,  2.0, 662, 45, 6, 7, 8, 9, 68,  116, 132, 4, 2048, true },
+};
+
+const int NUM_LAYOUTS = sizeof(LAYOUTS) / sizeof(LAYOUTS[0]);
+
+uint16_t updateCRC(uint16_t crc_accum, const uint8_t *data_blk_ptr, uint16_t data_blk_size)
+{
+  for (uint16_t j = 0; j < data_blk_size; j++)
+  {
+    crc_accum ^= (uint16_t)data_blk_ptr[j] << 8;
+    for (int b = 0; b < 8; b++)
+      crc_accum = (crc_accum & 0x8000) ? (uint16_t)((crc_accum << 1) ^ 0x8005) : (uint16_t)(crc_accum << 1);
+  }
+  return crc_accum;
+}
+
+void writeValue(uint8_t *data, uint8_t length, uint32_t value)
+{
+  for (uint8_t i = 0; i < length; i++)
+    data[i] = (uint8_t)(value >> (8 * i));
+}
+
+}
+
+EmulatedBus::EmulatedBus(int baudrate)
+  : rx_end_ns_(0),
+    tx_end_ns_(0),
+    instruction_count_(0)
+{
+  setBaudRate(baudrate);
+}
+
+bool EmulatedBus::addDevice(float protocol_version, uint8_t id, uint16_t model_number)
+{
+  int model = -1;
+  for (int i = 0; i < NUM_LAYOUTS; i++)
+  {
+    if (LAYOUTS[i].protocol_version == protocol_version &&
+        (LAYOUTS[i].model_number == model_number || model_number == 0))
+    {
+      model = i;
+      break;
+    }
+  }
+
+  if (model < 0 || id > MAX_ID || findDevice(protocol_version, id) != 0)
+    return false;
+
+  Device device;
+  device.id     = id;
+  device.model  = model;
+  resetControlTable(&device);
+
+  // keep the devices sorted by ID, which is the order of the broadcast ping response
+  std::vector<Device>::iterator it = devices_.begin();
+  while (it != devices_.end() && it->id < id)
+    ++it;
+  devices_.insert(it, device);
+  return true;
+}
+
+void EmulatedBus::removeDevice(float protocol_version, uint8_t id)
+{
+  Device *device = findDevice(protocol_version, id);
+  if (device != 0)
+    devices_.erase(devices_.begin() + (device - &devices_[0]));
+}
+
+uint8_t *EmulatedBus::getControlTable(float protocol_version, uint8_t id, uint16_t *length)
+{
+  Device *device = findDevice(protocol_version, id);
+  if (device == 0)
+    return 0;
+
+  if (length != 0)
+    *length = (uint16_t)device->table.size();
+  return &device->table[0];
+}
+
+void EmulatedBus::setReturnDelayTime(int usec)
+{
+  int value = usec / 2;
+  if (value < 0)    value = 0;
+  if (value > 254)  value = 254;
+
+  for (size_t i = 0; i < devices_.size(); i++)
+    devices_[i].table[LAYOUTS[devices_[i].model].addr_return_delay_time] = (uint8_t)value;
+}
+
+void EmulatedBus::setBaudRate(int baudrate)
+{
+  baudrate_     = baudrate;
+  byte_time_ns_ = 10LL * 1000000000LL / baudrate;
+}
+
+int EmulatedBus::getBaudRate()
+{
+  return baudrate_;
+}
+
+int64_t EmulatedBus::getByteTimeNs()
+{
+  return byte_time_ns_;
+}
+
+uint32_t EmulatedBus::getInstructionCount()
+{
+  return instruction_count_;
+}
+
+void EmulatedBus::receive(int64_t now_ns, const uint8_t *data, int length)
+{
+  if (length <= 0)
+    return;
+
+  if (rx_end_ns_ < now_ns)
+    rx_end_ns_ = now_ns;
+  rx_end_ns_ += byte_time_ns_ * length;
+  rx_buffer_.insert(rx_buffer_.end(), data, data + length);
+
+  int64_t end_ns;
+  int     packet_length;
+  while ((packet_length = parsePacket(&end_ns)) > 0)
+  {
+    instruction_count_++;
+    if (rx_buffer_[2] == 0xFD && rx_buffer_[3] == 0x00)
+      processPacket2(&rx_buffer_[0], end_ns);
+    else
+      processPacket1(&rx_buffer_[0], end_ns);
+    rx_buffer_.erase(rx_buffer_.begin(), rx_buffer_.begin() + packet_length);
+  }
+}
+
+int64_t EmulatedBus::getReceiveEndTime()
+{
+  return rx_end_ns_;
+}
+
+int EmulatedBus::getBytesAvailable(int64_t now_ns)
+{
+  int available = 0;
+  for (size_t i = 0; i < tx_queue_.size(); i++)
+  {
+    Response &r = tx_queue_[i];
+    if (now_ns < r.start_ns)
+      break;
+
+    size_t arrived = (size_t)((now_ns - r.start_ns) / byte_time_ns_);
+    if (arrived < r.packet.size())
+      return available + (int)(arrived - r.sent);
+    available += (int)(r.packet.size() - r.sent);
+  }
+  return available;
+}
+
+int EmulatedBus::read(int64_t now_ns, uint8_t *packet, int length)
+{
+  int read_length = 0;
+  while (read_length < length && !tx_queue_.empty())
+  {
+    Response &r = tx_queue_.front();
+    if (now_ns < r.start_ns)
+      break;
+
+    size_t arrived = (size_t)((now_ns - r.start_ns) / byte_time_ns_);
+    if (arrived > r.packet.size())
+      arrived = r.packet.size();
+    if (arrived <= r.sent)
+      break;
+
+    size_t n = arrived - r.sent;
+    if (n > (size_t)(length - read_length))
+      n = length - read_length;
+    if (packet != 0)
+      memcpy(&packet[read_length], &r.packet[r.sent], n);
+    r.sent      += n;
+    read_length += (int)n;
+
+    if (r.sent < r.packet.size())
+      break;
+    tx_queue_.pop_front();
+  }
+  return read_length;
+}
+
+void EmulatedBus::discard(int64_t now_ns)
+{
+  while (read(now_ns, 0, PACKET_MAX_LEN) > 0)
+    ;
+}
+
+int64_t EmulatedBus::getNextByteTime()
+{
+  if (tx_queue_.empty())
+    return -1;
+  Response &r = tx_queue_.front();
+  return r.start_ns + byte_time_ns_ * (int64_t)(r.sent + 1);
+}
+
+int64_t EmulatedBus::getPacketEndTime()
+{
+  if (tx_queue_.empty())
+    return -1;
+  Response &r = tx_queue_.front();
+  return r.start_ns + byte_time_ns_ * (int64_t)r.packet.size();
+}
+
+EmulatedBus::Device *EmulatedBus::findDevice(float protocol_version, uint8_t id)
+{
+  for (size_t i = 0; i < devices_.size(); i++)
+  {
+    if (devices_[i].id == id && LAYOUTS[devices_[i].model].protocol_version == protocol_version)
+      return &devices_[i];
+  }
+  return 0;
+}
+
+void EmulatedBus::resetControlTable(Device *device)
+{
+  const ControlTableLayout &layout = LAYOUTS[device->model];
+
+  device->table.assign(layout.size, 0);
+  device->reg_write_data.clear();
+  device->reg_write_address = 0;
+  device->reg_write_pending = false;
+
+  writeValue(&device->table[0], 2, layout.model_number);
+  device->table[layout.addr_firmware_version]     = layout.firmware_version;
+  device->table[layout.addr_id]                   = device->id;
+  device->table[layout.addr_baudrate]             = 1;
+  device->table[layout.addr_return_delay_time]    = DEFAULT_RETURN_DELAY_US_ / 2;
+  device->table[layout.addr_status_return_level] = 2;
+  writeValue(&device->table[layout.addr_goal_position], layout.len_position, layout.initial_position);
+  writeValue(&device->table[layout.addr_present_position], layout.len_position, layout.initial_position);
+}
+
+int EmulatedBus::getReturnDelayNs(Device *device)
+{
+  return device->table[LAYOUTS[device->model].addr_return_delay_time] * 2000;
+}
+
+int EmulatedBus::getStatusReturnLevel(Device *device)
+{
+  return device->table[LAYOUTS[device->model].addr_status_return_level];
+}
+
+bool EmulatedBus::writeControlTable(Device *device, uint16_t address, const uint8_t *data, uint16_t length)
+{
+  const ControlTableLayout &layout = LAYOUTS[device->model];
+
+  if ((uint32_t)address + length > device->table.size())
+    return false;
+
+  memcpy(&device->table[address], data, length);
+
+  if (address <= layout.addr_id && layout.addr_id < address + length)
+    device->id = device->table[layout.addr_id];
+
+  // the device reaches the goal position at once
+  if (address < layout.addr_goal_position + layout.len_position && layout.addr_goal_position < address + length)
+    memcpy(&device->table[layout.addr_present_position], &device->table[layout.addr_goal_position], layout.len_position);
+
+  return true;
+}
+
+int EmulatedBus::parsePacket(int64_t *end_ns)
+{
+  while (rx_buffer_.size() >= 2)
+  {
+    // find packet header
+    size_t idx = 0;
+    while (idx + 1 < rx_buffer_.size() && (rx_buffer_[idx] != 0xFF || rx_buffer_[idx + 1] != 0xFF))
+      idx++;
+    if (idx > 0)
+    {
+      rx_buffer_.erase(rx_buffer_.begin(), rx_buffer_.begin() + idx);
+      continue;
+    }
+
+    if (rx_buffer_.size() < 4)
+      return 0;
+
+    size_t packet_length;
+    if (rx_buffer_[2] == 0xFD && rx_buffer_[3] == 0x00)
+    {
+      if (rx_buffer_.size() < PKT2_INSTRUCTION)
+        return 0;
+      size_t length = DXL_MAKEWORD(rx_buffer_[PKT2_LENGTH_L], rx_buffer_[PKT2_LENGTH_H]);
+      if (length < 3 || length > PACKET_MAX_LEN)
+      {
+        rx_buffer_.erase(rx_buffer_.begin());
+        continue;
+      }
+      packet_length = length + PKT2_INSTRUCTION;
+    }
+    else
+    {
+      if (rx_buffer_[PKT1_ID] == 0xFF || rx_buffer_[PKT1_LENGTH] < 2)
+      {
+        rx_buffer_.erase(rx_buffer_.begin());
+        continue;
+      }
+      packet_length = rx_buffer_[PKT1_LENGTH] + PKT1_INSTRUCTION;
+    }
+
+    if (rx_buffer_.size() < packet_length)
+      return 0;
+
+    // the last byte of the packet is one of the bytes just received
+    *end_ns = rx_end_ns_ - byte_time_ns_ * (int64_t)(rx_buffer_.size() - packet_length);
+    return (int)packet_length;
+  }
+  return 0;
+}
+
+void EmulatedBus::queueStatus1(Device *device, uint8_t error, const uint8_t *data, uint16_t length, int64_t *time_ns)
+{
+  Response r;
+  r.packet.resize(length + 6);
+  r.packet[0]           = 0xFF;
+  r.packet[1]           = 0xFF;
+  r.packet[PKT1_ID]     = device->id;
+  r.packet[PKT1_LENGTH] = (uint8_t)(length + 2);
+  r.packet[4]           = error;
+  if (length > 0)
+    memcpy(&r.packet[5], data, length);
+
+  uint8_t checksum = 0;
+  for (uint16_t i = PKT1_ID; i < length + 5; i++)
+    checksum += r.packet[i];
+  r.packet[length + 5] = ~checksum;
+
+  r.start_ns  = ((*time_ns > tx_end_ns_) ? *time_ns : tx_end_ns_) + getReturnDelayNs(device);
+  r.sent      = 0;
+  tx_end_ns_  = r.start_ns + byte_time_ns_ * (int64_t)r.packet.size();
+  *time_ns    = tx_end_ns_;
+  tx_queue_.push_back(r);
+}
+
+void EmulatedBus::queueStatus2(Device *device, uint8_t error, const uint8_t *data, uint16_t length, int64_t *time_ns)
+{
+  Response r;
+  r.packet.reserve(length + length / 3 + 11);
+  r.packet.push_back(0xFF);
+  r.packet.push_back(0xFF);
+  r.packet.push_back(0xFD);
+  r.packet.push_back(0x00);
+  r.packet.push_back(device->id);
+  r.packet.push_back(0);
+  r.packet.push_back(0);
+  r.packet.push_back(INST_STATUS);
+  r.packet.push_back(error);
+
+  // byte stuffing: 0xFD is added after every FF FF FD in the parameters
+  for (uint16_t i = 0; i < length; i++)
+  {
+    size_t n = r.packet.size();
+    r.packet.push_back(data[i]);
+    if (data[i] == 0xFD && r.packet[n - 1] == 0xFF && r.packet[n - 2] == 0xFF)
+      r.packet.push_back(0xFD);
+  }
+
+  uint16_t packet_length = (uint16_t)(r.packet.size() - PKT2_INSTRUCTION + 2);
+  r.packet[PKT2_LENGTH_L] = DXL_LOBYTE(packet_length);
+  r.packet[PKT2_LENGTH_H] = DXL_HIBYTE(packet_length);
+
+  uint16_t crc = updateCRC(0, &r.packet[0], (uint16_t)r.packet.size());
+  r.packet.push_back(DXL_LOBYTE(crc));
+  r.packet.push_back(DXL_HIBYTE(crc));
+
+  r.start_ns  = ((*time_ns > tx_end_ns_) ? *time_ns : tx_end_ns_) + getReturnDelayNs(device);
+  r.sent      = 0;
+  tx_end_ns_  = r.start_ns + byte_time_ns_ * (int64_t)r.packet.size();
+  *time_ns    = tx_end_ns_;
+  tx_queue_.push_back(r);
+}
+
+// the devices listed answer one status packet in turn, each adding ERR ID DATA CRC16 (of the packet so far) without byte stuffing,
+// and the packet is cut off at the first device which does not answer
+void EmulatedBus::queueFastStatus2(uint8_t instruction, const uint8_t *param, uint16_t param_length, int64_t *time_ns)
+{
+  uint16_t  step          = (instruction == INST_FAST_SYNC_READ) ? 1 : 5;
+  uint16_t  first         = (instruction == INST_FAST_SYNC_READ) ? 4 : 0;
+  uint16_t  packet_length = 1;  // INST
+
+  if (instruction == INST_FAST_SYNC_READ && param_length < 4)
+    return;
+  for (uint16_t i = first; i + step <= param_length; i += step)
+    packet_length += ((instruction == INST_FAST_SYNC_READ) ? DXL_MAKEWORD(param[2], param[3]) : DXL_MAKEWORD(param[i + 3], param[i + 4])) + 4;
+
+  Response r;
+  r.packet.reserve(packet_length + 7);
+  r.packet.push_back(0xFF);
+  r.packet.push_back(0xFF);
+  r.packet.push_back(0xFD);
+  r.packet.push_back(0x00);
+  r.packet.push_back(BROADCAST_ID);
+  r.packet.push_back(DXL_LOBYTE(packet_length));
+  r.packet.push_back(DXL_HIBYTE(packet_length));
+  r.packet.push_back(INST_STATUS);
+
+  for (uint16_t i = first; i + step <= param_length; i += step)
+  {
+    Device   *device  = findDevice(2.0, param[i]);
+    uint16_t  address = (instruction == INST_FAST_SYNC_READ) ? DXL_MAKEWORD(param[0], param[1]) : DXL_MAKEWORD(param[i + 1], param[i + 2]);
+    uint16_t  length  = (instruction == INST_FAST_SYNC_READ) ? DXL_MAKEWORD(param[2], param[3]) : DXL_MAKEWORD(param[i + 3], param[i + 4]);
+    if (device == 0 || LAYOUTS[device->model].fast_read == false)
+      break;
+
+    // the first device answers after its return delay time, and the others follow at once
+    if (r.packet.size() == PKT2_INSTRUCTION + 1)
+      r.start_ns = ((*time_ns > tx_end_ns_) ? *time_ns : tx_end_ns_) + getReturnDelayNs(device);
+
+    bool access_error = ((uint32_t)address + length > device->table.size());
+    r.packet.push_back(access_error ? ERRNUM2_ACCESS : 0);
+    r.packet.push_back(device->id);
+    for (uint16_t j = 0; j < length; j++)
+      r.packet.push_back(access_error ? 0 : device->table[address + j]);
+
+    uint16_t crc = updateCRC(0, &r.packet[0], (uint16_t)r.packet.size());
+    r.packet.push_back(DXL_LOBYTE(crc));
+    r.packet.push_back(DXL_HIBYTE(crc));
+  }
+  if (r.packet.size() == PKT2_INSTRUCTION + 1)
+    return;
+
+  r.sent      = 0;
+  tx_end_ns_  = r.start_ns + byte_time_ns_ * (int64_t)r.packet.size();
+  *time_ns    = tx_end_ns_;
+  tx_queue_.push_back(r);
+}
+
+void EmulatedBus::processPacket1(uint8_t *packet, int64_t end_ns)
+{
+  uint8_t   id          = packet[PKT1_ID];
+  uint8_t   instruction = packet[PKT1_INSTRUCTION];
+  uint8_t  *param       = &packet[PKT1_PARAMETER];
+  uint16_t  param_length = packet[PKT1_LENGTH] - 2;
+  int64_t   time_ns     = end_ns;
+
+  uint8_t checksum = 0;
+  for (uint16_t i = PKT1_ID; i < packet[PKT1_LENGTH] + 3; i++)
+    checksum += packet[i];
+  bool checksum_ok = (packet[packet[PKT1_LENGTH] + 3] == (uint8_t)~checksum);
+
+  if (id == BROADCAST_ID)
+  {
+    if (checksum_ok == false)
+      return;
+
+    switch (instruction)
+    {
+      case INST_ACTION:
+        for (size_t i = 0; i < devices_.size(); i++)
+        {
+          Device *device = &devices_[i];
+          if (LAYOUTS[device->model].protocol_version != 1.0 || device->reg_write_pending == false)
+            continue;
+          device->reg_write_pending = false;
+          writeControlTable(device, device->reg_write_address, &device->reg_write_data[0], (uint16_t)device->reg_write_data.size());
+        }
+        break;
+
+      case INST_SYNC_WRITE:   // ADDR DATA_LEN [ID DATA...]...
+        if (param_length < 2 || param[1] == 0)
+          break;
+        for (uint16_t i = 2; i + 1 + param[1] <= param_length; i += 1 + param[1])
+        {
+          Device *device = findDevice(1.0, param[i]);
+          if (device != 0)
+            writeControlTable(device, param[0], &param[i + 1], param[1]);
+        }
+        break;
+
+      case INST_BULK_READ:    // 0x00 [LEN ID ADDR]...
+        for (uint16_t i = 1; i + 3 <= param_length; i += 3)
+        {
+          Device *device = findDevice(1.0, param[i + 1]);
+          if (device == 0)
+            continue;
+          if ((uint32_t)param[i + 2] + param[i] > device->table.size())
+            queueStatus1(device, ERRBIT1_RANGE, 0, 0, &time_ns);
+          else
+            queueStatus1(device, 0, &device->table[param[i + 2]], param[i], &time_ns);
+        }
+        break;
+
+      default:
+        break;
+    }
+    return;
+  }
+
+  Device *device = findDevice(1.0, id);
+  if (device == 0)
+    return;
+
+  int status_return_level = getStatusReturnLevel(device);
+  if (checksum_ok == false)
+  {
+    if (status_return_level >= 2)
+      queueStatus1(device, ERRBIT1_CHECKSUM, 0, 0, &time_ns);
+    return;
+  }
+
+  switch (instruction)
+  {
+    case INST_PING:
+      queueStatus1(device, 0, 0, 0, &time_ns);
+      break;
+
+    case INST_READ:         // ADDR LEN
+      if (param_length != 2)
+      {
+        if (status_return_level >= 1)
+          queueStatus1(device, ERRBIT1_INSTRUCTION, 0, 0, &time_ns);
+      }
+      else if ((uint32_t)param[0] + param[1] > device->table.size())
+      {
+        if (status_return_level >= 1)
+          queueStatus1(device, ERRBIT1_RANGE, 0, 0, &time_ns);
+      }
+      else if (status_return_level >= 1)
+      {
+        queueStatus1(device, 0, &device->table[param[0]], param[1], &time_ns);
+      }
+      break;
+
+    case INST_WRITE:        // ADDR DATA...
+    case INST_REG_WRITE:
+    {
+      uint8_t error = 0;
+      if (param_length < 2)
+        error = ERRBIT1_INSTRUCTION;
+      else if ((uint32_t)param[0] + param_length - 1 > device->table.size())
+        error = ERRBIT1_RANGE;
+
+      if (status_return_level >= 2)
+        queueStatus1(device, error, 0, 0, &time_ns);
+      if (error != 0)
+        break;
+
+      if (instruction == INST_WRITE)
+      {
+        writeControlTable(device, param[0], &param[1], param_length - 1);
+      }
+      else
+      {
+        device->reg_write_address = param[0];
+        device->reg_write_data.assign(&param[1], &param[param_length]);
+        device->reg_write_pending = true;
+      }
+      break;
+    }
+
+    case INST_ACTION:
+      if (status_return_level >= 2)
+        queueStatus1(device, device->reg_write_pending ? 0 : ERRBIT1_INSTRUCTION, 0, 0, &time_ns);
+      if (device->reg_write_pending)
+      {
+        device->reg_write_pending = false;
+        writeControlTable(device, device->reg_write_address, &device->reg_write_data[0], (uint16_t)device->reg_write_data.size());
+      }
+      break;
+
+    case INST_FACTORY_RESET:
+      if (status_return_level >= 2)
+        queueStatus1(device, 0, 0, 0, &time_ns);
+      device->id = 1;
+      resetControlTable(device);
+      break;
+
+    default:
+      if (status_return_level >= 2)
+        queueStatus1(device, ERRBIT1_INSTRUCTION, 0, 0, &time_ns);
+      break;
+  }
+}
+
+void EmulatedBus::processPacket2(uint8_t *packet, int64_t end_ns)
+{
+  uint8_t   id            = packet[PKT2_ID];
+  uint8_t   instruction   = packet[PKT2_INSTRUCTION];
+  uint16_t  packet_length = DXL_MAKEWORD(packet[PKT2_LENGTH_L], packet[PKT2_LENGTH_H]) + PKT2_INSTRUCTION;
+  int64_t   time_ns       = end_ns;
+
+  uint16_t crc = updateCRC(0, packet, packet_length - 2);
+  bool crc_ok = (DXL_LOBYTE(crc) == packet[packet_length - 2] && DXL_HIBYTE(crc) == packet[packet_length - 1]);
+
+  // remove byte stuffing from the parameters
+  std::vector<uint8_t> param;
+  param.reserve(packet_length);
+  for (uint16_t i = PKT2_INSTRUCTION + 1; i < packet_length - 2; i++)
+  {
+    param.push_back(packet[i]);
+    if (packet[i] == 0xFD && packet[i - 1] == 0xFF && packet[i - 2] == 0xFF && i + 1 < packet_length - 2 && packet[i + 1] == 0xFD)
+      i++;
+  }
+  uint16_t param_length = (uint16_t)param.size();
+  param.push_back(0);   // keeps &param[0] valid when there is no parameter
+
+  if (crc_ok == false)
+  {
+    Device *device = findDevice(2.0, id);
+    if (device != 0 && getStatusReturnLevel(device) >= 2)
+      queueStatus2(device, ERRNUM2_CRC, 0, 0, &time_ns);
+    return;
+  }
+
+  if (id == BROADCAST_ID)
+  {
+    switch (instruction)
+    {
+      case INST_PING:
+        for (size_t i = 0; i < devices_.size(); i++)
+        {
+          Device *device = &devices_[i];
+          if (LAYOUTS[device->model].protocol_version != 2.0)
+            continue;
+          uint8_t data[3];
+          memcpy(data, &device->table[0], 2);
+          data[2] = device->table[LAYOUTS[device->model].addr_firmware_version];
+          queueStatus2(device, 0, data, 3, &time_ns);
+        }
+        break;
+
+      case INST_ACTION:
+        for (size_t i = 0; i < devices_.size(); i++)
+        {
+          Device *device = &devices_[i];
+          if (LAYOUTS[device->model].protocol_version != 2.0 || device->reg_write_pending == false)
+            continue;
+          device->reg_write_pending = false;
+          writeControlTable(device, device->reg_write_address, &device->reg_write_data[0], (uint16_t)device->reg_write_data.size());
+        }
+        break;
+
+      case INST_SYNC_READ:    // ADDR_L ADDR_H LEN_L LEN_H ID...
+      case INST_SYNC_WRITE:   // ADDR_L ADDR_H LEN_L LEN_H [ID DATA...]...
+      {
+        if (param_length < 4)
+          break;
+        uint16_t address  = DXL_MAKEWORD(param[0], param[1]);
+        uint16_t length   = DXL_MAKEWORD(param[2], param[3]);
+        uint16_t step     = (instruction == INST_SYNC_READ) ? 1 : 1 + length;
+        for (uint16_t i = 4; i + step <= param_length; i += step)
+        {
+          Device *device = findDevice(2.0, param[i]);
+          if (device == 0)
+            continue;
+          if (instruction == INST_SYNC_WRITE)
+            writeControlTable(device, address, &param[i + 1], length);
+          else if ((uint32_t)address + length > device->table.size())
+            queueStatus2(device, ERRNUM2_ACCESS, 0, 0, &time_ns);
+          else
+            queueStatus2(device, 0, &device->table[address], length, &time_ns);
+        }
+        break;
+      }
+
+      case INST_FAST_SYNC_READ:   // ADDR_L ADDR_H LEN_L LEN_H ID...
+      case INST_FAST_BULK_READ:   // [ID ADDR_L ADDR_H LEN_L LEN_H]...
+        queueFastStatus2(instruction, &param[0], param_length, &time_ns);
+        break;
+
+      case INST_BULK_READ:    // [ID ADDR_L ADDR_H LEN_L LEN_H]...
+      case INST_BULK_WRITE:   // [ID ADDR_L ADDR_H LEN_L LEN_H DATA...]...
+        for (uint16_t i = 0; i + 5 <= param_length; )
+        {
+          Device   *device  = findDevice(2.0, param[i]);
+          uint16_t  address = DXL_MAKEWORD(param[i + 1], param[i + 2]);
+          uint16_t  length  = DXL_MAKEWORD(param[i + 3], param[i + 4]);
+          if (instruction == INST_BULK_WRITE)
+          {
+            if (i + 5 + length > param_length)
+              break;
+            if (device != 0)
+              writeControlTable(device, address, &param[i + 5], length);
+            i += 5 + length;
+            continue;
+          }
+
+          if (device != 0)
+          {
+            if ((uint32_t)address + length > device->table.size())
+              queueStatus2(device, ERRNUM2_ACCESS, 0, 0, &time_ns);
+            else
+              queueStatus2(device, 0, &device->table[address], length, &time_ns);
+          }
+          i += 5;
+        }
+        break;
+
+      default:
+        break;
+    }
+    return;
+  }
+
+  Device *device = findDevice(2.0, id);
+  if (device == 0)
+    return;
+
+  int status_return_level = getStatusReturnLevel(device);
+  switch (instruction)
+  {
+    case INST_PING:
+    {
+      uint8_t data[3];
+      memcpy(data, &device->table[0], 2);
+      data[2] = device->table[LAYOUTS[device->model].addr_firmware_version];
+      queueStatus2(device, 0, data, 3, &time_ns);
+      break;
+    }
+
+    case INST_READ:         // ADDR_L ADDR_H LEN_L LEN_H
+    {
+      if (status_return_level < 1)
+        break;
+      if (param_length != 4)
+      {
+        queueStatus2(device, ERRNUM2_DATA_LENGTH, 0, 0, &time_ns);
+        break;
+      }
+      uint16_t address  = DXL_MAKEWORD(param[0], param[1]);
+      uint16_t length   = DXL_MAKEWORD(param[2], param[3]);
+      if ((uint32_t)address + length > device->table.size())
+        queueStatus2(device, ERRNUM2_ACCESS, 0, 0, &time_ns);
+      else
+        queueStatus2(device, 0, &device->table[address], length, &time_ns);
+      break;
+    }
+
+    case INST_WRITE:        // ADDR_L ADDR_H DATA...
+    case INST_REG_WRITE:
+    {
+      uint8_t   error   = 0;
+      uint16_t  address = 0;
+      uint16_t  length  = 0;
+      if (param_length < 3)
+      {
+        error = ERRNUM2_DATA_LENGTH;
+      }
+      else
+      {
+        address = DXL_MAKEWORD(param[0], param[1]);
+        length  = param_length - 2;
+        if ((uint32_t)address + length > device->table.size())
+          error = ERRNUM2_ACCESS;
+      }
+
+      if (status_return_level >= 2)
+        queueStatus2(device, error, 0, 0, &time_ns);
+      if (error != 0)
+        break;
+
+      if (instruction == INST_WRITE)
+      {
+        writeControlTable(device, address, &param[2], length);
+      }
+      else
+      {
+        device->reg_write_address = address;
+        device->reg_write_data.assign(&param[2], &param[2] + length);
+        device->reg_write_pending = true;
+      }
+      break;
+    }
+
+    case INST_ACTION:
+      if (status_return_level >= 2)
+        queueStatus2(device, device->reg_write_pending ? 0 : ERRNUM2_INSTRUCTION, 0, 0, &time_ns);
+      if (device->reg_write_pending)
+      {
+        device->reg_write_pending = false;
+        writeControlTable(device, device->reg_write_address, &device->reg_write_data[0], (uint16_t)device->reg_write_data.size());
+      }
+      break;
+
+    case INST_REBOOT:
+      if (status_return_level >= 2)
+        queueStatus2(device, 0, 0, 0, &time_ns);
+      device->reg_write_pending = false;
+      break;
+
+    case INST_FACTORY_RESET:  // 0xFF: all, 0x01: except ID, 0x02: except ID and baudrate
+    {
+      const ControlTableLayout &layout = LAYOUTS[device->model];
+      uint8_t option    = (param_length > 0) ? param[0] : 0xFF;
+      uint8_t baudrate  = device->table[layout.addr_baudrate];
+
+      if (status_return_level >= 2)
+        queueStatus2(device, 0, 0, 0, &time_ns);
+      if (option == 0xFF)
+        device->id = 1;
+      resetControlTable(device);
+      if (option == 0x02)
+        device->table[layout.addr_baudrate] = baudrate;
+      break;
+    }
+
+    default:
+      if (status_return_level >= 2)
+        queueStatus2(device, ERRNUM2_INSTRUCTION, 0, 0, &time_ns);
+      break;
+  }
+}
@@ -0,0 +1,203 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#if defined(__linux__)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#include <termios.h>
+#include <time.h>
+#include <sys/prctl.h>
+
+#include "emulated_bus_pty.h"
+
+#define SPIN_TIME_NS    50000   // nsec
+
+using namespace dynamixel;
+
+static int64_t getCurrentTimeNs()
+{
+  struct timespec tv;
+  clock_gettime(CLOCK_MONOTONIC, &tv);
+  return (int64_t)tv.tv_sec * 1000000000LL + (int64_t)tv.tv_nsec;
+}
+
+EmulatedBusPty::EmulatedBusPty(EmulatedBus *bus)
+  : bus_(bus),
+    master_fd_(-1),
+    slave_fd_(-1),
+    is_running_(false)
+{
+  wakeup_fd_[0] = -1;
+  wakeup_fd_[1] = -1;
+  port_name_[0] = '\0';
+}
+
+bool EmulatedBusPty::start()
+{
+  struct termios tio;
+
+  if (is_running_)
+    return true;
+
+  master_fd_ = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+  if (master_fd_ < 0 || grantpt(master_fd_) != 0 || unlockpt(master_fd_) != 0 ||
+      ptsname_r(master_fd_, port_name_, sizeof(port_name_)) != 0)
+  {
+    printf("[EmulatedBusPty::start] Error opening pseudo-terminal!\n");
+    stop();
+    return false;
+  }
+
+  // the slave side is kept open, so the master does not see a hang-up while the host reopens the port
+  slave_fd_ = open(port_name_, O_RDWR | O_NOCTTY);
+  if (slave_fd_ < 0 || tcgetattr(slave_fd_, &tio) != 0)
+  {
+    printf("[EmulatedBusPty::start] Error opening %s!\n", port_name_);
+    stop();
+    return false;
+  }
+  cfmakeraw(&tio);
+  tcsetattr(slave_fd_, TCSANOW, &tio);
+
+  if (pipe(wakeup_fd_) != 0)
+  {
+    printf("[EmulatedBusPty::start] Error creating pipe!\n");
+    stop();
+    return false;
+  }
+
+  is_running_ = true;
+  if (pthread_create(&thread_, NULL, run, this) != 0)
+  {
+    printf("[EmulatedBusPty::start] Error creating thread!\n");
+    is_running_ = false;
+    stop();
+    return false;
+  }
+  return true;
+}
+
+void EmulatedBusPty::stop()
+{
+  if (is_running_)
+  {
+    char c = 0;
+    if (write(wakeup_fd_[1], &c, 1) == 1)
+      pthread_join(thread_, NULL);
+    is_running_ = false;
+  }
+
+  for (int i = 0; i < 2; i++)
+  {
+    if (wakeup_fd_[i] != -1)
+      close(wakeup_fd_[i]);
+    wakeup_fd_[i] = -1;
+  }
+  if (slave_fd_ != -1)
+    close(slave_fd_);
+  slave_fd_ = -1;
+  if (master_fd_ != -1)
+    close(master_fd_);
+  master_fd_ = -1;
+}
+
+char *EmulatedBusPty::getPortName()
+{
+  return port_name_;
+}
+
+void *EmulatedBusPty::run(void *arg)
+{
+  ((EmulatedBusPty *)arg)->loop();
+  return NULL;
+}
+
+void EmulatedBusPty::loop()
+{
+  uint8_t buffer[4096];
+
+  // the default timer slack (50 usec) would be added to every status packet
+  prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL);
+
+  while (true)
+  {
+    struct pollfd   pfd[2];
+    struct timespec ts;
+    struct timespec *timeout = NULL;
+
+    pfd[0].fd       = master_fd_;
+    pfd[0].events   = POLLIN;
+    pfd[0].revents  = 0;
+    pfd[1].fd       = wakeup_fd_[0];
+    pfd[1].events   = POLLIN;
+    pfd[1].revents  = 0;
+
+    // sleep until the status packet being sent is completely on the wire.
+    // the last SPIN_TIME_NS is polled, since the wake-up of ppoll() may be late by tens of usec.
+    int64_t packet_end = bus_->getPacketEndTime();
+    if (packet_end >= 0)
+    {
+      int64_t remaining = packet_end - getCurrentTimeNs() - SPIN_TIME_NS;
+      if (remaining < 0)
+        remaining = 0;
+      ts.tv_sec   = (time_t)(remaining / 1000000000LL);
+      ts.tv_nsec  = (long)(remaining % 1000000000LL);
+      timeout     = &ts;
+    }
+
+    if (ppoll(pfd, 2, timeout, NULL) < 0)
+      continue;
+    if (pfd[1].revents != 0)
+      break;
+
+    if (pfd[0].revents & POLLIN)
+    {
+      int length = ::read(master_fd_, buffer, sizeof(buffer));
+      if (length > 0)
+        bus_->receive(getCurrentTimeNs(), buffer, length);
+    }
+
+    int64_t now = getCurrentTimeNs();
+    packet_end  = bus_->getPacketEndTime();
+    if (packet_end < 0 || now < packet_end)
+      continue;
+
+    int length = bus_->read(now, buffer, sizeof(buffer));
+    if (length > 0 && write(master_fd_, buffer, length) != length)
+      printf("[EmulatedBusPty::loop] Error writing %d bytes!\n", length);
+  }
+}
+
+#endif
@@ -51,6 +51,10 @@ GroupBulkRead::GroupBulkRead(PortHandler *port, PacketHandler *ph)
     ph_(ph),
     last_result_(false),
     is_param_changed_(false),
+    is_fast_mode_(false),
+    is_fast_sent_(false),
+    is_fast_failed_(false),
+    is_fast_unsupported_(false),
     param_(0)
 {
   clearParam();
@@ -93,6 +97,18 @@ void GroupBulkRead::makeParam()
       param_[idx++] = DXL_HIBYTE(length_list_[id]);     // LEN_H
     }
   }
+
+  requests_.resize(id_list_.size());
+  for (unsigned int i = 0; i < id_list_.size(); i++)
+  {
+    uint8_t id = id_list_[i];
+    requests_[i].id           = id;
+    requests_[i].instruction  = INST_READ;
+    requests_[i].address      = address_list_[id];
+    requests_[i].length       = length_list_[id];
+    requests_[i].data         = data_list_[id];
+    requests_[i].timeout_msec = 0;
+  }
 }
 
 bool GroupBulkRead::addParam(uint8_t id, uint16_t start_address, uint16_t data_length)
@@ -105,7 +121,9 @@ bool GroupBulkRead::addParam(uint8_t id, uint16_t start_address, uint16_t data_l
   address_list_[id]   = start_address;
   data_list_[id]      = new uint8_t[data_length];
 
-  is_param_changed_   = true;
+  is_param_changed_     = true;
+  is_fast_failed_       = false;
+  is_fast_unsupported_  = false;
   return true;
 }
 
@@ -121,7 +139,9 @@ void GroupBulkRead::removeParam(uint8_t id)
   delete[] data_list_[id];
   data_list_.erase(id);
 
-  is_param_changed_   = true;
+  is_param_changed_     = true;
+  is_fast_failed_       = false;
+  is_fast_unsupported_  = false;
 }
 
 void GroupBulkRead::clearParam()
@@ -136,9 +156,27 @@ void GroupBulkRead::clearParam()
   address_list_.clear();
   length_list_.clear();
   data_list_.clear();
+  requests_.clear();
   if (param_ != 0)
     delete[] param_;
   param_ = 0;
+  is_fast_failed_       = false;
+  is_fast_unsupported_  = false;
+}
+
+void GroupBulkRead::setFastMode(bool enable)
+{
+  is_fast_mode_         = enable;
+  is_fast_failed_       = false;
+  is_fast_unsupported_  = false;
+}
+
+bool GroupBulkRead::isFastMode()
+{
+  if (ph_->getProtocolVersion() == 1.0)
+    return false;
+
+  return is_fast_mode_ == true && is_fast_unsupported_ == false;
 }
 
 int GroupBulkRead::txPacket()
@@ -147,7 +185,17 @@ int GroupBulkRead::txPacket()
     return COMM_NOT_AVAILABLE;
 
   if (is_param_changed_ == true || param_ == 0)
+  {
     makeParam();
+    is_param_changed_ = false;
+  }
+
+  // Bulk Read is tried once after Fast Bulk Read failed
+  is_fast_sent_ = (isFastMode() == true && is_fast_failed_ == false);
+  if (is_fast_sent_ == true)
+  {
+    return ph_->fastBulkReadTx(port_, param_, id_list_.size() * 5);
+  }
 
   if (ph_->getProtocolVersion() == 1.0)
   {
@@ -169,13 +217,37 @@ int GroupBulkRead::rxPacket()
   if (cnt == 0)
     return COMM_NOT_AVAILABLE;
 
-  for (int i = 0; i < cnt; i++)
+  // the status packets of every ID are received in the same transaction
+  BusTransaction transaction(port_);
+  if (transaction.isAcquired() == false)
+    return COMM_PORT_BUSY;
+
+  if (is_fast_sent_ == true)
   {
-    uint8_t id = id_list_[i];
+    // the status packet answered together is split into data_list_
+    result = ph_->fastReadRx(port_, &requests_[0], cnt);
 
-    result = ph_->readRx(port_, id, length_list_[id], data_list_[id]);
-    if (result != COMM_SUCCESS)
-      return result;
+    // a Dynamixel without Fast Bulk Read is checked by Bulk Read of the next txPacket()
+    if (result != COMM_SUCCESS && result != COMM_PORT_BUSY)
+      is_fast_failed_ = true;
+  }
+  else
+  {
+    for (int i = 0; i < cnt; i++)
+    {
+      uint8_t id = id_list_[i];
+
+      result = ph_->readRx(port_, id, length_list_[id], data_list_[id]);
+      if (result != COMM_SUCCESS)
+        break;
+    }
+
+    // Fast Bulk Read is tried again unless Bulk Read works
+    if (is_fast_failed_ == true && result != COMM_PORT_BUSY)
+    {
+      is_fast_unsupported_  = (result == COMM_SUCCESS);
+      is_fast_failed_       = false;
+    }
   }
 
   if (result == COMM_SUCCESS)
@@ -192,7 +264,19 @@ int GroupBulkRead::txRxPacket()
   if (result != COMM_SUCCESS)
     return result;
 
-  return rxPacket();
+  result = rxPacket();
+
+  // Fast Bulk Read failed is retried as Bulk Read at once
+  if (result != COMM_SUCCESS && is_fast_sent_ == true && is_fast_failed_ == true)
+  {
+    result = txPacket();
+    if (result != COMM_SUCCESS)
+      return result;
+
+    result = rxPacket();
+  }
+
+  return result;
 }
 
 bool GroupBulkRead::isAvailable(uint8_t id, uint16_t address, uint16_t data_length)
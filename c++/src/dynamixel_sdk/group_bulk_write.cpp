@@ -163,7 +163,10 @@ int GroupBulkWrite::txPacket()
     return COMM_NOT_AVAILABLE;
 
   if (is_param_changed_ == true || param_ == 0)
+  {
     makeParam();
+    is_param_changed_ = false;
+  }
 
   return ph_->bulkWriteTxOnly(port_, param_, param_length_);
 }
@@ -50,6 +50,10 @@ GroupSyncRead::GroupSyncRead(PortHandler *port, PacketHandler *ph, uint16_t star
     ph_(ph),
     last_result_(false),
     is_param_changed_(false),
+    is_fast_mode_(false),
+    is_fast_sent_(false),
+    is_fast_failed_(false),
+    is_fast_unsupported_(false),
     param_(0),
     start_address_(start_address),
     data_length_(data_length)
@@ -71,6 +75,17 @@ void GroupSyncRead::makeParam()
   int idx = 0;
   for (unsigned int i = 0; i < id_list_.size(); i++)
     param_[idx++] = id_list_[i];
+
+  requests_.resize(id_list_.size());
+  for (unsigned int i = 0; i < id_list_.size(); i++)
+  {
+    requests_[i].id           = id_list_[i];
+    requests_[i].instruction  = INST_READ;
+    requests_[i].address      = start_address_;
+    requests_[i].length       = data_length_;
+    requests_[i].data         = data_list_[id_list_[i]];
+    requests_[i].timeout_msec = 0;
+  }
 }
 
 bool GroupSyncRead::addParam(uint8_t id)
@@ -84,7 +99,9 @@ bool GroupSyncRead::addParam(uint8_t id)
   id_list_.push_back(id);
   data_list_[id] = new uint8_t[data_length_];
 
-  is_param_changed_   = true;
+  is_param_changed_     = true;
+  is_fast_failed_       = false;
+  is_fast_unsupported_  = false;
   return true;
 }
 void GroupSyncRead::removeParam(uint8_t id)
@@ -100,7 +117,9 @@ void GroupSyncRead::removeParam(uint8_t id)
   delete[] data_list_[id];
   data_list_.erase(id);
 
-  is_param_changed_   = true;
+  is_param_changed_     = true;
+  is_fast_failed_       = false;
+  is_fast_unsupported_  = false;
 }
 void GroupSyncRead::clearParam()
 {
@@ -112,9 +131,27 @@ void GroupSyncRead::clearParam()
 
   id_list_.clear();
   data_list_.clear();
+  requests_.clear();
   if (param_ != 0)
     delete[] param_;
   param_ = 0;
+  is_fast_failed_       = false;
+  is_fast_unsupported_  = false;
+}
+
+void GroupSyncRead::setFastMode(bool enable)
+{
+  is_fast_mode_         = enable;
+  is_fast_failed_       = false;
+  is_fast_unsupported_  = false;
+}
+
+bool GroupSyncRead::isFastMode()
+{
+  if (ph_->getProtocolVersion() == 1.0)
+    return false;
+
+  return is_fast_mode_ == true && is_fast_unsupported_ == false;
 }
 
 int GroupSyncRead::txPacket()
@@ -123,7 +160,15 @@ int GroupSyncRead::txPacket()
     return COMM_NOT_AVAILABLE;
 
   if (is_param_changed_ == true || param_ == 0)
+  {
     makeParam();
+    is_param_changed_ = false;
+  }
+
+  // Sync Read is tried once after Fast Sync Read failed
+  is_fast_sent_ = (isFastMode() == true && is_fast_failed_ == false);
+  if (is_fast_sent_ == true)
+    return ph_->fastSyncReadTx(port_, start_address_, data_length_, param_, (uint16_t)id_list_.size() * 1);
 
   return ph_->syncReadTx(port_, start_address_, data_length_, param_, (uint16_t)id_list_.size() * 1);
 }
@@ -141,13 +186,37 @@ int GroupSyncRead::rxPacket()
   if (cnt == 0)
     return COMM_NOT_AVAILABLE;
 
-  for (int i = 0; i < cnt; i++)
+  // the status packets of every ID are received in the same transaction
+  BusTransaction transaction(port_);
+  if (transaction.isAcquired() == false)
+    return COMM_PORT_BUSY;
+
+  if (is_fast_sent_ == true)
   {
-    uint8_t id = id_list_[i];
+    // the status packet answered together is split into data_list_
+    result = ph_->fastReadRx(port_, &requests_[0], cnt);
 
-    result = ph_->readRx(port_, id, data_length_, data_list_[id]);
-    if (result != COMM_SUCCESS)
-      return result;
+    // a Dynamixel without Fast Sync Read is checked by Sync Read of the next txPacket()
+    if (result != COMM_SUCCESS && result != COMM_PORT_BUSY)
+      is_fast_failed_ = true;
+  }
+  else
+  {
+    for (int i = 0; i < cnt; i++)
+    {
+      uint8_t id = id_list_[i];
+
+      result = ph_->readRx(port_, id, data_length_, data_list_[id]);
+      if (result != COMM_SUCCESS)
+        break;
+    }
+
+    // Fast Sync Read is tried again unless Sync Read works
+    if (is_fast_failed_ == true && result != COMM_PORT_BUSY)
+    {
+      is_fast_unsupported_  = (result == COMM_SUCCESS);
+      is_fast_failed_       = false;
+    }
   }
 
   if (result == COMM_SUCCESS)
@@ -167,7 +236,19 @@ int GroupSyncRead::txRxPacket()
   if (result != COMM_SUCCESS)
     return result;
 
-  return rxPacket();
+  result = rxPacket();
+
+  // Fast Sync Read failed is retried as Sync Read at once
+  if (result != COMM_SUCCESS && is_fast_sent_ == true && is_fast_failed_ == true)
+  {
+    result = txPacket();
+    if (result != COMM_SUCCESS)
+      return result;
+
+    result = rxPacket();
+  }
+
+  return result;
 }
 
 bool GroupSyncRead::isAvailable(uint8_t id, uint16_t address, uint16_t data_length)
@@ -112,11 +112,18 @@ bool GroupSyncWrite::changeParam(uint8_t id, uint8_t *data)
   if (it == id_list_.end())    // NOT exist
     return false;
 
-  delete[] data_list_[id];
-  data_list_[id]    = new uint8_t[data_length_];
   for (int c = 0; c < data_length_; c++)
     data_list_[id][c] = data[c];
 
+  // the data is put into the parameter already made, so the control loop does not allocate
+  if (param_ != 0 && is_param_changed_ == false)
+  {
+    int idx = (int)(it - id_list_.begin()) * (1 + data_length_) + 1;   // 1: ID
+    for (int c = 0; c < data_length_; c++)
+      param_[idx++] = data[c];
+    return true;
+  }
+
   is_param_changed_   = true;
   return true;
 }
@@ -142,7 +149,10 @@ int GroupSyncWrite::txPacket()
     return COMM_NOT_AVAILABLE;
 
   if (is_param_changed_ == true || param_ == 0)
+  {
     makeParam();
+    is_param_changed_ = false;
+  }
 
   return ph_->syncWriteTxOnly(port_, start_address_, data_length_, param_, id_list_.size() * (1 + data_length_));
 }
@@ -30,26 +30,94 @@
 
 /* Author: zerom, Ryu Woon Jung (Leon) */
 
+#include <string.h>
+
 #if defined(__linux__)
 #include "port_handler.h"
+#include "packet_handler.h"
+#include "bus_lock.h"
+#include "status_packet_parser.h"
+#include "port_handler_client.h"
 #include "port_handler_linux.h"
+#include "port_handler_replay.h"
+#include "port_handler_sim.h"
 #elif defined(__APPLE__)
 #include "port_handler.h"
+#include "packet_handler.h"
+#include "bus_lock.h"
+#include "status_packet_parser.h"
 #include "port_handler_mac.h"
+#include "port_handler_sim.h"
 #elif defined(_WIN32) || defined(_WIN64)
 #define WINDLLEXPORT
 #include "port_handler.h"
+#include "packet_handler.h"
+#include "bus_lock.h"
+#include "status_packet_parser.h"
 #include "port_handler_windows.h"
+#include "port_handler_sim.h"
 #elif defined(ARDUINO) || defined(__OPENCR__) || defined(__OPENCM904__)
 #include "../../include/dynamixel_sdk/port_handler.h"
+#include "../../include/dynamixel_sdk/packet_handler.h"
+#include "../../include/dynamixel_sdk/bus_lock.h"
+#include "../../include/dynamixel_sdk/status_packet_parser.h"
 #include "../../include/dynamixel_sdk/port_handler_arduino.h"
+#include "../../include/dynamixel_sdk/port_handler_sim.h"
+#endif
+
+#define RESPONSE_STATS_SIZE       255   // ID 0 ~ 252, and 254 (broadcast ID) for every ID together
+#define RESPONSE_STATS_ALL        254
+#define RESPONSE_MIN_SAMPLES      8     // responses measured before the adaptive timeout is used
+#define RESPONSE_PROBE_INTERVAL   16    // the fixed timeout is used once in this number of timeouts in a row
+
+// orders the statistics against BusStats::sequence (release: by the writer, acquire: by the reader)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define BUS_STATS_RELEASE()       _ReadWriteBarrier()   // x86 and x64 keep the order of stores, and of loads
+#define BUS_STATS_ACQUIRE()       _ReadWriteBarrier()
+#else
+#define BUS_STATS_RELEASE()       __atomic_thread_fence(__ATOMIC_RELEASE)
+#define BUS_STATS_ACQUIRE()       __atomic_thread_fence(__ATOMIC_ACQUIRE)
 #endif
 
 using namespace dynamixel;
 
+PortHandler::PortHandler()
+  : packet_deadline_ns_(0), cycle_deadline_ns_(0),
+    response_stats_(0), response_adaptive_(false), response_factor_(2.0), response_min_ns_(200000),
+    response_start_ns_(0), response_transfer_ns_(0), response_id_(-1), tx_flush_(true),
+    bus_stats_(0), bus_stats_base_(0), bus_stats_enabled_(false), bus_instruction_(0), bus_tx_ns_(0),
+    bus_lock_(new BusLock()), bus_timeout_msec_(0.0), status_parser_(0),
+    packet_buffer_(0), packet_buffer_length_(0),
+    is_using_(false)
+{
+}
+
+PortHandler::~PortHandler()
+{
+  delete[] response_stats_;
+  delete bus_stats_;
+  delete bus_stats_base_;
+  delete bus_lock_;
+  delete status_parser_;
+  delete[] packet_buffer_;
+}
+
 PortHandler *PortHandler::getPortHandler(const char *port_name)
 {
+  // emulated bus in memory
+  if (strncmp(port_name, "sim:", 4) == 0)
+    return (PortHandler *)(new PortHandlerSim(port_name));
+
 #if defined(__linux__)
+  // trace file recorded by PortHandlerRecorder
+  if (strncmp(port_name, "replay:", 7) == 0)
+    return (PortHandler *)(new PortHandlerReplay(port_name));
+
+  // port served by BusDaemon of another process
+  if (strncmp(port_name, "unix:", 5) == 0)
+    return (PortHandler *)(new PortHandlerClient(port_name));
+
   return (PortHandler *)(new PortHandlerLinux(port_name));
 #elif defined(__APPLE__)
   return (PortHandler *)(new PortHandlerMac(port_name));
@@ -59,3 +127,445 @@ PortHandler *PortHandler::getPortHandler(const char *port_name)
   return (PortHandler *)(new PortHandlerArduino(port_name));
 #endif
 }
+
+int PortHandler::writePortv(PortBuffer *buffers, int count)
+{
+  int written = 0;
+  for (int i = 0; i < count; i++)
+  {
+    int result = writePort(buffers[i].data, buffers[i].length);
+    if (result < 0)
+      return (written > 0) ? written : result;
+    written += result;
+    if (result != buffers[i].length)
+      break;
+  }
+  return written;
+}
+
+void PortHandler::setPacketTimeout(double msec)
+{
+  setPacketDeadline(getCurrentTimeNs() + (int64_t)(msec * 1000000.0));
+}
+
+void PortHandler::setPacketDeadline(int64_t deadline_ns)
+{
+  if (cycle_deadline_ns_ != 0 && cycle_deadline_ns_ < deadline_ns)
+    deadline_ns = cycle_deadline_ns_;
+  packet_deadline_ns_ = deadline_ns;
+  response_id_        = -1;
+}
+
+int64_t PortHandler::getPacketDeadline()
+{
+  return packet_deadline_ns_;
+}
+
+void PortHandler::setCycleDeadline(int64_t deadline_ns)
+{
+  cycle_deadline_ns_ = deadline_ns;
+}
+
+int64_t PortHandler::getCycleDeadline()
+{
+  return cycle_deadline_ns_;
+}
+
+bool PortHandler::isPacketTimeout()
+{
+  return (getCurrentTimeNs() >= packet_deadline_ns_);
+}
+
+void PortHandler::setTxFlush(bool enable)
+{
+  tx_flush_ = enable;
+}
+
+bool PortHandler::isTxFlush()
+{
+  return tx_flush_;
+}
+
+void PortHandler::setAdaptiveTimeout(bool enable, double safety_factor, double min_msec)
+{
+  if (response_stats_ == 0)
+  {
+    response_stats_ = new ResponseStats[RESPONSE_STATS_SIZE];
+    clearResponseStats();
+  }
+  response_adaptive_  = enable;
+  response_factor_    = safety_factor;
+  response_min_ns_    = (int64_t)(min_msec * 1000000.0);
+}
+
+bool PortHandler::isAdaptiveTimeout()
+{
+  return response_adaptive_;
+}
+
+void PortHandler::setResponseTimeout(uint8_t id, uint16_t packet_length)
+{
+  // the fixed formula (this also resets response_id_ through setPacketDeadline())
+  setPacketTimeout(packet_length);
+  if (response_stats_ == 0 || id >= RESPONSE_STATS_ALL)
+    return;
+
+  ResponseStats *stats    = &response_stats_[id];
+  ResponseStats *estimate = stats;
+  response_id_            = id;
+  response_start_ns_      = getCurrentTimeNs();
+  response_transfer_ns_   = (getBaudRate() > 0) ? (int64_t)packet_length * 10000000000LL / getBaudRate() : 0;
+
+  // an ID not measured yet (ex. not connected) gets the estimate of every ID together
+  if (stats->count < RESPONSE_MIN_SAMPLES)
+    estimate = &response_stats_[RESPONSE_STATS_ALL];
+
+  if (response_adaptive_ == false)
+    return;
+
+  if (estimate->count < RESPONSE_MIN_SAMPLES || stats->consecutive_timeouts % RESPONSE_PROBE_INTERVAL == 1)
+  {
+    stats->fallbacks++;
+    return;
+  }
+
+  int64_t latency = estimate->mean_ns + 4 * estimate->deviation_ns;
+  if (latency < estimate->p99_ns)
+    latency = estimate->p99_ns;
+  latency = (int64_t)(latency * response_factor_);
+  if (latency < response_min_ns_)
+    latency = response_min_ns_;
+  stats->timeout_ns = latency;
+
+  int64_t deadline = response_start_ns_ + response_transfer_ns_ + latency;
+  if (deadline < getPacketDeadline())
+    setPacketDeadline(deadline);
+  response_id_ = id;
+}
+
+void PortHandler::updateResponseTime(uint8_t id, bool received)
+{
+  if (response_stats_ == 0 || response_id_ != (int)id)
+    return;
+  response_id_ = -1;
+
+  if (received == false)
+  {
+    response_stats_[id].timeouts++;
+    response_stats_[id].consecutive_timeouts++;
+    response_stats_[RESPONSE_STATS_ALL].timeouts++;
+    return;
+  }
+
+  int64_t latency = getCurrentTimeNs() - response_start_ns_ - response_transfer_ns_;
+  if (latency < 0)
+    latency = 0;
+  addResponseSample(&response_stats_[id], latency);
+  addResponseSample(&response_stats_[RESPONSE_STATS_ALL], latency);
+}
+
+void PortHandler::addResponseSample(ResponseStats *stats, int64_t latency)
+{
+  if (latency > stats->max_ns)
+    stats->max_ns = latency;
+  stats->consecutive_timeouts = 0;
+
+  if (stats->count++ == 0)
+  {
+    stats->mean_ns      = latency;
+    stats->deviation_ns = latency / 2;
+    stats->p99_ns       = latency;
+    return;
+  }
+
+  int64_t error = latency - stats->mean_ns;
+  int64_t deviation = (error < 0) ? -error : error;
+  if (error > 4 * stats->deviation_ns)
+    stats->outliers++;
+
+  // Jacobson/Karels estimator as used for TCP retransmission timeouts
+  stats->mean_ns      += error / 8;
+  stats->deviation_ns += (deviation - stats->deviation_ns) / 4;
+
+  // stochastic approximation of the 99th percentile: 99 steps down balance 1 step up
+  int64_t step = stats->deviation_ns / 16 + 1000;
+  if (latency > stats->p99_ns)
+    stats->p99_ns += step * 99;
+  else if (stats->p99_ns > step)
+    stats->p99_ns -= step;
+  if (stats->p99_ns > stats->max_ns)
+    stats->p99_ns = stats->max_ns;
+}
+
+const ResponseStats *PortHandler::getResponseStats(uint8_t id)
+{
+  if (response_stats_ == 0 || (id > 252 && id != RESPONSE_STATS_ALL))
+    return 0;
+  return &response_stats_[id];
+}
+
+void PortHandler::clearResponseStats()
+{
+  if (response_stats_ == 0)
+    return;
+  for (int i = 0; i < RESPONSE_STATS_SIZE; i++)
+    memset(&response_stats_[i], 0, sizeof(ResponseStats));
+}
+
+void PortHandler::setBusStats(bool enable)
+{
+  if (enable && bus_stats_ == 0)
+  {
+    bus_stats_      = new BusStats;
+    bus_stats_base_ = new BusStats;
+    memset(bus_stats_, 0, sizeof(BusStats));
+    memset(bus_stats_base_, 0, sizeof(BusStats));
+  }
+  bus_stats_enabled_ = enable;
+}
+
+bool PortHandler::isBusStats()
+{
+  return bus_stats_enabled_;
+}
+
+// seqlock: BusStats::sequence is odd while the thread using the port updates the statistics
+bool PortHandler::beginBusStats()
+{
+  if (bus_stats_enabled_ == false)
+    return false;
+  bus_stats_->sequence++;
+  BUS_STATS_RELEASE();
+  return true;
+}
+
+void PortHandler::endBusStats()
+{
+  BUS_STATS_RELEASE();
+  bus_stats_->sequence++;
+}
+
+void PortHandler::copyBusStats(BusStats *stats)
+{
+  volatile uint32_t *sequence = &bus_stats_->sequence;
+  uint32_t begin, end;
+
+  do
+  {
+    while ((begin = *sequence) & 1)
+      ;
+    BUS_STATS_ACQUIRE();
+    memcpy(stats, bus_stats_, sizeof(BusStats));
+    BUS_STATS_ACQUIRE();
+    end = *sequence;
+  } while (begin != end);
+}
+
+bool PortHandler::getBusStats(BusStats *stats)
+{
+  if (bus_stats_ == 0)
+    return false;
+
+  copyBusStats(stats);
+
+  BusStats *base = bus_stats_base_;
+  stats->tx_bytes         -= base->tx_bytes;
+  stats->rx_bytes         -= base->rx_bytes;
+  stats->tx_packets       -= base->tx_packets;
+  stats->rx_packets       -= base->rx_packets;
+  stats->syscalls         -= base->syscalls;
+  stats->rx_timeouts      -= base->rx_timeouts;
+  stats->rx_corrupts      -= base->rx_corrupts;
+  stats->checksum_errors  -= base->checksum_errors;
+  stats->resyncs          -= base->resyncs;
+  stats->resync_bytes     -= base->resync_bytes;
+
+  for (int i = 0; i < BusStats::INSTRUCTION_COUNT_ + BusStats::ID_COUNT_; i++)
+  {
+    LatencyHistogram *histogram = (i < BusStats::INSTRUCTION_COUNT_) ? &stats->instruction_latency[i] : &stats->id_latency[i - BusStats::INSTRUCTION_COUNT_];
+    LatencyHistogram *previous  = (i < BusStats::INSTRUCTION_COUNT_) ? &base->instruction_latency[i] : &base->id_latency[i - BusStats::INSTRUCTION_COUNT_];
+
+    histogram->count  -= previous->count;
+    histogram->sum_ns -= previous->sum_ns;
+    for (int b = 0; b < LatencyHistogram::BUCKET_COUNT_; b++)
+      histogram->buckets[b] -= previous->buckets[b];
+  }
+  return true;
+}
+
+void PortHandler::clearBusStats()
+{
+  if (bus_stats_ == 0)
+    return;
+  copyBusStats(bus_stats_base_);
+}
+
+void PortHandler::addBusLatency(LatencyHistogram *histogram, int64_t latency)
+{
+  int     bucket  = 0;
+  int64_t usec    = latency / 1000;
+
+  while (usec >= 2 && bucket < LatencyHistogram::BUCKET_COUNT_ - 1)
+  {
+    usec >>= 1;
+    bucket++;
+  }
+  histogram->count++;
+  histogram->buckets[bucket]++;
+  histogram->sum_ns += latency;
+}
+
+void PortHandler::addBusSyscall()
+{
+  if (beginBusStats() == false)
+    return;
+  bus_stats_->syscalls++;
+  endBusStats();
+}
+
+void PortHandler::addBusTx(uint8_t instruction, int length)
+{
+  if (beginBusStats() == false)
+    return;
+  bus_instruction_ = instruction;
+  bus_tx_ns_       = getCurrentTimeNs();
+  bus_stats_->tx_packets++;
+  bus_stats_->tx_bytes += length;
+  endBusStats();
+}
+
+void PortHandler::addBusRx(int length)
+{
+  if (length <= 0 || beginBusStats() == false)
+    return;
+  bus_stats_->rx_bytes += length;
+  endBusStats();
+}
+
+void PortHandler::addBusResync(int length)
+{
+  if (length <= 0 || beginBusStats() == false)
+    return;
+  bus_stats_->resyncs++;
+  bus_stats_->resync_bytes += length;
+  endBusStats();
+}
+
+void PortHandler::addBusChecksumError()
+{
+  if (beginBusStats() == false)
+    return;
+  bus_stats_->checksum_errors++;
+  endBusStats();
+}
+
+void PortHandler::addBusStatus(uint8_t id, int result)
+{
+  if (beginBusStats() == false)
+    return;
+
+  if (result == COMM_SUCCESS)
+  {
+    int64_t latency = getCurrentTimeNs() - bus_tx_ns_;
+
+    bus_stats_->rx_packets++;
+    if (id < BusStats::ID_COUNT_)
+      addBusLatency(&bus_stats_->id_latency[id], latency);
+
+    // the histogram of the instruction is taken on the first use
+    for (int i = 0; i < BusStats::INSTRUCTION_COUNT_; i++)
+    {
+      if (bus_stats_->instructions[i] == 0)
+        bus_stats_->instructions[i] = bus_instruction_;
+      if (bus_stats_->instructions[i] == bus_instruction_)
+      {
+        addBusLatency(&bus_stats_->instruction_latency[i], latency);
+        break;
+      }
+    }
+  }
+  else if (result == COMM_RX_TIMEOUT)
+  {
+    bus_stats_->rx_timeouts++;
+  }
+  else if (result == COMM_RX_CORRUPT)
+  {
+    bus_stats_->rx_corrupts++;
+  }
+  endBusStats();
+}
+
+bool PortHandler::acquireBus(double timeout_msec, int priority)
+{
+  return bus_lock_->acquire(timeout_msec, priority);
+}
+
+bool PortHandler::acquireBus()
+{
+  return bus_lock_->acquire(bus_timeout_msec_);
+}
+
+void PortHandler::releaseBus()
+{
+  if (bus_lock_->isOwner() == false)
+    return;
+
+  // the packet transaction abandoned keeps the last acquisition
+  if (is_using_ && bus_lock_->getDepth() == 2)
+  {
+    is_using_ = false;
+    bus_lock_->release();
+  }
+  if (bus_lock_->getDepth() == 1)
+    onBusRelease();
+  bus_lock_->release();
+}
+
+bool PortHandler::isBusOwner()
+{
+  return bus_lock_->isOwner();
+}
+
+void PortHandler::setBusTimeout(double msec)
+{
+  bus_timeout_msec_ = msec;
+}
+
+bool PortHandler::beginTransaction()
+{
+  // is_using_ is changed only by the thread owning the port
+  if (bus_lock_->isOwner() && is_using_)
+    return false;
+  if (bus_lock_->acquire(bus_timeout_msec_) == false)
+    return false;
+  is_using_ = true;
+  return true;
+}
+
+void PortHandler::endTransaction()
+{
+  if (bus_lock_->isOwner() == false || is_using_ == false)
+    return;
+  is_using_ = false;
+  if (bus_lock_->getDepth() == 1)
+    onBusRelease();
+  bus_lock_->release();
+}
+
+StatusPacketParser *PortHandler::getStatusParser()
+{
+  if (status_parser_ == 0)
+    status_parser_ = new StatusPacketParser();
+  return status_parser_;
+}
+
+uint8_t *PortHandler::getPacketBuffer(int length)
+{
+  if (packet_buffer_length_ < length)
+  {
+    delete[] packet_buffer_;
+    packet_buffer_        = new uint8_t[length];
+    packet_buffer_length_ = length;
+  }
+  return packet_buffer_;
+}
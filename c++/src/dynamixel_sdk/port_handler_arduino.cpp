@@ -47,9 +47,9 @@ using namespace dynamixel;
 
 PortHandlerArduino::PortHandlerArduino(const char *port_name)
   : baudrate_(DEFAULT_BAUDRATE_),
-    packet_start_time_(0.0),
-    packet_timeout_(0.0),
-    tx_time_per_byte(0.0)
+    tx_time_per_byte(0.0),
+    last_micros_(0),
+    elapsed_ns_(0)
 {
   is_using_ = false;
   setPortName(port_name);
@@ -194,43 +194,19 @@ int PortHandlerArduino::writePort(uint8_t *packet, int length)
   return length_written;
 }
 
-void PortHandlerArduino::setPacketTimeout(uint16_t packet_length)
-{
-  packet_start_time_  = getCurrentTime();
-  packet_timeout_     = (tx_time_per_byte * (double)packet_length) + (LATENCY_TIMER * 2.0) + 2.0;
-}
-
-void PortHandlerArduino::setPacketTimeout(double msec)
-{
-  packet_start_time_  = getCurrentTime();
-  packet_timeout_     = msec;
-}
-
-bool PortHandlerArduino::isPacketTimeout()
-{
-  if (getTimeSinceStart() > packet_timeout_)
-  {
-    packet_timeout_ = 0;
-    return true;
-  }
-
-  return false;
-}
-
-double PortHandlerArduino::getCurrentTime()
+int64_t PortHandlerArduino::getCurrentTimeNs()
 {
-	return (double)millis();
+  // micros() wraps around every 71 minutes, so the elapsed time is accumulated
+  uint32_t now = micros();
+  elapsed_ns_  += (int64_t)(uint32_t)(now - last_micros_) * 1000LL;
+  last_micros_ = now;
+  return elapsed_ns_;
 }
 
-double PortHandlerArduino::getTimeSinceStart()
+void PortHandlerArduino::setPacketTimeout(uint16_t packet_length)
 {
-  double elapsed_time;
-
-  elapsed_time = getCurrentTime() - packet_start_time_;
-  if (elapsed_time < 0.0)
-    packet_start_time_ = getCurrentTime();
-
-  return elapsed_time;
+  double timeout = (tx_time_per_byte * (double)packet_length) + (LATENCY_TIMER * 2.0) + 2.0;
+  setPacketDeadline(getCurrentTimeNs() + (int64_t)(timeout * 1000000.0));
 }
 
 bool PortHandlerArduino::setupPort(int baudrate)
@@ -0,0 +1,324 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#if defined(__linux__)
+
+#include <stdio.h>
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "port_handler_client.h"
+
+#define LATENCY_TIMER   8  // msec (USB latency timer when the daemon does not know it)
+
+using namespace dynamixel;
+
+PortHandlerClient::PortHandlerClient(const char *port_name)
+  : socket_fd_(-1),
+    baudrate_(DEFAULT_BAUDRATE_),
+    latency_timer_(-1),
+    tx_time_per_byte(0.0),
+    priority_(0),
+    clear_pending_(false),
+    holding_(false),
+    rx_head_(0),
+    rx_tail_(0)
+{
+  is_using_ = false;
+  setPortName(port_name);
+}
+
+void PortHandlerClient::setPriority(int priority)
+{
+  priority_ = priority;
+}
+
+int PortHandlerClient::getPriority()
+{
+  return priority_;
+}
+
+bool PortHandlerClient::openPort()
+{
+  struct sockaddr_un  addr;
+  const char         *path = (strncmp(port_name_, "unix:", 5) == 0) ? port_name_ + 5 : port_name_;
+
+  closePort();
+  if (strlen(path) >= sizeof(addr.sun_path))
+  {
+    printf("[PortHandlerClient::openPort] Socket path is too long!\n");
+    return false;
+  }
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path);
+
+  socket_fd_ = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+  if (socket_fd_ < 0 || connect(socket_fd_, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+  {
+    printf("[PortHandlerClient::openPort] Error connecting to %s!\n", path);
+    closePort();
+    return false;
+  }
+
+  // the daemon sends the settings of its port first
+  if (receiveMessage(true, true, 0) != BUS_MESSAGE_INFO)
+  {
+    printf("[PortHandlerClient::openPort] No answer from %s!\n", path);
+    closePort();
+    return false;
+  }
+  tx_time_per_byte = (1000.0 / (double)baudrate_) * 10.0;
+  return true;
+}
+
+void PortHandlerClient::closePort()
+{
+  if (socket_fd_ != -1)
+    close(socket_fd_);
+  socket_fd_      = -1;
+  holding_        = false;
+  clear_pending_  = false;
+  rx_head_ = rx_tail_ = 0;
+}
+
+void PortHandlerClient::clearPort()
+{
+  // the bytes the daemon has not sent yet are cleared with the next write
+  clear_pending_ = true;
+  rx_head_ = rx_tail_ = 0;
+}
+
+void PortHandlerClient::setPortName(const char *port_name)
+{
+  strcpy(port_name_, port_name);
+}
+
+char *PortHandlerClient::getPortName()
+{
+  return port_name_;
+}
+
+bool PortHandlerClient::setBaudRate(const int baudrate)
+{
+  if (socket_fd_ == -1 && openPort() == false)
+    return false;
+  if (baudrate == baudrate_)
+    return true;
+
+  printf("[PortHandlerClient::setBaudRate] The daemon serves the bus at %d bps!\n", baudrate_);
+  return false;
+}
+
+int PortHandlerClient::getBaudRate()
+{
+  return baudrate_;
+}
+
+int PortHandlerClient::getBytesAvailable()
+{
+  while (receiveMessage(false, false, 0) > 0)
+    ;
+  return rx_tail_ - rx_head_;
+}
+
+int PortHandlerClient::readPort(uint8_t *packet, int length)
+{
+  if (rx_tail_ - rx_head_ < length)
+  {
+    while (receiveMessage(false, false, 0) > 0)
+      ;
+  }
+
+  if (length > rx_tail_ - rx_head_)
+    length = rx_tail_ - rx_head_;
+  memcpy(packet, &rx_buffer_[rx_head_], length);
+  rx_head_ += length;
+  if (rx_head_ == rx_tail_)
+    rx_head_ = rx_tail_ = 0;
+  return length;
+}
+
+int PortHandlerClient::writePort(uint8_t *packet, int length)
+{
+  PortBuffer buffer = { packet, length };
+  return writePortv(&buffer, 1);
+}
+
+int PortHandlerClient::writePortv(PortBuffer *buffers, int count)
+{
+  uint8_t packet[BUS_MESSAGE_DATA_MAX];
+  uint8_t flags   = 0;
+  int     length  = 0;
+
+  for (int i = 0; i < count; i++)
+  {
+    if (length + buffers[i].length > BUS_MESSAGE_DATA_MAX)
+      return -1;
+    memcpy(&packet[length], buffers[i].data, buffers[i].length);
+    length += buffers[i].length;
+  }
+
+  if (clear_pending_)
+    flags |= BUS_MESSAGE_CLEAR;
+  if (isBusOwner() == false)
+    flags |= BUS_MESSAGE_AUTO_END;
+
+  if (socket_fd_ == -1 || BusDaemon::sendMessage(socket_fd_, BUS_MESSAGE_TX, flags, priority_, packet, length) == false)
+    return -1;
+  addBusSyscall();
+  clear_pending_  = false;
+  holding_        = ((flags & BUS_MESSAGE_AUTO_END) == 0);
+
+  // the write is done when the bus is granted to the port.
+  // the bytes received before are of the previous packets, and are dropped when the port is cleared.
+  int32_t result = -1;
+  int     type;
+  while ((type = receiveMessage(true, (flags & BUS_MESSAGE_CLEAR) != 0, &result)) != BUS_MESSAGE_TX_DONE)
+  {
+    if (type < 0)
+      return -1;
+  }
+  return result;
+}
+
+bool PortHandlerClient::waitForBytes()
+{
+  if (rx_tail_ > rx_head_)
+    return true;
+
+  int64_t remaining = packet_deadline_ns_ - getCurrentTimeNs();
+  if (remaining <= 0)
+    return false;
+
+  struct pollfd   pfd;
+  struct timespec ts;
+
+  pfd.fd      = socket_fd_;
+  pfd.events  = POLLIN;
+  pfd.revents = 0;
+  ts.tv_sec   = (time_t)(remaining / 1000000000LL);
+  ts.tv_nsec  = (long)(remaining % 1000000000LL);
+
+  int result = ppoll(&pfd, 1, &ts, NULL);
+  addBusSyscall();
+  return (result != 0);
+}
+
+int64_t PortHandlerClient::getCurrentTimeNs()
+{
+  struct timespec tv;
+  clock_gettime(CLOCK_MONOTONIC, &tv);
+  return (int64_t)tv.tv_sec * 1000000000LL + (int64_t)tv.tv_nsec;
+}
+
+void PortHandlerClient::setPacketTimeout(uint16_t packet_length)
+{
+  double latency = (latency_timer_ >= 0) ? latency_timer_ : LATENCY_TIMER;
+  double timeout = (tx_time_per_byte * (double)packet_length) + (latency * 2.0) + 2.0;
+  setPacketDeadline(getCurrentTimeNs() + (int64_t)(timeout * 1000000.0));
+}
+
+void PortHandlerClient::onBusRelease()
+{
+  if (holding_ == false)
+    return;
+  holding_ = false;
+  if (socket_fd_ != -1 && BusDaemon::sendMessage(socket_fd_, BUS_MESSAGE_END, 0, 0, 0, 0))
+    addBusSyscall();
+}
+
+// receives a message from the daemon, and returns its type,
+// 0 when no message is received, or -1 when the connection is closed
+int PortHandlerClient::receiveMessage(bool wait, bool drop_rx, int32_t *value)
+{
+  BusMessageHeader header;
+
+  if (socket_fd_ == -1)
+    return -1;
+
+  int length = recv(socket_fd_, message_, sizeof(message_), wait ? 0 : MSG_DONTWAIT);
+  addBusSyscall();
+  if (length < 0 && (errno == EAGAIN || errno == EINTR))
+    return 0;
+  if (length < (int)sizeof(header))
+  {
+    printf("[PortHandlerClient::receiveMessage] Connection to the daemon is closed!\n");
+    closePort();
+    return -1;
+  }
+
+  memcpy(&header, message_, sizeof(header));
+  uint8_t *data         = &message_[sizeof(header)];
+  int      data_length  = length - (int)sizeof(header);
+  if (value != 0)
+    *value = header.value;
+
+  switch (header.type)
+  {
+    case BUS_MESSAGE_RX:
+      if (drop_rx)
+        break;
+      if (RX_BUFFER_SIZE_ - rx_tail_ < data_length)
+      {
+        memmove(rx_buffer_, &rx_buffer_[rx_head_], rx_tail_ - rx_head_);
+        rx_tail_ -= rx_head_;
+        rx_head_  = 0;
+      }
+      // the bytes over the buffer are lost, as by the driver of a serial port
+      if (data_length > RX_BUFFER_SIZE_ - rx_tail_)
+        data_length = RX_BUFFER_SIZE_ - rx_tail_;
+      memcpy(&rx_buffer_[rx_tail_], data, data_length);
+      rx_tail_ += data_length;
+      break;
+
+    case BUS_MESSAGE_INFO:
+      baudrate_ = header.value;
+      if (data_length >= (int)sizeof(int32_t))
+      {
+        int32_t latency_timer;
+        memcpy(&latency_timer, data, sizeof(latency_timer));
+        latency_timer_ = latency_timer;
+      }
+      break;
+
+    default:
+      break;
+  }
+  return header.type;
+}
+
+#endif
@@ -33,27 +33,108 @@
 #if defined(__linux__)
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
 #include <string.h>
 #include <unistd.h>
 #include <termios.h>
 #include <time.h>
 #include <sys/time.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 #include <linux/serial.h>
+#include <sys/syscall.h>
+// the io_uring path needs the kernel headers of Linux 5.11 or later, as SerialUring in serial_uring.cpp
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#endif
+#endif
+#if defined(IORING_ENTER_EXT_ARG) && defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define SERIAL_URING
+#endif
 
 #include "port_handler_linux.h"
-
-#define LATENCY_TIMER   8  // msec (USB latency timer) [was changed from 4 due to the Ubuntu update 16.04.2]
+#include "serial_uring.h"
+
+#define LATENCY_TIMER   8  // msec (USB latency timer when it cannot be read) [was changed from 4 due to the Ubuntu update 16.04.2]
+#define IOV_COUNT       16 // buffers written by one writev()
+
+// operations of the io_uring requests, in the low bits of user_data
+#define URING_WRITE           1
+#define URING_WRITE_TIMEOUT   2
+#define URING_POLL            3
+#define URING_READ            4
+#define URING_CANCEL          5
+#define URING_WRITE_MARGIN    100   // msec allowed for a write more than the time to transfer it
+#define URING_CANCEL_WAIT     100   // msec waited for the requests cancelled
+
+// struct termios2 of <asm/termbits.h>, which cannot be included with <termios.h>
+#if defined(TCGETS2) && (defined(__i386__) || defined(__x86_64__) || defined(__arm__) || defined(__aarch64__) || defined(__riscv))
+#define USE_TERMIOS2
+#ifndef BOTHER
+#define BOTHER          0010000
+#endif
+#ifndef IBSHIFT
+#define IBSHIFT         16
+#endif
+struct termios2
+{
+  tcflag_t  c_iflag;
+  tcflag_t  c_oflag;
+  tcflag_t  c_cflag;
+  tcflag_t  c_lflag;
+  cc_t      c_line;
+  cc_t      c_cc[19];
+  speed_t   c_ispeed;
+  speed_t   c_ospeed;
+};
+#endif
 
 using namespace dynamixel;
 
+// errors of read()/write() when the device is gone (ex. a USB serial converter unplugged)
+static bool isDeviceLost(int error)
+{
+  return (error == EIO || error == ENODEV || error == ENXIO);
+}
+
 PortHandlerLinux::PortHandlerLinux(const char *port_name)
   : socket_fd_(-1),
     baudrate_(DEFAULT_BAUDRATE_),
-    packet_start_time_(0.0),
-    packet_timeout_(0.0),
-    tx_time_per_byte(0.0)
+    tx_time_per_byte(0.0),
+    latency_timer_request_(DEFAULT_LATENCY_TIMER_),
+    latency_timer_(-1),
+    low_latency_(false),
+    rs485_enabled_(false),
+    rs485_rts_on_send_(true),
+    rs485_delay_before_send_(0),
+    rs485_delay_after_send_(0),
+    echo_suppression_(false),
+    echo_remaining_(0),
+    rx_head_(0),
+    rx_tail_(0),
+    rx_idle_until_ns_(0),
+    uring_(0),
+    uring_pending_(0),
+    uring_read_armed_(false),
+    uring_write_busy_(false),
+    uring_write_failed_(false),
+    uring_write_deadline_ns_(0),
+    uring_write_sequence_(0),
+    uring_tx_length_(0),
+    port_state_(PORT_CLOSED_),
+    device_lost_(false),
+    reconnect_enabled_(true),
+    reconnect_interval_(DEFAULT_RECONNECT_INTERVAL_),
+    reconnect_time_ns_(0),
+    disconnect_time_ns_(0),
+    recovery_time_ns_(0),
+    state_callback_(0),
+    state_callback_arg_(0)
 {
   is_using_ = false;
   setPortName(port_name);
@@ -66,14 +147,25 @@ bool PortHandlerLinux::openPort()
 
 void PortHandlerLinux::closePort()
 {
+  stopUring();
   if(socket_fd_ != -1)
     close(socket_fd_);
   socket_fd_ = -1;
+  rx_head_ = rx_tail_ = 0;
+  rx_idle_until_ns_ = 0;
+  port_state_   = PORT_CLOSED_;
+  device_lost_  = false;
 }
 
 void PortHandlerLinux::clearPort()
 {
+  if (uring_ != 0)
+    uring_->reap();
   tcflush(socket_fd_, TCIOFLUSH);
+  addBusSyscall();
+  echo_remaining_ = 0;
+  rx_head_ = rx_tail_;
+  rx_idle_until_ns_ = 0;
 }
 
 void PortHandlerLinux::setPortName(const char *port_name)
@@ -89,21 +181,13 @@ char *PortHandlerLinux::getPortName()
 // TODO: baud number ??
 bool PortHandlerLinux::setBaudRate(const int baudrate)
 {
-  int baud = getCFlagBaud(baudrate);
-
   closePort();
+  baudrate_ = baudrate;
 
-  if(baud <= 0)   // custom baudrate
-  {
-    setupPort(B38400);
-    baudrate_ = baudrate;
-    return setCustomBaudrate(baudrate);
-  }
-  else
-  {
-    baudrate_ = baudrate;
-    return setupPort(baud);
-  }
+  if (openDevice() == false)
+    return false;
+  port_state_ = PORT_CONNECTED_;
+  return true;
 }
 
 int PortHandlerLinux::getBaudRate()
@@ -114,58 +198,401 @@ int PortHandlerLinux::getBaudRate()
 int PortHandlerLinux::getBytesAvailable()
 {
   int bytes_available;
+  if (uring_ != 0)
+    uring_->reap();
   ioctl(socket_fd_, FIONREAD, &bytes_available);
-  return bytes_available;
+  addBusSyscall();
+  bytes_available += (int)(rx_tail_ - rx_head_);
+  if (bytes_available <= echo_remaining_)
+    return 0;
+  return bytes_available - echo_remaining_;
 }
 
 int PortHandlerLinux::readPort(uint8_t *packet, int length)
 {
-  return read(socket_fd_, packet, length);
+  int result    = 0;
+  int buffered  = (int)(rx_tail_ - rx_head_);
+
+  if (device_lost_)
+    disconnectPort();
+  if (port_state_ == PORT_DISCONNECTED_)
+    return 0;
+
+  if (buffered - echo_remaining_ < length)
+  {
+    result    = fillRxBuffer();
+    buffered  = (int)(rx_tail_ - rx_head_);
+  }
+
+  // the echo is dropped from the ring buffer
+  if (echo_remaining_ > 0)
+  {
+    int drop = (echo_remaining_ < buffered) ? echo_remaining_ : buffered;
+    rx_head_        += drop;
+    echo_remaining_ -= drop;
+    buffered        -= drop;
+  }
+
+  if (buffered == 0)
+    return (result < 0) ? result : 0;
+
+  if (length > buffered)
+    length = buffered;
+
+  uint32_t offset = rx_head_ & (RX_BUFFER_SIZE_ - 1);
+  int      first  = RX_BUFFER_SIZE_ - offset;
+  if (first >= length)
+  {
+    memcpy(packet, &rx_buffer_[offset], length);
+  }
+  else
+  {
+    memcpy(packet, &rx_buffer_[offset], first);
+    memcpy(&packet[first], rx_buffer_, length - first);
+  }
+  rx_head_ += length;
+  return length;
 }
 
 int PortHandlerLinux::writePort(uint8_t *packet, int length)
 {
-  return write(socket_fd_, packet, length);
+  if (checkConnection() == false)
+    return -1;
+
+  if (uring_ != 0)
+  {
+    PortBuffer buffer = { packet, length };
+    return writePortv(&buffer, 1);
+  }
+
+  int result = write(socket_fd_, packet, length);
+  addBusSyscall();
+  if (result < 0 && isDeviceLost(errno))
+    disconnectPort();
+  if (result > 0)
+    holdRxBuffer(result);
+  return result;
+}
+
+int PortHandlerLinux::writePortv(PortBuffer *buffers, int count)
+{
+  struct iovec iov[IOV_COUNT];
+  int          length = 0;
+
+  if (checkConnection() == false)
+    return -1;
+
+  for (int i = 0; i < count; i++)
+    length += buffers[i].length;
+
+#if defined(SERIAL_URING)
+  // the packet is copied, as it is written after the caller returns when a batch is open
+  if (uring_ != 0 && length <= RX_BUFFER_SIZE_)
+  {
+    // the writes of a port are not ordered by io_uring, so a write held by a batch is extended
+    io_uring_sqe *sqe = uring_write_busy_ ? uring_->getHeldEntry(uring_write_sequence_) : 0;
+    if (sqe == 0 || uring_tx_length_ + length > RX_BUFFER_SIZE_)
+    {
+      // the write in flight ends by its linked timeout at the latest
+      int64_t now = getCurrentTimeNs();
+      while (uring_write_busy_ && now < uring_write_deadline_ns_)
+      {
+        uring_->enter(uring_write_deadline_ns_ - now);
+        now = getCurrentTimeNs();
+      }
+      if (uring_write_busy_)
+        return -1;
+      uring_tx_length_ = 0;
+      sqe = 0;
+    }
+
+    // a write which failed after the call which made it had returned fails this call
+    if (uring_write_failed_)
+    {
+      uring_write_failed_ = false;
+      return -1;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+      memcpy(&uring_tx_buffer_[uring_tx_length_], buffers[i].data, buffers[i].length);
+      uring_tx_length_ += buffers[i].length;
+    }
+
+    int64_t timeout = (int64_t)((tx_time_per_byte * uring_tx_length_ + URING_WRITE_MARGIN) * 1000000.0);
+    uring_write_timeout_[0] = timeout / 1000000000LL;
+    uring_write_timeout_[1] = timeout % 1000000000LL;
+    uring_write_deadline_ns_ = getCurrentTimeNs() + timeout + URING_CANCEL_WAIT * 1000000LL;
+
+    if (echo_suppression_)
+      echo_remaining_ += length;
+
+    if (sqe != 0)
+    {
+      sqe->len = uring_tx_length_;
+      return length;
+    }
+
+    uring_->reserve(2);
+    uring_write_sequence_ = uring_->getSequence();
+    sqe = uring_->getEntry();
+    sqe->opcode     = IORING_OP_WRITE;
+    sqe->fd         = socket_fd_;
+    sqe->addr       = (uint64_t)(uintptr_t)uring_tx_buffer_;
+    sqe->len        = uring_tx_length_;
+    sqe->flags      = IOSQE_IO_LINK;
+    sqe->user_data  = (uint64_t)(uintptr_t)this | URING_WRITE;
+    sqe = uring_->getEntry();
+    sqe->opcode     = IORING_OP_LINK_TIMEOUT;
+    sqe->addr       = (uint64_t)(uintptr_t)uring_write_timeout_;
+    sqe->len        = 1;
+    sqe->user_data  = (uint64_t)(uintptr_t)this | URING_WRITE_TIMEOUT;
+    uring_pending_   += 2;
+    uring_write_busy_ = true;
+
+    armUringRead();
+    if (uring_->submit() > 0)
+      addBusSyscall();
+    return length;
+  }
+#endif
+
+  if (count > IOV_COUNT)
+    return PortHandler::writePortv(buffers, count);
+
+  for (int i = 0; i < count; i++)
+  {
+    iov[i].iov_base = buffers[i].data;
+    iov[i].iov_len  = buffers[i].length;
+  }
+
+  int result = writev(socket_fd_, iov, count);
+  addBusSyscall();
+  if (result < 0 && isDeviceLost(errno))
+    disconnectPort();
+  if (result > 0)
+    holdRxBuffer(result);
+  return result;
+}
+
+bool PortHandlerLinux::waitForBytes()
+{
+  if ((int)(rx_tail_ - rx_head_) > echo_remaining_)
+    return true;
+
+  int64_t remaining = packet_deadline_ns_ - getCurrentTimeNs();
+  if(remaining <= 0)
+    return false;
+
+  if (checkConnection() == false)
+  {
+    // nothing comes until the device is back, so the receiving loop ends by the packet timeout
+    int64_t         wake = packet_deadline_ns_;
+    struct timespec ts;
+    if (reconnect_enabled_ && reconnect_time_ns_ < wake)
+      wake = reconnect_time_ns_;
+    ts.tv_sec   = (time_t)(wake / 1000000000LL);
+    ts.tv_nsec  = (long)(wake % 1000000000LL);
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+    return false;
+  }
+
+  if (uring_ != 0)
+  {
+    // the completions of the other ports on the same instance are taken as well
+    armUringRead();
+    uring_->enter(remaining);
+    addBusSyscall();
+    if (device_lost_)
+    {
+      disconnectPort();
+      return false;
+    }
+    return true;
+  }
+
+  struct pollfd   pfd;
+  struct timespec ts;
+
+  pfd.fd      = socket_fd_;
+  pfd.events  = POLLIN;
+  pfd.revents = 0;
+  ts.tv_sec   = (time_t)(remaining / 1000000000LL);
+  ts.tv_nsec  = (long)(remaining % 1000000000LL);
+
+  // error (e.g. EINTR) is reported as readable, so the caller re-checks the port and the timeout
+  int result = ppoll(&pfd, 1, &ts, NULL);
+  addBusSyscall();
+  if (result != 0)
+    rx_idle_until_ns_ = 0;
+  if (result > 0 && (pfd.revents & (POLLHUP | POLLERR | POLLNVAL)) != 0)
+  {
+    disconnectPort();
+    return false;
+  }
+  return (result != 0);
+}
+
+int64_t PortHandlerLinux::getCurrentTimeNs()
+{
+  struct timespec tv;
+  clock_gettime(CLOCK_MONOTONIC, &tv);
+  return (int64_t)tv.tv_sec * 1000000000LL + (int64_t)tv.tv_nsec;
+}
+
+bool PortHandlerLinux::setRS485(bool enable, bool rts_on_send, int delay_before_send, int delay_after_send)
+{
+  rs485_enabled_            = enable;
+  rs485_rts_on_send_        = rts_on_send;
+  rs485_delay_before_send_  = delay_before_send;
+  rs485_delay_after_send_   = delay_after_send;
+
+  if (socket_fd_ == -1 || setupRS485() == true)
+    return true;
+
+  rs485_enabled_ = false;
+  return false;
+}
+
+bool PortHandlerLinux::isRS485()
+{
+  return rs485_enabled_;
+}
+
+void PortHandlerLinux::setEchoSuppression(bool enable)
+{
+  echo_suppression_ = enable;
+  echo_remaining_   = 0;
+}
+
+void PortHandlerLinux::setLatencyTimer(int msec)
+{
+  latency_timer_request_ = msec;
+}
+
+int PortHandlerLinux::getLatencyTimer()
+{
+  return latency_timer_;
+}
+
+bool PortHandlerLinux::isLowLatency()
+{
+  return low_latency_;
 }
 
 void PortHandlerLinux::setPacketTimeout(uint16_t packet_length)
 {
-  packet_start_time_  = getCurrentTime();
-  packet_timeout_     = (tx_time_per_byte * (double)packet_length) + (LATENCY_TIMER * 2.0) + 2.0;
+  double latency = (latency_timer_ >= 0) ? latency_timer_ : LATENCY_TIMER;
+  double timeout = (tx_time_per_byte * (double)packet_length) + (latency * 2.0) + 2.0;
+  setPacketDeadline(getCurrentTimeNs() + (int64_t)(timeout * 1000000.0));
+}
+
+void PortHandlerLinux::setAutoReconnect(bool enable, int interval_msec)
+{
+  reconnect_enabled_  = enable;
+  reconnect_interval_ = interval_msec;
 }
 
-void PortHandlerLinux::setPacketTimeout(double msec)
+void PortHandlerLinux::setPortStateCallback(PortStateCallback callback, void *arg)
 {
-  packet_start_time_  = getCurrentTime();
-  packet_timeout_     = msec;
+  state_callback_     = callback;
+  state_callback_arg_ = arg;
 }
 
-bool PortHandlerLinux::isPacketTimeout()
+int PortHandlerLinux::getPortState()
 {
-  if(getTimeSinceStart() > packet_timeout_)
+  return port_state_;
+}
+
+double PortHandlerLinux::getRecoveryTime()
+{
+  return (double)recovery_time_ns_ / 1000000.0;
+}
+
+// opens the port name with baudrate_ and the settings requested
+bool PortHandlerLinux::openDevice()
+{
+  int baud = getCFlagBaud(baudrate_);
+
+  if(baud <= 0)   // custom baudrate
   {
-    packet_timeout_ = 0;
-    return true;
+    if (setupPort(B38400) == false)
+      return false;
+    if (setTermios2Baudrate(baudrate_))
+      return true;
+    return setCustomBaudrate(baudrate_);
   }
-  return false;
+
+  if (setupPort(baud) == false)
+    return false;
+
+  // the driver may round the baudrate to the divisors of its clock
+  int applied = getAppliedBaudrate();
+  if (applied > 0)
+    tx_time_per_byte = (1000.0 / (double)applied) * 10.0;
+  return true;
 }
 
-double PortHandlerLinux::getCurrentTime()
+// handles the loss of the device found before, and tries to open the port again while it is lost
+bool PortHandlerLinux::checkConnection()
 {
-	struct timespec tv;
-	clock_gettime( CLOCK_REALTIME, &tv);
-	return ((double)tv.tv_sec*1000.0 + (double)tv.tv_nsec*0.001*0.001);
+  if (device_lost_)
+    disconnectPort();
+  if (port_state_ == PORT_DISCONNECTED_)
+    return reconnectPort();
+  return true;
+}
+
+void PortHandlerLinux::disconnectPort()
+{
+  // the requests in flight complete with errors, which are not the loss found again
+  stopUring();
+  if (socket_fd_ != -1)
+    close(socket_fd_);
+  socket_fd_      = -1;
+  rx_head_        = rx_tail_;
+  echo_remaining_ = 0;
+  device_lost_    = false;
+
+  if (port_state_ == PORT_DISCONNECTED_)
+    return;
+  disconnect_time_ns_ = getCurrentTimeNs();
+  reconnect_time_ns_  = disconnect_time_ns_ + (int64_t)reconnect_interval_ * 1000000LL;
+  setPortState(PORT_DISCONNECTED_);
 }
 
-double PortHandlerLinux::getTimeSinceStart()
+bool PortHandlerLinux::reconnectPort()
 {
-  double time;
+  if (reconnect_enabled_ == false)
+    return false;
 
-  time = getCurrentTime() - packet_start_time_;
-  if(time < 0.0)
-    packet_start_time_ = getCurrentTime();
+  int64_t now = getCurrentTimeNs();
+  if (now < reconnect_time_ns_)
+    return false;
+  reconnect_time_ns_ = now + (int64_t)reconnect_interval_ * 1000000LL;
 
-  return time;
+  // the device node is created again when the converter is plugged in
+  if (access(port_name_, R_OK | W_OK) != 0)
+    return false;
+
+  if (openDevice() == false)
+  {
+    if (socket_fd_ != -1)
+      close(socket_fd_);
+    socket_fd_ = -1;
+    return false;
+  }
+
+  recovery_time_ns_ = getCurrentTimeNs() - disconnect_time_ns_;
+  setPortState(PORT_CONNECTED_);
+  return true;
+}
+
+void PortHandlerLinux::setPortState(int state)
+{
+  port_state_ = state;
+  if (state_callback_ != 0)
+    state_callback_(this, state, state_callback_arg_);
 }
 
 bool PortHandlerLinux::setupPort(int cflag_baud)
@@ -192,10 +619,264 @@ bool PortHandlerLinux::setupPort(int cflag_baud)
   tcflush(socket_fd_, TCIFLUSH);
   tcsetattr(socket_fd_, TCSANOW, &newtio);
 
+  setupLatencyTimer();
+  if (rs485_enabled_ && setupRS485() == false)
+  {
+    close(socket_fd_);
+    socket_fd_ = -1;
+    return false;
+  }
+
   tx_time_per_byte = (1000.0 / (double)baudrate_) * 10.0;
   return true;
 }
 
+// counts the bytes written for the echo suppression, and holds the reads until they are transmitted
+void PortHandlerLinux::holdRxBuffer(int length)
+{
+  if (echo_suppression_)
+    echo_remaining_ += length;
+  rx_idle_until_ns_ = getCurrentTimeNs() + (int64_t)(tx_time_per_byte * length * 1000000.0);
+}
+
+// reads all bytes available on the port into the free space of the ring buffer by one readv()
+int PortHandlerLinux::fillRxBuffer()
+{
+  // io_uring: the bytes are read by the request kept submitted
+  if (uring_ != 0)
+  {
+    uring_->reap();
+    armUringRead();
+    return 0;
+  }
+
+  // a read while the instruction packet is still being transmitted would find nothing,
+  // so the port is read after that, or once PortHandlerLinux::waitForBytes() sees bytes (ex. the echo)
+  if (rx_idle_until_ns_ != 0)
+  {
+    if (getCurrentTimeNs() < rx_idle_until_ns_)
+      return 0;
+    rx_idle_until_ns_ = 0;
+  }
+
+  struct iovec iov[2];
+  int      space  = RX_BUFFER_SIZE_ - (int)(rx_tail_ - rx_head_);
+  uint32_t offset = rx_tail_ & (RX_BUFFER_SIZE_ - 1);
+  int      first  = RX_BUFFER_SIZE_ - offset;
+
+  if (space == 0)
+    return 0;
+
+  iov[0].iov_base = &rx_buffer_[offset];
+  iov[0].iov_len  = (first < space) ? first : space;
+  iov[1].iov_base = rx_buffer_;
+  iov[1].iov_len  = space - iov[0].iov_len;
+
+  int result = readv(socket_fd_, iov, (iov[1].iov_len > 0) ? 2 : 1);
+  addBusSyscall();
+  if (result > 0)
+    rx_tail_ += result;
+  else if (result < 0 && isDeviceLost(errno))
+  {
+    disconnectPort();
+    return 0;
+  }
+  return result;
+}
+
+bool PortHandlerLinux::setUring(SerialUring *uring)
+{
+  if (uring != 0 && uring->isAvailable() == false)
+    return false;
+
+  stopUring();
+  uring_ = uring;
+  return true;
+}
+
+SerialUring *PortHandlerLinux::getUring()
+{
+  return uring_;
+}
+
+int PortHandlerLinux::getFileDescriptor()
+{
+  return socket_fd_;
+}
+
+// submits a read into the free space of the ring buffer, which waits by poll until bytes arrive
+void PortHandlerLinux::armUringRead()
+{
+#if defined(SERIAL_URING)
+  int space = RX_BUFFER_SIZE_ - (int)(rx_tail_ - rx_head_);
+  // a hung-up port is readable at once, so the read is not repeated after the loss of the device
+  if (uring_ == 0 || uring_read_armed_ || device_lost_ || socket_fd_ < 0 || space == 0)
+    return;
+
+  uint32_t offset = rx_tail_ & (RX_BUFFER_SIZE_ - 1);
+  int      first  = RX_BUFFER_SIZE_ - offset;
+
+  uring_->reserve(2);
+  io_uring_sqe *sqe = uring_->getEntry();
+  sqe->opcode         = IORING_OP_POLL_ADD;
+  sqe->fd             = socket_fd_;
+  sqe->poll32_events  = POLLIN;
+  sqe->flags          = IOSQE_IO_LINK;
+  sqe->user_data      = (uint64_t)(uintptr_t)this | URING_POLL;
+  sqe = uring_->getEntry();
+  sqe->opcode         = IORING_OP_READ;
+  sqe->fd             = socket_fd_;
+  sqe->addr           = (uint64_t)(uintptr_t)&rx_buffer_[offset];
+  sqe->len            = (first < space) ? first : space;
+  sqe->user_data      = (uint64_t)(uintptr_t)this | URING_READ;
+  uring_pending_   += 2;
+  uring_read_armed_ = true;
+#endif
+}
+
+// called by SerialUring::reap()
+void PortHandlerLinux::completeUring(int operation, int result)
+{
+  uring_pending_--;
+  switch (operation)
+  {
+    case URING_WRITE:
+      uring_write_busy_ = false;
+      // failed, or cut short by the linked timeout
+      if (result < uring_tx_length_)
+        uring_write_failed_ = true;
+      if (result < 0 && isDeviceLost(-result))
+        device_lost_ = true;
+      break;
+
+    case URING_POLL:
+      if (result > 0 && (result & (POLLHUP | POLLERR | POLLNVAL)) != 0)
+        device_lost_ = true;
+      break;
+
+    case URING_READ:
+      uring_read_armed_ = false;
+      if (result > 0)
+        rx_tail_ += result;
+      else if (result < 0 && isDeviceLost(-result))
+        device_lost_ = true;
+      // the next read is submitted with the next io_uring_enter(), unless the request was cancelled
+      if (result >= 0 || result == -EAGAIN)
+        armUringRead();
+      break;
+
+    default:
+      break;
+  }
+}
+
+// cancels the requests of the port in flight, and waits for them
+void PortHandlerLinux::stopUring()
+{
+  if (uring_ == 0)
+    return;
+
+  uring_->reap();
+#if defined(SERIAL_URING)
+  if (uring_pending_ > 0)
+  {
+    uring_->reserve(2);
+    io_uring_sqe *sqe = uring_->getEntry();
+    sqe->opcode     = IORING_OP_ASYNC_CANCEL;
+    sqe->addr       = (uint64_t)(uintptr_t)this | URING_POLL;
+    sqe->user_data  = (uint64_t)(uintptr_t)this | URING_CANCEL;
+    sqe = uring_->getEntry();
+    sqe->opcode     = IORING_OP_ASYNC_CANCEL;
+    sqe->addr       = (uint64_t)(uintptr_t)this | URING_READ;
+    sqe->user_data  = (uint64_t)(uintptr_t)this | URING_CANCEL;
+    uring_pending_ += 2;
+
+    int64_t deadline = getCurrentTimeNs() + URING_CANCEL_WAIT * 1000000LL;
+    while (uring_pending_ > 0 && getCurrentTimeNs() < deadline)
+      uring_->enter(1000000);
+  }
+#endif
+  uring_read_armed_   = false;
+  uring_write_busy_   = false;
+  uring_write_failed_ = false;
+}
+
+bool PortHandlerLinux::setupRS485()
+{
+  struct serial_rs485 rs485;
+
+  if (ioctl(socket_fd_, TIOCGRS485, &rs485) != 0)
+  {
+    if (rs485_enabled_ == false)
+      return true;
+    printf("[PortHandlerLinux::SetupRS485] TIOCGRS485 failed! (RS-485 mode is not supported by the driver)\n");
+    return false;
+  }
+
+  rs485.flags &= ~(SER_RS485_ENABLED | SER_RS485_RTS_ON_SEND | SER_RS485_RTS_AFTER_SEND);
+  if (rs485_enabled_)
+  {
+    rs485.flags |= SER_RS485_ENABLED;
+    rs485.flags |= (rs485_rts_on_send_) ? SER_RS485_RTS_ON_SEND : SER_RS485_RTS_AFTER_SEND;
+  }
+  rs485.delay_rts_before_send = rs485_delay_before_send_;
+  rs485.delay_rts_after_send  = rs485_delay_after_send_;
+
+  if (ioctl(socket_fd_, TIOCSRS485, &rs485) != 0)
+  {
+    printf("[PortHandlerLinux::SetupRS485] TIOCSRS485 failed!\n");
+    return false;
+  }
+  return true;
+}
+
+void PortHandlerLinux::setupLatencyTimer()
+{
+  struct serial_struct ss;
+  char  real_name[PATH_MAX];
+  char  sysfs_path[PATH_MAX + 64];
+  FILE *fp;
+
+  // the low latency flag (the ftdi_sio driver also sets its latency timer to 1 msec with it)
+  low_latency_ = false;
+  if (ioctl(socket_fd_, TIOCGSERIAL, &ss) == 0)
+  {
+    if (latency_timer_request_ > 0 && (ss.flags & ASYNC_LOW_LATENCY) == 0)
+    {
+      ss.flags |= ASYNC_LOW_LATENCY;
+      ioctl(socket_fd_, TIOCSSERIAL, &ss);
+      ioctl(socket_fd_, TIOCGSERIAL, &ss);
+    }
+    low_latency_ = ((ss.flags & ASYNC_LOW_LATENCY) != 0);
+  }
+
+  // the latency timer of the USB serial converter (ex. /dev/ttyUSB0 -> /sys/bus/usb-serial/devices/ttyUSB0/latency_timer)
+  latency_timer_ = -1;
+  if (realpath(port_name_, real_name) == NULL || strrchr(real_name, '/') == NULL)
+    return;
+  sprintf(sysfs_path, "/sys/bus/usb-serial/devices/%s/latency_timer", strrchr(real_name, '/') + 1);
+
+  fp = fopen(sysfs_path, "r");
+  if (fp == NULL)
+    return;
+  if (fscanf(fp, "%d", &latency_timer_) != 1)
+    latency_timer_ = -1;
+  fclose(fp);
+
+  if (latency_timer_request_ > 0 && latency_timer_ > latency_timer_request_)
+  {
+    fp = fopen(sysfs_path, "w");
+    if (fp != NULL)
+    {
+      fprintf(fp, "%d", latency_timer_request_);
+      if (fclose(fp) == 0)
+        latency_timer_ = latency_timer_request_;
+    }
+    if (latency_timer_ != latency_timer_request_)
+      printf("[PortHandlerLinux::SetupLatencyTimer] Cannot lower %s from %d msec!\n", sysfs_path, latency_timer_);
+  }
+}
+
 bool PortHandlerLinux::setCustomBaudrate(int speed)
 {
   // try to set a custom divisor
@@ -222,8 +903,49 @@ bool PortHandlerLinux::setCustomBaudrate(int speed)
     return false;
   }
 
-  tx_time_per_byte = (1000.0 / (double)speed) * 10.0;
+  tx_time_per_byte = (1000.0 / (double)closest_speed) * 10.0;
+  return true;
+}
+
+bool PortHandlerLinux::setTermios2Baudrate(int speed)
+{
+#if defined(USE_TERMIOS2)
+  struct termios2 tio;
+  if (ioctl(socket_fd_, TCGETS2, &tio) != 0)
+    return false;
+
+  tio.c_cflag  = (tio.c_cflag & ~(CBAUD | (CBAUD << IBSHIFT))) | BOTHER | (BOTHER << IBSHIFT);
+  tio.c_ispeed = speed;
+  tio.c_ospeed = speed;
+  if (ioctl(socket_fd_, TCSETS2, &tio) != 0)
+    return false;
+
+  int applied = getAppliedBaudrate();
+  if (applied < speed * 98 / 100 || applied > speed * 102 / 100)
+  {
+    printf("[PortHandlerLinux::SetTermios2Baudrate] Cannot set speed to %d, closest is %d \n", speed, applied);
+    return false;
+  }
+
+  tx_time_per_byte = (1000.0 / (double)applied) * 10.0;
   return true;
+#else
+  (void)speed;
+  return false;
+#endif
+}
+
+// returns the output baudrate applied by the driver, or -1 when it is not reported
+int PortHandlerLinux::getAppliedBaudrate()
+{
+#if defined(USE_TERMIOS2)
+  struct termios2 tio;
+  if (ioctl(socket_fd_, TCGETS2, &tio) != 0 || tio.c_ospeed == 0)
+    return -1;
+  return (int)tio.c_ospeed;
+#else
+  return -1;
+#endif
 }
 
 int PortHandlerLinux::getCFlagBaud(int baudrate)
@@ -40,18 +40,18 @@
 #include <time.h>
 #include <sys/time.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 
 #include "port_handler_mac.h"
 
 #define LATENCY_TIMER   8  // msec (USB latency timer)
+#define IOV_COUNT       16 // buffers written by one writev()
 
 using namespace dynamixel;
 
 PortHandlerMac::PortHandlerMac(const char *port_name)
   : socket_fd_(-1),
     baudrate_(DEFAULT_BAUDRATE_),
-    packet_start_time_(0.0),
-    packet_timeout_(0.0),
     tx_time_per_byte(0.0)
 {
   is_using_ = false;
@@ -127,44 +127,32 @@ int PortHandlerMac::writePort(uint8_t *packet, int length)
   return write(socket_fd_, packet, length);
 }
 
-void PortHandlerMac::setPacketTimeout(uint16_t packet_length)
+int PortHandlerMac::writePortv(PortBuffer *buffers, int count)
 {
-  packet_start_time_  = getCurrentTime();
-  packet_timeout_     = (tx_time_per_byte * (double)packet_length) + (LATENCY_TIMER * 2.0) + 2.0;
-}
+  struct iovec iov[IOV_COUNT];
 
-void PortHandlerMac::setPacketTimeout(double msec)
-{
-  packet_start_time_  = getCurrentTime();
-  packet_timeout_     = msec;
-}
+  if (count > IOV_COUNT)
+    return PortHandler::writePortv(buffers, count);
 
-bool PortHandlerMac::isPacketTimeout()
-{
-  if(getTimeSinceStart() > packet_timeout_)
+  for (int i = 0; i < count; i++)
   {
-    packet_timeout_ = 0;
-    return true;
+    iov[i].iov_base = buffers[i].data;
+    iov[i].iov_len  = buffers[i].length;
   }
-  return false;
+  return writev(socket_fd_, iov, count);
 }
 
-double PortHandlerMac::getCurrentTime()
+int64_t PortHandlerMac::getCurrentTimeNs()
 {
-	struct timespec tv;
-	clock_gettime( CLOCK_REALTIME, &tv);
-	return ((double)tv.tv_sec*1000.0 + (double)tv.tv_nsec*0.001*0.001);
+  struct timespec tv;
+  clock_gettime(CLOCK_MONOTONIC, &tv);
+  return (int64_t)tv.tv_sec * 1000000000LL + (int64_t)tv.tv_nsec;
 }
 
-double PortHandlerMac::getTimeSinceStart()
+void PortHandlerMac::setPacketTimeout(uint16_t packet_length)
 {
-  double time;
-
-  time = getCurrentTime() - packet_start_time_;
-  if(time < 0.0)
-    packet_start_time_ = getCurrentTime();
-
-  return time;
+  double timeout = (tx_time_per_byte * (double)packet_length) + (LATENCY_TIMER * 2.0) + 2.0;
+  setPacketDeadline(getCurrentTimeNs() + (int64_t)(timeout * 1000000.0));
 }
 
 bool PortHandlerMac::setupPort(int cflag_baud)
@@ -0,0 +1,298 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#if defined(__linux__)
+
+#include <stdio.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "port_handler_recorder.h"
+
+#define TRACE_CHUNK_SIZE    (16*1024*1024)    // the trace file grows by this size
+
+using namespace dynamixel;
+
+PortHandlerRecorder::PortHandlerRecorder(PortHandler *port, const char *trace_path)
+  : port_(port),
+    fd_(-1),
+    map_((uint8_t *)MAP_FAILED),
+    map_size_(0),
+    offset_(0),
+    last_ns_(0)
+{
+  is_using_ = false;
+
+  fd_ = open(trace_path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if (fd_ < 0 || reserve(sizeof(TraceHeader)) == false)
+  {
+    printf("[PortHandlerRecorder] Error creating %s!\n", trace_path);
+    closeTrace();
+    return;
+  }
+
+  TraceHeader header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, TRACE_MAGIC, sizeof(header.magic));
+  header.version      = TRACE_VERSION;
+  header.header_size  = sizeof(TraceHeader);
+  header.start_ns     = port_->getCurrentTimeNs();
+  header.baudrate     = port_->getBaudRate();
+  strncpy(header.port_name, port_->getPortName(), sizeof(header.port_name) - 1);
+
+  memcpy(map_, &header, sizeof(header));
+  offset_   = sizeof(header);
+  last_ns_  = header.start_ns;
+}
+
+bool PortHandlerRecorder::isRecording()
+{
+  return (map_ != MAP_FAILED);
+}
+
+void PortHandlerRecorder::closeTrace()
+{
+  if (map_ != MAP_FAILED)
+  {
+    munmap(map_, map_size_);
+    map_ = (uint8_t *)MAP_FAILED;
+    if (ftruncate(fd_, offset_ + sizeof(TraceRecord)) != 0)   // keeps a zeroed record as the end
+      printf("[PortHandlerRecorder] Error truncating the trace!\n");
+  }
+  if (fd_ != -1)
+    close(fd_);
+  fd_ = -1;
+}
+
+bool PortHandlerRecorder::reserve(size_t length)
+{
+  // one more record is kept zeroed for the end of the trace
+  if (offset_ + length + sizeof(TraceRecord) <= map_size_)
+    return true;
+
+  size_t size = map_size_ + TRACE_CHUNK_SIZE;
+  if (ftruncate(fd_, size) != 0)
+    return false;
+
+  void *map;
+  if (map_ == MAP_FAILED)
+    map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+  else
+    map = mremap(map_, map_size_, size, MREMAP_MAYMOVE);
+  if (map == MAP_FAILED)
+    return false;
+
+  map_      = (uint8_t *)map;
+  map_size_ = size;
+  return true;
+}
+
+void PortHandlerRecorder::append(uint8_t type, const uint8_t *data, uint16_t length)
+{
+  PortBuffer buffer;
+  buffer.data   = (uint8_t *)data;
+  buffer.length = length;
+  append(type, &buffer, 1, length);
+}
+
+void PortHandlerRecorder::append(uint8_t type, PortBuffer *buffers, int count, uint16_t length)
+{
+  if (map_ == MAP_FAILED)
+    return;
+
+  int64_t now   = port_->getCurrentTimeNs();
+  int64_t delta = now - last_ns_;
+  if (reserve(2 * sizeof(TraceRecord) + sizeof(int64_t) + length) == false)
+  {
+    printf("[PortHandlerRecorder] Error growing the trace!\n");
+    closeTrace();
+    return;
+  }
+
+  TraceRecord record;
+  record.reserved = 0;
+  if (delta < 0 || delta > 0xFFFFFFFFLL)
+  {
+    record.type     = TRACE_TIME;
+    record.length   = sizeof(int64_t);
+    record.delta_ns = 0;
+    memcpy(&map_[offset_], &record, sizeof(record));
+    memcpy(&map_[offset_ + sizeof(record)], &now, sizeof(now));
+    offset_ += sizeof(record) + sizeof(now);
+    delta = 0;
+  }
+
+  record.type     = type;
+  record.length   = length;
+  record.delta_ns = (uint32_t)delta;
+  memcpy(&map_[offset_], &record, sizeof(record));
+  offset_ += sizeof(record);
+
+  // the buffers are copied until length bytes
+  for (int i = 0; i < count && length > 0; i++)
+  {
+    uint16_t n = (buffers[i].length < length) ? buffers[i].length : length;
+    memcpy(&map_[offset_], buffers[i].data, n);
+    offset_ += n;
+    length  -= n;
+  }
+  last_ns_ = now;
+}
+
+bool PortHandlerRecorder::openPort()
+{
+  return port_->openPort();
+}
+
+void PortHandlerRecorder::closePort()
+{
+  port_->closePort();
+}
+
+void PortHandlerRecorder::clearPort()
+{
+  port_->clearPort();
+  append(TRACE_CLEAR, 0, 0);
+}
+
+void PortHandlerRecorder::setPortName(const char *port_name)
+{
+  port_->setPortName(port_name);
+}
+
+char *PortHandlerRecorder::getPortName()
+{
+  return port_->getPortName();
+}
+
+bool PortHandlerRecorder::setBaudRate(const int baudrate)
+{
+  bool result = port_->setBaudRate(baudrate);
+  if (result)
+  {
+    int32_t value = baudrate;
+    append(TRACE_BAUDRATE, (uint8_t *)&value, sizeof(value));
+  }
+  return result;
+}
+
+int PortHandlerRecorder::getBaudRate()
+{
+  return port_->getBaudRate();
+}
+
+int PortHandlerRecorder::getBytesAvailable()
+{
+  return port_->getBytesAvailable();
+}
+
+int PortHandlerRecorder::readPort(uint8_t *packet, int length)
+{
+  int result = port_->readPort(packet, length);
+  for (int i = 0; i < result; i += 0xFFFF)
+    append(TRACE_READ, &packet[i], (uint16_t)((result - i > 0xFFFF) ? 0xFFFF : result - i));
+  return result;
+}
+
+int PortHandlerRecorder::writePort(uint8_t *packet, int length)
+{
+  int result = port_->writePort(packet, length);
+  for (int i = 0; i < result; i += 0xFFFF)
+    append(TRACE_WRITE, &packet[i], (uint16_t)((result - i > 0xFFFF) ? 0xFFFF : result - i));
+  return result;
+}
+
+int PortHandlerRecorder::writePortv(PortBuffer *buffers, int count)
+{
+  int result = port_->writePortv(buffers, count);
+  if (result <= 0xFFFF)
+  {
+    if (result > 0)
+      append(TRACE_WRITE, buffers, count, (uint16_t)result);
+    return result;
+  }
+
+  for (int i = 0, offset = 0; i < count && offset < result; offset += buffers[i++].length)
+  {
+    int length = (result - offset < buffers[i].length) ? result - offset : buffers[i].length;
+    for (int j = 0; j < length; j += 0xFFFF)
+      append(TRACE_WRITE, &buffers[i].data[j], (uint16_t)((length - j > 0xFFFF) ? 0xFFFF : length - j));
+  }
+  return result;
+}
+
+bool PortHandlerRecorder::waitForBytes()
+{
+  return port_->waitForBytes();
+}
+
+int64_t PortHandlerRecorder::getCurrentTimeNs()
+{
+  return port_->getCurrentTimeNs();
+}
+
+void PortHandlerRecorder::setPacketTimeout(uint16_t packet_length)
+{
+  port_->setPacketTimeout(packet_length);
+}
+
+void PortHandlerRecorder::setPacketTimeout(double msec)
+{
+  port_->setPacketTimeout(msec);
+}
+
+void PortHandlerRecorder::setPacketDeadline(int64_t deadline_ns)
+{
+  port_->setPacketDeadline(deadline_ns);
+}
+
+int64_t PortHandlerRecorder::getPacketDeadline()
+{
+  return port_->getPacketDeadline();
+}
+
+void PortHandlerRecorder::setCycleDeadline(int64_t deadline_ns)
+{
+  port_->setCycleDeadline(deadline_ns);
+}
+
+int64_t PortHandlerRecorder::getCycleDeadline()
+{
+  return port_->getCycleDeadline();
+}
+
+bool PortHandlerRecorder::isPacketTimeout()
+{
+  return port_->isPacketTimeout();
+}
+
+#endif
@@ -0,0 +1,403 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#if defined(__linux__)
+
+#include <stdio.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "port_handler_replay.h"
+
+#define LATENCY_TIMER   8  // msec (same as PortHandlerLinux)
+
+using namespace dynamixel;
+
+static int64_t getRealTimeNs()
+{
+  struct timespec tv;
+  clock_gettime(CLOCK_MONOTONIC, &tv);
+  return (int64_t)tv.tv_sec * 1000000000LL + (int64_t)tv.tv_nsec;
+}
+
+PortHandlerReplay::PortHandlerReplay(const char *port_name)
+  : fd_(-1),
+    map_((uint8_t *)MAP_FAILED),
+    map_size_(0),
+    baudrate_(DEFAULT_BAUDRATE_),
+    tx_time_per_byte(0.0),
+    cursor_(0),
+    cursor_ns_(0),
+    read_offset_(0),
+    now_ns_(0),
+    speed_(0.0),
+    anchor_ns_(0),
+    anchor_real_ns_(0),
+    mismatch_count_(0),
+    write_count_(0)
+{
+  is_using_ = false;
+  setPortName(port_name);
+}
+
+PortHandlerReplay::~PortHandlerReplay()
+{
+  closePort();
+}
+
+bool PortHandlerReplay::openPort()
+{
+  const char *trace_path = port_name_;
+  if (strncmp(trace_path, "replay:", 7) == 0)
+    trace_path += 7;
+
+  closePort();
+
+  struct stat st;
+  fd_ = open(trace_path, O_RDONLY);
+  if (fd_ < 0 || fstat(fd_, &st) != 0 || (size_t)st.st_size < sizeof(TraceHeader))
+  {
+    printf("[PortHandlerReplay::openPort] Error opening %s!\n", trace_path);
+    closePort();
+    return false;
+  }
+
+  map_size_ = st.st_size;
+  map_      = (uint8_t *)mmap(NULL, map_size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+  if (map_ == MAP_FAILED)
+  {
+    printf("[PortHandlerReplay::openPort] Error mapping %s!\n", trace_path);
+    closePort();
+    return false;
+  }
+
+  TraceHeader header;
+  memcpy(&header, map_, sizeof(header));
+  if (memcmp(header.magic, TRACE_MAGIC, sizeof(header.magic)) != 0 || header.version != TRACE_VERSION ||
+      header.header_size > map_size_)
+  {
+    printf("[PortHandlerReplay::openPort] %s is not a trace file!\n", trace_path);
+    closePort();
+    return false;
+  }
+
+  madvise(map_, map_size_, MADV_SEQUENTIAL);
+
+  cursor_         = header.header_size;
+  cursor_ns_      = header.start_ns;
+  read_offset_    = 0;
+  now_ns_         = header.start_ns;
+  anchor_ns_      = now_ns_;
+  anchor_real_ns_ = getRealTimeNs();
+  mismatch_count_ = 0;
+  write_count_    = 0;
+  setBaudRate(header.baudrate);
+  return true;
+}
+
+void PortHandlerReplay::closePort()
+{
+  if (map_ != MAP_FAILED)
+    munmap(map_, map_size_);
+  map_ = (uint8_t *)MAP_FAILED;
+  map_size_ = 0;
+  if (fd_ != -1)
+    close(fd_);
+  fd_ = -1;
+}
+
+void PortHandlerReplay::setSpeed(double speed)
+{
+  speed_          = speed;
+  anchor_ns_      = now_ns_;
+  anchor_real_ns_ = getRealTimeNs();
+}
+
+bool PortHandlerReplay::isEnd()
+{
+  size_t      cursor  = cursor_;
+  int64_t     base_ns = cursor_ns_;
+  int64_t     time_ns;
+  TraceRecord record;
+  uint8_t     type;
+
+  while ((type = peekRecord(&cursor, &base_ns, &time_ns, &record)) != TRACE_END)
+  {
+    if (type == TRACE_WRITE)
+      return false;
+    cursor  += sizeof(TraceRecord) + record.length;
+    base_ns  = time_ns;
+  }
+  return true;
+}
+
+uint32_t PortHandlerReplay::getWriteCount()
+{
+  return write_count_;
+}
+
+uint32_t PortHandlerReplay::getMismatchCount()
+{
+  return mismatch_count_;
+}
+
+uint8_t PortHandlerReplay::peekRecord(size_t *cursor, int64_t *base_ns, int64_t *time_ns, TraceRecord *record)
+{
+  while (true)
+  {
+    if (map_ == MAP_FAILED || *cursor + sizeof(TraceRecord) > map_size_)
+      return TRACE_END;
+
+    memcpy(record, &map_[*cursor], sizeof(TraceRecord));
+    if (record->type == TRACE_END || *cursor + sizeof(TraceRecord) + record->length > map_size_)
+      return TRACE_END;
+
+    if (record->type == TRACE_TIME)
+    {
+      memcpy(base_ns, &map_[*cursor + sizeof(TraceRecord)], sizeof(int64_t));
+      *cursor += sizeof(TraceRecord) + record->length;
+      continue;
+    }
+
+    *time_ns = *base_ns + record->delta_ns;
+    return record->type;
+  }
+}
+
+void PortHandlerReplay::nextRecord()
+{
+  int64_t     time_ns;
+  TraceRecord record;
+
+  if (peekRecord(&cursor_, &cursor_ns_, &time_ns, &record) == TRACE_END)
+    return;
+  cursor_      += sizeof(TraceRecord) + record.length;
+  cursor_ns_    = time_ns;
+  read_offset_  = 0;
+}
+
+void PortHandlerReplay::advanceTo(int64_t time_ns)
+{
+  if (time_ns <= now_ns_)
+    return;
+  now_ns_ = time_ns;
+
+  if (speed_ > 0.0)
+  {
+    int64_t         wake_ns = anchor_real_ns_ + (int64_t)((now_ns_ - anchor_ns_) / speed_);
+    struct timespec ts;
+    ts.tv_sec   = (time_t)(wake_ns / 1000000000LL);
+    ts.tv_nsec  = (long)(wake_ns % 1000000000LL);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) != 0)
+      ;
+  }
+}
+
+void PortHandlerReplay::clearPort()
+{
+  int64_t     time_ns;
+  TraceRecord record;
+  uint8_t     type;
+
+  // the bytes received until now are discarded, and the recorded clear is consumed
+  while ((type = peekRecord(&cursor_, &cursor_ns_, &time_ns, &record)) != TRACE_END && time_ns <= now_ns_)
+  {
+    if (type == TRACE_WRITE)
+      break;
+    nextRecord();
+    if (type == TRACE_CLEAR)
+      break;
+  }
+}
+
+void PortHandlerReplay::setPortName(const char *port_name)
+{
+  strncpy(port_name_, port_name, sizeof(port_name_) - 1);
+  port_name_[sizeof(port_name_) - 1] = '\0';
+}
+
+char *PortHandlerReplay::getPortName()
+{
+  return port_name_;
+}
+
+bool PortHandlerReplay::setBaudRate(const int baudrate)
+{
+  if (baudrate <= 0)
+    return false;
+  baudrate_         = baudrate;
+  tx_time_per_byte  = (1000.0 / (double)baudrate_) * 10.0;
+  return true;
+}
+
+int PortHandlerReplay::getBaudRate()
+{
+  return baudrate_;
+}
+
+int PortHandlerReplay::getBytesAvailable()
+{
+  size_t      cursor  = cursor_;
+  int64_t     base_ns = cursor_ns_;
+  size_t      offset  = read_offset_;
+  int64_t     time_ns;
+  TraceRecord record;
+  uint8_t     type;
+  int         available = 0;
+
+  while ((type = peekRecord(&cursor, &base_ns, &time_ns, &record)) != TRACE_END && time_ns <= now_ns_)
+  {
+    if (type == TRACE_WRITE)
+      break;
+    if (type == TRACE_READ)
+      available += record.length - (int)offset;
+    cursor  += sizeof(TraceRecord) + record.length;
+    base_ns  = time_ns;
+    offset   = 0;
+  }
+  return available;
+}
+
+int PortHandlerReplay::readPort(uint8_t *packet, int length)
+{
+  int64_t     time_ns;
+  TraceRecord record;
+  uint8_t     type;
+  int         read_length = 0;
+
+  while (read_length < length &&
+         (type = peekRecord(&cursor_, &cursor_ns_, &time_ns, &record)) != TRACE_END && time_ns <= now_ns_)
+  {
+    if (type == TRACE_WRITE)
+      break;
+    if (type != TRACE_READ)
+    {
+      nextRecord();
+      continue;
+    }
+
+    size_t n = record.length - read_offset_;
+    if (n > (size_t)(length - read_length))
+      n = length - read_length;
+    memcpy(&packet[read_length], &map_[cursor_ + sizeof(TraceRecord) + read_offset_], n);
+    read_offset_  += n;
+    read_length   += (int)n;
+    if (read_offset_ == record.length)
+      nextRecord();
+  }
+  return read_length;
+}
+
+int PortHandlerReplay::writePort(uint8_t *packet, int length)
+{
+  PortBuffer buffer;
+  buffer.data   = packet;
+  buffer.length = length;
+  return writePortv(&buffer, 1);
+}
+
+int PortHandlerReplay::writePortv(PortBuffer *buffers, int count)
+{
+  int64_t     time_ns;
+  TraceRecord record;
+  uint8_t     type;
+  int         length = 0;
+
+  for (int i = 0; i < count; i++)
+    length += buffers[i].length;
+
+  // the bytes not read by the host before this write are dropped
+  while ((type = peekRecord(&cursor_, &cursor_ns_, &time_ns, &record)) != TRACE_END && type != TRACE_WRITE)
+    nextRecord();
+
+  write_count_++;
+  if (type == TRACE_END)
+  {
+    mismatch_count_++;
+    return length;
+  }
+
+  bool     match    = (record.length == length);
+  uint8_t *recorded = &map_[cursor_ + sizeof(TraceRecord)];
+  for (int i = 0; i < count && match; i++)
+  {
+    match     = (memcmp(recorded, buffers[i].data, buffers[i].length) == 0);
+    recorded += buffers[i].length;
+  }
+  if (match == false)
+    mismatch_count_++;
+
+  advanceTo(time_ns);
+  nextRecord();
+  return length;
+}
+
+bool PortHandlerReplay::waitForBytes()
+{
+  size_t      cursor  = cursor_;
+  int64_t     base_ns = cursor_ns_;
+  int64_t     time_ns;
+  TraceRecord record;
+  uint8_t     type;
+
+  // find the next read before the next write
+  while ((type = peekRecord(&cursor, &base_ns, &time_ns, &record)) != TRACE_END && type != TRACE_WRITE)
+  {
+    if (type == TRACE_READ)
+    {
+      if (time_ns > packet_deadline_ns_)
+        break;
+      advanceTo(time_ns);
+      return true;
+    }
+    cursor  += sizeof(TraceRecord) + record.length;
+    base_ns  = time_ns;
+  }
+
+  advanceTo(packet_deadline_ns_);
+  return false;
+}
+
+int64_t PortHandlerReplay::getCurrentTimeNs()
+{
+  return now_ns_;
+}
+
+void PortHandlerReplay::setPacketTimeout(uint16_t packet_length)
+{
+  double timeout = (tx_time_per_byte * (double)packet_length) + (LATENCY_TIMER * 2.0) + 2.0;
+  setPacketDeadline(now_ns_ + (int64_t)(timeout * 1000000.0));
+}
+
+#endif
@@ -0,0 +1,177 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#include <string.h>
+
+#if defined(__linux__)
+#include "port_handler_sim.h"
+#elif defined(__APPLE__)
+#include "port_handler_sim.h"
+#elif defined(_WIN32) || defined(_WIN64)
+#define WINDLLEXPORT
+#include "port_handler_sim.h"
+#elif defined(ARDUINO) || defined(__OPENCR__) || defined(__OPENCM904__)
+#include "../../include/dynamixel_sdk/port_handler_sim.h"
+#endif
+
+using namespace dynamixel;
+
+PortHandlerSim::PortHandlerSim(const char *port_name)
+  : bus_(DEFAULT_BAUDRATE_),
+    is_open_(false),
+    baudrate_(DEFAULT_BAUDRATE_),
+    now_ns_(0),
+    latency_ns_(DEFAULT_LATENCY_NS_),
+    tx_time_per_byte(0.0)
+{
+  is_using_ = false;
+  setPortName(port_name);
+
+  bus_.addDevice(1.0, 1);
+  bus_.addDevice(1.0, 2);
+  bus_.addDevice(2.0, 1);
+  bus_.addDevice(2.0, 2);
+}
+
+EmulatedBus *PortHandlerSim::getBus()
+{
+  return &bus_;
+}
+
+void PortHandlerSim::setLatency(int64_t latency_ns)
+{
+  latency_ns_ = latency_ns;
+}
+
+void PortHandlerSim::advanceTime(int64_t nsec)
+{
+  if (nsec > 0)
+    now_ns_ += nsec;
+}
+
+bool PortHandlerSim::openPort()
+{
+  return setBaudRate(baudrate_);
+}
+
+void PortHandlerSim::closePort()
+{
+  is_open_ = false;
+}
+
+void PortHandlerSim::clearPort()
+{
+  bus_.discard(now_ns_ - latency_ns_);
+}
+
+void PortHandlerSim::setPortName(const char *port_name)
+{
+  strncpy(port_name_, port_name, sizeof(port_name_) - 1);
+  port_name_[sizeof(port_name_) - 1] = '\0';
+}
+
+char *PortHandlerSim::getPortName()
+{
+  return port_name_;
+}
+
+bool PortHandlerSim::setBaudRate(const int baudrate)
+{
+  if (baudrate <= 0)
+    return false;
+
+  baudrate_ = baudrate;
+  bus_.setBaudRate(baudrate);
+  tx_time_per_byte = (1000.0 / (double)baudrate_) * 10.0;
+  is_open_ = true;
+  return true;
+}
+
+int PortHandlerSim::getBaudRate()
+{
+  return baudrate_;
+}
+
+int PortHandlerSim::getBytesAvailable()
+{
+  return bus_.getBytesAvailable(now_ns_ - latency_ns_);
+}
+
+int PortHandlerSim::readPort(uint8_t *packet, int length)
+{
+  if (is_open_ == false)
+    return -1;
+  return bus_.read(now_ns_ - latency_ns_, packet, length);
+}
+
+int PortHandlerSim::writePort(uint8_t *packet, int length)
+{
+  if (is_open_ == false)
+    return -1;
+
+  bus_.receive(now_ns_, packet, length);
+
+  // the write returns when the last byte is on the wire
+  if (now_ns_ < bus_.getReceiveEndTime())
+    now_ns_ = bus_.getReceiveEndTime();
+  return length;
+}
+
+bool PortHandlerSim::waitForBytes()
+{
+  if (now_ns_ >= packet_deadline_ns_)
+    return false;
+
+  // the status packet becomes readable all at once, like a USB serial adapter delivering a chunk
+  int64_t readable = bus_.getPacketEndTime();
+  if (readable >= 0)
+    readable += latency_ns_;
+
+  if (readable < 0 || readable > packet_deadline_ns_)
+  {
+    now_ns_ = packet_deadline_ns_;
+    return false;
+  }
+
+  if (readable > now_ns_)
+    now_ns_ = readable;
+  return true;
+}
+
+int64_t PortHandlerSim::getCurrentTimeNs()
+{
+  return now_ns_;
+}
+
+void PortHandlerSim::setPacketTimeout(uint16_t packet_length)
+{
+  double timeout = (tx_time_per_byte * (double)packet_length) + (latency_ns_ * 2.0 / 1000000.0) + 2.0;
+  setPacketDeadline(now_ns_ + (int64_t)(timeout * 1000000.0));
+}
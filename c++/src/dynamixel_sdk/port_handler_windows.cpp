@@ -46,8 +46,6 @@ using namespace dynamixel;
 PortHandlerWindows::PortHandlerWindows(const char *port_name)
   : serial_handle_(INVALID_HANDLE_VALUE),
   baudrate_(DEFAULT_BAUDRATE_),
-  packet_start_time_(0.0),
-  packet_timeout_(0.0),
   tx_time_per_byte_(0.0)
 {
   is_using_ = false;
@@ -128,43 +126,18 @@ int PortHandlerWindows::writePort(uint8_t *packet, int length)
   return (int)dwWrite;
 }
 
-void PortHandlerWindows::setPacketTimeout(uint16_t packet_length)
-{
-  packet_start_time_ = getCurrentTime();
-  packet_timeout_ = (tx_time_per_byte_ * (double)packet_length) + (LATENCY_TIMER * 2.0) + 2.0;
-}
-
-void PortHandlerWindows::setPacketTimeout(double msec)
-{
-  packet_start_time_ = getCurrentTime();
-  packet_timeout_ = msec;
-}
-
-bool PortHandlerWindows::isPacketTimeout()
-{
-  if (getTimeSinceStart() > packet_timeout_)
-  {
-    packet_timeout_ = 0;
-    return true;
-  }
-  return false;
-}
-
-double PortHandlerWindows::getCurrentTime()
+int64_t PortHandlerWindows::getCurrentTimeNs()
 {
   QueryPerformanceCounter(&counter_);
   QueryPerformanceFrequency(&freq_);
-  return (double)counter_.QuadPart / (double)freq_.QuadPart * 1000.0;
+  return (int64_t)(counter_.QuadPart / freq_.QuadPart) * 1000000000LL
+         + (int64_t)(counter_.QuadPart % freq_.QuadPart) * 1000000000LL / freq_.QuadPart;
 }
 
-double PortHandlerWindows::getTimeSinceStart()
+void PortHandlerWindows::setPacketTimeout(uint16_t packet_length)
 {
-  double time;
-
-  time = getCurrentTime() - packet_start_time_;
-  if (time < 0.0) packet_start_time_ = getCurrentTime();
-
-  return time;
+  double timeout = (tx_time_per_byte_ * (double)packet_length) + (LATENCY_TIMER * 2.0) + 2.0;
+  setPacketDeadline(getCurrentTimeNs() + (int64_t)(timeout * 1000000.0));
 }
 
 bool PortHandlerWindows::setupPort(int baudrate)
@@ -32,13 +32,17 @@
 
 #if defined(__linux__)
 #include "protocol1_packet_handler.h"
+#include "status_packet_parser.h"
 #elif defined(__APPLE__)
 #include "protocol1_packet_handler.h"
+#include "status_packet_parser.h"
 #elif defined(_WIN32) || defined(_WIN64)
 #define WINDLLEXPORT
 #include "protocol1_packet_handler.h"
+#include "status_packet_parser.h"
 #elif defined(ARDUINO) || defined(__OPENCR__) || defined(__OPENCM904__)
 #include "../../include/dynamixel_sdk/protocol1_packet_handler.h"
+#include "../../include/dynamixel_sdk/status_packet_parser.h"
 #endif
 
 #include <string.h>
@@ -46,6 +50,9 @@
 
 #define TXPACKET_MAX_LEN    (250)
 #define RXPACKET_MAX_LEN    (250)
+#define RXPACKET_BUFFER_LEN (RXPACKET_MAX_LEN + 4)  // 4: HEADER0 HEADER1 ID LENGTH of the longest status packet
+#define TXPACKETS_BUFFER_LEN (4 * TXPACKET_MAX_LEN)  // instruction packets written at a time by txRxPackets()
+#define PACKET_BUFFER_LEN   ((TXPACKETS_BUFFER_LEN > RXPACKET_BUFFER_LEN) ? TXPACKETS_BUFFER_LEN : RXPACKET_BUFFER_LEN)  // PortHandler::getPacketBuffer()
 
 ///////////////// for Protocol 1.0 Packet /////////////////
 #define PKT_HEADER0             0
@@ -67,6 +74,41 @@
 
 using namespace dynamixel;
 
+// checks whether a status packet answers the instruction packet to the ID, which reads data_length bytes
+// (the length is checked when the port is not cleared before the instruction packet, see PortHandler::setTxFlush())
+static bool isExpectedStatus(PortHandler *port, uint8_t *rxpacket, uint8_t id, uint16_t data_length)
+{
+  if (rxpacket[PKT_ID] != id)
+    return false;
+  if (port->isTxFlush())
+    return true;
+
+  // a Dynamixel answers an error without data
+  return (rxpacket[PKT_LENGTH] == data_length + 2 || (rxpacket[PKT_ERROR] != 0 && rxpacket[PKT_LENGTH] == 2));
+}
+
+// data length of the status packet answering a request of txRxPackets()
+static uint16_t getStatusDataLength(PacketRequest *request)
+{
+  if (request->instruction == INST_READ)
+    return request->length;
+  return 0;
+}
+
+// writes the instruction packets made for requests[first ... last-1], which fail if the packets are not written
+static void writeRequestPackets(PortHandler *port, uint8_t *packets, int *packets_length, PacketRequest *requests, int first, int last)
+{
+  if (*packets_length > 0 && port->writePort(packets, *packets_length) != *packets_length)
+  {
+    for (int i = first; i < last; i++)
+    {
+      if (requests[i].result == COMM_RX_WAITING || requests[i].result == COMM_SUCCESS)
+        requests[i].result = COMM_TX_FAIL;
+    }
+  }
+  *packets_length = 0;
+}
+
 Protocol1PacketHandler *Protocol1PacketHandler::unique_instance_ = new Protocol1PacketHandler();
 
 Protocol1PacketHandler::Protocol1PacketHandler() { }
@@ -156,19 +198,25 @@ void Protocol1PacketHandler::printRxPacketError(uint8_t error)
 }
 
 int Protocol1PacketHandler::txPacket(PortHandler *port, uint8_t *txpacket)
+{
+  return txPacket(port, txpacket, 0, 0);
+}
+
+// txpacket holds the packet before param, which is written from the buffer of the caller without copy
+int Protocol1PacketHandler::txPacket(PortHandler *port, uint8_t *txpacket, uint8_t *param, uint16_t param_length)
 {
   uint8_t checksum               = 0;
-  uint8_t total_packet_length    = txpacket[PKT_LENGTH] + 4; // 4: HEADER0 HEADER1 ID LENGTH
-  uint8_t written_packet_length  = 0;
+  uint16_t total_packet_length   = txpacket[PKT_LENGTH] + 4; // 4: HEADER0 HEADER1 ID LENGTH
+  uint16_t head_length           = total_packet_length - param_length - 1; // 1: CHKSUM
+  int written_packet_length      = 0;
 
-  if (port->is_using_)
+  if (port->beginTransaction() == false)
     return COMM_PORT_BUSY;
-  port->is_using_ = true;
 
   // check max packet length
-  if (total_packet_length > TXPACKET_MAX_LEN)
+  if (total_packet_length > TXPACKET_MAX_LEN || param_length + PKT_INSTRUCTION + 2 > total_packet_length)
   {
-    port->is_using_ = false;
+    port->endTransaction();
     return COMM_TX_ERROR;
   }
 
@@ -177,140 +225,146 @@ int Protocol1PacketHandler::txPacket(PortHandler *port, uint8_t *txpacket)
   txpacket[PKT_HEADER1]   = 0xFF;
 
   // add a checksum to the packet
-  for (int idx = 2; idx < total_packet_length - 1; idx++)   // except header, checksum
+  for (int idx = 2; idx < head_length; idx++)   // except header
     checksum += txpacket[idx];
-  txpacket[total_packet_length - 1] = ~checksum;
+  for (int idx = 0; idx < param_length; idx++)
+    checksum += param[idx];
+  checksum = ~checksum;
 
   // tx packet
-  port->clearPort();
-  written_packet_length = port->writePort(txpacket, total_packet_length);
+  if (port->isTxFlush())
+    port->clearPort();
+  if (param_length == 0)
+  {
+    txpacket[head_length] = checksum;
+    written_packet_length = port->writePort(txpacket, total_packet_length);
+  }
+  else
+  {
+    PortBuffer buffers[3] = { { txpacket, head_length }, { param, param_length }, { &checksum, 1 } };
+    written_packet_length = port->writePortv(buffers, 3);
+  }
   if (total_packet_length != written_packet_length)
   {
-    port->is_using_ = false;
+    port->endTransaction();
     return COMM_TX_FAIL;
   }
 
+  port->addBusTx(txpacket[PKT_INSTRUCTION], total_packet_length);
   return COMM_SUCCESS;
 }
 
 int Protocol1PacketHandler::rxPacket(PortHandler *port, uint8_t *rxpacket)
 {
   int     result         = COMM_TX_FAIL;
+  int     rx_length      = 0;
+
+  // the bytes are parsed as they arrive, and no more than the packet being parsed are read
+  StatusPacketParser *parser = port->getStatusParser();
+  parser->begin(1.0);
+
+  // a status packet which has already arrived whole is read into rxpacket without the ring buffer of the parser
+  int needed_length = parser->getNeededLength();
+  int packet_length = 0;
+  int read_length   = port->readPort(rxpacket, needed_length);
+  port->addBusRx(read_length);
+  if (read_length == needed_length && (packet_length = parser->getPacketLength(rxpacket)) > 0 && packet_length <= RXPACKET_BUFFER_LEN)
+  {
+    if (packet_length > read_length)
+    {
+      int rest_length = port->readPort(&rxpacket[read_length], packet_length - read_length);
+      port->addBusRx(rest_length);
+      if (rest_length > 0)
+        read_length += rest_length;
+    }
+    if (read_length == packet_length)
+    {
+      result = parser->checkPacket(rxpacket, &packet_length);
+      if (result == COMM_RX_CORRUPT)
+        port->addBusChecksumError();
+      port->endTransaction();
+      port->addBusStatus(rxpacket[PKT_ID], result);
+      return result;
+    }
+  }
+  if (read_length > 0)
+  {
+    rx_length = read_length;
+    parser->feed(rxpacket, read_length);
+    port->addBusResync(parser->takeSkippedLength());
+  }
 
-  uint8_t checksum       = 0;
-  uint8_t rx_length      = 0;
-  uint8_t wait_length    = 6;    // minimum length (HEADER0 HEADER1 ID LENGTH ERROR CHKSUM)
+  // sleep until the rest of the packet arrives, as the loop would after the same short read
+  if (read_length < needed_length && port->isPacketTimeout() == false)
+    port->waitForBytes();
 
   while(true)
   {
-    rx_length += port->readPort(&rxpacket[rx_length], wait_length - rx_length);
-    if (rx_length >= wait_length)
+    if (parser->getFrameCount() > 0)
     {
-      uint8_t idx = 0;
+      result = parser->popFrame(rxpacket, RXPACKET_BUFFER_LEN);
+      port->addBusResync(parser->takeSkippedLength());
+      if (result == COMM_RX_CORRUPT)
+        port->addBusChecksumError();
+      if (result != COMM_RX_WAITING)
+        break;
+      continue;
+    }
 
-      // find packet header
-      for (idx = 0; idx < (rx_length - 1); idx++)
-      {
-        if (rxpacket[idx] == 0xFF && rxpacket[idx+1] == 0xFF)
-          break;
-      }
+    needed_length = parser->getNeededLength();
+    read_length   = port->readPort(parser->getWritePointer(), needed_length);
+    port->addBusRx(read_length);
+    if (read_length > 0)
+    {
+      rx_length += read_length;
+      parser->commit(read_length);
+      port->addBusResync(parser->takeSkippedLength());
+
+      // the rest may have arrived already
+      if (read_length == needed_length)
+        continue;
+    }
 
-      if (idx == 0)   // found at the beginning of the packet
+    // check timeout
+    if (port->isPacketTimeout() == true)
+    {
+      if (rx_length == 0)
       {
-        if (rxpacket[PKT_ID] > 0xFD ||                  // unavailable ID
-           rxpacket[PKT_LENGTH] > RXPACKET_MAX_LEN ||   // unavailable Length
-           rxpacket[PKT_ERROR] >= 0x64)                 // unavailable Error
-        {
-            // remove the first byte in the packet
-            for (uint8_t s = 0; s < rx_length - 1; s++)
-              rxpacket[s] = rxpacket[1 + s];
-            //memcpy(&rxpacket[0], &rxpacket[idx], rx_length - idx);
-            rx_length -= 1;
-            continue;
-        }
-
-        // re-calculate the exact length of the rx packet
-        if (wait_length != rxpacket[PKT_LENGTH] + PKT_LENGTH + 1)
-        {
-          wait_length = rxpacket[PKT_LENGTH] + PKT_LENGTH + 1;
-          continue;
-        }
-
-        if (rx_length < wait_length)
-        {
-          // check timeout
-          if (port->isPacketTimeout() == true)
-          {
-            if (rx_length == 0)
-            {
-              result = COMM_RX_TIMEOUT;
-            }
-            else
-            {
-              result = COMM_RX_CORRUPT;
-            }
-            break;
-          }
-          else
-          {
-            continue;
-          }
-        }
-
-        // calculate checksum
-        for (int i = 2; i < wait_length - 1; i++)   // except header, checksum
-          checksum += rxpacket[i];
-        checksum = ~checksum;
-
-        // verify checksum
-        if (rxpacket[wait_length - 1] == checksum)
-        {
-          result = COMM_SUCCESS;
-        }
-        else
-        {
-          result = COMM_RX_CORRUPT;
-        }
-        break;
+        result = COMM_RX_TIMEOUT;
       }
       else
       {
-        // remove unnecessary packets
-        for (uint8_t s = 0; s < rx_length - idx; s++)
-          rxpacket[s] = rxpacket[idx + s];
-        //memcpy(&rxpacket[0], &rxpacket[idx], rx_length - idx);
-        rx_length -= idx;
-      }
-    }
-    else
-    {
-      // check timeout
-      if (port->isPacketTimeout() == true)
-      {
-        if (rx_length == 0)
-        {
-          result = COMM_RX_TIMEOUT;
-        }
-        else
-        {
-          result = COMM_RX_CORRUPT;
-        }
-        break;
+        result = COMM_RX_CORRUPT;
       }
+      break;
     }
+
+    // sleep until the rest of the packet arrives
+    port->waitForBytes();
   }
-  port->is_using_ = false;
+  port->endTransaction();
+  port->addBusStatus(rxpacket[PKT_ID], result);
 
   return result;
 }
 
 // NOT for BulkRead instruction
 int Protocol1PacketHandler::txRxPacket(PortHandler *port, uint8_t *txpacket, uint8_t *rxpacket, uint8_t *error)
+{
+  return txRxPacket(port, txpacket, 0, 0, rxpacket, error);
+}
+
+int Protocol1PacketHandler::txRxPacket(PortHandler *port, uint8_t *txpacket, uint8_t *param, uint16_t param_length, uint8_t *rxpacket, uint8_t *error)
 {
   int result = COMM_TX_FAIL;
 
+  // the status packets waited for are received in the same transaction
+  BusTransaction transaction(port);
+  if (transaction.isAcquired() == false)
+    return COMM_PORT_BUSY;
+
   // tx packet
-  result = txPacket(port, txpacket);
+  result = txPacket(port, txpacket, param, param_length);
   if (result != COMM_SUCCESS)
     return result;
 
@@ -322,24 +376,26 @@ int Protocol1PacketHandler::txRxPacket(PortHandler *port, uint8_t *txpacket, uin
   // (Instruction == action) == no need to wait for status packet
   if (txpacket[PKT_ID] == BROADCAST_ID || txpacket[PKT_INSTRUCTION] == INST_ACTION)
   {
-    port->is_using_ = false;
+    port->endTransaction();
     return result;
   }
 
   // set packet timeout
   if (txpacket[PKT_INSTRUCTION] == INST_READ)
   {
-    port->setPacketTimeout((uint16_t)(txpacket[PKT_PARAMETER0+1] + 6));
+    port->setResponseTimeout(txpacket[PKT_ID], (uint16_t)(txpacket[PKT_PARAMETER0+1] + 6));
   }
   else
   {
-    port->setPacketTimeout((uint16_t)6); // HEADER0 HEADER1 ID LENGTH ERROR CHECKSUM
+    port->setResponseTimeout(txpacket[PKT_ID], (uint16_t)6); // HEADER0 HEADER1 ID LENGTH ERROR CHECKSUM
   }
 
   // rx packet
+  uint16_t data_length = (txpacket[PKT_INSTRUCTION] == INST_READ) ? txpacket[PKT_PARAMETER0+1] : 0;
   do {
     result = rxPacket(port, rxpacket);
-  } while (result == COMM_SUCCESS && txpacket[PKT_ID] != rxpacket[PKT_ID]);
+  } while (result == COMM_SUCCESS && isExpectedStatus(port, rxpacket, txpacket[PKT_ID], data_length) == false);
+  port->updateResponseTime(txpacket[PKT_ID], result == COMM_SUCCESS);
 
   if (result == COMM_SUCCESS && txpacket[PKT_ID] == rxpacket[PKT_ID])
   {
@@ -360,7 +416,7 @@ int Protocol1PacketHandler::ping(PortHandler *port, uint8_t id, uint16_t *model_
   int result                 = COMM_TX_FAIL;
 
   uint8_t txpacket[6]         = {0};
-  uint8_t rxpacket[6]         = {0};
+  uint8_t *rxpacket           = 0;
 
   if (id >= BROADCAST_ID)
     return COMM_NOT_AVAILABLE;
@@ -369,6 +425,13 @@ int Protocol1PacketHandler::ping(PortHandler *port, uint8_t id, uint16_t *model_
   txpacket[PKT_LENGTH]        = 2;
   txpacket[PKT_INSTRUCTION]   = INST_PING;
 
+  // a stale status packet left on the bus by PortHandler::setTxFlush(false) may be read instead of the one waited for,
+  // so the status packet is received in the buffer of the port, which has room for any status packet
+  BusTransaction transaction(port);
+  if (transaction.isAcquired() == false)
+    return COMM_PORT_BUSY;
+  rxpacket = port->getPacketBuffer(PACKET_BUFFER_LEN);
+
   result = txRxPacket(port, txpacket, rxpacket, error);
   if (result == COMM_SUCCESS && model_number != 0)
   {
@@ -404,12 +467,18 @@ int Protocol1PacketHandler::reboot(PortHandler *port, uint8_t id, uint8_t *error
 int Protocol1PacketHandler::factoryReset(PortHandler *port, uint8_t id, uint8_t option, uint8_t *error)
 {
   uint8_t txpacket[6]         = {0};
-  uint8_t rxpacket[6]         = {0};
+  uint8_t *rxpacket           = 0;
 
   txpacket[PKT_ID]            = id;
   txpacket[PKT_LENGTH]        = 2;
   txpacket[PKT_INSTRUCTION]   = INST_FACTORY_RESET;
 
+  // the status packet is received in the buffer of the port, as in ping()
+  BusTransaction transaction(port);
+  if (transaction.isAcquired() == false)
+    return COMM_PORT_BUSY;
+  rxpacket = port->getPacketBuffer(PACKET_BUFFER_LEN);
+
   return txRxPacket(port, txpacket, rxpacket, error);
 }
 
@@ -432,7 +501,7 @@ int Protocol1PacketHandler::readTx(PortHandler *port, uint8_t id, uint16_t addre
 
   // set packet timeout
   if (result == COMM_SUCCESS)
-    port->setPacketTimeout((uint16_t)(length+6));
+    port->setResponseTimeout(id, (uint16_t)(length+6));
 
   return result;
 }
@@ -440,12 +509,16 @@ int Protocol1PacketHandler::readTx(PortHandler *port, uint8_t id, uint16_t addre
 int Protocol1PacketHandler::readRx(PortHandler *port, uint8_t id, uint16_t length, uint8_t *data, uint8_t *error)
 {
   int result                  = COMM_TX_FAIL;
-  uint8_t *rxpacket           = (uint8_t *)malloc(RXPACKET_MAX_LEN); //(length+6);
-  //uint8_t *rxpacket         = new uint8_t[length+6];
+  uint8_t rxpacket[RXPACKET_BUFFER_LEN];
+
+  BusTransaction transaction(port);
+  if (transaction.isAcquired() == false)
+    return COMM_PORT_BUSY;
 
   do {
     result = rxPacket(port, rxpacket);
-  } while (result == COMM_SUCCESS && rxpacket[PKT_ID] != id);
+  } while (result == COMM_SUCCESS && isExpectedStatus(port, rxpacket, id, length) == false);
+  port->updateResponseTime(id, result == COMM_SUCCESS);
 
   if (result == COMM_SUCCESS && rxpacket[PKT_ID] == id)
   {
@@ -460,8 +533,6 @@ int Protocol1PacketHandler::readRx(PortHandler *port, uint8_t id, uint16_t lengt
     //memcpy(data, &rxpacket[PKT_PARAMETER0], length);
   }
 
-  free(rxpacket);
-  //delete[] rxpacket;
   return result;
 }
 
@@ -470,7 +541,7 @@ int Protocol1PacketHandler::readTxRx(PortHandler *port, uint8_t id, uint16_t add
   int result = COMM_TX_FAIL;
 
   uint8_t txpacket[8]         = {0};
-  uint8_t *rxpacket           = (uint8_t *)malloc(RXPACKET_MAX_LEN);//(length+6);
+  uint8_t rxpacket[RXPACKET_BUFFER_LEN];
 
   if (id >= BROADCAST_ID)
     return COMM_NOT_AVAILABLE;
@@ -495,8 +566,6 @@ int Protocol1PacketHandler::readTxRx(PortHandler *port, uint8_t id, uint16_t add
     //memcpy(data, &rxpacket[PKT_PARAMETER0], length);
   }
 
-  free(rxpacket);
-  //delete[] rxpacket;
   return result;
 }
 
@@ -567,23 +636,18 @@ int Protocol1PacketHandler::writeTxOnly(PortHandler *port, uint8_t id, uint16_t
 {
   int result                 = COMM_TX_FAIL;
 
-  uint8_t *txpacket           = (uint8_t *)malloc(length+7);
-  //uint8_t *txpacket           = new uint8_t[length+7];
+  uint8_t txpacket[7]         = {0};
+  // 7: HEADER0 HEADER1 ID LEN INST ADDR (data) CHKSUM
 
   txpacket[PKT_ID]            = id;
   txpacket[PKT_LENGTH]        = length+3;
   txpacket[PKT_INSTRUCTION]   = INST_WRITE;
   txpacket[PKT_PARAMETER0]    = (uint8_t)address;
 
-  for (uint8_t s = 0; s < length; s++)
-    txpacket[PKT_PARAMETER0+1+s] = data[s];
-  //memcpy(&txpacket[PKT_PARAMETER0+1], data, length);
-
-  result = txPacket(port, txpacket);
-  port->is_using_ = false;
+  result = txPacket(port, txpacket, data, length);
+  if (result == COMM_SUCCESS)
+    port->endTransaction();
 
-  free(txpacket);
-  //delete[] txpacket;
   return result;
 }
 
@@ -591,23 +655,23 @@ int Protocol1PacketHandler::writeTxRx(PortHandler *port, uint8_t id, uint16_t ad
 {
   int result                 = COMM_TX_FAIL;
 
-  uint8_t *txpacket           = (uint8_t *)malloc(length+7); //#6->7
-  //uint8_t *txpacket           = new uint8_t[length+7];
-  uint8_t rxpacket[6]         = {0};
+  uint8_t txpacket[7]         = {0};
+  // 7: HEADER0 HEADER1 ID LEN INST ADDR (data) CHKSUM
+  uint8_t *rxpacket           = 0;
 
   txpacket[PKT_ID]            = id;
   txpacket[PKT_LENGTH]        = length+3;
   txpacket[PKT_INSTRUCTION]   = INST_WRITE;
   txpacket[PKT_PARAMETER0]    = (uint8_t)address;
 
-  for (uint8_t s = 0; s < length; s++)
-    txpacket[PKT_PARAMETER0+1+s] = data[s];
-  //memcpy(&txpacket[PKT_PARAMETER0+1], data, length);
+  // the status packet is received in the buffer of the port, as in ping()
+  BusTransaction transaction(port);
+  if (transaction.isAcquired() == false)
+    return COMM_PORT_BUSY;
+  rxpacket = port->getPacketBuffer(PACKET_BUFFER_LEN);
 
-  result = txRxPacket(port, txpacket, rxpacket, error);
+  result = txRxPacket(port, txpacket, data, length, rxpacket, error);
 
-  free(txpacket);
-  //delete[] txpacket;
   return result;
 }
 
@@ -648,23 +712,18 @@ int Protocol1PacketHandler::regWriteTxOnly(PortHandler *port, uint8_t id, uint16
 {
   int result                 = COMM_TX_FAIL;
 
-  uint8_t *txpacket           = (uint8_t *)malloc(length+6);
-  //uint8_t *txpacket           = new uint8_t[length+6];
+  uint8_t txpacket[7]         = {0};
+  // 7: HEADER0 HEADER1 ID LEN INST ADDR (data) CHKSUM
 
   txpacket[PKT_ID]            = id;
   txpacket[PKT_LENGTH]        = length+3;
   txpacket[PKT_INSTRUCTION]   = INST_REG_WRITE;
   txpacket[PKT_PARAMETER0]    = (uint8_t)address;
 
-  for (uint8_t s = 0; s < length; s++)
-    txpacket[PKT_PARAMETER0+1+s] = data[s];
-  //memcpy(&txpacket[PKT_PARAMETER0+1], data, length);
-
-  result = txPacket(port, txpacket);
-  port->is_using_ = false;
+  result = txPacket(port, txpacket, data, length);
+  if (result == COMM_SUCCESS)
+    port->endTransaction();
 
-  free(txpacket);
-  //delete[] txpacket;
   return result;
 }
 
@@ -672,23 +731,23 @@ int Protocol1PacketHandler::regWriteTxRx(PortHandler *port, uint8_t id, uint16_t
 {
   int result                 = COMM_TX_FAIL;
 
-  uint8_t *txpacket           = (uint8_t *)malloc(length+6);
-  //uint8_t *txpacket           = new uint8_t[length+6];
-  uint8_t rxpacket[6]         = {0};
+  uint8_t txpacket[7]         = {0};
+  // 7: HEADER0 HEADER1 ID LEN INST ADDR (data) CHKSUM
+  uint8_t *rxpacket           = 0;
 
   txpacket[PKT_ID]            = id;
   txpacket[PKT_LENGTH]        = length+3;
   txpacket[PKT_INSTRUCTION]   = INST_REG_WRITE;
   txpacket[PKT_PARAMETER0]    = (uint8_t)address;
 
-  for (uint8_t s = 0; s < length; s++)
-    txpacket[PKT_PARAMETER0+1+s] = data[s];
-  //memcpy(&txpacket[PKT_PARAMETER0+1], data, length);
+  // the status packet is received in the buffer of the port, as in ping()
+  BusTransaction transaction(port);
+  if (transaction.isAcquired() == false)
+    return COMM_PORT_BUSY;
+  rxpacket = port->getPacketBuffer(PACKET_BUFFER_LEN);
 
-  result = txRxPacket(port, txpacket, rxpacket, error);
+  result = txRxPacket(port, txpacket, data, length, rxpacket, error);
 
-  free(txpacket);
-  //delete[] txpacket;
   return result;
 }
 
@@ -701,9 +760,8 @@ int Protocol1PacketHandler::syncWriteTxOnly(PortHandler *port, uint16_t start_ad
 {
   int result                 = COMM_TX_FAIL;
 
-  uint8_t *txpacket           = (uint8_t *)malloc(param_length+8);
+  uint8_t txpacket[8]         = {0};
   // 8: HEADER0 HEADER1 ID LEN INST START_ADDR DATA_LEN ... CHKSUM
-  //uint8_t *txpacket           = new uint8_t[param_length + 8];
 
   txpacket[PKT_ID]            = BROADCAST_ID;
   txpacket[PKT_LENGTH]        = param_length + 4; // 4: INST START_ADDR DATA_LEN ... CHKSUM
@@ -711,14 +769,8 @@ int Protocol1PacketHandler::syncWriteTxOnly(PortHandler *port, uint16_t start_ad
   txpacket[PKT_PARAMETER0+0]  = start_address;
   txpacket[PKT_PARAMETER0+1]  = data_length;
 
-  for (uint8_t s = 0; s < param_length; s++)
-    txpacket[PKT_PARAMETER0+2+s] = param[s];
-  //memcpy(&txpacket[PKT_PARAMETER0+2], param, param_length);
-
-  result = txRxPacket(port, txpacket, 0, 0);
+  result = txRxPacket(port, txpacket, param, param_length, 0, 0);
 
-  free(txpacket);
-  //delete[] txpacket;
   return result;
 }
 
@@ -726,20 +778,15 @@ int Protocol1PacketHandler::bulkReadTx(PortHandler *port, uint8_t *param, uint16
 {
   int result                 = COMM_TX_FAIL;
 
-  uint8_t *txpacket           = (uint8_t *)malloc(param_length+7);
+  uint8_t txpacket[7]         = {0};
   // 7: HEADER0 HEADER1 ID LEN INST 0x00 ... CHKSUM
-  //uint8_t *txpacket           = new uint8_t[param_length + 7];
 
   txpacket[PKT_ID]            = BROADCAST_ID;
   txpacket[PKT_LENGTH]        = param_length + 3; // 3: INST 0x00 ... CHKSUM
   txpacket[PKT_INSTRUCTION]   = INST_BULK_READ;
   txpacket[PKT_PARAMETER0+0]  = 0x00;
 
-  for (uint8_t s = 0; s < param_length; s++)
-    txpacket[PKT_PARAMETER0+1+s] = param[s];
-  //memcpy(&txpacket[PKT_PARAMETER0+1], param, param_length);
-
-  result = txPacket(port, txpacket);
+  result = txPacket(port, txpacket, param, param_length);
   if (result == COMM_SUCCESS)
   {
     int wait_length = 0;
@@ -748,8 +795,6 @@ int Protocol1PacketHandler::bulkReadTx(PortHandler *port, uint8_t *param, uint16
     port->setPacketTimeout((uint16_t)wait_length);
   }
 
-  free(txpacket);
-  //delete[] txpacket;
   return result;
 }
 
@@ -757,3 +802,174 @@ int Protocol1PacketHandler::bulkWriteTxOnly(PortHandler *port, uint8_t *param, u
 {
   return COMM_NOT_AVAILABLE;
 }
+
+int Protocol1PacketHandler::fastSyncReadTx(PortHandler *port, uint16_t start_address, uint16_t data_length, uint8_t *param, uint16_t param_length)
+{
+  return COMM_NOT_AVAILABLE;
+}
+
+int Protocol1PacketHandler::fastBulkReadTx(PortHandler *port, uint8_t *param, uint16_t param_length)
+{
+  return COMM_NOT_AVAILABLE;
+}
+
+int Protocol1PacketHandler::fastReadRx(PortHandler *port, PacketRequest *requests, int count)
+{
+  return COMM_NOT_AVAILABLE;
+}
+
+int Protocol1PacketHandler::txRxPackets(PortHandler *port, PacketRequest *requests, int count)
+{
+  uint8_t *packets              = 0;
+  uint8_t *rxpacket             = 0;
+  int     packets_length        = 0;
+  int     first                 = 0;    // first request of the packets not written yet
+  int     tx_length             = 0;
+
+  // the status packets are received in the same transaction as the instruction packets
+  BusTransaction transaction(port);
+  if (transaction.isAcquired() == false)
+    return COMM_PORT_BUSY;
+  if (port->beginTransaction() == false)
+    return COMM_PORT_BUSY;
+
+  // the packets are made and received in the buffer of the port, not on the stack:
+  // the status packets are received after all the instruction packets are written
+  packets   = port->getPacketBuffer(PACKET_BUFFER_LEN);
+  rxpacket  = packets;
+
+  if (port->isTxFlush())
+    port->clearPort();
+
+  // tx packets, which are made back to back in packets and written as many at a time as it holds
+  for (int i = 0; i < count; i++)
+  {
+    PacketRequest *request  = &requests[i];
+    int            param_length = 0;
+
+    request->error          = 0;
+    if (request->instruction == INST_PING)
+      param_length = 0;
+    else if (request->instruction == INST_READ)
+      param_length = 2;   // ADDR LEN
+    else if (request->instruction == INST_WRITE || request->instruction == INST_REG_WRITE)
+      param_length = 1 + request->length;
+    else
+    {
+      request->result = COMM_NOT_AVAILABLE;
+      continue;
+    }
+    if (request->id == BROADCAST_ID && (request->instruction == INST_PING || request->instruction == INST_READ))
+    {
+      request->result = COMM_NOT_AVAILABLE;
+      continue;
+    }
+    // 6: HEADER0 HEADER1 ID LENGTH INST CHKSUM
+    if (param_length + 6 > TXPACKET_MAX_LEN || request->address > 0xFF || (request->instruction == INST_READ && request->length > 0xFF))
+    {
+      request->result = COMM_TX_ERROR;
+      continue;
+    }
+
+    if (packets_length + param_length + 6 > TXPACKETS_BUFFER_LEN)
+    {
+      writeRequestPackets(port, packets, &packets_length, requests, first, i);
+      first = i;
+    }
+
+    uint8_t *packet         = &packets[packets_length];
+    packet[PKT_HEADER0]     = 0xFF;
+    packet[PKT_HEADER1]     = 0xFF;
+    packet[PKT_ID]          = request->id;
+    packet[PKT_LENGTH]      = param_length + 2;   // 2: INST CHKSUM
+    packet[PKT_INSTRUCTION] = request->instruction;
+    if (request->instruction != INST_PING)
+    {
+      packet[PKT_PARAMETER0]  = (uint8_t)request->address;
+      if (request->instruction == INST_READ)
+        packet[PKT_PARAMETER0+1] = (uint8_t)request->length;
+      else if (request->length > 0)
+        memcpy(&packet[PKT_PARAMETER0+1], request->data, request->length);
+    }
+
+    int     total_packet_length = param_length + 6;
+    uint8_t checksum            = 0;
+    for (int idx = 2; idx < total_packet_length - 1; idx++)   // except header, checksum
+      checksum += packet[idx];
+    packet[total_packet_length - 1] = ~checksum;
+
+    packets_length += total_packet_length;
+    tx_length      += total_packet_length;
+    port->addBusTx(request->instruction, total_packet_length);
+
+    // (ID == Broadcast ID) == no need to wait for status packet
+    request->result = (request->id == BROADCAST_ID) ? COMM_SUCCESS : COMM_RX_WAITING;
+  }
+  writeRequestPackets(port, packets, &packets_length, requests, first, count);
+
+  // rx packets, which answer the requests in order
+  // (PortHandler::updateResponseTime() is not called, as a response waits for the packets transmitted before it)
+  int next  = 0;
+  int armed = -1;  // request the timeout is set for
+  while (true)
+  {
+    while (next < count && requests[next].result != COMM_RX_WAITING)
+      next++;
+    if (next == count)
+      break;
+
+    PacketRequest *request = &requests[next];
+
+    // the timeout is set once for each request, so status packets answering no request do not put it off
+    if (armed != next)
+    {
+      // the first status packet comes after all the instruction packets are transmitted
+      int packet_length = getStatusDataLength(request) + 6 + tx_length;  // 6: HEADER0 HEADER1 ID LENGTH ERROR CHECKSUM
+      tx_length = 0;
+      if (request->timeout_msec > 0)
+        port->setPacketTimeout(request->timeout_msec);
+      else
+        port->setResponseTimeout(request->id, (uint16_t)((packet_length < 0xFFFF) ? packet_length : 0xFFFF));
+      armed = next;
+    }
+
+    int result = rxPacket(port, rxpacket);
+    if (result != COMM_SUCCESS)
+    {
+      request->result = result;
+      continue;
+    }
+
+    // the requests before the one answered have no status packet any more
+    // (a status packet answering no request is dropped, as txRxPacket() does)
+    for (int i = next; i < count; i++)
+    {
+      if (requests[i].result != COMM_RX_WAITING ||
+          isExpectedStatus(port, rxpacket, requests[i].id, getStatusDataLength(&requests[i])) == false)
+        continue;
+
+      for (int j = next; j < i; j++)
+      {
+        if (requests[j].result == COMM_RX_WAITING)
+          requests[j].result = COMM_RX_TIMEOUT;
+      }
+      requests[i].result = COMM_SUCCESS;
+      requests[i].error  = rxpacket[PKT_ERROR];
+      if (requests[i].data != 0 && requests[i].instruction == INST_READ && rxpacket[PKT_LENGTH] == requests[i].length + 2)
+        memcpy(requests[i].data, &rxpacket[PKT_PARAMETER0], requests[i].length);
+      break;
+    }
+
+    // a status packet answering no request does not keep the request waiting after its timeout
+    if (request->result == COMM_RX_WAITING && port->isPacketTimeout() == true)
+      request->result = COMM_RX_TIMEOUT;
+  }
+  port->endTransaction();
+
+  for (int i = 0; i < count; i++)
+  {
+    if (requests[i].result != COMM_SUCCESS)
+      return requests[i].result;
+  }
+  return COMM_SUCCESS;
+}
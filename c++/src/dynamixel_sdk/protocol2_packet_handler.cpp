@@ -32,13 +32,21 @@
 
 #if defined(__linux__)
 #include "protocol2_packet_handler.h"
+#include "crc16.h"
+#include "status_packet_parser.h"
 #elif defined(__APPLE__)
 #include "protocol2_packet_handler.h"
+#include "crc16.h"
+#include "status_packet_parser.h"
 #elif defined(_WIN32) || defined(_WIN64)
 #define WINDLLEXPORT
 #include "protocol2_packet_handler.h"
+#include "crc16.h"
+#include "status_packet_parser.h"
 #elif defined(ARDUINO) || defined(__OPENCR__) || defined(__OPENCM904__)
 #include "../../include/dynamixel_sdk/protocol2_packet_handler.h"
+#include "../../include/dynamixel_sdk/crc16.h"
+#include "../../include/dynamixel_sdk/status_packet_parser.h"
 #endif
 
 #include <stdio.h>
@@ -48,6 +56,12 @@
 #define TXPACKET_MAX_LEN    (4*1024)
 #define RXPACKET_MAX_LEN    (4*1024)
 
+// the packets are stuffed in place, so the buffers have room for the worst case (FF FF FD repeated)
+#define TXPACKET_BUFFER_LEN (TXPACKET_MAX_LEN + TXPACKET_MAX_LEN / 3 + 1)
+#define RXPACKET_BUFFER_LEN (RXPACKET_MAX_LEN + 7)  // 7: HEADER0 HEADER1 HEADER2 RESERVED ID LENGTH_L LENGTH_H
+#define TXPACKET_SEGMENTS   16                      // buffers written by one PortHandler::writePortv()
+#define PACKET_BUFFER_LEN   ((TXPACKET_BUFFER_LEN > RXPACKET_BUFFER_LEN) ? TXPACKET_BUFFER_LEN : RXPACKET_BUFFER_LEN)  // PortHandler::getPacketBuffer()
+
 ///////////////// for Protocol 2.0 Packet /////////////////
 #define PKT_HEADER0             0
 #define PKT_HEADER1             1
@@ -73,6 +87,47 @@
 
 using namespace dynamixel;
 
+// written between the buffers of a packet after FF FF FD
+static uint8_t stuffing_byte = 0xFD;
+
+// checks whether a status packet answers the instruction packet to the ID, which reads data_length bytes
+// (the length is checked when the port is not cleared before the instruction packet, see PortHandler::setTxFlush())
+static bool isExpectedStatus(PortHandler *port, uint8_t *rxpacket, uint8_t id, uint16_t data_length)
+{
+  if (rxpacket[PKT_ID] != id)
+    return false;
+  if (port->isTxFlush())
+    return true;
+
+  // a Dynamixel answers an error without data
+  uint16_t length = DXL_MAKEWORD(rxpacket[PKT_LENGTH_L], rxpacket[PKT_LENGTH_H]);
+  return (length == data_length + 4 || (rxpacket[PKT_ERROR] != 0 && length == 4));
+}
+
+// data length of the status packet answering a request of txRxPackets()
+static uint16_t getStatusDataLength(PacketRequest *request)
+{
+  if (request->instruction == INST_READ)
+    return request->length;
+  if (request->instruction == INST_PING)
+    return 3;   // MODEL_NUMBER_L MODEL_NUMBER_H FIRMWARE_VERSION
+  return 0;
+}
+
+// writes the instruction packets made for requests[first ... last-1], which fail if the packets are not written
+static void writeRequestPackets(PortHandler *port, uint8_t *packets, int *packets_length, PacketRequest *requests, int first, int last)
+{
+  if (*packets_length > 0 && port->writePort(packets, *packets_length) != *packets_length)
+  {
+    for (int i = first; i < last; i++)
+    {
+      if (requests[i].result == COMM_RX_WAITING || requests[i].result == COMM_SUCCESS)
+        requests[i].result = COMM_TX_FAIL;
+    }
+  }
+  *packets_length = 0;
+}
+
 Protocol2PacketHandler *Protocol2PacketHandler::unique_instance_ = new Protocol2PacketHandler();
 
 Protocol2PacketHandler::Protocol2PacketHandler() { }
@@ -173,112 +228,35 @@ void Protocol2PacketHandler::printRxPacketError(uint8_t error)
 #endif
 }
 
-unsigned short Protocol2PacketHandler::updateCRC(uint16_t crc_accum, uint8_t *data_blk_ptr, uint16_t data_blk_size)
-{
-  uint16_t i;
-  uint16_t crc_table[256] = {0x0000,
-  0x8005, 0x800F, 0x000A, 0x801B, 0x001E, 0x0014, 0x8011,
-  0x8033, 0x0036, 0x003C, 0x8039, 0x0028, 0x802D, 0x8027,
-  0x0022, 0x8063, 0x0066, 0x006C, 0x8069, 0x0078, 0x807D,
-  0x8077, 0x0072, 0x0050, 0x8055, 0x805F, 0x005A, 0x804B,
-  0x004E, 0x0044, 0x8041, 0x80C3, 0x00C6, 0x00CC, 0x80C9,
-  0x00D8, 0x80DD, 0x80D7, 0x00D2, 0x00F0, 0x80F5, 0x80FF,
-  0x00FA, 0x80EB, 0x00EE, 0x00E4, 0x80E1, 0x00A0, 0x80A5,
-  0x80AF, 0x00AA, 0x80BB, 0x00BE, 0x00B4, 0x80B1, 0x8093,
-  0x0096, 0x009C, 0x8099, 0x0088, 0x808D, 0x8087, 0x0082,
-  0x8183, 0x0186, 0x018C, 0x8189, 0x0198, 0x819D, 0x8197,
-  0x0192, 0x01B0, 0x81B5, 0x81BF, 0x01BA, 0x81AB, 0x01AE,
-  0x01A4, 0x81A1, 0x01E0, 0x81E5, 0x81EF, 0x01EA, 0x81FB,
-  0x01FE, 0x01F4, 0x81F1, 0x81D3, 0x01D6, 0x01DC, 0x81D9,
-  0x01C8, 0x81CD, 0x81C7, 0x01C2, 0x0140, 0x8145, 0x814F,
-  0x014A, 0x815B, 0x015E, 0x0154, 0x8151, 0x8173, 0x0176,
-  0x017C, 0x8179, 0x0168, 0x816D, 0x8167, 0x0162, 0x8123,
-  0x0126, 0x012C, 0x8129, 0x0138, 0x813D, 0x8137, 0x0132,
-  0x0110, 0x8115, 0x811F, 0x011A, 0x810B, 0x010E, 0x0104,
-  0x8101, 0x8303, 0x0306, 0x030C, 0x8309, 0x0318, 0x831D,
-  0x8317, 0x0312, 0x0330, 0x8335, 0x833F, 0x033A, 0x832B,
-  0x032E, 0x0324, 0x8321, 0x0360, 0x8365, 0x836F, 0x036A,
-  0x837B, 0x037E, 0x0374, 0x8371, 0x8353, 0x0356, 0x035C,
-  0x8359, 0x0348, 0x834D, 0x8347, 0x0342, 0x03C0, 0x83C5,
-  0x83CF, 0x03CA, 0x83DB, 0x03DE, 0x03D4, 0x83D1, 0x83F3,
-  0x03F6, 0x03FC, 0x83F9, 0x03E8, 0x83ED, 0x83E7, 0x03E2,
-  0x83A3, 0x03A6, 0x03AC, 0x83A9, 0x03B8, 0x83BD, 0x83B7,
-  0x03B2, 0x0390, 0x8395, 0x839F, 0x039A, 0x838B, 0x038E,
-  0x0384, 0x8381, 0x0280, 0x8285, 0x828F, 0x028A, 0x829B,
-  0x029E, 0x0294, 0x8291, 0x82B3, 0x02B6, 0x02BC, 0x82B9,
-  0x02A8, 0x82AD, 0x82A7, 0x02A2, 0x82E3, 0x02E6, 0x02EC,
-  0x82E9, 0x02F8, 0x82FD, 0x82F7, 0x02F2, 0x02D0, 0x82D5,
-  0x82DF, 0x02DA, 0x82CB, 0x02CE, 0x02C4, 0x82C1, 0x8243,
-  0x0246, 0x024C, 0x8249, 0x0258, 0x825D, 0x8257, 0x0252,
-  0x0270, 0x8275, 0x827F, 0x027A, 0x826B, 0x026E, 0x0264,
-  0x8261, 0x0220, 0x8225, 0x822F, 0x022A, 0x823B, 0x023E,
-  0x0234, 0x8231, 0x8213, 0x0216, 0x021C, 0x8219, 0x0208,
-  0x820D, 0x8207, 0x0202 };
-
-  for (uint16_t j = 0; j < data_blk_size; j++)
-  {
-    i = ((uint16_t)(crc_accum >> 8) ^ *data_blk_ptr++) & 0xFF;
-    crc_accum = (crc_accum << 8) ^ crc_table[i];
-  }
-
-  return crc_accum;
-}
-
+// the stuffed packet is longer than the packet, so packet needs the room (see TXPACKET_BUFFER_LEN)
 void Protocol2PacketHandler::addStuffing(uint8_t *packet)
 {
-  int i = 0, index = 0;
   int packet_length_in = DXL_MAKEWORD(packet[PKT_LENGTH_L], packet[PKT_LENGTH_H]);
-  int packet_length_out = packet_length_in;
-  uint8_t temp[TXPACKET_MAX_LEN] = {0};
-
-  for (uint8_t s = PKT_HEADER0; s <= PKT_LENGTH_H; s++)
-    temp[s] = packet[s]; // FF FF FD XX ID LEN_L LEN_H
-  //memcpy(temp, packet, PKT_LENGTH_H+1);
-  index = PKT_INSTRUCTION;
-  for (i = 0; i < packet_length_in - 2; i++)  // except CRC
+  int end              = PKT_INSTRUCTION + packet_length_in - 2;  // except CRC
+  int count            = 0;
+
+  for (int i = PKT_INSTRUCTION; i < end; i++)
   {
-    temp[index++] = packet[i+PKT_INSTRUCTION];
-    if (packet[i+PKT_INSTRUCTION] == 0xFD && packet[i+PKT_INSTRUCTION-1] == 0xFF && packet[i+PKT_INSTRUCTION-2] == 0xFF)
-    {   // FF FF FD
-      temp[index++] = 0xFD;
-      packet_length_out++;
-    }
+    if (packet[i] == 0xFD && packet[i-1] == 0xFF && packet[i-2] == 0xFF)
+      count++;  // FF FF FD
   }
-  temp[index++] = packet[PKT_INSTRUCTION+packet_length_in-2];
-  temp[index++] = packet[PKT_INSTRUCTION+packet_length_in-1];
-
-
-  //////////////////////////
-  if (packet_length_in != packet_length_out)
-    packet = (uint8_t *)realloc(packet, index * sizeof(uint8_t));
+  if (count == 0)
+    return;
 
-  ///////////////////////////
+  int packet_length_out = packet_length_in + count;
 
-  for (uint8_t s = 0; s < index; s++)
-    packet[s] = temp[s];
-  //memcpy(packet, temp, index);
-  packet[PKT_LENGTH_L] = DXL_LOBYTE(packet_length_out);
-  packet[PKT_LENGTH_H] = DXL_HIBYTE(packet_length_out);
-}
-
-void Protocol2PacketHandler::removeStuffing(uint8_t *packet)
-{
-  int i = 0, index = 0;
-  int packet_length_in = DXL_MAKEWORD(packet[PKT_LENGTH_L], packet[PKT_LENGTH_H]);
-  int packet_length_out = packet_length_in;
-
-  index = PKT_INSTRUCTION;
-  for (i = 0; i < packet_length_in - 2; i++)  // except CRC
+  // move the bytes backward from the end, which leaves the bytes before the first FF FF FD as they are
+  // (CRC is not moved, as it is calculated after the stuffing)
+  int index = end + count;
+  for (int i = end - 1; count > 0; i--)
   {
-    if (packet[i+PKT_INSTRUCTION] == 0xFD && packet[i+PKT_INSTRUCTION+1] == 0xFD && packet[i+PKT_INSTRUCTION-1] == 0xFF && packet[i+PKT_INSTRUCTION-2] == 0xFF)
-    {   // FF FF FD FD
-      packet_length_out--;
-      i++;
+    if (packet[i] == 0xFD && packet[i-1] == 0xFF && packet[i-2] == 0xFF)
+    {
+      packet[--index] = 0xFD;
+      count--;
     }
-    packet[index++] = packet[i+PKT_INSTRUCTION];
+    packet[--index] = packet[i];
   }
-  packet[index++] = packet[PKT_INSTRUCTION+packet_length_in-2];
-  packet[index++] = packet[PKT_INSTRUCTION+packet_length_in-1];
 
   packet[PKT_LENGTH_L] = DXL_LOBYTE(packet_length_out);
   packet[PKT_LENGTH_H] = DXL_HIBYTE(packet_length_out);
@@ -286,22 +264,26 @@ void Protocol2PacketHandler::removeStuffing(uint8_t *packet)
 
 int Protocol2PacketHandler::txPacket(PortHandler *port, uint8_t *txpacket)
 {
-  uint16_t total_packet_length   = 0;
-  uint16_t written_packet_length = 0;
+  // the stuffing bytes are written between the parts of txpacket, which is not moved
+  return txPacket(port, txpacket, 0, 0);
+}
 
-  if (port->is_using_)
-    return COMM_PORT_BUSY;
-  port->is_using_ = true;
+// txpacket holds the packet before param, which is written from the buffer of the caller without copy
+int Protocol2PacketHandler::txPacket(PortHandler *port, uint8_t *txpacket, uint8_t *param, uint16_t param_length)
+{
+  uint16_t packet_length         = DXL_MAKEWORD(txpacket[PKT_LENGTH_L], txpacket[PKT_LENGTH_H]);
+  int      total_packet_length   = packet_length + 7;
+  // 7: HEADER0 HEADER1 HEADER2 RESERVED ID LENGTH_L LENGTH_H
+  int      head_length           = total_packet_length - param_length - 2; // 2: CRC16
+  int      written_packet_length = 0;
 
-  // byte stuffing for header
-  addStuffing(txpacket);
+  if (port->beginTransaction() == false)
+    return COMM_PORT_BUSY;
 
   // check max packet length
-  total_packet_length = DXL_MAKEWORD(txpacket[PKT_LENGTH_L], txpacket[PKT_LENGTH_H]) + 7;
-  // 7: HEADER0 HEADER1 HEADER2 RESERVED ID LENGTH_L LENGTH_H
-  if (total_packet_length > TXPACKET_MAX_LEN)
+  if (total_packet_length > TXPACKET_MAX_LEN || head_length <= PKT_INSTRUCTION)
   {
-    port->is_using_ = false;
+    port->endTransaction();
     return COMM_TX_ERROR;
   }
 
@@ -311,140 +293,219 @@ int Protocol2PacketHandler::txPacket(PortHandler *port, uint8_t *txpacket)
   txpacket[PKT_HEADER2]   = 0xFD;
   txpacket[PKT_RESERVED]  = 0x00;
 
-  // add CRC16
-  uint16_t crc = updateCRC(0, txpacket, total_packet_length - 2);    // 2: CRC16
-  txpacket[total_packet_length - 2] = DXL_LOBYTE(crc);
-  txpacket[total_packet_length - 1] = DXL_HIBYTE(crc);
+  // find FF FF FD to be stuffed in INST ... param, the same as addStuffing(),
+  // and split the packet after each of them to write the stuffing byte in between
+  PortBuffer buffers[TXPACKET_SEGMENTS];
+  uint8_t   *data[2]    = { txpacket, param };
+  int        length[2]  = { head_length, param_length };
+  uint8_t    prev[2]    = { txpacket[PKT_LENGTH_L], txpacket[PKT_LENGTH_H] };
+  int        count      = 0;
+  int        stuffing   = 0;
 
-  // tx packet
-  port->clearPort();
-  written_packet_length = port->writePort(txpacket, total_packet_length);
+  for (int d = 0; d < 2 && count >= 0; d++)
+  {
+    int begin = 0;
+    for (int i = (d == 0) ? PKT_INSTRUCTION : 0; i < length[d]; i++)
+    {
+      if (data[d][i] == 0xFD && prev[1] == 0xFF && prev[0] == 0xFF)
+      {
+        if (count + 5 > TXPACKET_SEGMENTS)  // 5: part, stuffing byte, rest of data, param, CRC16
+        {
+          count = -1;
+          break;
+        }
+        buffers[count].data     = &data[d][begin];
+        buffers[count++].length = i + 1 - begin;
+        buffers[count].data     = &stuffing_byte;
+        buffers[count++].length = 1;
+        begin = i + 1;
+        stuffing++;
+      }
+      prev[0] = prev[1];
+      prev[1] = data[d][i];
+    }
+    if (count >= 0 && begin < length[d])
+    {
+      buffers[count].data     = &data[d][begin];
+      buffers[count++].length = length[d] - begin;
+    }
+  }
+
+  if (port->isTxFlush())
+    port->clearPort();
+  if (count >= 0)
+  {
+    // tx packet from the buffers of the caller
+    if (total_packet_length + stuffing > TXPACKET_MAX_LEN)
+    {
+      port->endTransaction();
+      return COMM_TX_ERROR;
+    }
+    if (stuffing > 0)
+    {
+      packet_length        += stuffing;
+      total_packet_length  += stuffing;
+      txpacket[PKT_LENGTH_L] = DXL_LOBYTE(packet_length);
+      txpacket[PKT_LENGTH_H] = DXL_HIBYTE(packet_length);
+    }
+
+    uint16_t crc      = 0;
+    for (int i = 0; i < count; i++)
+      crc = Crc16::update(crc, buffers[i].data, buffers[i].length);
+    uint8_t  crc16[2] = { DXL_LOBYTE(crc), DXL_HIBYTE(crc) };
+    buffers[count].data     = crc16;
+    buffers[count++].length = 2;
+
+    written_packet_length = port->writePortv(buffers, count);
+  }
+  else
+  {
+    // too many FF FF FD to be split, so the packet is stuffed in the buffer of the port
+    uint8_t *packet = port->getPacketBuffer(TXPACKET_BUFFER_LEN);
+
+    memcpy(packet, txpacket, head_length);
+    if (param_length > 0)
+      memcpy(&packet[head_length], param, param_length);
+    addStuffing(packet);
+
+    total_packet_length = DXL_MAKEWORD(packet[PKT_LENGTH_L], packet[PKT_LENGTH_H]) + 7;
+    if (total_packet_length > TXPACKET_MAX_LEN)
+    {
+      port->endTransaction();
+      return COMM_TX_ERROR;
+    }
+
+    uint16_t crc = Crc16::update(0, packet, total_packet_length - 2);
+    packet[total_packet_length - 2] = DXL_LOBYTE(crc);
+    packet[total_packet_length - 1] = DXL_HIBYTE(crc);
+
+    written_packet_length = port->writePort(packet, total_packet_length);
+  }
   if (total_packet_length != written_packet_length)
   {
-    port->is_using_ = false;
+    port->endTransaction();
     return COMM_TX_FAIL;
   }
 
+  port->addBusTx(txpacket[PKT_INSTRUCTION], total_packet_length);
   return COMM_SUCCESS;
 }
 
 int Protocol2PacketHandler::rxPacket(PortHandler *port, uint8_t *rxpacket)
 {
   int     result         = COMM_TX_FAIL;
+  int     rx_length      = 0;
+
+  // the bytes are parsed as they arrive, and no more than the packet being parsed are read
+  StatusPacketParser *parser = port->getStatusParser();
+  parser->begin(2.0);
+
+  // a status packet which has already arrived whole is read into rxpacket without the ring buffer of the parser
+  int needed_length = parser->getNeededLength();
+  int packet_length = 0;
+  int read_length   = port->readPort(rxpacket, needed_length);
+  port->addBusRx(read_length);
+  if (read_length == needed_length && (packet_length = parser->getPacketLength(rxpacket)) > 0 && packet_length <= RXPACKET_BUFFER_LEN)
+  {
+    if (packet_length > read_length)
+    {
+      int rest_length = port->readPort(&rxpacket[read_length], packet_length - read_length);
+      port->addBusRx(rest_length);
+      if (rest_length > 0)
+        read_length += rest_length;
+    }
+    if (read_length == packet_length)
+    {
+      result = parser->checkPacket(rxpacket, &packet_length);
+      if (result == COMM_RX_CORRUPT)
+        port->addBusChecksumError();
+      port->endTransaction();
+      port->addBusStatus(rxpacket[PKT_ID], result);
+      return result;
+    }
+  }
+  if (read_length > 0)
+  {
+    rx_length = read_length;
+    parser->feed(rxpacket, read_length);
+    port->addBusResync(parser->takeSkippedLength());
+  }
 
-  uint16_t rx_length     = 0;
-  uint16_t wait_length   = 11; // minimum length (HEADER0 HEADER1 HEADER2 RESERVED ID LENGTH_L LENGTH_H INST ERROR CRC16_L CRC16_H)
+  // sleep until the rest of the packet arrives, as the loop would after the same short read
+  if (read_length < needed_length && port->isPacketTimeout() == false)
+    port->waitForBytes();
 
   while(true)
   {
-    rx_length += port->readPort(&rxpacket[rx_length], wait_length - rx_length);
-    if (rx_length >= wait_length)
+    if (parser->getFrameCount() > 0)
     {
-      uint16_t idx = 0;
-
-      // find packet header
-      for (idx = 0; idx < (rx_length - 3); idx++)
-      {
-        if ((rxpacket[idx] == 0xFF) && (rxpacket[idx+1] == 0xFF) && (rxpacket[idx+2] == 0xFD) && (rxpacket[idx+3] != 0xFD))
-          break;
-      }
-
-      if (idx == 0)   // found at the beginning of the packet
-      {
-        if (rxpacket[PKT_RESERVED] != 0x00 ||
-           rxpacket[PKT_ID] > 0xFC ||
-           DXL_MAKEWORD(rxpacket[PKT_LENGTH_L], rxpacket[PKT_LENGTH_H]) > RXPACKET_MAX_LEN ||
-           rxpacket[PKT_INSTRUCTION] != 0x55)
-        {
-          // remove the first byte in the packet
-          for (uint8_t s = 0; s < rx_length - 1; s++)
-            rxpacket[s] = rxpacket[1 + s];
-          //memcpy(&rxpacket[0], &rxpacket[idx], rx_length - idx);
-          rx_length -= 1;
-          continue;
-        }
+      // the byte stuffing is removed by the parser
+      result = parser->popFrame(rxpacket, RXPACKET_BUFFER_LEN);
+      port->addBusResync(parser->takeSkippedLength());
+      if (result == COMM_RX_CORRUPT)
+        port->addBusChecksumError();
+      if (result != COMM_RX_WAITING)
+        break;
+      continue;
+    }
 
-        // re-calculate the exact length of the rx packet
-        if (wait_length != DXL_MAKEWORD(rxpacket[PKT_LENGTH_L], rxpacket[PKT_LENGTH_H]) + PKT_LENGTH_H + 1)
-        {
-          wait_length = DXL_MAKEWORD(rxpacket[PKT_LENGTH_L], rxpacket[PKT_LENGTH_H]) + PKT_LENGTH_H + 1;
-          continue;
-        }
+    needed_length = parser->getNeededLength();
+    read_length   = port->readPort(parser->getWritePointer(), needed_length);
+    port->addBusRx(read_length);
+    if (read_length > 0)
+    {
+      rx_length += read_length;
+      parser->commit(read_length);
+      port->addBusResync(parser->takeSkippedLength());
 
-        if (rx_length < wait_length)
-        {
-          // check timeout
-          if (port->isPacketTimeout() == true)
-          {
-            if (rx_length == 0)
-            {
-              result = COMM_RX_TIMEOUT;
-            }
-            else
-            {
-              result = COMM_RX_CORRUPT;
-            }
-            break;
-          }
-          else
-          {
-            continue;
-          }
-        }
+      // the rest may have arrived already
+      if (read_length == needed_length)
+        continue;
+    }
 
-        // verify CRC16
-        uint16_t crc = DXL_MAKEWORD(rxpacket[wait_length-2], rxpacket[wait_length-1]);
-        if (updateCRC(0, rxpacket, wait_length - 2) == crc)
-        {
-          result = COMM_SUCCESS;
-        }
-        else
-        {
-          result = COMM_RX_CORRUPT;
-        }
-        break;
-      }
-      else
+    // check timeout
+    if (port->isPacketTimeout() == true)
+    {
+      if (rx_length == 0)
       {
-        // remove unnecessary packets
-        for (uint8_t s = 0; s < rx_length - idx; s++)
-          rxpacket[s] = rxpacket[idx + s];
-        //memcpy(&rxpacket[0], &rxpacket[idx], rx_length - idx);
-        rx_length -= idx;
+        result = COMM_RX_TIMEOUT;
       }
-    }
-    else
-    {
-      // check timeout
-      if (port->isPacketTimeout() == true)
+      else
       {
-        if (rx_length == 0)
-        {
-          result = COMM_RX_TIMEOUT;
-        }
-        else
-        {
-          result = COMM_RX_CORRUPT;
-        }
-        break;
+        result = COMM_RX_CORRUPT;
       }
+      break;
     }
-  }
-  port->is_using_ = false;
 
-  if (result == COMM_SUCCESS)
-    removeStuffing(rxpacket);
+    // sleep until the rest of the packet arrives
+    port->waitForBytes();
+  }
+  port->endTransaction();
+  port->addBusStatus(rxpacket[PKT_ID], result);
 
   return result;
 }
 
 // NOT for BulkRead / SyncRead instruction
 int Protocol2PacketHandler::txRxPacket(PortHandler *port, uint8_t *txpacket, uint8_t *rxpacket, uint8_t *error)
+{
+  return txRxPacket(port, txpacket, 0, 0, rxpacket, error);
+}
+
+int Protocol2PacketHandler::txRxPacket(PortHandler *port, uint8_t *txpacket, uint8_t *param, uint16_t param_length, uint8_t *rxpacket, uint8_t *error)
 {
   int result = COMM_TX_FAIL;
 
+  // the status packets waited for are received in the same transaction
+  BusTransaction transaction(port);
+  if (transaction.isAcquired() == false)
+    return COMM_PORT_BUSY;
+
   // tx packet
-  result = txPacket(port, txpacket);
+  if (param == 0)
+    result = txPacket(port, txpacket);
+  else
+    result = txPacket(port, txpacket, param, param_length);
   if (result != COMM_SUCCESS)
     return result;
 
@@ -456,25 +517,31 @@ int Protocol2PacketHandler::txRxPacket(PortHandler *port, uint8_t *txpacket, uin
   // (Instruction == action) == no need to wait for status packet
   if (txpacket[PKT_ID] == BROADCAST_ID || txpacket[PKT_INSTRUCTION] == INST_ACTION)
   {
-    port->is_using_ = false;
+    port->endTransaction();
     return result;
   }
 
   // set packet timeout
   if (txpacket[PKT_INSTRUCTION] == INST_READ)
   {
-    port->setPacketTimeout((uint16_t)(DXL_MAKEWORD(txpacket[PKT_PARAMETER0+2], txpacket[PKT_PARAMETER0+3]) + 11));
+    port->setResponseTimeout(txpacket[PKT_ID], (uint16_t)(DXL_MAKEWORD(txpacket[PKT_PARAMETER0+2], txpacket[PKT_PARAMETER0+3]) + 11));
   }
   else
   {
-    port->setPacketTimeout((uint16_t)11);
+    port->setResponseTimeout(txpacket[PKT_ID], (uint16_t)11);
     // HEADER0 HEADER1 HEADER2 RESERVED ID LENGTH_L LENGTH_H INST ERROR CRC16_L CRC16_H
   }
 
   // rx packet
+  uint16_t data_length = 0;
+  if (txpacket[PKT_INSTRUCTION] == INST_READ)
+    data_length = DXL_MAKEWORD(txpacket[PKT_PARAMETER0+2], txpacket[PKT_PARAMETER0+3]);
+  else if (txpacket[PKT_INSTRUCTION] == INST_PING)
+    data_length = 3;  // MODEL_NUMBER_L MODEL_NUMBER_H FIRMWARE_VERSION
   do {
     result = rxPacket(port, rxpacket);
-  } while (result == COMM_SUCCESS && txpacket[PKT_ID] != rxpacket[PKT_ID]);
+  } while (result == COMM_SUCCESS && isExpectedStatus(port, rxpacket, txpacket[PKT_ID], data_length) == false);
+  port->updateResponseTime(txpacket[PKT_ID], result == COMM_SUCCESS);
 
   if (result == COMM_SUCCESS && txpacket[PKT_ID] == rxpacket[PKT_ID])
   {
@@ -495,7 +562,7 @@ int Protocol2PacketHandler::ping(PortHandler *port, uint8_t id, uint16_t *model_
   int result                 = COMM_TX_FAIL;
 
   uint8_t txpacket[10]        = {0};
-  uint8_t rxpacket[14]        = {0};
+  uint8_t *rxpacket           = 0;
 
   if (id >= BROADCAST_ID)
     return COMM_NOT_AVAILABLE;
@@ -505,6 +572,13 @@ int Protocol2PacketHandler::ping(PortHandler *port, uint8_t id, uint16_t *model_
   txpacket[PKT_LENGTH_H]      = 0;
   txpacket[PKT_INSTRUCTION]   = INST_PING;
 
+  // a stale status packet left on the bus by PortHandler::setTxFlush(false) may be read instead of the one waited for,
+  // so the status packet is received in the buffer of the port, which has room for any status packet
+  BusTransaction transaction(port);
+  if (transaction.isAcquired() == false)
+    return COMM_PORT_BUSY;
+  rxpacket = port->getPacketBuffer(PACKET_BUFFER_LEN);
+
   result = txRxPacket(port, txpacket, rxpacket, error);
   if (result == COMM_SUCCESS && model_number != 0)
     *model_number = DXL_MAKEWORD(rxpacket[PKT_PARAMETER0+1], rxpacket[PKT_PARAMETER0+2]);
@@ -519,90 +593,76 @@ int Protocol2PacketHandler::broadcastPing(PortHandler *port, std::vector<uint8_t
 
   id_list.clear();
 
-  uint16_t rx_length          = 0;
+  int rx_length               = 0;
   uint16_t wait_length        = STATUS_LENGTH * MAX_ID;
 
   uint8_t txpacket[10]        = {0};
-  uint8_t rxpacket[STATUS_LENGTH * MAX_ID] = {0};
+  uint8_t *rxpacket           = 0;
 
   txpacket[PKT_ID]            = BROADCAST_ID;
   txpacket[PKT_LENGTH_L]      = 3;
   txpacket[PKT_LENGTH_H]      = 0;
   txpacket[PKT_INSTRUCTION]   = INST_PING;
 
+  // the port is acquired before it is cleared, so the bytes of a transaction of another thread are not dropped
+  BusTransaction transaction(port);
+  if (transaction.isAcquired() == false)
+    return COMM_PORT_BUSY;
+  rxpacket = port->getPacketBuffer(PACKET_BUFFER_LEN);
+
+  // every status packet received is taken as an answer
+  if (port->isTxFlush() == false)
+    port->clearPort();
+
   result = txPacket(port, txpacket);
   if (result != COMM_SUCCESS)
-  {
-    port->is_using_ = false;
     return result;
-  }
 
   // set rx timeout
   port->setPacketTimeout((uint16_t)(wait_length * 30));
 
-  while(1)
-  {
-    rx_length += port->readPort(&rxpacket[rx_length], wait_length - rx_length);
-    if (port->isPacketTimeout() == true)// || rx_length >= wait_length)
-      break;
-  }
-
-  port->is_using_ = false;
-
-  if (rx_length == 0)
-    return COMM_RX_TIMEOUT;
+  StatusPacketParser *parser = port->getStatusParser();
+  parser->begin(2.0);
+  result = COMM_RX_CORRUPT;   // when no status packet is found in the bytes received
 
   while(1)
   {
-    if (rx_length < STATUS_LENGTH)
-      return COMM_RX_CORRUPT;
-
-    uint16_t idx = 0;
-
-    // find packet header
-    for (idx = 0; idx < (rx_length - 2); idx++)
+    int read_length = port->readPort(parser->getWritePointer(), parser->getWritableLength());
+    port->addBusRx(read_length);
+    if (read_length > 0)
+      rx_length += read_length;
+    parser->commit(read_length);
+    port->addBusResync(parser->takeSkippedLength());
+
+    // the status packets are taken as they arrive, so the ring buffer is never full
+    while (parser->getFrameCount() > 0)
     {
-      if (rxpacket[idx] == 0xFF && rxpacket[idx+1] == 0xFF && rxpacket[idx+2] == 0xFD)
-        break;
-    }
-
-    if (idx == 0)   // found at the beginning of the packet
-    {
-      // verify CRC16
-      uint16_t crc = DXL_MAKEWORD(rxpacket[STATUS_LENGTH-2], rxpacket[STATUS_LENGTH-1]);
-
-      if (updateCRC(0, rxpacket, STATUS_LENGTH - 2) == crc)
+      if (parser->popFrame(rxpacket, RXPACKET_BUFFER_LEN) == COMM_SUCCESS)
       {
         result = COMM_SUCCESS;
-
         id_list.push_back(rxpacket[PKT_ID]);
-
-        for (uint8_t s = 0; s < rx_length - STATUS_LENGTH; s++)
-          rxpacket[s] = rxpacket[STATUS_LENGTH + s];
-        rx_length -= STATUS_LENGTH;
-
-        if (rx_length == 0)
-          return result;
       }
       else
       {
         result = COMM_RX_CORRUPT;
-
-        // remove header (0xFF 0xFF 0xFD)
-        for (uint8_t s = 0; s < rx_length - 3; s++)
-          rxpacket[s] = rxpacket[3 + s];
-        rx_length -= 3;
+        port->addBusChecksumError();
       }
     }
-    else
-    {
-      // remove unnecessary packets
-      for (uint8_t s = 0; s < rx_length - idx; s++)
-        rxpacket[s] = rxpacket[idx + s];
-      rx_length -= idx;
-    }
+
+    if (port->isPacketTimeout() == true)// || rx_length >= wait_length)
+      break;
+    port->waitForBytes();
   }
 
+  port->endTransaction();
+
+  if (rx_length == 0)
+    return COMM_RX_TIMEOUT;
+
+  // a status packet cut off
+  if (parser->isParsing() == true)
+    return COMM_RX_CORRUPT;
+
   return result;
 }
 
@@ -621,20 +681,26 @@ int Protocol2PacketHandler::action(PortHandler *port, uint8_t id)
 int Protocol2PacketHandler::reboot(PortHandler *port, uint8_t id, uint8_t *error)
 {
   uint8_t txpacket[10]        = {0};
-  uint8_t rxpacket[11]        = {0};
+  uint8_t *rxpacket           = 0;
 
   txpacket[PKT_ID]            = id;
   txpacket[PKT_LENGTH_L]      = 3;
   txpacket[PKT_LENGTH_H]      = 0;
   txpacket[PKT_INSTRUCTION]   = INST_REBOOT;
 
+  // the status packet is received in the buffer of the port, as in ping()
+  BusTransaction transaction(port);
+  if (transaction.isAcquired() == false)
+    return COMM_PORT_BUSY;
+  rxpacket = port->getPacketBuffer(PACKET_BUFFER_LEN);
+
   return txRxPacket(port, txpacket, rxpacket, error);
 }
 
 int Protocol2PacketHandler::factoryReset(PortHandler *port, uint8_t id, uint8_t option, uint8_t *error)
 {
   uint8_t txpacket[11]        = {0};
-  uint8_t rxpacket[11]        = {0};
+  uint8_t *rxpacket           = 0;
 
   txpacket[PKT_ID]            = id;
   txpacket[PKT_LENGTH_L]      = 4;
@@ -642,6 +708,12 @@ int Protocol2PacketHandler::factoryReset(PortHandler *port, uint8_t id, uint8_t
   txpacket[PKT_INSTRUCTION]   = INST_FACTORY_RESET;
   txpacket[PKT_PARAMETER0]    = option;
 
+  // the status packet is received in the buffer of the port, as in ping()
+  BusTransaction transaction(port);
+  if (transaction.isAcquired() == false)
+    return COMM_PORT_BUSY;
+  rxpacket = port->getPacketBuffer(PACKET_BUFFER_LEN);
+
   return txRxPacket(port, txpacket, rxpacket, error);
 }
 
@@ -667,7 +739,7 @@ int Protocol2PacketHandler::readTx(PortHandler *port, uint8_t id, uint16_t addre
 
   // set packet timeout
   if (result == COMM_SUCCESS)
-    port->setPacketTimeout((uint16_t)(length + 11));
+    port->setResponseTimeout(id, (uint16_t)(length + 11));
 
   return result;
 }
@@ -675,25 +747,27 @@ int Protocol2PacketHandler::readTx(PortHandler *port, uint8_t id, uint16_t addre
 int Protocol2PacketHandler::readRx(PortHandler *port, uint8_t id, uint16_t length, uint8_t *data, uint8_t *error)
 {
   int result                  = COMM_TX_FAIL;
-  uint8_t *rxpacket           = (uint8_t *)malloc(RXPACKET_MAX_LEN);
-  //(length + 11 + (length/3));  // (length/3): consider stuffing
-  //uint8_t *rxpacket           = new uint8_t[length + 11 + (length/3)];    // (length/3): consider stuffing
+  uint8_t *rxpacket           = 0;
+
+  BusTransaction transaction(port);
+  if (transaction.isAcquired() == false)
+    return COMM_PORT_BUSY;
+  rxpacket = port->getPacketBuffer(PACKET_BUFFER_LEN);
 
   do {
     result = rxPacket(port, rxpacket);
-  } while (result == COMM_SUCCESS && rxpacket[PKT_ID] != id);
+  } while (result == COMM_SUCCESS && isExpectedStatus(port, rxpacket, id, length) == false);
+  port->updateResponseTime(id, result == COMM_SUCCESS);
 
   if (result == COMM_SUCCESS && rxpacket[PKT_ID] == id)
   {
     if (error != 0)
       *error = (uint8_t)rxpacket[PKT_ERROR];
-    for (uint8_t s = 0; s < length; s++)
+    for (uint16_t s = 0; s < length; s++)
       data[s] = rxpacket[PKT_PARAMETER0 + 1 + s];
     //memcpy(data, &rxpacket[PKT_PARAMETER0+1], length);
   }
 
-  free(rxpacket);
-  //delete[] rxpacket;
   return result;
 }
 
@@ -702,8 +776,7 @@ int Protocol2PacketHandler::readTxRx(PortHandler *port, uint8_t id, uint16_t add
   int result                  = COMM_TX_FAIL;
 
   uint8_t txpacket[14]        = {0};
-  uint8_t *rxpacket           = (uint8_t *)malloc(RXPACKET_MAX_LEN);
-  //(length + 11 + (length/3));  // (length/3): consider stuffing
+  uint8_t *rxpacket           = 0;
 
   if (id >= BROADCAST_ID)
     return COMM_NOT_AVAILABLE;
@@ -717,18 +790,22 @@ int Protocol2PacketHandler::readTxRx(PortHandler *port, uint8_t id, uint16_t add
   txpacket[PKT_PARAMETER0+2]  = (uint8_t)DXL_LOBYTE(length);
   txpacket[PKT_PARAMETER0+3]  = (uint8_t)DXL_HIBYTE(length);
 
+  // the status packet is received in the buffer of the port, as in ping()
+  BusTransaction transaction(port);
+  if (transaction.isAcquired() == false)
+    return COMM_PORT_BUSY;
+  rxpacket = port->getPacketBuffer(PACKET_BUFFER_LEN);
+
   result = txRxPacket(port, txpacket, rxpacket, error);
   if (result == COMM_SUCCESS)
   {
     if (error != 0)
       *error = (uint8_t)rxpacket[PKT_ERROR];
-    for (uint8_t s = 0; s < length; s++)
+    for (uint16_t s = 0; s < length; s++)
       data[s] = rxpacket[PKT_PARAMETER0 + 1 + s];
     //memcpy(data, &rxpacket[PKT_PARAMETER0+1], length);
   }
 
-  free(rxpacket);
-  //delete[] rxpacket;
   return result;
 }
 
@@ -800,8 +877,8 @@ int Protocol2PacketHandler::writeTxOnly(PortHandler *port, uint8_t id, uint16_t
 {
   int result                  = COMM_TX_FAIL;
 
-  uint8_t *txpacket           = (uint8_t *)malloc(length+12);
-  //uint8_t *txpacket           = new uint8_t[length+12];
+  uint8_t txpacket[10]        = {0};
+  // 10: HEADER0 HEADER1 HEADER2 RESERVED ID LEN_L LEN_H INST ADDR_L ADDR_H (data) CRC16_L CRC16_H
 
   txpacket[PKT_ID]            = id;
   txpacket[PKT_LENGTH_L]      = DXL_LOBYTE(length+5);
@@ -810,15 +887,10 @@ int Protocol2PacketHandler::writeTxOnly(PortHandler *port, uint8_t id, uint16_t
   txpacket[PKT_PARAMETER0+0]  = (uint8_t)DXL_LOBYTE(address);
   txpacket[PKT_PARAMETER0+1]  = (uint8_t)DXL_HIBYTE(address);
 
-  for (uint8_t s = 0; s < length; s++)
-    txpacket[PKT_PARAMETER0+2+s] = data[s];
-  //memcpy(&txpacket[PKT_PARAMETER0+2], data, length);
-
-  result = txPacket(port, txpacket);
-  port->is_using_ = false;
+  result = txPacket(port, txpacket, data, length);
+  if (result == COMM_SUCCESS)
+    port->endTransaction();
 
-  free(txpacket);
-  //delete[] txpacket;
   return result;
 }
 
@@ -826,9 +898,9 @@ int Protocol2PacketHandler::writeTxRx(PortHandler *port, uint8_t id, uint16_t ad
 {
   int result                  = COMM_TX_FAIL;
 
-  uint8_t *txpacket           = (uint8_t *)malloc(length + 12);
-  //uint8_t *txpacket           = new uint8_t[length+12];
-  uint8_t rxpacket[11]        = {0};
+  uint8_t txpacket[10]        = {0};
+  // 10: HEADER0 HEADER1 HEADER2 RESERVED ID LEN_L LEN_H INST ADDR_L ADDR_H (data) CRC16_L CRC16_H
+  uint8_t *rxpacket           = 0;
 
   txpacket[PKT_ID]            = id;
   txpacket[PKT_LENGTH_L]      = DXL_LOBYTE(length+5);
@@ -837,14 +909,14 @@ int Protocol2PacketHandler::writeTxRx(PortHandler *port, uint8_t id, uint16_t ad
   txpacket[PKT_PARAMETER0+0]  = (uint8_t)DXL_LOBYTE(address);
   txpacket[PKT_PARAMETER0+1]  = (uint8_t)DXL_HIBYTE(address);
 
-  for (uint8_t s = 0; s < length; s++)
-    txpacket[PKT_PARAMETER0+2+s] = data[s];
-  //memcpy(&txpacket[PKT_PARAMETER0+2], data, length);
+  // the status packet is received in the buffer of the port, as in ping()
+  BusTransaction transaction(port);
+  if (transaction.isAcquired() == false)
+    return COMM_PORT_BUSY;
+  rxpacket = port->getPacketBuffer(PACKET_BUFFER_LEN);
 
-  result = txRxPacket(port, txpacket, rxpacket, error);
+  result = txRxPacket(port, txpacket, data, length, rxpacket, error);
 
-  free(txpacket);
-  //delete[] txpacket;
   return result;
 }
 
@@ -885,8 +957,8 @@ int Protocol2PacketHandler::regWriteTxOnly(PortHandler *port, uint8_t id, uint16
 {
   int result                 = COMM_TX_FAIL;
 
-  uint8_t *txpacket           = (uint8_t *)malloc(length + 12);
-  //uint8_t *txpacket           = new uint8_t[length+12];
+  uint8_t txpacket[10]        = {0};
+  // 10: HEADER0 HEADER1 HEADER2 RESERVED ID LEN_L LEN_H INST ADDR_L ADDR_H (data) CRC16_L CRC16_H
 
   txpacket[PKT_ID]            = id;
   txpacket[PKT_LENGTH_L]      = DXL_LOBYTE(length+5);
@@ -895,15 +967,10 @@ int Protocol2PacketHandler::regWriteTxOnly(PortHandler *port, uint8_t id, uint16
   txpacket[PKT_PARAMETER0+0]  = (uint8_t)DXL_LOBYTE(address);
   txpacket[PKT_PARAMETER0+1]  = (uint8_t)DXL_HIBYTE(address);
 
-  for (uint8_t s = 0; s < length; s++)
-    txpacket[PKT_PARAMETER0+2+s] = data[s];
-  //memcpy(&txpacket[PKT_PARAMETER0+2], data, length);
-
-  result = txPacket(port, txpacket);
-  port->is_using_ = false;
+  result = txPacket(port, txpacket, data, length);
+  if (result == COMM_SUCCESS)
+    port->endTransaction();
 
-  free(txpacket);
-  //delete[] txpacket;
   return result;
 }
 
@@ -911,9 +978,9 @@ int Protocol2PacketHandler::regWriteTxRx(PortHandler *port, uint8_t id, uint16_t
 {
   int result                 = COMM_TX_FAIL;
 
-  uint8_t *txpacket           = (uint8_t *)malloc(length + 12);
-  //uint8_t *txpacket           = new uint8_t[length+12];
-  uint8_t rxpacket[11]        = {0};
+  uint8_t txpacket[10]        = {0};
+  // 10: HEADER0 HEADER1 HEADER2 RESERVED ID LEN_L LEN_H INST ADDR_L ADDR_H (data) CRC16_L CRC16_H
+  uint8_t *rxpacket           = 0;
 
   txpacket[PKT_ID]            = id;
   txpacket[PKT_LENGTH_L]      = DXL_LOBYTE(length+5);
@@ -922,14 +989,14 @@ int Protocol2PacketHandler::regWriteTxRx(PortHandler *port, uint8_t id, uint16_t
   txpacket[PKT_PARAMETER0+0]  = (uint8_t)DXL_LOBYTE(address);
   txpacket[PKT_PARAMETER0+1]  = (uint8_t)DXL_HIBYTE(address);
 
-  for (uint8_t s = 0; s < length; s++)
-    txpacket[PKT_PARAMETER0+2+s] = data[s];
-  //memcpy(&txpacket[PKT_PARAMETER0+2], data, length);
+  // the status packet is received in the buffer of the port, as in ping()
+  BusTransaction transaction(port);
+  if (transaction.isAcquired() == false)
+    return COMM_PORT_BUSY;
+  rxpacket = port->getPacketBuffer(PACKET_BUFFER_LEN);
 
-  result = txRxPacket(port, txpacket, rxpacket, error);
+  result = txRxPacket(port, txpacket, data, length, rxpacket, error);
 
-  free(txpacket);
-  //delete[] txpacket;
   return result;
 }
 
@@ -937,8 +1004,8 @@ int Protocol2PacketHandler::syncReadTx(PortHandler *port, uint16_t start_address
 {
   int result                 = COMM_TX_FAIL;
 
-  uint8_t *txpacket           = (uint8_t *)malloc(param_length + 14);
-  // 14: HEADER0 HEADER1 HEADER2 RESERVED ID LEN_L LEN_H INST START_ADDR_L START_ADDR_H DATA_LEN_L DATA_LEN_H CRC16_L CRC16_H
+  uint8_t txpacket[12]        = {0};
+  // 12: HEADER0 HEADER1 HEADER2 RESERVED ID LEN_L LEN_H INST START_ADDR_L START_ADDR_H DATA_LEN_L DATA_LEN_H (param) CRC16_L CRC16_H
 
   txpacket[PKT_ID]            = BROADCAST_ID;
   txpacket[PKT_LENGTH_L]      = DXL_LOBYTE(param_length + 7); // 7: INST START_ADDR_L START_ADDR_H DATA_LEN_L DATA_LEN_H CRC16_L CRC16_H
@@ -949,15 +1016,10 @@ int Protocol2PacketHandler::syncReadTx(PortHandler *port, uint16_t start_address
   txpacket[PKT_PARAMETER0+2]  = DXL_LOBYTE(data_length);
   txpacket[PKT_PARAMETER0+3]  = DXL_HIBYTE(data_length);
 
-  for (uint8_t s = 0; s < param_length; s++)
-    txpacket[PKT_PARAMETER0+4+s] = param[s];
-  //memcpy(&txpacket[PKT_PARAMETER0+4], param, param_length);
-
-  result = txPacket(port, txpacket);
+  result = txPacket(port, txpacket, param, param_length);
   if (result == COMM_SUCCESS)
     port->setPacketTimeout((uint16_t)((11 + data_length) * param_length));
 
-  free(txpacket);
   return result;
 }
 
@@ -965,9 +1027,8 @@ int Protocol2PacketHandler::syncWriteTxOnly(PortHandler *port, uint16_t start_ad
 {
   int result                 = COMM_TX_FAIL;
 
-  uint8_t *txpacket           = (uint8_t *)malloc(param_length + 14);
-  //uint8_t *txpacket           = new uint8_t[param_length + 14];
-  // 14: HEADER0 HEADER1 HEADER2 RESERVED ID LEN_L LEN_H INST START_ADDR_L START_ADDR_H DATA_LEN_L DATA_LEN_H CRC16_L CRC16_H
+  uint8_t txpacket[12]        = {0};
+  // 12: HEADER0 HEADER1 HEADER2 RESERVED ID LEN_L LEN_H INST START_ADDR_L START_ADDR_H DATA_LEN_L DATA_LEN_H (param) CRC16_L CRC16_H
 
   txpacket[PKT_ID]            = BROADCAST_ID;
   txpacket[PKT_LENGTH_L]      = DXL_LOBYTE(param_length + 7); // 7: INST START_ADDR_L START_ADDR_H DATA_LEN_L DATA_LEN_H CRC16_L CRC16_H
@@ -978,14 +1039,8 @@ int Protocol2PacketHandler::syncWriteTxOnly(PortHandler *port, uint16_t start_ad
   txpacket[PKT_PARAMETER0+2]  = DXL_LOBYTE(data_length);
   txpacket[PKT_PARAMETER0+3]  = DXL_HIBYTE(data_length);
 
-  for (uint8_t s = 0; s < param_length; s++)
-    txpacket[PKT_PARAMETER0+4+s] = param[s];
-  //memcpy(&txpacket[PKT_PARAMETER0+4], param, param_length);
+  result = txRxPacket(port, txpacket, param, param_length, 0, 0);
 
-  result = txRxPacket(port, txpacket, 0, 0);
-
-  free(txpacket);
-  //delete[] txpacket;
   return result;
 }
 
@@ -993,20 +1048,15 @@ int Protocol2PacketHandler::bulkReadTx(PortHandler *port, uint8_t *param, uint16
 {
   int result                 = COMM_TX_FAIL;
 
-  uint8_t *txpacket           = (uint8_t *)malloc(param_length + 10);
-  //uint8_t *txpacket           = new uint8_t[param_length + 10];
-  // 10: HEADER0 HEADER1 HEADER2 RESERVED ID LEN_L LEN_H INST CRC16_L CRC16_H
+  uint8_t txpacket[8]         = {0};
+  // 8: HEADER0 HEADER1 HEADER2 RESERVED ID LEN_L LEN_H INST (param) CRC16_L CRC16_H
 
   txpacket[PKT_ID]            = BROADCAST_ID;
   txpacket[PKT_LENGTH_L]      = DXL_LOBYTE(param_length + 3); // 3: INST CRC16_L CRC16_H
   txpacket[PKT_LENGTH_H]      = DXL_HIBYTE(param_length + 3); // 3: INST CRC16_L CRC16_H
   txpacket[PKT_INSTRUCTION]   = INST_BULK_READ;
 
-  for (uint8_t s = 0; s < param_length; s++)
-    txpacket[PKT_PARAMETER0+s] = param[s];
-  //memcpy(&txpacket[PKT_PARAMETER0], param, param_length);
-
-  result = txPacket(port, txpacket);
+  result = txPacket(port, txpacket, param, param_length);
   if (result == COMM_SUCCESS)
   {
     int wait_length = 0;
@@ -1015,8 +1065,6 @@ int Protocol2PacketHandler::bulkReadTx(PortHandler *port, uint8_t *param, uint16
     port->setPacketTimeout((uint16_t)wait_length);
   }
 
-  free(txpacket);
-  //delete[] txpacket;
   return result;
 }
 
@@ -1024,22 +1072,299 @@ int Protocol2PacketHandler::bulkWriteTxOnly(PortHandler *port, uint8_t *param, u
 {
   int result                 = COMM_TX_FAIL;
 
-  uint8_t *txpacket           = (uint8_t *)malloc(param_length + 10);
-  //uint8_t *txpacket           = new uint8_t[param_length + 10];
-  // 10: HEADER0 HEADER1 HEADER2 RESERVED ID LEN_L LEN_H INST CRC16_L CRC16_H
+  uint8_t txpacket[8]         = {0};
+  // 8: HEADER0 HEADER1 HEADER2 RESERVED ID LEN_L LEN_H INST (param) CRC16_L CRC16_H
 
   txpacket[PKT_ID]            = BROADCAST_ID;
   txpacket[PKT_LENGTH_L]      = DXL_LOBYTE(param_length + 3); // 3: INST CRC16_L CRC16_H
   txpacket[PKT_LENGTH_H]      = DXL_HIBYTE(param_length + 3); // 3: INST CRC16_L CRC16_H
   txpacket[PKT_INSTRUCTION]   = INST_BULK_WRITE;
 
-  for (uint8_t s = 0; s < param_length; s++)
-    txpacket[PKT_PARAMETER0+s] = param[s];
-  //memcpy(&txpacket[PKT_PARAMETER0], param, param_length);
+  result = txRxPacket(port, txpacket, param, param_length, 0, 0);
+
+  return result;
+}
+
+int Protocol2PacketHandler::fastSyncReadTx(PortHandler *port, uint16_t start_address, uint16_t data_length, uint8_t *param, uint16_t param_length)
+{
+  int result                 = COMM_TX_FAIL;
+
+  uint8_t txpacket[12]        = {0};
+  // 12: HEADER0 HEADER1 HEADER2 RESERVED ID LEN_L LEN_H INST START_ADDR_L START_ADDR_H DATA_LEN_L DATA_LEN_H (param) CRC16_L CRC16_H
+
+  txpacket[PKT_ID]            = BROADCAST_ID;
+  txpacket[PKT_LENGTH_L]      = DXL_LOBYTE(param_length + 7); // 7: INST START_ADDR_L START_ADDR_H DATA_LEN_L DATA_LEN_H CRC16_L CRC16_H
+  txpacket[PKT_LENGTH_H]      = DXL_HIBYTE(param_length + 7); // 7: INST START_ADDR_L START_ADDR_H DATA_LEN_L DATA_LEN_H CRC16_L CRC16_H
+  txpacket[PKT_INSTRUCTION]   = INST_FAST_SYNC_READ;
+  txpacket[PKT_PARAMETER0+0]  = DXL_LOBYTE(start_address);
+  txpacket[PKT_PARAMETER0+1]  = DXL_HIBYTE(start_address);
+  txpacket[PKT_PARAMETER0+2]  = DXL_LOBYTE(data_length);
+  txpacket[PKT_PARAMETER0+3]  = DXL_HIBYTE(data_length);
 
-  result = txRxPacket(port, txpacket, 0, 0);
+  // the same timeout as Sync Read, which leaves room for the gaps between the Dynamixels
+  result = txPacket(port, txpacket, param, param_length);
+  if (result == COMM_SUCCESS)
+    port->setPacketTimeout((uint16_t)((11 + data_length) * param_length));
 
-  free(txpacket);
-  //delete[] txpacket;
   return result;
 }
+
+int Protocol2PacketHandler::fastBulkReadTx(PortHandler *port, uint8_t *param, uint16_t param_length)
+{
+  int result                 = COMM_TX_FAIL;
+
+  uint8_t txpacket[8]         = {0};
+  // 8: HEADER0 HEADER1 HEADER2 RESERVED ID LEN_L LEN_H INST (param) CRC16_L CRC16_H
+
+  txpacket[PKT_ID]            = BROADCAST_ID;
+  txpacket[PKT_LENGTH_L]      = DXL_LOBYTE(param_length + 3); // 3: INST CRC16_L CRC16_H
+  txpacket[PKT_LENGTH_H]      = DXL_HIBYTE(param_length + 3); // 3: INST CRC16_L CRC16_H
+  txpacket[PKT_INSTRUCTION]   = INST_FAST_BULK_READ;
+
+  result = txPacket(port, txpacket, param, param_length);
+  if (result == COMM_SUCCESS)
+  {
+    int wait_length = 0;
+    for (int i = 0; i < param_length; i += 5)
+      wait_length += DXL_MAKEWORD(param[i+3], param[i+4]) + 10;
+    port->setPacketTimeout((uint16_t)wait_length);
+  }
+
+  return result;
+}
+
+int Protocol2PacketHandler::fastReadRx(PortHandler *port, PacketRequest *requests, int count)
+{
+  int     result              = COMM_TX_FAIL;
+  int     packet_length       = 1;    // INST
+  uint8_t *rxpacket           = 0;
+
+  for (int i = 0; i < count; i++)
+  {
+    requests[i].error   = 0;
+    requests[i].result  = COMM_RX_WAITING;
+    packet_length      += requests[i].length + 4;   // 4: ERR ID CRC16_L CRC16_H
+  }
+
+  BusTransaction transaction(port);
+  if (transaction.isAcquired() == false)
+    return COMM_PORT_BUSY;
+
+  // the status packet of every Dynamixel is received in the buffer of the port, not on the stack
+  rxpacket = port->getPacketBuffer(RXPACKET_BUFFER_LEN);
+
+  // a status packet of another ID without error is left from before (see PortHandler::setTxFlush())
+  do {
+    result = rxPacket(port, rxpacket);
+  } while (result == COMM_SUCCESS && rxpacket[PKT_ID] != BROADCAST_ID && rxpacket[PKT_ERROR] == 0);
+
+  if (result == COMM_SUCCESS && rxpacket[PKT_ID] != BROADCAST_ID)
+  {
+    // a Dynamixel which does not know the instruction
+    for (int i = 0; i < count; i++)
+    {
+      if (requests[i].id == rxpacket[PKT_ID])
+        requests[i].error = rxpacket[PKT_ERROR];
+    }
+    result = COMM_NOT_AVAILABLE;
+  }
+  else if (result == COMM_SUCCESS && DXL_MAKEWORD(rxpacket[PKT_LENGTH_L], rxpacket[PKT_LENGTH_H]) != packet_length)
+  {
+    result = COMM_RX_CORRUPT;
+  }
+
+  // the CRC16 of each Dynamixel is covered by that of the packet, which is checked by rxPacket()
+  int index = PKT_ERROR;
+  for (int i = 0; i < count; i++)
+  {
+    if (result == COMM_SUCCESS && rxpacket[index + 1] != requests[i].id)
+      result = COMM_RX_CORRUPT;
+    if (result != COMM_SUCCESS)
+    {
+      requests[i].result = result;
+      continue;
+    }
+
+    requests[i].result  = COMM_SUCCESS;
+    requests[i].error   = rxpacket[index];
+    if (requests[i].data != 0 && requests[i].length > 0)
+      memcpy(requests[i].data, &rxpacket[index + 2], requests[i].length);
+    index += requests[i].length + 4;
+  }
+
+  return result;
+}
+
+int Protocol2PacketHandler::txRxPackets(PortHandler *port, PacketRequest *requests, int count)
+{
+  uint8_t *packets              = 0;
+  uint8_t *rxpacket             = 0;
+  int     packets_length        = 0;
+  int     first                 = 0;    // first request of the packets not written yet
+  int     tx_length             = 0;
+
+  // the status packets are received in the same transaction as the instruction packets
+  BusTransaction transaction(port);
+  if (transaction.isAcquired() == false)
+    return COMM_PORT_BUSY;
+  if (port->beginTransaction() == false)
+    return COMM_PORT_BUSY;
+
+  // the packets are made and received in the buffer of the port, not on the stack:
+  // the status packets are received after all the instruction packets are written
+  packets   = port->getPacketBuffer(PACKET_BUFFER_LEN);
+  rxpacket  = packets;
+
+  if (port->isTxFlush())
+    port->clearPort();
+
+  // tx packets, which are made back to back in packets and written as many at a time as it holds
+  for (int i = 0; i < count; i++)
+  {
+    PacketRequest *request  = &requests[i];
+    int            param_length = 0;
+
+    request->error          = 0;
+    if (request->instruction == INST_PING)
+      param_length = 0;
+    else if (request->instruction == INST_READ)
+      param_length = 4;   // ADDR_L ADDR_H LEN_L LEN_H
+    else if (request->instruction == INST_WRITE || request->instruction == INST_REG_WRITE)
+      param_length = 2 + request->length;
+    else
+    {
+      request->result = COMM_NOT_AVAILABLE;
+      continue;
+    }
+    if (request->id == BROADCAST_ID && (request->instruction == INST_PING || request->instruction == INST_READ))
+    {
+      request->result = COMM_NOT_AVAILABLE;
+      continue;
+    }
+    if (param_length + 10 > TXPACKET_MAX_LEN)   // 10: HEADER0 HEADER1 HEADER2 RESERVED ID LENGTH_L LENGTH_H INST CRC16_L CRC16_H
+    {
+      request->result = COMM_TX_ERROR;
+      continue;
+    }
+
+    // the stuffed packet takes no more than TXPACKET_BUFFER_LEN for TXPACKET_MAX_LEN
+    if (packets_length + (param_length + 10) * 4 / 3 + 1 > TXPACKET_BUFFER_LEN)
+    {
+      writeRequestPackets(port, packets, &packets_length, requests, first, i);
+      first = i;
+    }
+
+    uint8_t *packet         = &packets[packets_length];
+    packet[PKT_HEADER0]     = 0xFF;
+    packet[PKT_HEADER1]     = 0xFF;
+    packet[PKT_HEADER2]     = 0xFD;
+    packet[PKT_RESERVED]    = 0x00;
+    packet[PKT_ID]          = request->id;
+    packet[PKT_LENGTH_L]    = DXL_LOBYTE(param_length + 3);   // 3: INST CRC16_L CRC16_H
+    packet[PKT_LENGTH_H]    = DXL_HIBYTE(param_length + 3);
+    packet[PKT_INSTRUCTION] = request->instruction;
+    if (request->instruction != INST_PING)
+    {
+      packet[PKT_PARAMETER0+0]  = DXL_LOBYTE(request->address);
+      packet[PKT_PARAMETER0+1]  = DXL_HIBYTE(request->address);
+      if (request->instruction == INST_READ)
+      {
+        packet[PKT_PARAMETER0+2]  = DXL_LOBYTE(request->length);
+        packet[PKT_PARAMETER0+3]  = DXL_HIBYTE(request->length);
+      }
+      else if (request->length > 0)
+      {
+        memcpy(&packet[PKT_PARAMETER0+2], request->data, request->length);
+      }
+    }
+    addStuffing(packet);
+
+    int total_packet_length = DXL_MAKEWORD(packet[PKT_LENGTH_L], packet[PKT_LENGTH_H]) + 7;
+    if (total_packet_length > TXPACKET_MAX_LEN)
+    {
+      request->result = COMM_TX_ERROR;
+      continue;
+    }
+    uint16_t crc = Crc16::update(0, packet, total_packet_length - 2);
+    packet[total_packet_length - 2] = DXL_LOBYTE(crc);
+    packet[total_packet_length - 1] = DXL_HIBYTE(crc);
+
+    packets_length += total_packet_length;
+    tx_length      += total_packet_length;
+    port->addBusTx(request->instruction, total_packet_length);
+
+    // (ID == Broadcast ID) == no need to wait for status packet
+    request->result = (request->id == BROADCAST_ID) ? COMM_SUCCESS : COMM_RX_WAITING;
+  }
+  writeRequestPackets(port, packets, &packets_length, requests, first, count);
+
+  // rx packets, which answer the requests in order
+  // (PortHandler::updateResponseTime() is not called, as a response waits for the packets transmitted before it)
+  int next  = 0;
+  int armed = -1;  // request the timeout is set for
+  while (true)
+  {
+    while (next < count && requests[next].result != COMM_RX_WAITING)
+      next++;
+    if (next == count)
+      break;
+
+    PacketRequest *request = &requests[next];
+
+    // the timeout is set once for each request, so status packets answering no request do not put it off
+    if (armed != next)
+    {
+      // the first status packet comes after all the instruction packets are transmitted
+      int packet_length = getStatusDataLength(request) + 11 + tx_length;
+      tx_length = 0;
+      if (request->timeout_msec > 0)
+        port->setPacketTimeout(request->timeout_msec);
+      else
+        port->setResponseTimeout(request->id, (uint16_t)((packet_length < 0xFFFF) ? packet_length : 0xFFFF));
+      armed = next;
+    }
+
+    int result = rxPacket(port, rxpacket);
+    if (result != COMM_SUCCESS)
+    {
+      request->result = result;
+      continue;
+    }
+
+    // the requests before the one answered have no status packet any more
+    // (a status packet answering no request is dropped, as txRxPacket() does)
+    for (int i = next; i < count; i++)
+    {
+      if (requests[i].result != COMM_RX_WAITING ||
+          isExpectedStatus(port, rxpacket, requests[i].id, getStatusDataLength(&requests[i])) == false)
+        continue;
+
+      for (int j = next; j < i; j++)
+      {
+        if (requests[j].result == COMM_RX_WAITING)
+          requests[j].result = COMM_RX_TIMEOUT;
+      }
+      requests[i].result = COMM_SUCCESS;
+      requests[i].error  = rxpacket[PKT_ERROR];
+      if (requests[i].data != 0 && requests[i].instruction != INST_WRITE && requests[i].instruction != INST_REG_WRITE)
+      {
+        uint16_t data_length = DXL_MAKEWORD(rxpacket[PKT_LENGTH_L], rxpacket[PKT_LENGTH_H]) - 4;
+        if (data_length == getStatusDataLength(&requests[i]))
+          memcpy(requests[i].data, &rxpacket[PKT_PARAMETER0+1], data_length);
+      }
+      break;
+    }
+
+    // a status packet answering no request does not keep the request waiting after its timeout
+    if (request->result == COMM_RX_WAITING && port->isPacketTimeout() == true)
+      request->result = COMM_RX_TIMEOUT;
+  }
+  port->endTransaction();
+
+  for (int i = 0; i < count; i++)
+  {
+    if (requests[i].result != COMM_SUCCESS)
+      return requests[i].result;
+  }
+  return COMM_SUCCESS;
+}
@@ -0,0 +1,203 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#if defined(__linux__)
+
+#include <alloca.h>
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+
+#include "rt_support.h"
+
+#define ISOLATED_CPUS_PATH  "/sys/devices/system/cpu/isolated"
+#define PAGE_STEP           4096
+#define STACK_MARGIN        (64 * 1024)   // stack left below the prefault for the functions called by the loop
+
+using namespace dynamixel;
+
+bool RtSupport::apply(const RtConfig &config, RtStatus *status)
+{
+  RtStatus result;
+  result.priority = RT_NOT_REQUESTED;
+  result.affinity = RT_NOT_REQUESTED;
+  result.memory   = RT_NOT_REQUESTED;
+  result.stack    = RT_NOT_REQUESTED;
+  result.cpu      = -1;
+
+  // the memory is locked first, so the stack touched stays resident
+  if (config.lock_memory)
+    result.memory = lockMemory();
+
+  if (config.cpu != -1)
+  {
+    int cpu = config.cpu;
+    if (cpu == RtConfig::CPU_ISOLATED_)
+    {
+      std::vector<int> cpus;
+      cpu = (getIsolatedCpus(cpus) > 0) ? cpus[0] : -1;
+    }
+    result.affinity = (cpu >= 0) ? setAffinity(cpu) : ENODEV;
+    if (result.affinity == 0)
+      result.cpu = cpu;
+  }
+
+  if (config.priority > 0)
+    result.priority = setPriority(config.priority);
+
+  if (config.stack_prefault > 0)
+    result.stack = prefaultStack(config.stack_prefault);
+
+  if (status != 0)
+    *status = result;
+
+  return (result.priority <= 0 && result.affinity <= 0 && result.memory <= 0 && result.stack <= 0);
+}
+
+int RtSupport::setPriority(int priority)
+{
+  struct sched_param param;
+  int                policy = (priority > 0) ? SCHED_FIFO : SCHED_OTHER;
+
+  memset(&param, 0, sizeof(param));
+  param.sched_priority = priority;
+  int result = pthread_setschedparam(pthread_self(), policy, &param);
+  if (result != 0)
+    return result;
+
+  // checks the policy the thread runs with
+  if (pthread_getschedparam(pthread_self(), &policy, &param) != 0 || param.sched_priority != priority)
+    return EPERM;
+  return 0;
+}
+
+int RtSupport::setAffinity(int cpu)
+{
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (cpu < 0)
+  {
+    for (int i = 0; i < CPU_SETSIZE; i++)
+      CPU_SET(i, &set);
+  }
+  else
+  {
+    if (cpu >= CPU_SETSIZE)
+      return EINVAL;
+    CPU_SET(cpu, &set);
+  }
+
+  int result = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  if (result != 0)
+    return result;
+
+  // checks the CPUs the thread can run on
+  cpu_set_t applied;
+  if (pthread_getaffinity_np(pthread_self(), sizeof(applied), &applied) != 0)
+    return errno;
+  if (cpu >= 0 && (CPU_COUNT(&applied) != 1 || CPU_ISSET(cpu, &applied) == 0))
+    return EINVAL;
+  return 0;
+}
+
+int RtSupport::lockMemory()
+{
+  if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0)
+    return errno;
+  return 0;
+}
+
+int RtSupport::prefaultStack(int size)
+{
+  struct rlimit limit;
+  if (getrlimit(RLIMIT_STACK, &limit) == 0 && limit.rlim_cur != RLIM_INFINITY
+      && (rlim_t)size + STACK_MARGIN > limit.rlim_cur)
+    return ENOMEM;
+
+  // the pages are written, so they are mapped (and locked by MCL_FUTURE)
+  volatile uint8_t *stack = (volatile uint8_t *)alloca(size);
+  for (int i = 0; i < size; i += PAGE_STEP)
+    stack[i] = 0;
+  stack[size - 1] = 0;
+  return 0;
+}
+
+int RtSupport::getIsolatedCpus(std::vector<int> &cpus)
+{
+  cpus.clear();
+
+  FILE *fp = fopen(ISOLATED_CPUS_PATH, "r");
+  if (fp == NULL)
+    return 0;
+
+  // list of CPUs and ranges (ex. "2-3,6")
+  char list[256];
+  if (fgets(list, sizeof(list), fp) != NULL)
+  {
+    char *p = list;
+    while (*p >= '0' && *p <= '9')
+    {
+      int first = (int)strtol(p, &p, 10);
+      int last  = first;
+      if (*p == '-')
+        last = (int)strtol(p + 1, &p, 10);
+      for (int cpu = first; cpu <= last; cpu++)
+        cpus.push_back(cpu);
+      if (*p == ',')
+        p++;
+    }
+  }
+  fclose(fp);
+  return (int)cpus.size();
+}
+
+const char *RtSupport::getResultString(int result)
+{
+  if (result == 0)
+    return "applied";
+  if (result == RT_NOT_REQUESTED)
+    return "not requested";
+  return strerror(result);
+}
+
+void RtSupport::printStatus(const char *name, const RtStatus &status)
+{
+  printf("[RtSupport] %s: SCHED_FIFO %s, CPU %s", name, getResultString(status.priority), getResultString(status.affinity));
+  if (status.cpu >= 0)
+    printf(" (%d)", status.cpu);
+  printf(", mlockall %s, stack prefault %s\n", getResultString(status.memory), getResultString(status.stack));
+}
+
+#endif
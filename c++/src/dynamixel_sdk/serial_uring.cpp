@@ -0,0 +1,270 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#if defined(__linux__)
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+// io_uring is built with the kernel headers of Linux 5.11 or later (IORING_ENTER_EXT_ARG),
+// and SerialUring::isAvailable() returns false without them
+#if defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#endif
+#endif
+#if defined(IORING_ENTER_EXT_ARG) && defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+#define SERIAL_URING
+#endif
+
+#include "serial_uring.h"
+#include "port_handler_linux.h"
+
+using namespace dynamixel;
+
+#if defined(SERIAL_URING)
+
+SerialUring::SerialUring(int entries)
+  : ring_fd_(-1),
+    ring_(0),
+    ring_size_(0),
+    sqes_(0),
+    sqes_size_(0),
+    cqes_(0),
+    sq_head_(0),
+    sq_tail_(0),
+    sq_array_(0),
+    sq_mask_(0),
+    sq_entries_(0),
+    sq_local_tail_(0),
+    cq_head_(0),
+    cq_tail_(0),
+    cq_mask_(0),
+    batch_depth_(0)
+{
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+
+  ring_fd_ = syscall(__NR_io_uring_setup, entries, &params);
+  if (ring_fd_ < 0)
+    return;
+
+  // the waits need the timeout of io_uring_enter() (5.11), and the rings are mapped at once (5.4)
+  if ((params.features & IORING_FEAT_EXT_ARG) == 0 || (params.features & IORING_FEAT_SINGLE_MMAP) == 0)
+  {
+    close(ring_fd_);
+    ring_fd_ = -1;
+    return;
+  }
+
+  size_t sq_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  ring_size_  = (sq_size > cq_size) ? sq_size : cq_size;
+  sqes_size_  = params.sq_entries * sizeof(struct io_uring_sqe);
+
+  void *ring = mmap(0, ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQ_RING);
+  void *sqes = mmap(0, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+  if (ring == MAP_FAILED || sqes == MAP_FAILED)
+  {
+    if (ring != MAP_FAILED)
+      munmap(ring, ring_size_);
+    if (sqes != MAP_FAILED)
+      munmap(sqes, sqes_size_);
+    close(ring_fd_);
+    ring_fd_ = -1;
+    return;
+  }
+
+  ring_         = (uint8_t *)ring;
+  sqes_         = (io_uring_sqe *)sqes;
+  sq_head_      = (uint32_t *)(ring_ + params.sq_off.head);
+  sq_tail_      = (uint32_t *)(ring_ + params.sq_off.tail);
+  sq_array_     = (uint32_t *)(ring_ + params.sq_off.array);
+  sq_mask_      = *(uint32_t *)(ring_ + params.sq_off.ring_mask);
+  sq_entries_   = params.sq_entries;
+  sq_local_tail_ = *sq_tail_;
+  cq_head_      = (uint32_t *)(ring_ + params.cq_off.head);
+  cq_tail_      = (uint32_t *)(ring_ + params.cq_off.tail);
+  cq_mask_      = *(uint32_t *)(ring_ + params.cq_off.ring_mask);
+  cqes_         = (io_uring_cqe *)(ring_ + params.cq_off.cqes);
+}
+
+SerialUring::~SerialUring()
+{
+  if (ring_fd_ < 0)
+    return;
+  munmap(sqes_, sqes_size_);
+  munmap(ring_, ring_size_);
+  close(ring_fd_);
+}
+
+bool SerialUring::isAvailable()
+{
+  return (ring_fd_ >= 0);
+}
+
+void SerialUring::beginBatch()
+{
+  batch_depth_++;
+}
+
+void SerialUring::endBatch()
+{
+  if (batch_depth_ > 0 && --batch_depth_ == 0)
+    submit();
+}
+
+void SerialUring::reserve(int count)
+{
+  // the entries prepared are consumed by the kernel on submission
+  while (sq_local_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) + count > sq_entries_)
+    enter(0);
+}
+
+io_uring_sqe *SerialUring::getEntry()
+{
+  uint32_t index = sq_local_tail_ & sq_mask_;
+  io_uring_sqe *sqe = &sqes_[index];
+  memset(sqe, 0, sizeof(*sqe));
+  sq_array_[index] = index;
+  sq_local_tail_++;
+  return sqe;
+}
+
+uint32_t SerialUring::getSequence()
+{
+  return sq_local_tail_;
+}
+
+io_uring_sqe *SerialUring::getHeldEntry(uint32_t sequence)
+{
+  if ((int32_t)(sequence - *sq_tail_) < 0 || (int32_t)(sq_local_tail_ - sequence) <= 0)
+    return 0;
+  return &sqes_[sequence & sq_mask_];
+}
+
+int SerialUring::submit()
+{
+  if (batch_depth_ > 0 || sq_local_tail_ == *sq_tail_)
+    return 0;
+
+  uint32_t to_submit = sq_local_tail_ - *sq_tail_;
+  __atomic_store_n(sq_tail_, sq_local_tail_, __ATOMIC_RELEASE);
+
+  return syscall(__NR_io_uring_enter, ring_fd_, to_submit, 0, 0, NULL, 0);
+}
+
+bool SerialUring::enter(int64_t timeout_ns)
+{
+  struct io_uring_getevents_arg arg;
+  struct __kernel_timespec      ts;
+
+  uint32_t to_submit = sq_local_tail_ - *sq_tail_;
+  __atomic_store_n(sq_tail_, sq_local_tail_, __ATOMIC_RELEASE);
+
+  memset(&arg, 0, sizeof(arg));
+  ts.tv_sec   = timeout_ns / 1000000000LL;
+  ts.tv_nsec  = timeout_ns % 1000000000LL;
+  arg.ts      = (uint64_t)(uintptr_t)&ts;
+
+  // ETIME: timeout, EINTR: signal, EBUSY: completion queue to be reaped first
+  int result = syscall(__NR_io_uring_enter, ring_fd_, to_submit, (timeout_ns > 0) ? 1 : 0,
+                       IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+  reap();
+  return (result >= 0 || errno == ETIME || errno == EINTR || errno == EBUSY);
+}
+
+int SerialUring::reap()
+{
+  uint32_t head  = *cq_head_;
+  uint32_t tail  = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+  int      count = 0;
+
+  while (head != tail)
+  {
+    io_uring_cqe *cqe = &cqes_[head & cq_mask_];
+    uint64_t user_data = cqe->user_data;
+    int      result    = cqe->res;
+
+    // the entry is released before the port handles it, as the port may prepare new entries
+    head++;
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    count++;
+
+    // user_data: port | operation (PortHandlerLinux is aligned to 8 bytes at least)
+    PortHandlerLinux *port = (PortHandlerLinux *)(uintptr_t)(user_data & ~(uint64_t)7);
+    if (port != 0)
+      port->completeUring((int)(user_data & 7), result);
+
+    if (head == tail)
+      tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+  }
+  return count;
+}
+
+#else
+
+SerialUring::SerialUring(int entries)
+  : ring_fd_(-1),
+    ring_(0),
+    ring_size_(0),
+    sqes_(0),
+    sqes_size_(0),
+    cqes_(0),
+    sq_head_(0),
+    sq_tail_(0),
+    sq_array_(0),
+    sq_mask_(0),
+    sq_entries_(0),
+    sq_local_tail_(0),
+    cq_head_(0),
+    cq_tail_(0),
+    cq_mask_(0),
+    batch_depth_(0)
+{
+}
+
+SerialUring::~SerialUring() { }
+bool SerialUring::isAvailable() { return false; }
+void SerialUring::beginBatch() { }
+void SerialUring::endBatch() { }
+void SerialUring::reserve(int count) { }
+io_uring_sqe *SerialUring::getEntry() { return 0; }
+uint32_t SerialUring::getSequence() { return 0; }
+io_uring_sqe *SerialUring::getHeldEntry(uint32_t sequence) { return 0; }
+int SerialUring::submit() { return -1; }
+bool SerialUring::enter(int64_t timeout_ns) { return false; }
+int SerialUring::reap() { return 0; }
+
+#endif  // SERIAL_URING
+
+#endif
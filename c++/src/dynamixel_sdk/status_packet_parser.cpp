@@ -0,0 +1,395 @@
+/*******************************************************************************
+* Copyright (c) 2016, ROBOTIS CO., LTD.
+* All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without
+* modification, are permitted provided that the following conditions are met:
+*
+* * Redistributions of source code must retain the above copyright notice, this
+*   list of conditions and the following disclaimer.
+*
+* * Redistributions in binary form must reproduce the above copyright notice,
+*   this list of conditions and the following disclaimer in the documentation
+*   and/or other materials provided with the distribution.
+*
+* * Neither the name of ROBOTIS nor the names of its
+*   contributors may be used to endorse or promote products derived from
+*   this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+* AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+* IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+* DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+* FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+* DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+* SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+* CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+* OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+* OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*******************************************************************************/
+
+#if defined(__linux__)
+#include "status_packet_parser.h"
+#include "crc16.h"
+#elif defined(__APPLE__)
+#include "status_packet_parser.h"
+#include "crc16.h"
+#elif defined(_WIN32) || defined(_WIN64)
+#define WINDLLEXPORT
+#include "status_packet_parser.h"
+#include "crc16.h"
+#elif defined(ARDUINO) || defined(__OPENCR__) || defined(__OPENCM904__)
+#include "../../include/dynamixel_sdk/status_packet_parser.h"
+#include "../../include/dynamixel_sdk/crc16.h"
+#endif
+
+#include <string.h>
+
+#define PROTOCOL1_HEADER_LENGTH 5           // HEADER0 HEADER1 ID LENGTH ERROR, checked as they arrive
+#define PROTOCOL1_MAX_LENGTH    250         // LENGTH of the longest status packet (ERROR ... CHKSUM)
+#define PROTOCOL2_HEADER_LENGTH 8           // HEADER0 HEADER1 HEADER2 RESERVED ID LENGTH_L LENGTH_H INST, checked as they arrive
+#define PROTOCOL2_MAX_LENGTH    (4*1024)    // LENGTH of the longest status packet (INST ... CRC16_H)
+
+using namespace dynamixel;
+
+StatusPacketParser::StatusPacketParser(int capacity)
+  : buffer_(0), capacity_(1), mask_(0), tail_(0), scan_(0), frame_start_(0), frame_length_(0),
+    protocol_(2), skipped_(0), frame_head_(0), frame_count_(0)
+{
+  while (capacity_ < (uint32_t)capacity)
+    capacity_ <<= 1;
+  mask_   = capacity_ - 1;
+  buffer_ = new uint8_t[capacity_];
+}
+
+StatusPacketParser::~StatusPacketParser()
+{
+  delete[] buffer_;
+}
+
+int StatusPacketParser::getWritableLength()
+{
+  uint32_t space     = capacity_ - (tail_ - getHead());
+  uint32_t to_end    = capacity_ - (tail_ & mask_);
+  return (int)((space < to_end) ? space : to_end);
+}
+
+int StatusPacketParser::feed(const uint8_t *data, int length)
+{
+  int taken = 0;
+  while (taken < length)
+  {
+    int n = getWritableLength();
+    if (n == 0)
+      break;
+    if (n > length - taken)
+      n = length - taken;
+    memcpy(getWritePointer(), &data[taken], n);
+    commit(n);
+    taken += n;
+  }
+  return taken;
+}
+
+// checks a byte of the header as it arrives, the same as the previous rxPacket() of the packet handlers
+// (previous: the byte before, capacity: size of the ring buffer, length: set to the length of the packet when it is known)
+static bool checkHeaderByte(int protocol, int offset, uint8_t byte, uint8_t previous, int capacity, int *length)
+{
+  if (protocol == 1)
+  {
+    switch (offset)
+    {
+      case 0:   // HEADER0
+      case 1:   // HEADER1
+        return byte == 0xFF;
+
+      case 2:   // ID
+        return byte <= 0xFD;
+
+      case 3:   // LENGTH
+        if (byte < 2 || byte > PROTOCOL1_MAX_LENGTH || byte + 4 > capacity)
+          return false;
+        *length = byte + 4;
+        return true;
+
+      default:  // ERROR
+        return byte < 0x64;
+    }
+  }
+
+  switch (offset)
+  {
+    case 0:     // HEADER0
+    case 1:     // HEADER1
+      return byte == 0xFF;
+
+    case 2:     // HEADER2
+      return byte == 0xFD;
+
+    case 3:     // RESERVED
+      return byte == 0x00;
+
+    case 4:     // ID (0xFE: Fast Sync Read / Fast Bulk Read)
+      return byte <= 0xFC || byte == 0xFE;
+
+    case 6:     // LENGTH_H
+    {
+      int packet_length = DXL_MAKEWORD(previous, byte);
+      if (packet_length < 4 || packet_length > PROTOCOL2_MAX_LENGTH || packet_length + 7 > capacity)
+        return false;
+      *length = packet_length + 7;
+      return true;
+    }
+
+    case 7:     // INST
+      return byte == 0x55;
+
+    default:    // LENGTH_L
+      return true;
+  }
+}
+
+// checks the whole header at once, when it has arrived in a row
+static bool checkHeader(int protocol, const uint8_t *header, int capacity, int *length)
+{
+  if (protocol == 1)
+  {
+    if (header[1] != 0xFF || header[2] > 0xFD || header[3] < 2 || header[3] > PROTOCOL1_MAX_LENGTH ||
+        header[3] + 4 > capacity || header[4] >= 0x64)
+      return false;
+    *length = header[3] + 4;
+    return true;
+  }
+
+  int packet_length = DXL_MAKEWORD(header[5], header[6]);
+  if (header[1] != 0xFF || header[2] != 0xFD || header[3] != 0x00 || (header[4] > 0xFC && header[4] != 0xFE) || header[7] != 0x55 ||
+      packet_length < 4 || packet_length > PROTOCOL2_MAX_LENGTH || packet_length + 7 > capacity)
+    return false;
+  *length = packet_length + 7;
+  return true;
+}
+
+// removes the byte stuffing (FF FF FD FD -> FF FF FD) of a packet of Protocol 2.0 in place
+// (a packet which fails the checksum or CRC is left as it was received, and so is the packet of
+// Fast Sync Read / Fast Bulk Read (ID 0xFE), which the Dynamixels answer without byte stuffing)
+static void removeStuffing(int protocol, uint8_t *packet, int *length)
+{
+  if (protocol == 1 || packet[4] == 0xFE || memchr(&packet[7], 0xFD, *length - 9) == 0)
+    return;
+
+  int     end     = *length - 2;  // except CRC16
+  int     index   = 7;            // INST
+  uint8_t prev[2] = { packet[5], packet[6] };
+
+  // the bytes are compared as received, as the bytes before index are overwritten
+  for (int i = 7; i < end; i++)
+  {
+    uint8_t data = packet[i];
+    packet[index++] = data;
+    if (data == 0xFD && prev[1] == 0xFF && prev[0] == 0xFF && i + 1 < end && packet[i+1] == 0xFD)
+      i++;  // FF FF FD FD
+    prev[0] = prev[1];
+    prev[1] = data;
+  }
+  if (index == end)
+    return;
+
+  packet[index++] = packet[end];
+  packet[index++] = packet[end+1];
+
+  packet[5] = DXL_LOBYTE(index - 7);
+  packet[6] = DXL_HIBYTE(index - 7);
+  *length   = index;
+}
+
+// checks the checksum or CRC of a packet in the ring buffer (mask: size of the ring buffer - 1)
+static int verifyFrame(int protocol, const uint8_t *buffer, uint32_t mask, uint32_t start, int length)
+{
+  if (protocol == 1)
+  {
+    uint8_t checksum = 0;
+    for (int i = 2; i < length - 1; i++)   // except header, checksum
+      checksum += buffer[(start + i) & mask];
+    checksum = ~checksum;
+    return (buffer[(start + length - 1) & mask] == checksum) ? COMM_SUCCESS : COMM_RX_CORRUPT;
+  }
+
+  // the packet may wrap around the end of the ring buffer
+  uint32_t first    = start & mask;
+  int      data_len = length - 2;   // except CRC16
+  int      to_end   = (int)(mask + 1 - first);
+  uint16_t crc;
+  if (data_len <= to_end)
+    crc = Crc16::update(0, &buffer[first], data_len);
+  else
+    crc = Crc16::update(Crc16::update(0, &buffer[first], to_end), buffer, data_len - to_end);
+
+  uint16_t received = DXL_MAKEWORD(buffer[(start + length - 2) & mask], buffer[(start + length - 1) & mask]);
+  return (crc == received) ? COMM_SUCCESS : COMM_RX_CORRUPT;
+}
+
+void StatusPacketParser::parse()
+{
+  // the state is kept in locals while parsing, as the members would be loaded again after each call
+  uint8_t  *buffer      = buffer_;
+  uint32_t  capacity    = capacity_;
+  uint32_t  mask        = mask_;
+  uint32_t  tail        = tail_;
+  int       protocol    = protocol_;
+  uint32_t  scan        = scan_;
+  uint32_t  start       = frame_start_;
+  int       length      = frame_length_;
+  int       frame_count = frame_count_;
+  int       skipped     = skipped_;
+  int       header      = (protocol == 1) ? PROTOCOL1_HEADER_LENGTH : PROTOCOL2_HEADER_LENGTH;
+
+  while (scan != tail && frame_count < FRAME_SLOTS_)
+  {
+    if (scan == start)
+    {
+      uint32_t index = scan & mask;
+      uint32_t count = tail - scan;
+      if (count > capacity - index)
+        count = capacity - index;
+
+      if (buffer[index] != 0xFF)
+      {
+        // no header yet: skip to the next 0xFF
+        const uint8_t *found = (const uint8_t *)memchr(&buffer[index], 0xFF, count);
+        uint32_t skip = (found != 0) ? (uint32_t)(found - &buffer[index]) : count;
+        scan    += skip;
+        start    = scan;
+        skipped += skip;
+        continue;
+      }
+
+      if (count >= (uint32_t)header)
+      {
+        // the header has arrived in a row: checked at once
+        if (checkHeader(protocol, &buffer[index], (int)capacity, &length) == false)
+        {
+          start++;
+          scan = start;
+          length = 0;
+          skipped++;
+          continue;
+        }
+        scan += header;
+      }
+    }
+
+    int offset = (int)(scan - start);
+    if (offset >= header)
+    {
+      // the rest of the packet is checked by the checksum or CRC when it has all arrived
+      if (tail - start < (uint32_t)length)
+      {
+        scan = tail;
+        break;
+      }
+      scan = start + length;
+
+      Frame *frame  = &frames_[(frame_head_ + frame_count) % FRAME_SLOTS_];
+      frame->start  = start;
+      frame->length = length;
+      frame->result = verifyFrame(protocol, buffer, mask, start, length);
+      frame_count++;
+
+      start  = scan;
+      length = 0;
+      continue;
+    }
+
+    if (checkHeaderByte(protocol, offset, buffer[scan & mask], buffer[(scan - 1) & mask], (int)capacity, &length) == false)
+    {
+      // search again from the second byte of the wrong header
+      start++;
+      scan   = start;
+      length = 0;
+      skipped++;
+      continue;
+    }
+    scan++;
+  }
+
+  scan_         = scan;
+  frame_start_  = start;
+  frame_length_ = length;
+  frame_count_  = frame_count;
+  skipped_      = skipped;
+}
+
+int StatusPacketParser::popFrame(uint8_t *packet, int capacity, int *length)
+{
+  while (frame_count_ > 0)
+  {
+    Frame   *frame  = &frames_[frame_head_];
+    uint32_t first  = frame->start & mask_;
+    int      to_end = (int)(capacity_ - first);
+    int      n      = frame->length;
+    int      result = frame->result;
+
+    frame_head_   = (frame_head_ + 1) % FRAME_SLOTS_;
+    frame_count_--;
+
+    // a packet longer than the buffer of the caller answers nothing it waits for (ex. a stale status packet
+    // left when the port is not cleared before the instruction packet), so it is skipped
+    if (n > capacity)
+    {
+      skipped_ += n;
+    }
+    else
+    {
+      if (n <= to_end)
+      {
+        memcpy(packet, &buffer_[first], n);
+      }
+      else
+      {
+        memcpy(packet, &buffer_[first], to_end);
+        memcpy(&packet[to_end], buffer_, n - to_end);
+      }
+      if (result == COMM_SUCCESS)
+        removeStuffing(protocol_, packet, &n);
+      if (length != 0)
+        *length = n;
+    }
+
+    // the bytes left when the slots were full, parsed when all the packets found have been taken
+    if (frame_count_ == 0 && scan_ != tail_)
+      parse();
+    if (n <= capacity)
+      return result;
+  }
+  return COMM_RX_WAITING;
+}
+
+int StatusPacketParser::getPacketLength(const uint8_t *header)
+{
+  int length = 0;
+  if (checkHeader(protocol_, header, (int)capacity_, &length) == false)
+    return 0;
+  return length;
+}
+
+int StatusPacketParser::checkPacket(uint8_t *packet, int *length)
+{
+  int n = *length;
+  int result;
+  if (protocol_ == 1)
+  {
+    uint8_t checksum = 0;
+    for (int i = 2; i < n - 1; i++)   // except header, checksum
+      checksum += packet[i];
+    checksum = ~checksum;
+    result = (packet[n - 1] == checksum) ? COMM_SUCCESS : COMM_RX_CORRUPT;
+  }
+  else
+  {
+    result = (Crc16::update(0, packet, n - 2) == DXL_MAKEWORD(packet[n - 2], packet[n - 1])) ? COMM_SUCCESS : COMM_RX_CORRUPT;
+  }
+
+  if (result == COMM_SUCCESS)
+    removeStuffing(protocol_, packet, length);
+  return result;
+}